@@ -12,16 +12,28 @@
 
 struct Adxl345_Handle;
 
-#define ADXL345_HANDLE_INITIALIZER                                             \
+/**
+ * Number of sensors sharing SPI1, each with its own chip select line.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define ADXL345TRANSPORTIMPL_SENSORS 2U
+
+/**
+ * Initializes the handle of sensor SENSOR in [0, ADXL345TRANSPORTIMPL_SENSORS).
+ */
+#define ADXL345_HANDLE_INITIALIZER(SENSOR)                                     \
   {                                                                            \
-    .doTransmitFrameImpl = Adxl345TransportImpl_doTransmitFrameImpl,           \
+    .doTransmitFrameImpl = Adxl345TransportImpl_doTransmitFrame##SENSOR##Impl, \
     .doTransmitReceiveFrameImpl =                                              \
-        Adxl345TransportImpl_doTransmitReceiveFrameImpl                        \
+        Adxl345TransportImpl_doTransmitReceiveFrame##SENSOR##Impl              \
   }
 
 /**
  * Sends one single frame to ADXL345 via SPI interface.
  *
+ * One function per sensor (suffix denotes the chip select line) since the
+ * handle's pimpls do not receive the handle.
+ *
  * @param frame the payload to send via SPI
  * @param numBytes size of frame
  * @param applyCs whether or not to set nCS before and clear nCS after
@@ -32,7 +44,10 @@ struct Adxl345_Handle;
  *
  * @return -EINVAL if invalid args, -EIO on TX error, 0 otherwise
  */
-int Adxl345TransportImpl_doTransmitFrameImpl(
+int Adxl345TransportImpl_doTransmitFrame0Impl(
+    const union Adxl345Transport_TxFrame *frame, uint8_t numBytes,
+    enum Adxl345Spi_Cs applyCs, enum Adxl345Spi_RwFlags rwFlag);
+int Adxl345TransportImpl_doTransmitFrame1Impl(
     const union Adxl345Transport_TxFrame *frame, uint8_t numBytes,
     enum Adxl345Spi_Cs applyCs, enum Adxl345Spi_RwFlags rwFlag);
 
@@ -48,6 +63,19 @@ int Adxl345TransportImpl_doTransmitFrameImpl(
  *
  * @return -EINVAL if invalid args, -EIO on TX/RX error, 0 otherwise
  */
-int Adxl345TransportImpl_doTransmitReceiveFrameImpl(
+int Adxl345TransportImpl_doTransmitReceiveFrame0Impl(
     const union Adxl345Transport_TxFrame *txFrame,
     union Adxl345Transport_RxFrame *rxFrame, uint8_t numBytesReceive);
+int Adxl345TransportImpl_doTransmitReceiveFrame1Impl(
+    const union Adxl345Transport_TxFrame *txFrame,
+    union Adxl345Transport_RxFrame *rxFrame, uint8_t numBytesReceive);
+
+/**
+ * Reinitializes SPI1 shared by all sensors with another clock prescaler.
+ *
+ * Must not be called while a transfer is ongoing.
+ *
+ * @param divisor SPI prescaler of PCLK2, 2 to 256
+ * @return -EINVAL if divisor is invalid, -EIO on HAL failure, 0 otherwise
+ */
+int Adxl345TransportImpl_setSpiDivisor(uint16_t divisor);
@@ -0,0 +1,41 @@
+/**
+ * \file clock_profile_impl.h
+ *
+ * API of the system clock profile implementation.
+ *
+ * The profile is selected at compile time by CLOCK_PROFILE_MAX_PERFORMANCE or
+ * CLOCK_PROFILE_LOW_POWER, otherwise the clock configured by CubeMX is kept.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+/**
+ * Reconfigures the PLL, bus dividers, flash latency and regulator voltage
+ * scale to the selected profile.
+ *
+ * Called once after SystemClock_Config(), before any peripheral but the
+ * oscillators is initialized.
+ *
+ * @return -EINVAL if the profile is invalid, -EIO on HAL failure, 0 otherwise
+ */
+int ClockProfileImpl_apply();
+
+/**
+ * @return smallest SPI prescaler keeping the sensors' SPI clock at 5MHz at
+ * most, 0 if none
+ */
+uint16_t ClockProfileImpl_spiRatedDivisor();
+
+/**
+ * @param divisor SPI prescaler 2 to 256
+ * @return SPI_BAUDRATEPRESCALER_* of divisor, SPI_BAUDRATEPRESCALER_256 if
+ * divisor is invalid
+ */
+uint32_t ClockProfileImpl_spiBaudRatePrescaler(uint16_t divisor);
+
+/**
+ * @return TIM3 period of the 5us delay between FiFo reads
+ */
+uint32_t ClockProfileImpl_tim3Period();
@@ -0,0 +1,45 @@
+/**
+ * \file config_store_impl.h
+ *
+ * API of the flash sector backing the configuration store.
+ *
+ * The last flash sector (128kB) is reserved, the application must not exceed
+ * CONFIGSTOREIMPL_SECTOR_ADDRESS, see board_upload.maximum_size in
+ * platformio.ini.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+#if defined(STM32F401xC)
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONFIGSTOREIMPL_SECTOR_ADDRESS 0x08020000UL
+#else
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONFIGSTOREIMPL_SECTOR_ADDRESS 0x08060000UL
+#endif
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONFIGSTOREIMPL_SECTOR_BYTES (128UL * 1024UL)
+
+/**
+ * Erases the reserved sector.
+ *
+ * Context: main()
+ *
+ * @return -EIO on HAL failure, 0 otherwise
+ */
+int ConfigStoreImpl_doEraseImpl();
+
+/**
+ * Programs one word of the reserved sector.
+ *
+ * Context: main()
+ *
+ * @param offset word offset from CONFIGSTOREIMPL_SECTOR_ADDRESS
+ * @param word
+ * @return -EINVAL if offset is beyond the sector, -EIO on HAL failure, 0
+ * otherwise
+ */
+int ConfigStoreImpl_doProgramWordImpl(uint32_t offset, uint32_t word);
@@ -0,0 +1,20 @@
+/**
+ * \file crc_impl.h
+ *
+ * API of the hardware CRC calculation unit implementation.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+void CrcImpl_init();
+
+/**
+ * Computes the CRC by means of the CRC calculation unit.
+ *
+ * Same result as Crc_crc32Words(const uint32_t *, uint16_t).
+ *
+ * Context: main()
+ */
+uint32_t CrcImpl_doCrc32WordsImpl(const uint32_t *words, uint16_t count);
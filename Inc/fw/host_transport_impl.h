@@ -16,3 +16,10 @@ enum HostTransport_Status HostTransportImpl_doTransmitImpl(uint8_t *buffer,
 volatile bool HostTransportImpl_isTransmitBusyImpl();
 
 int HostTransportImpl_onTakeReceivedImpl(const uint8_t *buffer);
+
+/**
+ * Context: OTG_FS_IRQHandler()
+ *
+ * @return 11-bit number of the current USB frame
+ */
+uint16_t HostTransportImpl_getFrameNumber();
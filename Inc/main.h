@@ -73,6 +73,14 @@ void Error_Handler(void);
 #define SPI1_SS_GPIO_Port GPIOA
 #define USER_DEBUG1_Pin GPIO_PIN_0
 #define USER_DEBUG1_GPIO_Port GPIOB
+#define SPI1_SS1_Pin GPIO_PIN_12
+#define SPI1_SS1_GPIO_Port GPIOB
+#define FIFO_WMARK1_Pin GPIO_PIN_13
+#define FIFO_WMARK1_GPIO_Port GPIOB
+#define FIFO_WMARK1_EXTI_IRQn EXTI15_10_IRQn
+#define FIFO_OVFL1_Pin GPIO_PIN_14
+#define FIFO_OVFL1_GPIO_Port GPIOB
+#define FIFO_OVFL1_EXTI_IRQn EXTI15_10_IRQn
 
 /* USER CODE BEGIN Private defines */
 
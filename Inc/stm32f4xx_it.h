@@ -58,6 +58,7 @@ void SysTick_Handler(void);
 void EXTI2_IRQHandler(void);
 void EXTI3_IRQHandler(void);
 void TIM3_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
 void OTG_FS_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
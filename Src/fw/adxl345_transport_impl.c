@@ -5,24 +5,41 @@
  */
 
 #include "fw/adxl345_transport_impl.h"
+#include "fw/clock_profile_impl.h"
 #include "gpio.h"
 #include "spi.h"
 #include <adxl345_spi_types.h>
 #include <adxl345_transport_types.h>
 #include <errno.h>
 
+/**
+ * Chip select (CS) line of one sensor on the shared SPI bus.
+ */
+struct ChipSelect {
+  GPIO_TypeDef *port;
+  uint16_t pin;
+};
+
+/**
+ * Chip select lines indexed by sensor: 0 is the primary sensor.
+ */
+static const struct ChipSelect chipSelects[ADXL345TRANSPORTIMPL_SENSORS] = {
+    {.port = SPI1_SS_GPIO_Port, .pin = SPI1_SS_Pin},
+    {.port = SPI1_SS1_GPIO_Port, .pin = SPI1_SS1_Pin},
+};
+
 /**
  * Sets the chip select (CS) line accordingly: nCS is active low.
  */
-static void ncsSet() {
-  HAL_GPIO_WritePin(SPI1_SS_GPIO_Port, SPI1_SS_Pin, GPIO_PIN_RESET);
+static void ncsSet(const struct ChipSelect *cs) {
+  HAL_GPIO_WritePin(cs->port, cs->pin, GPIO_PIN_RESET);
 }
 
 /**
  * Clears the chip select (CS) line accordingly: nCS is inactive high.
  */
-static void ncsClear() {
-  HAL_GPIO_WritePin(SPI1_SS_GPIO_Port, SPI1_SS_Pin, GPIO_PIN_SET);
+static void ncsClear(const struct ChipSelect *cs) {
+  HAL_GPIO_WritePin(cs->port, cs->pin, GPIO_PIN_SET);
 }
 
 /**
@@ -31,6 +48,7 @@ static void ncsClear() {
  * \see Adxl345TransportImpl_transmitReceiveFrame(union Adxl345TP_TxFrame *,
  * union Adxl345TP_RxFrame *, uint8_t)
  *
+ * @param cs chip select line of addressed sensor
  * @param frame receive buffer
  * @param numBytes expected size of received data
  * @param applyCs whether or not to set nCS before and clear nCS after
@@ -38,7 +56,8 @@ static void ncsClear() {
  *
  * @return -EINVAL if invalid args, -EIO on RX error, 0 otherwise
  */
-static int receiveFrame(union Adxl345Transport_RxFrame *frame,
+static int receiveFrame(const struct ChipSelect *cs,
+                        union Adxl345Transport_RxFrame *frame,
                         // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
                         uint8_t numBytes, enum Adxl345Spi_Cs applyCs) {
 
@@ -48,11 +67,11 @@ static int receiveFrame(union Adxl345Transport_RxFrame *frame,
   const uint32_t timeoutMs = 10;
 
   if (Adxl345Spi_Cs_modify == applyCs) {
-    ncsSet();
+    ncsSet(cs);
     if (0 != HAL_SPI_Receive(&hspi1, (uint8_t *)frame, numBytes, timeoutMs)) {
       return -EIO;
     }
-    ncsClear();
+    ncsClear(cs);
   } else {
     if (0 != HAL_SPI_Receive(&hspi1, (uint8_t *)frame, numBytes, timeoutMs)) {
       return -EIO;
@@ -62,7 +81,15 @@ static int receiveFrame(union Adxl345Transport_RxFrame *frame,
   return 0;
 }
 
-int Adxl345TransportImpl_doTransmitFrameImpl(
+/**
+ * Sends one single frame to the sensor selected by cs.
+ *
+ * \see Adxl345TransportImpl_doTransmitFrame0Impl(const union
+ * Adxl345Transport_TxFrame *, uint8_t, enum Adxl345Spi_Cs, enum
+ * Adxl345Spi_RwFlags)
+ */
+static int transmitFrame(
+    const struct ChipSelect *cs,
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     const union Adxl345Transport_TxFrame *frame, uint8_t numBytes,
     enum Adxl345Spi_Cs applyCs, enum Adxl345Spi_RwFlags rwFlag) {
@@ -77,12 +104,12 @@ int Adxl345TransportImpl_doTransmitFrameImpl(
   tx_frame.asAddress |= rwFlag;
 
   if (Adxl345Spi_Cs_modify == applyCs) {
-    ncsSet();
+    ncsSet(cs);
     if (0 !=
         HAL_SPI_Transmit(&hspi1, (uint8_t *)&tx_frame, numBytes, timeoutMs)) {
       return -EIO;
     }
-    ncsClear();
+    ncsClear(cs);
   } else {
     if (0 !=
         HAL_SPI_Transmit(&hspi1, (uint8_t *)&tx_frame, numBytes, timeoutMs)) {
@@ -92,9 +119,16 @@ int Adxl345TransportImpl_doTransmitFrameImpl(
   return 0;
 }
 
-int Adxl345TransportImpl_doTransmitReceiveFrameImpl(
-    const union Adxl345Transport_TxFrame *txFrame,
-    union Adxl345Transport_RxFrame *rxFrame, uint8_t numBytesReceive) {
+/**
+ * Transmits and receives frames of the sensor selected by cs.
+ *
+ * \see Adxl345TransportImpl_doTransmitReceiveFrame0Impl(const union
+ * Adxl345Transport_TxFrame *, union Adxl345Transport_RxFrame *, uint8_t)
+ */
+static int transmitReceiveFrame(const struct ChipSelect *cs,
+                                const union Adxl345Transport_TxFrame *txFrame,
+                                union Adxl345Transport_RxFrame *rxFrame,
+                                uint8_t numBytesReceive) {
 
   if (NULL == txFrame || NULL == rxFrame) {
     return -EINVAL;
@@ -103,12 +137,52 @@ int Adxl345TransportImpl_doTransmitReceiveFrameImpl(
   const uint8_t multiByte = (numBytesReceive > 1)
                                 ? Adxl345Spi_RwFlags_multiByte
                                 : Adxl345Spi_RwFlags_singleByte;
-  ncsSet();
-  Adxl345TransportImpl_doTransmitFrameImpl(txFrame, 1, Adxl345Spi_Cs_untouched,
-                                           (uint8_t)Adxl345Spi_RwFlags_read |
-                                               multiByte);
-  receiveFrame(rxFrame, numBytesReceive, Adxl345Spi_Cs_untouched);
-  ncsClear();
+  ncsSet(cs);
+  transmitFrame(cs, txFrame, 1, Adxl345Spi_Cs_untouched,
+                (uint8_t)Adxl345Spi_RwFlags_read | multiByte);
+  receiveFrame(cs, rxFrame, numBytesReceive, Adxl345Spi_Cs_untouched);
+  ncsClear(cs);
+
+  return 0;
+}
+
+int Adxl345TransportImpl_doTransmitFrame0Impl(
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    const union Adxl345Transport_TxFrame *frame, uint8_t numBytes,
+    enum Adxl345Spi_Cs applyCs, enum Adxl345Spi_RwFlags rwFlag) {
+  return transmitFrame(&chipSelects[0], frame, numBytes, applyCs, rwFlag);
+}
+
+int Adxl345TransportImpl_doTransmitReceiveFrame0Impl(
+    const union Adxl345Transport_TxFrame *txFrame,
+    union Adxl345Transport_RxFrame *rxFrame, uint8_t numBytesReceive) {
+  return transmitReceiveFrame(&chipSelects[0], txFrame, rxFrame,
+                              numBytesReceive);
+}
 
+int Adxl345TransportImpl_doTransmitFrame1Impl(
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    const union Adxl345Transport_TxFrame *frame, uint8_t numBytes,
+    enum Adxl345Spi_Cs applyCs, enum Adxl345Spi_RwFlags rwFlag) {
+  return transmitFrame(&chipSelects[1], frame, numBytes, applyCs, rwFlag);
+}
+
+int Adxl345TransportImpl_doTransmitReceiveFrame1Impl(
+    const union Adxl345Transport_TxFrame *txFrame,
+    union Adxl345Transport_RxFrame *rxFrame, uint8_t numBytesReceive) {
+  return transmitReceiveFrame(&chipSelects[1], txFrame, rxFrame,
+                              numBytesReceive);
+}
+
+int Adxl345TransportImpl_setSpiDivisor(uint16_t divisor) {
+  // power of two from 2 to 256
+  if (2U > divisor || 256U < divisor || 0 != (divisor & (divisor - 1U))) {
+    return -EINVAL;
+  }
+  hspi1.Init.BaudRatePrescaler =
+      ClockProfileImpl_spiBaudRatePrescaler(divisor);
+  if (HAL_OK != HAL_SPI_Init(&hspi1)) {
+    return -EIO;
+  }
   return 0;
 }
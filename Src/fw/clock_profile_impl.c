@@ -0,0 +1,147 @@
+/**
+ * \file clock_profile_impl.c
+ *
+ * Applies the selected clock profile by means of the HAL.
+ */
+
+#include "fw/clock_profile_impl.h"
+#include <clock_profile.h>
+#include <errno.h>
+#include <stm32f4xx_hal.h>
+
+/**
+ * UM ADXL345 Rev.G p8: SPI clock speed 5MHz at most.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILEIMPL_MAX_SPI_HZ 5000000U
+
+/**
+ * UM ADXL345 Rev.G p21: delay between FiFo reads.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILEIMPL_FIFO_DELAY_NS 5000U
+
+#if defined(CLOCK_PROFILE_MAX_PERFORMANCE)
+#define CLOCKPROFILEIMPL_SELECTED CLOCKPROFILE_MAX_PERFORMANCE_INITIALIZER
+#elif defined(CLOCK_PROFILE_LOW_POWER)
+#define CLOCKPROFILEIMPL_SELECTED CLOCKPROFILE_LOW_POWER_INITIALIZER
+#endif
+
+#ifdef CLOCKPROFILEIMPL_SELECTED
+static uint32_t busDivider(uint8_t divider) {
+  switch (divider) {
+  case 2:
+    return RCC_HCLK_DIV2;
+  case 4:
+    return RCC_HCLK_DIV4;
+  case 8:
+    return RCC_HCLK_DIV8;
+  case 16:
+    return RCC_HCLK_DIV16;
+  default:
+    return RCC_HCLK_DIV1;
+  }
+}
+
+static uint32_t voltageScale(uint8_t scale) {
+  switch (scale) {
+#ifdef PWR_REGULATOR_VOLTAGE_SCALE1
+  case 1:
+    return PWR_REGULATOR_VOLTAGE_SCALE1;
+#endif
+  case 3:
+    return PWR_REGULATOR_VOLTAGE_SCALE3;
+  default:
+    return PWR_REGULATOR_VOLTAGE_SCALE2;
+  }
+}
+#endif
+
+int ClockProfileImpl_apply() {
+#ifdef CLOCKPROFILEIMPL_SELECTED
+  const struct ClockProfile profile = CLOCKPROFILEIMPL_SELECTED;
+  if (0 != ClockProfile_validate(&profile)) {
+    return -EINVAL;
+  }
+  const uint32_t hclkHz = {ClockProfile_sysclkHz(&profile)};
+
+  // the PLL is reconfigured while the core runs from HSE
+  RCC_ClkInitTypeDef clkInit = {0};
+  clkInit.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK |
+                      RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  clkInit.SYSCLKSource = RCC_SYSCLKSOURCE_HSE;
+  clkInit.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  clkInit.APB1CLKDivider = RCC_HCLK_DIV1;
+  clkInit.APB2CLKDivider = RCC_HCLK_DIV1;
+  // FLASH_LATENCY_<n> equals n
+  if (HAL_OK !=
+      HAL_RCC_ClockConfig(&clkInit,
+                          ClockProfile_flashLatency(CLOCKPROFILE_HSE_HZ))) {
+    return -EIO;
+  }
+
+  // the voltage scale may only be changed while the PLL is off
+  RCC_OscInitTypeDef oscInit = {0};
+  oscInit.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+  oscInit.PLL.PLLState = RCC_PLL_OFF;
+  if (HAL_OK != HAL_RCC_OscConfig(&oscInit)) {
+    return -EIO;
+  }
+  __HAL_PWR_VOLTAGESCALING_CONFIG(
+      voltageScale(ClockProfile_voltageScale(hclkHz)));
+
+  // RCC_PLLP_DIV<n> equals n
+  oscInit.PLL.PLLState = RCC_PLL_ON;
+  oscInit.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+  oscInit.PLL.PLLM = profile.pllM;
+  oscInit.PLL.PLLN = profile.pllN;
+  oscInit.PLL.PLLP = profile.pllP;
+  oscInit.PLL.PLLQ = profile.pllQ;
+  if (HAL_OK != HAL_RCC_OscConfig(&oscInit)) {
+    return -EIO;
+  }
+
+  clkInit.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+  clkInit.APB1CLKDivider = busDivider(profile.apb1Divider);
+  clkInit.APB2CLKDivider = busDivider(profile.apb2Divider);
+  if (HAL_OK !=
+      HAL_RCC_ClockConfig(&clkInit, ClockProfile_flashLatency(hclkHz))) {
+    return -EIO;
+  }
+#endif
+  return 0;
+}
+
+uint16_t ClockProfileImpl_spiRatedDivisor() {
+  return ClockProfile_spiDivisor(HAL_RCC_GetPCLK2Freq(),
+                                 CLOCKPROFILEIMPL_MAX_SPI_HZ);
+}
+
+uint32_t ClockProfileImpl_spiBaudRatePrescaler(uint16_t divisor) {
+  switch (divisor) {
+  case 2:
+    return SPI_BAUDRATEPRESCALER_2;
+  case 4:
+    return SPI_BAUDRATEPRESCALER_4;
+  case 8:
+    return SPI_BAUDRATEPRESCALER_8;
+  case 16:
+    return SPI_BAUDRATEPRESCALER_16;
+  case 32:
+    return SPI_BAUDRATEPRESCALER_32;
+  case 64:
+    return SPI_BAUDRATEPRESCALER_64;
+  case 128:
+    return SPI_BAUDRATEPRESCALER_128;
+  default:
+    return SPI_BAUDRATEPRESCALER_256;
+  }
+}
+
+uint32_t ClockProfileImpl_tim3Period() {
+  const uint32_t hclkHz = {HAL_RCC_GetHCLKFreq()};
+  const uint32_t pclk1Hz = {HAL_RCC_GetPCLK1Freq()};
+  const uint32_t timerHz = {ClockProfile_timerClockHz(
+      hclkHz, 0 != pclk1Hz ? (uint8_t)(hclkHz / pclk1Hz) : 1U)};
+  return ClockProfile_timerPeriod(timerHz, CLOCKPROFILEIMPL_FIFO_DELAY_NS);
+}
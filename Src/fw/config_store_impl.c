@@ -0,0 +1,44 @@
+/**
+ * \file config_store_impl.c
+ *
+ * Erases and programs the configuration sector by means of the HAL.
+ */
+
+#include "fw/config_store_impl.h"
+#include <errno.h>
+#include <stm32f4xx_hal.h>
+
+#if defined(STM32F401xC)
+#define CONFIGSTOREIMPL_SECTOR FLASH_SECTOR_5
+#else
+#define CONFIGSTOREIMPL_SECTOR FLASH_SECTOR_7
+#endif
+
+int ConfigStoreImpl_doEraseImpl() {
+  FLASH_EraseInitTypeDef erase = {0};
+  erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+  erase.Sector = CONFIGSTOREIMPL_SECTOR;
+  erase.NbSectors = 1;
+  erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+  uint32_t failedSector = {0};
+
+  HAL_FLASH_Unlock();
+  const HAL_StatusTypeDef status = {HAL_FLASHEx_Erase(&erase, &failedSector)};
+  HAL_FLASH_Lock();
+  return HAL_OK == status ? 0 : -EIO;
+}
+
+int ConfigStoreImpl_doProgramWordImpl(uint32_t offset, uint32_t word) {
+  if (CONFIGSTOREIMPL_SECTOR_BYTES / sizeof(uint32_t) <= offset) {
+    return -EINVAL;
+  }
+
+  HAL_FLASH_Unlock();
+  const HAL_StatusTypeDef status = {
+      HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD,
+                        CONFIGSTOREIMPL_SECTOR_ADDRESS +
+                            offset * sizeof(uint32_t),
+                        word)};
+  HAL_FLASH_Lock();
+  return HAL_OK == status ? 0 : -EIO;
+}
@@ -5,6 +5,10 @@
  */
 
 #include "fw/adxl345_transport_impl.h"
+#include "fw/clock_profile_impl.h"
+#include "fw/config_store_impl.h"
+#include "fw/crc_impl.h"
+#include "fw/debug.h"
 #include "fw/host_transport_impl.h"
 #include "fw/led.h"
 #include "fw/ringbuffer_impl.h"
@@ -13,15 +17,22 @@
 #include "main.h"
 #include <adxl345.h>
 #include <adxl345_flags.h>
+#include <adxl345_register.h>
 #include <adxl345_transport_types.h>
+#include <calibration.h>
+#include <capture.h>
+#include <clock_profile.h>
+#include <config_store.h>
 #include <controller.h>
 #include <errno.h>
 #include <from_host_transport.h>
 #include <host_transport_types.h>
 #include <sampling.h>
 #include <sampling_types.h>
+#include <sequencer.h>
 #include <stm32f4xx_hal.h>
 #include <to_host_transport.h>
+#include <trigger.h>
 
 #define MYSTRINGIZE0(A) #A
 #define MYSTRINGIZE(A) MYSTRINGIZE0(A)
@@ -41,11 +52,28 @@ static_assert(
   MYSTRINGIZE(TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES) " vs. "
   MYSTRINGIZE(ADXL345_WATERMARK_LEVEL));
 
+// NOLINTNEXTLINE(readability-redundant-declaration)
+static_assert(
+  CONTROLLER_SENSORS == ADXL345TRANSPORTIMPL_SENSORS,
+  "ERROR: each sensor requires its chip select line: "
+  MYSTRINGIZE(ADXL345TRANSPORTIMPL_SENSORS));
+
 // clang-format on
 
 #undef MYSTRINGIZE
 #undef MYSTRINGIZE0
 
+/**
+ * Number of raw samples fitting into ringbufferStorage when used for capture.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONTROLLER_CAPTURE_ITEMS                                               \
+  (RINGBUFFER_STORAGE_SIZE_BYTES / sizeof(struct Sampling_Acceleration))
+
+// NOLINTNEXTLINE(readability-redundant-declaration)
+static_assert(CONTROLLER_CAPTURE_ITEMS <= UINT16_MAX,
+              "ERROR: capture index must fit into uint16_t");
+
 /**
  * Controller public API implementation.
  *
@@ -62,7 +90,18 @@ static void ControllerImpl_loop();
  */
 static void ControllerImpl_device_checkReboot();
 static void ControllerImpl_device_requestAsyncReboot();
+static void ControllerImpl_device_waitForEvent();
 static void ControllerImpl_transmitPendingResponses();
+static void ControllerImpl_checkInterruptSource();
+static void ControllerImpl_finishRecording();
+static void ControllerImpl_startSampling(uint16_t maxSamplesCount,
+                                         bool isInterleavable);
+static int
+ControllerImpl_forwardSequence(const struct Sampling_Acceleration *buffer,
+                               uint16_t bufferLen);
+static bool ControllerImpl_isCalibrated();
+static bool ControllerImpl_isCapturing();
+static void ControllerImpl_applyStoredConfiguration();
 /// @}
 
 /**
@@ -71,6 +110,10 @@ static void ControllerImpl_transmitPendingResponses();
  * @{
  */
 static void host_doTakeBytes(const uint8_t *buffer, uint16_t len);
+static void host_doNotifyTransmitComplete();
+static void host_doResetReception();
+static void host_doNotifyStartOfFrame();
+static void host_responseClockCorrelation();
 static void host_onRequestGetFirmwareVersion();
 static void host_responseGetFirmwareVersion();
 static void host_onRequestGetOutputDataRate();
@@ -87,6 +130,29 @@ static void host_onRequestGetDeviceSetup();
 static void host_responseGetDeviceSetup();
 static void host_onRequestSamplingStart(uint16_t maxSamplesCount);
 static void host_onRequestSamplingStop();
+static int host_onRequestConfigureAndStart(
+    const struct TransportRx_ConfigureAndStart *setup);
+static int host_onRequestCaptureStart(uint16_t maxSamplesCount);
+static int host_onRequestCaptureRead(uint16_t offset);
+static int host_onRequestSetAxes(uint8_t axes);
+static int host_onRequestSetFraming(bool isFramed);
+static void host_responseStreamSetup();
+static int host_onRequestSetMaxLatency(uint16_t maxLatencyMs);
+static int
+host_onRequestSetCalibration(const struct Transport_Calibration *setup);
+static int host_onRequestGetCalibration(uint8_t sensor);
+static void host_responseCalibration();
+static void host_onRequestGetSpiClock();
+static void host_responseSpiClock();
+static int host_onRequestSaveConfiguration();
+static void host_responseConfigurationSaved();
+static void host_responseCaptureChunk();
+static int
+host_onRequestRecorderStart(const struct TransportRx_RecorderStart *setup);
+static void host_responseRecorderFinished();
+static int
+host_onRequestSequenceAppend(const struct TransportRx_SequenceAppend *entry);
+static void host_onRequestSequenceMarker();
 static void host_onRequestGetUptime();
 static void host_responseGetUptime();
 static void host_onRequestGetBufferStatus();
@@ -112,28 +178,36 @@ static int sensor_doGetRangeImpl(uint8_t *range);
  *
  * @{
  */
-static void sampling_setFifoWatermark();
-static void sampling_clearFifoWatermark();
-static void sampling_setFifoOverflow();
+static void sampling_setFifoWatermark(uint8_t sensor);
+static void sampling_clearFifoWatermark(uint8_t sensor);
+static void sampling_setFifoOverflow(uint8_t sensor);
 static void sampling_on5usTimerExpired();
+static void sampling_onMillisecondTick();
 static void sampling_onSamplingStartedCb();
 static void sampling_onSamplingStoppedCb();
+static void sampling_onFollowerStartedCb();
+static void sampling_onFollowerStoppedCb();
 static void sampling_responseSamplingStopped();
 static void sampling_onSamplingAbortedCb();
 static void sampling_responseSamplingAborted();
 static void sampling_onSamplingFinishedCb();
 static void sampling_responseSamplingFinished();
 static int sampling_doForwardAccelerationBufferImpl(
+    const struct Sampling_Handle *handle,
     const struct Sampling_Acceleration *buffer, uint16_t bufferLen,
     uint16_t firstIndex);
 static void sampling_onFifoOverflowCb();
 static void sampling_responseFifoOverflow();
 static void sampling_onBufferOverflowCb();
 static void sampling_responseBufferOverflow();
-static void sampling_doEnableSensorImpl();
-static void sampling_doDisableSensorImpl();
+static void sampling_doEnableSensorImpl(const struct Sampling_Handle *handle);
+static void sampling_doDisableSensorImpl(const struct Sampling_Handle *handle);
 static void
-sampling_doFetchSensorAccelerationImpl(struct Sampling_Acceleration *sample);
+sampling_doFetchSensorAccelerationImpl(const struct Sampling_Handle *handle,
+                                       struct Sampling_Acceleration *sample);
+static int sampling_doFlushAccelerationBufferImpl();
+static uint8_t
+sampling_doGetFifoEntriesImpl(const struct Sampling_Handle *handle);
 /// @}
 
 /**
@@ -147,38 +221,47 @@ static void fault_onHardFaultHandler();
 static void fault_onErrorHandler();
 /// @}
 
-struct Transport_ResponseFlags {
-  uint8_t host_responseGetFirmwareVersion : 1;
-  uint8_t host_responseGetOutputDataRate : 1;
-  uint8_t host_responseGetRange : 1;
-  uint8_t host_responseGetScale : 1;
-  uint8_t host_responseGetDeviceSetup : 1;
-  uint8_t host_responseGetUptime : 1;
-  uint8_t host_responseGetBufferStatus : 1;
-  uint8_t sampling_responseSamplingStopped : 1;
-  uint8_t sampling_responseSamplingAborted : 1;
-  uint8_t sampling_responseSamplingFinished : 1;
-  uint8_t sampling_responseFifoOverflow : 1;
-  uint8_t sampling_responseBufferOverflow : 1;
-  uint8_t sampling_responseTransmissionError : 1;
-  uint8_t _reserved_0 : 1;
-  uint8_t _reserved_1 : 1;
-} __attribute__((packed));
+/**
+ * Maximum number of responses transmitted per loop iteration while sampling.
+ *
+ * Each response is a blocking transmission. Keeping the slice small hands the
+ * USB back to the acceleration stream early.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONTROLLER_RESPONSES_PER_LOOP_WHILE_SAMPLING 1U
 
-// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-volatile struct Transport_ResponseFlags pendingResponses = {0};
+/**
+ * Number of USB start-of-frames (1ms each) in between two clock
+ * correlations sent while streaming.
+ *
+ * Each correlation flushes the stream bytes held back for the next USB
+ * packet in a short packet, hence the period bounds that overhead.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONTROLLER_CLOCK_CORRELATION_PERIOD_SOFS 100U
 
-#define SAMPLING_DECLARE_INITIALIZER                                           \
+/**
+ * Initializes the sampling handle of sensor SENSOR.
+ *
+ * Only the primary sensor 0 reports the start and the end of sampling, the
+ * other sensors follow it \see sampling_onFollowerStoppedCb().
+ */
+#define SAMPLING_DECLARE_INITIALIZER(SENSOR, STARTED_CB, STOPPED_CB)           \
   {                                                                            \
     .state = {.maxSamples = 0,                                                 \
               .doStart = false,                                                \
               .doStop = false,                                                 \
               .isStarted = false,                                              \
               .waitFor5usTimer = false,                                        \
+              .samplesPerFetch = SAMPLING_NUM_SAMPLES_READ_AT_ONCE,            \
               .rxBuffer = {{.x = 0, .y = 0, .z = 0}},                          \
               .isFifoOverflowSet = false,                                      \
               .isFifoWatermarkSet = false,                                     \
-              .transactionsCount = 0},                                         \
+              .transactionsCount = 0,                                          \
+              .maxLatencyMs = 0,                                               \
+              .latencyCountdownMs = 0,                                         \
+              .isLatencyDeadlineSet = false},                                  \
+    .sensor = (SENSOR),                                                        \
                                                                                \
     .doEnableSensorImpl = sampling_doEnableSensorImpl,                         \
     .doDisableSensorImpl = sampling_doDisableSensorImpl,                       \
@@ -186,9 +269,11 @@ volatile struct Transport_ResponseFlags pendingResponses = {0};
     .doWaitDelay5usImpl = SamplingImpl_doWaitDelay5usImpl,                     \
     .doForwardAccelerationBufferImpl =                                         \
         sampling_doForwardAccelerationBufferImpl,                              \
+    .doFlushAccelerationBufferImpl = sampling_doFlushAccelerationBufferImpl,   \
+    .doGetFifoEntriesImpl = sampling_doGetFifoEntriesImpl,                     \
                                                                                \
-    .onSamplingStartedCb = sampling_onSamplingStartedCb,                       \
-    .onSamplingStoppedCb = sampling_onSamplingStoppedCb,                       \
+    .onSamplingStartedCb = (STARTED_CB),                                       \
+    .onSamplingStoppedCb = (STOPPED_CB),                                       \
     .onSamplingAbortedCb = sampling_onSamplingAbortedCb,                       \
     .onSamplingFinishedCb = sampling_onSamplingFinishedCb,                     \
     .onFifoOverflowCb = sampling_onFifoOverflowCb,                             \
@@ -198,27 +283,51 @@ volatile struct Transport_ResponseFlags pendingResponses = {0};
 
 #define HOSTTRANSPORT_DECLARE_INITIALIZER                                      \
   {                                                                            \
-    .fromHost = {.doTakeReceivedPacketImpl =                                   \
+    .fromHost = {.parser = {.length = 0,                                       \
+                            .expectedLength = 0,                               \
+                            .discardedBytes = 0},                              \
+                 .queue = {.head = 0, .tail = 0, .droppedCount = 0},           \
+                 .doTakeReceivedPacketImpl =                                   \
                      HostTransportImpl_onTakeReceivedImpl},                    \
     .toHost = {                                                                \
       .ringbuffer = RINGBUFFER_DECLARE_INITIALIZER,                            \
       .largestTxChunkBytes = 0,                                                \
+      .txBytesCount = 0,                                                       \
+      .txTransfersCount = 0,                                                   \
+      .txCarryBytes = 0,                                                       \
+      .txCarryOffset = 0,                                                      \
+      .txCarrySinceMs = 0,                                                     \
+      .axes = Transport_Axis_All,                                              \
+      .format = Transport_SampleFormat_Acceleration,                           \
+      .isFramed = false,                                                       \
+      .frameSequence = 0,                                                      \
       .doTransmitImpl = HostTransportImpl_doTransmitImpl,                      \
       .isTransmitBusyImpl = HostTransportImpl_isTransmitBusyImpl,              \
+      .doCrc32WordsImpl = CrcImpl_doCrc32WordsImpl,                            \
+      .getTickMsImpl = HAL_GetTick,                                            \
     }                                                                          \
   }
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 struct Controller_Handle controllerHandle = {
-    .sensor = {.handle = ADXL345_HANDLE_INITIALIZER, .init = sensor_doInitImpl},
+    .sensor = {.handles = {ADXL345_HANDLE_INITIALIZER(0),
+                           ADXL345_HANDLE_INITIALIZER(1)},
+               .count = 1,
+               .init = sensor_doInitImpl},
 
     .sampling =
         {
-            .handle = SAMPLING_DECLARE_INITIALIZER,
+            .handles = {SAMPLING_DECLARE_INITIALIZER(
+                            0, sampling_onSamplingStartedCb,
+                            sampling_onSamplingStoppedCb),
+                        SAMPLING_DECLARE_INITIALIZER(
+                            1, sampling_onFollowerStartedCb,
+                            sampling_onFollowerStoppedCb)},
             .doSetFifoWatermark = sampling_setFifoWatermark,
             .doClearFifoWatermark = sampling_clearFifoWatermark,
             .doSetFifoOverflow = sampling_setFifoOverflow,
             .doSet5usTimerExpired = sampling_on5usTimerExpired,
+            .doTickMillisecond = sampling_onMillisecondTick,
 
         },
 
@@ -226,6 +335,9 @@ struct Controller_Handle controllerHandle = {
         {
             .handle = HOSTTRANSPORT_DECLARE_INITIALIZER,
             .doTakeBytes = host_doTakeBytes,
+            .doNotifyTransmitComplete = host_doNotifyTransmitComplete,
+            .doResetReception = host_doResetReception,
+            .doNotifyStartOfFrame = host_doNotifyStartOfFrame,
             .onRequestGetFirmwareVersion = host_onRequestGetFirmwareVersion,
             .onRequestGetOutputDataRate = host_onRequestGetOutputDataRate,
             .onRequestSetOutputDatatRate = host_onRequestSetOutputDatatRate,
@@ -236,10 +348,26 @@ struct Controller_Handle controllerHandle = {
             .onRequestGetDeviceSetup = host_onRequestGetDeviceSetup,
             .onRequestSamplingStart = host_onRequestSamplingStart,
             .onRequestSamplingStop = host_onRequestSamplingStop,
+            .onRequestConfigureAndStart = host_onRequestConfigureAndStart,
+            .onRequestCaptureStart = host_onRequestCaptureStart,
+            .onRequestCaptureRead = host_onRequestCaptureRead,
+            .onRequestSetAxes = host_onRequestSetAxes,
+            .onRequestSetFraming = host_onRequestSetFraming,
+            .onRequestSetMaxLatency = host_onRequestSetMaxLatency,
+            .onRequestSetCalibration = host_onRequestSetCalibration,
+            .onRequestGetCalibration = host_onRequestGetCalibration,
+            .onRequestGetSpiClock = host_onRequestGetSpiClock,
+            .onRequestSaveConfiguration = host_onRequestSaveConfiguration,
+            .onRequestRecorderStart = host_onRequestRecorderStart,
+            .onRequestSequenceAppend = host_onRequestSequenceAppend,
+            .onRequestSequenceMarker = host_onRequestSequenceMarker,
             .onRequestUptime = host_onRequestGetUptime,
             .onRequestBufferStatus = host_onRequestGetBufferStatus,
         },
 
+    .events = {.pending = 0},
+    .responses = {.pending = 0},
+
     .init = ControllerImpl_init,
     .loop = ControllerImpl_loop,
 
@@ -264,10 +392,299 @@ struct Controller_Handle controllerHandle = {
 static bool rebootRequested = false;
 /// @}
 
-void ControllerImpl_init() { controllerHandle.sensor.init(); }
+/**
+ * Effective setup of a pending configure-and-start request.
+ *
+ * Read back once when the request is applied so that the started response
+ * does not need to access the sensor.
+ *
+ * \see host_onRequestConfigureAndStart(const struct
+ * TransportRx_ConfigureAndStart *)
+ */
+struct ControllerImpl_ConfiguredStart {
+  bool isPending; ///< echo setup with next started response
+  uint8_t odr;
+  uint8_t scale;
+  uint8_t range;
+  uint8_t watermark;
+  enum Transport_SampleFormat format;
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_ConfiguredStart configuredStart = {
+    .isPending = false};
+
+/**
+ * Capture-to-RAM state.
+ *
+ * The capture shares ringbufferStorage with the streaming ringbuffer. It is
+ * not used while capturing and captured samples are discarded by the next
+ * sampling start.
+ */
+struct ControllerImpl_Capture {
+  struct Capture buffer;
+  bool isEnabled;      ///< forward samples to buffer instead of host
+  uint16_t readOffset; ///< offset of pending capture chunk response
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_Capture capture = {
+    .buffer = CAPTURE_INITIALIZER(ringbufferStorage, CONTROLLER_CAPTURE_ITEMS,
+                                  sizeof(struct Sampling_Acceleration)),
+    .isEnabled = false,
+    .readOffset = 0};
+
+/**
+ * Pre-trigger (flight recorder) state.
+ *
+ * Samples are kept in an overwriting ringbuffer on ringbufferStorage until
+ * the trigger fires and the post-trigger samples are recorded. Afterwards the
+ * ringbuffer is linearized in place and handed over to the capture read out.
+ */
+struct ControllerImpl_Recorder {
+  struct Ringbuffer buffer;
+  struct Trigger trigger;
+  volatile bool isEnabled; ///< Context: main() and interrupts
+  bool isTriggered;        ///< result of last recording
+  uint16_t triggerIndex;   ///< result of last recording
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_Recorder recorder = {
+    .buffer = RINGBUFFER_INITIALIZER(ringbufferStorage,
+                                     CONTROLLER_CAPTURE_ITEMS,
+                                     sizeof(struct Sampling_Acceleration)),
+    .trigger = TRIGGER_INITIALIZER,
+    .isEnabled = false,
+    .isTriggered = false,
+    .triggerIndex = 0};
+
+/**
+ * Multi-segment capture sequence state.
+ *
+ * The sensor keeps sampling for the whole sequence; samples in between
+ * segments are discarded so that segments follow each other without host
+ * interaction.
+ */
+struct ControllerImpl_Sequence {
+  struct Sequencer sequencer;
+  bool isEnabled; ///< forward samples through the sequencer
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_Sequence sequence = {
+    .sequencer = SEQUENCER_INITIALIZER, .isEnabled = false};
+
+/**
+ * USB start-of-frame clock correlation state.
+ *
+ * The frame number, sample index and cycle counter are latched together in
+ * interrupt context and transmitted later on in main().
+ */
+struct ControllerImpl_ClockCorrelation {
+  uint16_t sofCount;              ///< Context: OTG_FS_IRQHandler()
+  volatile uint16_t frameNumber;  ///< Context: main() and interrupts
+  volatile uint16_t sampleIndex;  ///< Context: main() and interrupts
+  volatile uint32_t cycleCounter; ///< Context: main() and interrupts
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_ClockCorrelation clockCorrelation = {
+    .sofCount = 0, .frameNumber = 0, .sampleIndex = 0, .cycleCounter = 0};
+
+/**
+ * Per sensor calibration state.
+ *
+ * Samples are calibrated as fetched from the sensor, hence stream, capture,
+ * recorder and sequence all carry calibrated samples.
+ */
+struct ControllerImpl_Calibration {
+  struct Calibration stages[CONTROLLER_SENSORS]; ///< indexed by sensor ID
+  /// as uploaded, echoed to the host
+  struct Transport_Calibration setups[CONTROLLER_SENSORS];
+  uint8_t responseSensor; ///< sensor of pending calibration response
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_Calibration calibration = {
+    .stages = {CALIBRATION_INITIALIZER, CALIBRATION_INITIALIZER},
+    .setups = {{.sensor = 0, .enable = 0}, {.sensor = 1, .enable = 0}},
+    .responseSensor = 0};
+
+/**
+ * Verified transfers per SPI prescaler at startup.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONTROLLER_SPI_VERIFY_ROUNDS 8U
+
+/**
+ * SPI clock of the sensor bus as calibrated at startup.
+ */
+struct ControllerImpl_SpiClock {
+  uint16_t divisor;        ///< SPI prescaler in use, 0 if not calibrated
+  uint16_t fastestDivisor; ///< fastest prescaler verified, 0 if none passed
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_SpiClock spiClock = {.divisor = 0,
+                                                  .fastestDivisor = 0};
+
+/**
+ * Sensor setup persisted to flash, applied at boot.
+ */
+struct ControllerImpl_ConfigStore {
+  const struct ConfigStore_Handle handle;
+  struct ConfigStore_Config saved; ///< as stored, echoed to the host
+  int8_t result;                   ///< of last save
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ControllerImpl_ConfigStore configStore = {
+    .handle = CONFIGSTORE_INITIALIZER(
+        CONFIGSTOREIMPL_SECTOR_ADDRESS, CONFIGSTOREIMPL_SECTOR_BYTES,
+        ConfigStoreImpl_doEraseImpl, ConfigStoreImpl_doProgramWordImpl,
+        CrcImpl_doCrc32WordsImpl),
+    .saved = {0},
+    .result = 0};
+
+/**
+ * Result of the last axes or framing request, echoed to the host.
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static int8_t streamSetupResult = 0;
+
+/**
+ * @return true if any sensor's samples are calibrated
+ */
+static bool ControllerImpl_isCalibrated() {
+  for (uint8_t sensor = 0; sensor < CONTROLLER_SENSORS; sensor++) {
+    if (Calibration_isEnabled(&calibration.stages[sensor])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Whether all sensors found sample and stream their batches interleaved.
+ *
+ * Each batch is preceded by its sensor's tag TransportTx_AccelerationSensor.
+ * Applies to plain streaming of all axes in uncompressed format only; capture,
+ * recorder and sequence as well as compressed streams use the primary sensor.
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static bool isInterleaved = false;
+
+/**
+ * Upper bound of attempts to transmit buffered samples once the stream ends.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONTROLLER_STREAM_FLUSH_RETRIES 10000U
+
+void ControllerImpl_init() {
+  // keep the debugger attached while the core sleeps in WFI
+  HAL_DBGMCU_EnableDBGSleepMode();
+  // free running cycle counter for the clock correlation
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  CrcImpl_init();
+  controllerHandle.sensor.init();
+  ControllerImpl_applyStoredConfiguration();
+}
+
+/**
+ * Applies the sensor setup persisted by host_onRequestSaveConfiguration(), the
+ * sensors keep the defaults of Adxl345_init() if none is stored.
+ */
+static void ControllerImpl_applyStoredConfiguration() {
+  // echoed by a rejected save
+  struct ConfigStore_Config *config = {&configStore.saved};
+  if (0 != ConfigStore_load(&configStore.handle, config)) {
+    return;
+  }
+  host_onRequestSetOutputDatatRate(config->outputDataRate);
+  host_onRequestSetRange(config->range);
+  host_onRequestSetScale(config->scale);
+}
 
+/**
+ * Starts sampling of the primary sensor and, if applicable, of all other
+ * sensors found \see isInterleaved.
+ *
+ * The other sensors sample until the primary sensor stops.
+ *
+ * @param maxSamplesCount number of samples of primary sensor, 0 if unlimited
+ * @param isInterleavable whether the requested stream may be interleaved
+ */
+static void ControllerImpl_startSampling(uint16_t maxSamplesCount,
+                                         bool isInterleavable) {
+  struct Sampling_Handle *primary = {&controllerHandle.sampling.handles[0]};
+  if (primary->state.isStarted) {
+    // toggles: the followers stop along with the primary sensor
+    Sampling_start(primary, maxSamplesCount);
+    return;
+  }
+
+  isInterleaved =
+      isInterleavable && 1 < controllerHandle.sensor.count &&
+      Transport_Axis_All == controllerHandle.host.handle.toHost.axes;
+
+  // calibrate in full resolution LSB: 10 bit LSB doubles with each range step
+  uint8_t scale = {0};
+  uint8_t range = {0};
+  sensor_doGetScaleImpl(&scale);
+  sensor_doGetRangeImpl(&range);
+  const uint8_t inputShift = {
+      Adxl345Flags_DataFormat_FullResBit_10bit == scale ? range : 0};
+  for (uint8_t sensor = 0; sensor < CONTROLLER_SENSORS; sensor++) {
+    Calibration_setInputShift(&calibration.stages[sensor], inputShift);
+  }
+
+  Sampling_start(primary, maxSamplesCount);
+
+  for (uint8_t sensor = 1;
+       isInterleaved && sensor < controllerHandle.sensor.count; sensor++) {
+    Sampling_start(&controllerHandle.sampling.handles[sensor], 0);
+  }
+}
+
+/**
+ * Serves pending work in priority order and sleeps if idle.
+ *
+ * Priority: sensor FiFo drain and sample forwarding first (the sensor FiFo
+ * must never overrun), then host requests and responses, then reboot.
+ *
+ * The event bits wake the core and keep it out of WFI while the work itself
+ * is polled: each step returns at once if it has nothing to do, so no work is
+ * missed by coalesced event bits. Only Controller_Event_InterruptSource is
+ * dispatched on its bit as reading the source costs an SPI transfer.
+ *
+ * USER_DEBUG0 spans the wake-up latency of the watermark interrupt: high in
+ * sampling_setFifoWatermark(), low once the event is taken here.
+ *
+ * Each sensor is drained once per iteration, one batch of at most
+ * SAMPLING_NUM_SAMPLES_READ_AT_ONCE samples each. A sample takes 56 SPI clocks
+ * (address and six data bytes) plus the 5us FiFo pop delay, hence a batch of
+ * 24 samples takes 24 * (56 / f_SPI + 5us). The rated divisor of every clock
+ * profile yields more than half of the sensor's 5MHz rating, hence a batch
+ * takes below 0.7ms. A slower clock picked by the calibration at startup, see
+ * host_responseSpiClock(), keeps a batch below 1ms down to 1.6MHz. At 3200Hz
+ * the FiFo entries above the watermark last 2.5ms: a sensor waits for at most
+ * one batch of the other sensor plus one response.
+ */
 void ControllerImpl_loop() {
-  switch (Sampling_fetchForward(&controllerHandle.sampling.handle)) {
+  const uint32_t events = {Controller_takeEvents(&controllerHandle.events)};
+
+  if (events & Controller_Event_FifoWatermark) {
+    USER_DEBUG0_LOW; // mark end of watermark wake-up latency
+  }
+
+  if (events & Controller_Event_InterruptSource) {
+    ControllerImpl_checkInterruptSource();
+  }
+
+  switch (Sampling_fetchForward(&controllerHandle.sampling.handles[0])) {
   case -ECANCELED: // NOLINT(bugprone-branch-clone)
   case -EOVERFLOW: // NOLINT(bugprone-branch-clone)
     USER_LED0_ON;
@@ -278,8 +695,38 @@ void ControllerImpl_loop() {
   default:
     break;
   }
-  ControllerImpl_device_checkReboot();
+
+  // the LED reflects the primary sensor, the others report by callbacks
+  for (uint8_t sensor = 1; sensor < controllerHandle.sensor.count; sensor++) {
+    Sampling_fetchForward(&controllerHandle.sampling.handles[sensor]);
+  }
+
+  // safe point: in between two sampling batches
+  TransportRx_DispatchPending(&controllerHandle.host.handle);
   ControllerImpl_transmitPendingResponses();
+  ControllerImpl_device_checkReboot();
+  ControllerImpl_device_waitForEvent();
+}
+
+/**
+ * Tells the activity and the FiFo overrun interrupt apart while both share
+ * INT2.
+ *
+ * \see sampling_setFifoOverflow()
+ */
+static void ControllerImpl_checkInterruptSource() {
+  struct Adxl345Register_IntSource source = {0};
+  Adxl345_getInterruptSource(&controllerHandle.sensor.handles[0], &source);
+
+  if (source.activity) {
+    Trigger_fire(&recorder.trigger);
+  }
+
+  if (source.overrun) {
+    Sampling_setFifoOverflow(&controllerHandle.sampling.handles[0]);
+    Controller_postEvents(&controllerHandle.events,
+                          Controller_Event_FifoOverflow);
+  }
 }
 
 void ControllerImpl_device_checkReboot() {
@@ -290,91 +737,144 @@ void ControllerImpl_device_checkReboot() {
 
 void ControllerImpl_device_requestAsyncReboot() { rebootRequested = true; }
 
+/**
+ * Puts the core to sleep until the next interrupt unless work is pending.
+ *
+ * Interrupts are masked while checking for pending work so that an event
+ * posted in between the check and WFI is not lost: a pending interrupt wakes
+ * the core even if masked by PRIMASK. It is served right after unmasking.
+ *
+ * Besides the event sources (EXTI2/3/15_10, OTG_FS) the SysTick interrupt
+ * wakes the core at least every 1ms.
+ */
+static void ControllerImpl_device_waitForEvent() {
+  __disable_irq();
+  bool isPending = {Controller_hasEvents(&controllerHandle.events) ||
+                    Controller_hasResponses(&controllerHandle.responses) ||
+                    TransportRx_hasPending(&controllerHandle.host.handle)};
+  for (uint8_t sensor = 0; sensor < controllerHandle.sensor.count; sensor++) {
+    isPending = isPending || Sampling_hasPendingWork(
+                                 &controllerHandle.sampling.handles[sensor]);
+  }
+  if (!isPending) {
+    __WFI();
+  }
+  __enable_irq();
+}
+
 /**
  * Decouples possible interrupt context from execution which is performed in
  * in main() context.
  *
- * Example: each user request, handled in ISR, sets a flag so that the
+ * Example: each user request, handled in ISR, requests a response so that
  * it can be handled later in context of main().
+ *
+ * Responses are transmitted in priority order \see Controller_Response.
+ * While sampling only a bounded slice is transmitted per call.
  */
 static void ControllerImpl_transmitPendingResponses() {
-
-  if (pendingResponses.host_responseGetFirmwareVersion) {
-    pendingResponses.host_responseGetFirmwareVersion = false;
-    host_responseGetFirmwareVersion();
-  }
-  if (pendingResponses.host_responseGetOutputDataRate) {
-    pendingResponses.host_responseGetOutputDataRate = false;
-    host_responseGetOutputDataRate();
-  }
-  if (pendingResponses.host_responseGetRange) {
-    pendingResponses.host_responseGetRange = false;
-    host_responseGetRange();
-  }
-  if (pendingResponses.host_responseGetScale) {
-    pendingResponses.host_responseGetScale = false;
-    host_responseGetScale();
-  }
-  if (pendingResponses.host_responseGetDeviceSetup) {
-    pendingResponses.host_responseGetDeviceSetup = false;
-    host_responseGetDeviceSetup();
-  }
-  if (pendingResponses.host_responseGetUptime) {
-    pendingResponses.host_responseGetUptime = false;
-    host_responseGetUptime();
-  }
-  if (pendingResponses.host_responseGetBufferStatus) {
-    pendingResponses.host_responseGetBufferStatus = false;
-    host_responseGetBufferStatus();
-  }
-
-  if (pendingResponses.sampling_responseSamplingStopped) {
-    pendingResponses.sampling_responseSamplingStopped = false;
-    sampling_responseSamplingStopped();
-  }
-  if (pendingResponses.sampling_responseSamplingAborted) {
-    pendingResponses.sampling_responseSamplingAborted = false;
-    sampling_responseSamplingAborted();
-  }
-  if (pendingResponses.sampling_responseSamplingFinished) {
-    pendingResponses.sampling_responseSamplingFinished = false;
-    sampling_responseSamplingFinished();
-  }
-  if (pendingResponses.sampling_responseFifoOverflow) {
-    pendingResponses.sampling_responseFifoOverflow = false;
-    sampling_responseFifoOverflow();
-  }
-  if (pendingResponses.sampling_responseBufferOverflow) {
-    pendingResponses.sampling_responseBufferOverflow = false;
-    sampling_responseBufferOverflow();
+  static void (*const transmitResponse[Controller_Response_Count])() = {
+      [Controller_Response_FirmwareVersion] = host_responseGetFirmwareVersion,
+      [Controller_Response_OutputDataRate] = host_responseGetOutputDataRate,
+      [Controller_Response_Range] = host_responseGetRange,
+      [Controller_Response_Scale] = host_responseGetScale,
+      [Controller_Response_Uptime] = host_responseGetUptime,
+      [Controller_Response_BufferStatus] = host_responseGetBufferStatus,
+      [Controller_Response_DeviceSetup] = host_responseGetDeviceSetup,
+      [Controller_Response_SamplingStopped] = sampling_responseSamplingStopped,
+      [Controller_Response_SamplingAborted] = sampling_responseSamplingAborted,
+      [Controller_Response_SamplingFinished] =
+          sampling_responseSamplingFinished,
+      [Controller_Response_FifoOverflow] = sampling_responseFifoOverflow,
+      [Controller_Response_BufferOverflow] = sampling_responseBufferOverflow,
+      [Controller_Response_TransmissionError] =
+          sampling_responseTransmissionError,
+      [Controller_Response_RecorderFinished] = host_responseRecorderFinished,
+      [Controller_Response_ClockCorrelation] = host_responseClockCorrelation,
+      [Controller_Response_Calibration] = host_responseCalibration,
+      [Controller_Response_SpiClock] = host_responseSpiClock,
+      [Controller_Response_ConfigurationSaved] =
+          host_responseConfigurationSaved,
+      [Controller_Response_StreamSetup] = host_responseStreamSetup,
+      [Controller_Response_CaptureChunk] = host_responseCaptureChunk,
+  };
+
+  uint8_t slice = {controllerHandle.sampling.handles[0].state.isStarted
+                       ? CONTROLLER_RESPONSES_PER_LOOP_WHILE_SAMPLING
+                       : Controller_Response_Count};
+
+  for (; slice > 0; slice--) {
+    const int response = {Controller_takeResponse(&controllerHandle.responses)};
+    if (response < 0) {
+      break;
+    }
+    transmitResponse[response]();
   }
-  if (pendingResponses.sampling_responseTransmissionError) {
-    pendingResponses.sampling_responseTransmissionError = false;
-    sampling_responseTransmissionError();
-  }
-
-  // note: avoid memset to clear flags of this struct due un-alignment issue
 }
 
 /* Host RX data ------------------------------------------------------------- */
 
 /**
- * Handles incoming bytes (unfragmented data packet).
+ * Handles incoming bytes (possibly fragmented or concatenated requests).
  *
  * Calls generic TransportRx_Process(uint8_t *buffer, uint16_t length)
- * implementation which performs basic checks only. Further
- * processing/dispatching is delegated to the respective pimpl. \see
- * host_transport_impl.h
+ * implementation which performs basic checks and queues the request. Further
+ * processing/dispatching is delegated to the respective pimpl in main()
+ * context. \see host_transport_impl.h
  *
- * @param buffer received byte buffer (must not be fragmented)
+ * @param buffer received byte buffer
  * @param len received data length
  */
 static void host_doTakeBytes(const uint8_t *buffer, uint16_t len) {
   TransportRx_Process(&controllerHandle.host.handle, buffer, len);
+  Controller_postEvents(&controllerHandle.events,
+                        Controller_Event_HostRequest);
+}
+
+static void host_doNotifyTransmitComplete() {
+  Controller_postEvents(&controllerHandle.events,
+                        Controller_Event_TransmitComplete);
+}
+
+static void host_doResetReception() {
+  TransportRx_ResetParser(&controllerHandle.host.handle);
+}
+
+static void host_doNotifyStartOfFrame() {
+  // latch as close to the start-of-frame as possible
+  const uint32_t cycleCounter = {DWT->CYCCNT};
+
+  // capture and recorder keep the host link silent
+  if (!controllerHandle.sampling.handles[0].state.isStarted ||
+      ControllerImpl_isCapturing()) {
+    clockCorrelation.sofCount = 0;
+    return;
+  }
+
+  // the period leaves main() plenty of time to send the previous latch
+  clockCorrelation.sofCount++;
+  if (CONTROLLER_CLOCK_CORRELATION_PERIOD_SOFS > clockCorrelation.sofCount) {
+    return;
+  }
+  clockCorrelation.sofCount = 0;
+
+  clockCorrelation.cycleCounter = cycleCounter;
+  clockCorrelation.frameNumber = HostTransportImpl_getFrameNumber();
+  clockCorrelation.sampleIndex =
+      controllerHandle.sampling.handles[0].state.transactionsCount;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_ClockCorrelation);
+}
+
+static void host_responseClockCorrelation() {
+  TransportTx_TxClockCorrelation(
+      &controllerHandle.host.handle, clockCorrelation.frameNumber,
+      clockCorrelation.sampleIndex, clockCorrelation.cycleCounter);
 }
 
 static void host_onRequestGetFirmwareVersion() {
-  pendingResponses.host_responseGetFirmwareVersion = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_FirmwareVersion);
 }
 
 static void host_responseGetFirmwareVersion() {
@@ -383,7 +883,8 @@ static void host_responseGetFirmwareVersion() {
 }
 
 static void host_onRequestGetOutputDataRate() {
-  pendingResponses.host_responseGetOutputDataRate = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_OutputDataRate);
 }
 
 static void host_responseGetOutputDataRate() {
@@ -394,11 +895,26 @@ static void host_responseGetOutputDataRate() {
 
 static int
 host_onRequestSetOutputDatatRate(enum TransportRx_SetOutputDataRate_Rate odr) {
-  return Adxl345_setOutputDataRate(&controllerHandle.sensor.handle, odr);
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    // answer with the unchanged setting, the host notices the rejection
+    Controller_requestResponse(&controllerHandle.responses,
+                               Controller_Response_OutputDataRate);
+    return -EBUSY;
+  }
+
+  // all sensors share one setup
+  int ret = {0};
+  for (uint8_t sensor = 0; 0 == ret && sensor < controllerHandle.sensor.count;
+       sensor++) {
+    ret = Adxl345_setOutputDataRate(&controllerHandle.sensor.handles[sensor],
+                                    odr);
+  }
+  return ret;
 }
 
 static void host_onRequestGetRange() {
-  pendingResponses.host_responseGetRange = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_Range);
 }
 
 static void host_responseGetRange() {
@@ -408,11 +924,25 @@ static void host_responseGetRange() {
 }
 
 static int host_onRequestSetRange(enum TransportRx_SetRange_Range range) {
-  return Adxl345_setRange(&controllerHandle.sensor.handle, range);
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    // answer with the unchanged setting, the host notices the rejection
+    Controller_requestResponse(&controllerHandle.responses,
+                               Controller_Response_Range);
+    return -EBUSY;
+  }
+
+  // all sensors share one setup
+  int ret = {0};
+  for (uint8_t sensor = 0; 0 == ret && sensor < controllerHandle.sensor.count;
+       sensor++) {
+    ret = Adxl345_setRange(&controllerHandle.sensor.handles[sensor], range);
+  }
+  return ret;
 }
 
 static void host_onRequestGetScale() {
-  pendingResponses.host_responseGetScale = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_Scale);
 }
 
 static void host_responseGetScale() {
@@ -422,11 +952,25 @@ static void host_responseGetScale() {
 }
 
 static int host_onRequestSetScale(enum TransportRx_SetScale_Scale scale) {
-  return Adxl345_setScale(&controllerHandle.sensor.handle, scale);
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    // answer with the unchanged setting, the host notices the rejection
+    Controller_requestResponse(&controllerHandle.responses,
+                               Controller_Response_Scale);
+    return -EBUSY;
+  }
+
+  // all sensors share one setup
+  int ret = {0};
+  for (uint8_t sensor = 0; 0 == ret && sensor < controllerHandle.sensor.count;
+       sensor++) {
+    ret = Adxl345_setScale(&controllerHandle.sensor.handles[sensor], scale);
+  }
+  return ret;
 }
 
 static void host_onRequestGetDeviceSetup() {
-  pendingResponses.host_responseGetDeviceSetup = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_DeviceSetup);
 }
 
 static void host_responseGetDeviceSetup() {
@@ -442,15 +986,530 @@ static void host_responseGetDeviceSetup() {
 }
 
 static void host_onRequestSamplingStart(uint16_t maxSamplesCount) {
-  Sampling_start(&controllerHandle.sampling.handle, maxSamplesCount);
+  if (!controllerHandle.sampling.handles[0].state.isStarted) {
+    capture.isEnabled = false;
+    recorder.isEnabled = false;
+    sequence.isEnabled = false;
+  }
+  ControllerImpl_startSampling(maxSamplesCount, true);
 }
 
 static void host_onRequestSamplingStop() {
-  Sampling_stop(&controllerHandle.sampling.handle);
+  Sampling_stop(&controllerHandle.sampling.handles[0]);
+}
+
+/**
+ * Applies setup and starts sampling, \see host_onRequestConfigureAndStart().
+ *
+ * @param setup
+ * @return -EBUSY if sampling, -EINVAL if setup is invalid, 0 otherwise
+ */
+static int ControllerImpl_configureAndStart(
+    const struct TransportRx_ConfigureAndStart *setup) {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    return -EBUSY;
+  }
+
+  // validate what the sensor does not know about before touching it
+  const bool isRaw = {Transport_SampleFormat_Acceleration == setup->format};
+  if (!Transport_isValidFormat(setup->format) ||
+      (!isRaw &&
+       Transport_Axis_All != controllerHandle.host.handle.toHost.axes) ||
+      0 == setup->watermark ||
+      SAMPLING_NUM_SAMPLES_READ_AT_ONCE < setup->watermark) {
+    return -EINVAL;
+  }
+
+  // calibrated samples may take all 16 bit
+  const bool isPacked = {Transport_SampleFormat_Packed13 == setup->format ||
+                         Transport_SampleFormat_Packed10 == setup->format};
+  if (isPacked && ControllerImpl_isCalibrated()) {
+    return -EINVAL;
+  }
+
+  // 10 bit mode or full resolution at +-2g: 10 significant bits at most
+  if (Transport_SampleFormat_Packed10 == setup->format &&
+      TransportRx_SetScale_Scale_10bit != setup->scale &&
+      TransportRx_SetRange_Range_2g != setup->range) {
+    return -EINVAL;
+  }
+
+  // all sensors share one setup: none is touched unless it is valid for all
+  const int ret = {Adxl345_validateSetup(setup->rate, setup->range,
+                                         setup->scale, setup->watermark)};
+  if (0 != ret) {
+    return ret;
+  }
+
+  for (uint8_t sensor = 0; sensor < controllerHandle.sensor.count; sensor++) {
+    Adxl345_configure(&controllerHandle.sensor.handles[sensor], setup->rate,
+                      setup->range, setup->scale, setup->watermark);
+    Sampling_setSamplesPerFetch(&controllerHandle.sampling.handles[sensor],
+                                setup->watermark);
+  }
+
+  sensor_doGetOutputDataRateImpl(&configuredStart.odr);
+  sensor_doGetScaleImpl(&configuredStart.scale);
+  sensor_doGetRangeImpl(&configuredStart.range);
+  configuredStart.watermark = setup->watermark;
+  configuredStart.format = setup->format;
+  configuredStart.isPending = true;
+
+  capture.isEnabled = false;
+  recorder.isEnabled = false;
+  sequence.isEnabled = false;
+  ControllerImpl_startSampling(setup->max_samples_count, isRaw);
+  return 0;
+}
+
+/**
+ * Answers a rejected start request with the unchanged setup, the host waits
+ * for it.
+ *
+ * @param result negative errno
+ */
+static void ControllerImpl_answerRejectedStart(int result) {
+  uint8_t odr = {0};
+  uint8_t scale = {0};
+  uint8_t range = {0};
+  sensor_doGetOutputDataRateImpl(&odr);
+  sensor_doGetScaleImpl(&scale);
+  sensor_doGetRangeImpl(&range);
+  TransportTx_TxSamplingConfiguredStarted(
+      &controllerHandle.host.handle, 0, odr, scale, range,
+      controllerHandle.sampling.handles[0].state.samplesPerFetch,
+      (enum Transport_SampleFormat)controllerHandle.host.handle.toHost.format,
+      (int8_t)result);
+}
+
+static int host_onRequestConfigureAndStart(
+    const struct TransportRx_ConfigureAndStart *setup) {
+  const int ret = {ControllerImpl_configureAndStart(setup)};
+  if (0 != ret) {
+    ControllerImpl_answerRejectedStart(ret);
+  }
+  return ret;
+}
+
+static int host_onRequestCaptureStart(uint16_t maxSamplesCount) {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    ControllerImpl_answerRejectedStart(-EBUSY);
+    return -EBUSY;
+  }
+
+  const uint16_t capacity = {Capture_capacity(&capture.buffer)};
+  if (0 == maxSamplesCount || capacity < maxSamplesCount) {
+    maxSamplesCount = capacity;
+  }
+
+  capture.isEnabled = true;
+  recorder.isEnabled = false;
+  sequence.isEnabled = false;
+  ControllerImpl_startSampling(maxSamplesCount, false);
+  return 0;
+}
+
+/**
+ * @return true while capturing to RAM or recording
+ */
+static bool ControllerImpl_isCapturing() {
+  return (capture.isEnabled || recorder.isEnabled) &&
+         controllerHandle.sampling.handles[0].state.isStarted;
+}
+
+static int host_onRequestCaptureRead(uint16_t offset) {
+  // answered by an empty chunk while capturing, the host waits for it
+  capture.readOffset = offset;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_CaptureChunk);
+  return ControllerImpl_isCapturing() ? -EBUSY : 0;
+}
+
+/**
+ * Selects the axes to stream and capture, \see host_onRequestSetAxes().
+ *
+ * @param axes
+ * @return -EBUSY if sampling, -EINVAL if axes are invalid, 0 otherwise
+ */
+static int ControllerImpl_setAxes(uint8_t axes) {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    return -EBUSY;
+  }
+
+  // the calibration mixes axes
+  if (Transport_Axis_All != axes && ControllerImpl_isCalibrated()) {
+    return -EINVAL;
+  }
+
+  const int ret = {Transport_setAxes(&controllerHandle.host.handle, axes,
+                                     RINGBUFFER_STORAGE_SIZE_BYTES)};
+  if (0 != ret) {
+    return ret;
+  }
+
+  // fewer axes per sample: more samples fit into the shared storage
+  const uint8_t sampleSizeBytes = {Transport_sampleSizeBytes(axes)};
+  return Capture_init(&capture.buffer, ringbufferStorage,
+                      RINGBUFFER_STORAGE_SIZE_BYTES / sampleSizeBytes,
+                      sampleSizeBytes);
+}
+
+/**
+ * Requests TransportTx_StreamSetup answering an axes or framing request, it
+ * echoes the unchanged setup if the request was rejected.
+ *
+ * @param result of the request
+ * @return result
+ */
+static int ControllerImpl_answerStreamSetup(int result) {
+  streamSetupResult = (int8_t)result;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_StreamSetup);
+  return result;
+}
+
+static int host_onRequestSetAxes(uint8_t axes) {
+  return ControllerImpl_answerStreamSetup(ControllerImpl_setAxes(axes));
+}
+
+static int host_onRequestSetFraming(bool isFramed) {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    return ControllerImpl_answerStreamSetup(-EBUSY);
+  }
+
+  Transport_setFraming(&controllerHandle.host.handle, isFramed);
+  return ControllerImpl_answerStreamSetup(0);
+}
+
+static void host_responseStreamSetup() {
+  TransportTx_TxStreamSetup(&controllerHandle.host.handle, streamSetupResult);
+}
+
+static int host_onRequestSetMaxLatency(uint16_t maxLatencyMs) {
+  int ret = {0};
+  for (uint8_t sensor = 0; 0 == ret && sensor < controllerHandle.sensor.count;
+       sensor++) {
+    ret = Sampling_setMaxLatency(&controllerHandle.sampling.handles[sensor],
+                                 maxLatencyMs);
+  }
+  return ret;
+}
+
+/**
+ * Configures the calibration of one sensor, \see
+ * host_onRequestSetCalibration().
+ *
+ * @param setup
+ * @return -EBUSY if sampling, -EINVAL if setup is invalid, 0 otherwise
+ */
+static int
+ControllerImpl_setCalibration(const struct Transport_Calibration *setup) {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    return -EBUSY;
+  }
+
+  if (controllerHandle.sensor.count <= setup->sensor ||
+      (setup->enable &&
+       Transport_Axis_All != controllerHandle.host.handle.toHost.axes)) {
+    return -EINVAL;
+  }
+
+  struct Calibration *stage = {&calibration.stages[setup->sensor]};
+  if (setup->enable) {
+    struct Calibration_Setup stageSetup = {.shift = setup->shift};
+    for (uint8_t row = 0; row < 3U; row++) {
+      for (uint8_t column = 0; column < 3U; column++) {
+        stageSetup.matrix[row][column] = setup->matrix[row * 3U + column];
+      }
+      stageSetup.offset[row] = setup->offset[row];
+    }
+
+    const int ret = {Calibration_configure(stage, &stageSetup)};
+    if (0 != ret) {
+      return ret;
+    }
+  } else {
+    Calibration_disable(stage);
+  }
+
+  calibration.setups[setup->sensor] = *setup;
+  return 0;
+}
+
+/**
+ * Requests the calibration response of a sensor.
+ *
+ * An unknown sensor is answered with the setup of the primary sensor, the
+ * host notices the rejection by the sensor ID.
+ *
+ * @param sensor
+ * @return -EINVAL if sensor is unknown, 0 otherwise
+ */
+static int ControllerImpl_requestCalibrationResponse(uint8_t sensor) {
+  const bool isKnown = {sensor < controllerHandle.sensor.count};
+  calibration.responseSensor = isKnown ? sensor : 0;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_Calibration);
+  return isKnown ? 0 : -EINVAL;
+}
+
+static int
+host_onRequestSetCalibration(const struct Transport_Calibration *setup) {
+  const int ret = {ControllerImpl_setCalibration(setup)};
+  // answer a rejection with the unchanged setup, the host notices it
+  ControllerImpl_requestCalibrationResponse(setup->sensor);
+  return ret;
+}
+
+static int host_onRequestGetCalibration(uint8_t sensor) {
+  return ControllerImpl_requestCalibrationResponse(sensor);
+}
+
+static void host_responseCalibration() {
+  TransportTx_TxCalibration(&controllerHandle.host.handle,
+                            &calibration.setups[calibration.responseSensor]);
+}
+
+static void host_onRequestGetSpiClock() {
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_SpiClock);
+}
+
+static void host_responseSpiClock() {
+  const uint32_t clockHz = {
+      0 != spiClock.divisor ? HAL_RCC_GetPCLK2Freq() / spiClock.divisor : 0};
+  TransportTx_TxSpiClock(&controllerHandle.host.handle, clockHz,
+                         spiClock.divisor, spiClock.fastestDivisor);
+}
+
+static int host_onRequestSaveConfiguration() {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    // answer with the unchanged stored setup, the host notices the rejection
+    configStore.result = -EBUSY;
+    Controller_requestResponse(&controllerHandle.responses,
+                               Controller_Response_ConfigurationSaved);
+    return -EBUSY;
+  }
+
+  // all sensors share the setup of the primary sensor
+  struct ConfigStore_Config *config = {&configStore.saved};
+  int ret = {sensor_doGetOutputDataRateImpl(&config->outputDataRate)};
+  if (0 == ret) {
+    ret = sensor_doGetRangeImpl(&config->range);
+  }
+  if (0 == ret) {
+    ret = sensor_doGetScaleImpl(&config->scale);
+  }
+  if (0 == ret) {
+    ret = ConfigStore_save(&configStore.handle, config);
+  }
+
+  configStore.result = (int8_t)ret;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_ConfigurationSaved);
+  return ret;
+}
+
+static void host_responseConfigurationSaved() {
+  TransportTx_TxConfigurationSaved(
+      &controllerHandle.host.handle, configStore.saved.outputDataRate,
+      configStore.saved.range, configStore.saved.scale, configStore.result);
+}
+
+static void host_responseCaptureChunk() {
+  // keep USB busy as short as possible until the capture has finished
+  if (ControllerImpl_isCapturing()) {
+    TransportTx_TxCaptureChunk(&controllerHandle.host.handle,
+                               capture.readOffset, 0, NULL, 0);
+    return;
+  }
+
+  uint16_t count = {0};
+  const void *samples =
+      Capture_itemsAt(&capture.buffer, capture.readOffset, &count);
+
+  if (TRANSPORTTX_CAPTURE_CHUNK_SAMPLES < count) {
+    count = TRANSPORTTX_CAPTURE_CHUNK_SAMPLES;
+  }
+
+  TransportTx_TxCaptureChunk(&controllerHandle.host.handle, capture.readOffset,
+                             Capture_count(&capture.buffer), samples, count);
+}
+
+static int
+host_onRequestRecorderStart(const struct TransportRx_RecorderStart *setup) {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    return -EBUSY;
+  }
+
+  const bool isSensorActivity = {Transport_TriggerSource_SensorActivity ==
+                                 setup->source};
+  if ((!isSensorActivity &&
+       Transport_TriggerSource_Threshold != setup->source) ||
+      0 == setup->threshold ||
+      (isSensorActivity && UINT8_MAX < setup->threshold) ||
+      CONTROLLER_CAPTURE_ITEMS <= setup->post_samples_count) {
+    return -EINVAL;
+  }
+
+  // the trigger evaluates the magnitude over all axes
+  if (Transport_Axis_All != controllerHandle.host.handle.toHost.axes) {
+    return -EINVAL;
+  }
+
+  // the sensor detects activity on its own, the threshold is applied there
+  Adxl345_setActivityDetection(&controllerHandle.sensor.handles[0],
+                               isSensorActivity ? setup->threshold : 0);
+  if (isSensorActivity) {
+    struct Adxl345Register_IntSource stale = {0};
+    Adxl345_getInterruptSource(&controllerHandle.sensor.handles[0], &stale);
+  }
+
+  Ringbuffer_reset(&recorder.buffer);
+  Trigger_arm(&recorder.trigger,
+              isSensorActivity ? Trigger_Source_External
+                               : Trigger_Source_Threshold,
+              setup->threshold, setup->post_samples_count);
+
+  capture.isEnabled = false;
+  recorder.isEnabled = true;
+  sequence.isEnabled = false;
+  ControllerImpl_startSampling(0, false);
+  return 0;
+}
+
+/**
+ * Hands the recorded window over to the capture read out.
+ *
+ * Called once sampling stopped, either because the post-trigger samples are
+ * recorded or upon stop request.
+ */
+static void ControllerImpl_finishRecording() {
+  if (Trigger_Source_External == recorder.trigger.source) {
+    Adxl345_setActivityDetection(&controllerHandle.sensor.handles[0], 0);
+  }
+  recorder.isEnabled = false;
+
+  // oldest sample first; capture and recorder share ringbufferStorage
+  Ringbuffer_linearize(&recorder.buffer);
+  const uint16_t count = {Ringbuffer_itemsCount(&recorder.buffer)};
+  Capture_setCount(&capture.buffer, count);
+
+  recorder.isTriggered = Trigger_isTriggered(&recorder.trigger);
+  recorder.triggerIndex =
+      recorder.isTriggered
+          ? count - Trigger_postSamplesAccepted(&recorder.trigger)
+          : count;
+
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_RecorderFinished);
+}
+
+static void host_responseRecorderFinished() {
+  TransportTx_TxRecorderFinished(&controllerHandle.host.handle,
+                                 Capture_count(&capture.buffer),
+                                 recorder.triggerIndex, recorder.isTriggered);
+}
+
+static int
+host_onRequestSequenceAppend(const struct TransportRx_SequenceAppend *entry) {
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    return -EBUSY;
+  }
+
+  // segment tags occupy one stream item of all axes layout
+  if ((Transport_SequenceTrigger_Delay != entry->trigger &&
+       Transport_SequenceTrigger_Marker != entry->trigger) ||
+      Transport_Axis_All != controllerHandle.host.handle.toHost.axes) {
+    return -EINVAL;
+  }
+
+  const struct Sequencer_Entry sequencerEntry = {
+      .trigger = Transport_SequenceTrigger_Marker == entry->trigger
+                     ? Sequencer_Trigger_Marker
+                     : Sequencer_Trigger_Delay,
+      .delayMs = entry->delay_ms,
+      .samplesCount = entry->samples_count};
+
+  const int ret = {Sequencer_append(&sequence.sequencer, &sequencerEntry)};
+  if (0 != ret || 0 == entry->do_start) {
+    return ret;
+  }
+
+  Sequencer_start(&sequence.sequencer, HAL_GetTick());
+  capture.isEnabled = false;
+  recorder.isEnabled = false;
+  sequence.isEnabled = true;
+  ControllerImpl_startSampling(0, false);
+  return 0;
+}
+
+static void host_onRequestSequenceMarker() {
+  Sequencer_mark(&sequence.sequencer);
+}
+
+/**
+ * Transmits all buffered stream data including the held back last packet.
+ */
+static void ControllerImpl_flushStream() {
+  uint16_t retries = {CONTROLLER_STREAM_FLUSH_RETRIES};
+  while (-ENODATA !=
+             TransportTx_TxAccelerationFlush(&controllerHandle.host.handle) &&
+         0 != retries) {
+    retries--;
+  }
+}
+
+/**
+ * Forwards the samples belonging to a segment and tags each segment start.
+ *
+ * Stops sampling once all segments are transmitted.
+ *
+ * @param buffer samples of one batch
+ * @param bufferLen number of samples
+ * @return same as TransportTx_TxAccelerationBuffer()
+ */
+static int
+ControllerImpl_forwardSequence(const struct Sampling_Acceleration *buffer,
+                               uint16_t bufferLen) {
+  const uint32_t nowMs = {HAL_GetTick()};
+  int ret = {0};
+  uint16_t offset = {0};
+  struct Sequencer_Slice slice;
+
+  while (offset < bufferLen && Sequencer_next(&sequence.sequencer, nowMs,
+                                              bufferLen - offset, &slice)) {
+    if (slice.isFirst) {
+      ret = TransportTx_TxSequenceSegment(&controllerHandle.host.handle,
+                                          slice.segment, slice.samplesCount,
+                                          nowMs);
+    }
+    if (-ENOMEM != ret) {
+      ret = TransportTx_TxAccelerationBuffer(
+          &controllerHandle.host.handle,
+          (const struct Transport_Acceleration *)&buffer[offset], slice.count,
+          slice.firstIndex);
+    }
+    if (-ENOMEM == ret) {
+      return ret;
+    }
+    offset += slice.count;
+  }
+
+  if (!Sequencer_isRunning(&sequence.sequencer)) {
+    // sampling is stopped right after: nothing would drain the buffer
+    ControllerImpl_flushStream();
+    Controller_requestResponse(&controllerHandle.responses,
+                               Controller_Response_SamplingFinished);
+    Sampling_stop(&controllerHandle.sampling.handles[0]);
+  }
+
+  return ret;
 }
 
 static void host_onRequestGetUptime() {
-  pendingResponses.host_responseGetUptime = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_Uptime);
 }
 
 static void host_responseGetUptime() {
@@ -458,85 +1517,207 @@ static void host_responseGetUptime() {
 }
 
 static void host_onRequestGetBufferStatus() {
-  pendingResponses.host_responseGetBufferStatus = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_BufferStatus);
 }
 
 static void host_responseGetBufferStatus() {
   TransportTx_TxBufferStatus(
       &controllerHandle.host.handle, RINGBUFFER_STORAGE_SIZE_BYTES,
-      RINGBUFFER_STORAGE_ITEMS,
+      Ringbuffer_capacity(&controllerHandle.host.handle.toHost.ringbuffer),
       Ringbuffer_maxCapacityUsed(
           &controllerHandle.host.handle.toHost.ringbuffer),
       Ringbuffer_putCount(&controllerHandle.host.handle.toHost.ringbuffer),
       Ringbuffer_takeCount(&controllerHandle.host.handle.toHost.ringbuffer),
-      controllerHandle.host.handle.toHost.largestTxChunkBytes);
+      controllerHandle.host.handle.toHost.largestTxChunkBytes,
+      Transport_averageTxChunkBytes(&controllerHandle.host.handle));
 }
 
 /* Sensor ------------------------------------------------------------------- */
 
+static int sensor_doVerifySpiImpl(uint16_t divisor) {
+  if (0 != Adxl345TransportImpl_setSpiDivisor(divisor)) {
+    return -EIO;
+  }
+  for (uint8_t sensor = 0; sensor < controllerHandle.sensor.count; sensor++) {
+    if (0 != Adxl345_verifyTransfer(&controllerHandle.sensor.handles[sensor])) {
+      return -EIO;
+    }
+  }
+  return 0;
+}
+
 static void sensor_doInitImpl() {
-  Adxl345_init(&controllerHandle.sensor.handle);
+  // further sensors are optional and expected in order of their chip selects
+  controllerHandle.sensor.count = 1;
+  for (uint8_t sensor = 1; sensor < CONTROLLER_SENSORS; sensor++) {
+    if (0 != Adxl345_probe(&controllerHandle.sensor.handles[sensor])) {
+      break;
+    }
+    controllerHandle.sensor.count++;
+  }
+
+  // before any register is configured: verification clobbers the offsets
+  const uint16_t ratedDivisor = {ClockProfileImpl_spiRatedDivisor()};
+  spiClock.divisor = ClockProfile_calibrateSpiDivisor(
+      ratedDivisor, CONTROLLER_SPI_VERIFY_ROUNDS, sensor_doVerifySpiImpl,
+      &spiClock.fastestDivisor);
+  if (0 != Adxl345TransportImpl_setSpiDivisor(spiClock.divisor)) {
+    spiClock.divisor = ratedDivisor;
+  }
+
+  for (uint8_t sensor = 0; sensor < controllerHandle.sensor.count; sensor++) {
+    Adxl345_init(&controllerHandle.sensor.handles[sensor]);
+  }
 }
 
 static int sensor_doGetOutputDataRateImpl(uint8_t *odr) {
   enum Adxl345Flags_BwRate_Rate adxlOdr = {0};
   int ret =
-      Adxl345_getOutputDataRate(&controllerHandle.sensor.handle, &adxlOdr);
+      Adxl345_getOutputDataRate(&controllerHandle.sensor.handles[0], &adxlOdr);
   *odr = adxlOdr;
   return ret;
 }
 
 static int sensor_doGetScaleImpl(uint8_t *scale) {
   enum Adxl345Flags_DataFormat_FullResBit adxlScale = {0};
-  int ret = Adxl345_getScale(&controllerHandle.sensor.handle, &adxlScale);
+  int ret = Adxl345_getScale(&controllerHandle.sensor.handles[0], &adxlScale);
   *scale = adxlScale;
   return ret;
 }
 
 static int sensor_doGetRangeImpl(uint8_t *range) {
   enum Adxl345Flags_DataFormat_Range adxlRange = {0};
-  int ret = Adxl345_getRange(&controllerHandle.sensor.handle, &adxlRange);
+  int ret = Adxl345_getRange(&controllerHandle.sensor.handles[0], &adxlRange);
   *range = adxlRange;
   return ret;
 }
 
-static void sampling_setFifoWatermark() {
-  Sampling_setFifoWatermark(&controllerHandle.sampling.handle);
+static void sampling_setFifoWatermark(uint8_t sensor) {
+  USER_DEBUG0_HIGH; // mark start of watermark wake-up latency
+  Sampling_setFifoWatermark(&controllerHandle.sampling.handles[sensor]);
+  Controller_postEvents(&controllerHandle.events,
+                        Controller_Event_FifoWatermark);
 }
 
-static void sampling_clearFifoWatermark() {
-  Sampling_clearFifoWatermark(&controllerHandle.sampling.handle);
+static void sampling_clearFifoWatermark(uint8_t sensor) {
+  Sampling_clearFifoWatermark(&controllerHandle.sampling.handles[sensor]);
 }
 
-static void sampling_setFifoOverflow() {
-  Sampling_setFifoOverflow(&controllerHandle.sampling.handle);
+static void sampling_setFifoOverflow(uint8_t sensor) {
+  // the recorder samples the primary sensor only
+  if (0 == sensor && recorder.isEnabled &&
+      Trigger_Source_External == recorder.trigger.source) {
+    // INT2 is shared with the activity interrupt: tell apart in main()
+    Controller_postEvents(&controllerHandle.events,
+                          Controller_Event_InterruptSource);
+    return;
+  }
+
+  Sampling_setFifoOverflow(&controllerHandle.sampling.handles[sensor]);
+  Controller_postEvents(&controllerHandle.events,
+                        Controller_Event_FifoOverflow);
 }
 
 static void sampling_on5usTimerExpired() {
-  Sampling_on5usTimerExpired(&controllerHandle.sampling.handle);
+  // sensors are fetched one after another: at most one handle is waiting
+  for (uint8_t sensor = 0; sensor < CONTROLLER_SENSORS; sensor++) {
+    Sampling_on5usTimerExpired(&controllerHandle.sampling.handles[sensor]);
+  }
+}
+
+static void sampling_onMillisecondTick() {
+  bool isDeadline = {false};
+  for (uint8_t sensor = 0; sensor < CONTROLLER_SENSORS; sensor++) {
+    isDeadline = Sampling_onMillisecondTick(
+                     &controllerHandle.sampling.handles[sensor]) ||
+                 isDeadline;
+  }
+
+  if (isDeadline) {
+    Controller_postEvents(&controllerHandle.events,
+                          Controller_Event_LatencyDeadline);
+  }
 }
 
 static void sampling_onSamplingStartedCb() {
-  Transport_resetBuffer(&controllerHandle.host.handle);
+  // both share ringbufferStorage: a previous capture is gone either way
+  // only a configure-and-start request may select a compressed stream
+  Transport_setFormat(&controllerHandle.host.handle,
+                      configuredStart.isPending
+                          ? configuredStart.format
+                          : Transport_SampleFormat_Acceleration,
+                      RINGBUFFER_STORAGE_SIZE_BYTES);
+  Capture_reset(&capture.buffer);
+
+  if (configuredStart.isPending) {
+    configuredStart.isPending = false;
+    TransportTx_TxSamplingConfiguredStarted(
+        &controllerHandle.host.handle,
+        controllerHandle.sampling.handles[0].state.maxSamples,
+        configuredStart.odr, configuredStart.scale, configuredStart.range,
+        configuredStart.watermark, configuredStart.format, 0);
+    return;
+  }
 
   TransportTx_TxSamplingStarted(
       &controllerHandle.host.handle,
-      controllerHandle.sampling.handle.state.maxSamples);
+      controllerHandle.sampling.handles[0].state.maxSamples);
 }
 
 static void sampling_onSamplingStoppedCb() {
-  pendingResponses.sampling_responseSamplingStopped = true;
+  // the followers fetch no further batch once requested to stop
+  for (uint8_t sensor = 1; sensor < controllerHandle.sensor.count; sensor++) {
+    if (controllerHandle.sampling.handles[sensor].state.isStarted) {
+      Sampling_stop(&controllerHandle.sampling.handles[sensor]);
+    }
+  }
+
+  // the stream ends: the last packet must not wait for its deadline
+  ControllerImpl_flushStream();
+
+  if (recorder.isEnabled) {
+    ControllerImpl_finishRecording();
+  }
+
+  if (sequence.isEnabled) {
+    sequence.isEnabled = false;
+    Sequencer_clear(&sequence.sequencer);
+  }
+
+  // each is a separate response; the priority order keeps the sequence
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_FirmwareVersion);
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_BufferStatus);
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_DeviceSetup);
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_SamplingStopped);
+}
+
+static void sampling_onFollowerStartedCb() {
+  // nothing to set up: the primary sensor started the stream right before
+}
+
+/**
+ * Ends the session once any other than the primary sensor stopped, e.g. due
+ * to its FiFo overflow.
+ */
+static void sampling_onFollowerStoppedCb() {
+  // a stopped primary sensor must not see a stale stop request
+  if (controllerHandle.sampling.handles[0].state.isStarted) {
+    Sampling_stop(&controllerHandle.sampling.handles[0]);
+  }
 }
 
 static void sampling_responseSamplingStopped() {
-  host_responseGetFirmwareVersion();
-  host_responseGetBufferStatus();
-  host_responseGetDeviceSetup();
   TransportTx_TxSamplingStopped(&controllerHandle.host.handle);
 }
 
 static void sampling_onSamplingAbortedCb() {
-  pendingResponses.sampling_responseSamplingAborted = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_SamplingAborted);
 }
 
 static void sampling_responseSamplingAborted() {
@@ -544,7 +1725,8 @@ static void sampling_responseSamplingAborted() {
 }
 
 static void sampling_onSamplingFinishedCb() {
-  pendingResponses.sampling_responseSamplingFinished = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_SamplingFinished);
 }
 
 static void sampling_responseSamplingFinished() {
@@ -552,6 +1734,7 @@ static void sampling_responseSamplingFinished() {
 }
 
 static int sampling_doForwardAccelerationBufferImpl(
+    const struct Sampling_Handle *handle,
     const struct Sampling_Acceleration *buffer, uint16_t bufferLen,
     uint16_t firstIndex) {
 
@@ -562,13 +1745,72 @@ static int sampling_doForwardAccelerationBufferImpl(
                     sizeof(struct Transport_Acceleration),
                 "ERROR: acceleration structs must match in size!");
 
+  if (capture.isEnabled) {
+    // nothing is ever pending for transmission while capturing
+    if (NULL == buffer || 0 == bufferLen) {
+      return -ENODATA;
+    }
+
+    const uint8_t axes = {controllerHandle.host.handle.toHost.axes};
+    if (Transport_Axis_All == axes) {
+      return Capture_append(&capture.buffer, buffer, bufferLen);
+    }
+
+    uint8_t packed[SAMPLING_NUM_SAMPLES_READ_AT_ONCE *
+                   sizeof(struct Transport_Acceleration)];
+    if (SAMPLING_NUM_SAMPLES_READ_AT_ONCE < bufferLen) {
+      return -EINVAL;
+    }
+    Transport_packAxes(axes, (const struct Transport_Acceleration *)buffer,
+                       bufferLen, packed);
+    return Capture_append(&capture.buffer, packed, bufferLen);
+  }
+
+  if (recorder.isEnabled) {
+    static_assert(sizeof(struct Sampling_Acceleration) ==
+                      sizeof(struct Trigger_Acceleration),
+                  "ERROR: acceleration structs must match in size!");
+
+    // host link stays idle until the recording is finished
+    if (NULL == buffer || 0 == bufferLen) {
+      return -ENODATA;
+    }
+
+    const uint16_t accepted = {
+        Trigger_feed(&recorder.trigger,
+                     (const struct Trigger_Acceleration *)buffer, bufferLen)};
+    for (uint16_t idx = 0; idx < accepted; idx++) {
+      Ringbuffer_putOverwrite(&recorder.buffer, &buffer[idx], NULL);
+    }
+
+    if (Trigger_isComplete(&recorder.trigger)) {
+      Sampling_stop(&controllerHandle.sampling.handles[0]);
+    }
+    return 0;
+  }
+
+  if (sequence.isEnabled && NULL != buffer && 0 != bufferLen) {
+    return ControllerImpl_forwardSequence(buffer, bufferLen);
+  }
+
+  if (isInterleaved && NULL != buffer && 0 != bufferLen) {
+    // the cycle counter relates to the clock correlation
+    const int ret = {TransportTx_TxAccelerationSensor(
+        &controllerHandle.host.handle, handle->sensor, (uint8_t)bufferLen,
+        firstIndex, DWT->CYCCNT)};
+    if (-ENOMEM == ret) {
+      return ret;
+    }
+  }
+
   return TransportTx_TxAccelerationBuffer(
       &controllerHandle.host.handle,
       (const struct Transport_Acceleration *)buffer, bufferLen, firstIndex);
 }
 
 static void sampling_onFifoOverflowCb() {
-  pendingResponses.sampling_responseFifoOverflow = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_FifoOverflow);
 }
 
 static void sampling_responseFifoOverflow() {
@@ -576,7 +1818,8 @@ static void sampling_responseFifoOverflow() {
 }
 
 static void sampling_onBufferOverflowCb() {
-  pendingResponses.host_responseGetBufferStatus = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_BufferOverflow);
 }
 
 static void sampling_responseBufferOverflow() {
@@ -584,33 +1827,61 @@ static void sampling_responseBufferOverflow() {
 }
 
 static void sampling_onTransmissionErrorCb() {
-  pendingResponses.sampling_responseTransmissionError = true;
+  Controller_requestResponse(&controllerHandle.responses,
+                             Controller_Response_TransmissionError);
 }
 
 static void sampling_responseTransmissionError() {
   TransportTx_TxTransmissionError(&controllerHandle.host.handle);
 }
 
-static void sampling_doEnableSensorImpl() {
-  Adxl345_setPowerCtlMeasure(&controllerHandle.sensor.handle);
+static void sampling_doEnableSensorImpl(const struct Sampling_Handle *handle) {
+  Adxl345_setPowerCtlMeasure(&controllerHandle.sensor.handles[handle->sensor]);
 }
 
-static void sampling_doDisableSensorImpl() {
-  Adxl345_setPowerCtlStandby(&controllerHandle.sensor.handle);
+static void sampling_doDisableSensorImpl(const struct Sampling_Handle *handle) {
+  Adxl345_setPowerCtlStandby(&controllerHandle.sensor.handles[handle->sensor]);
 }
 
 static void
-sampling_doFetchSensorAccelerationImpl(struct Sampling_Acceleration *sample) {
+sampling_doFetchSensorAccelerationImpl(const struct Sampling_Handle *handle,
+                                       struct Sampling_Acceleration *sample) {
+  static_assert((uint8_t)Transport_Axis_X == (uint8_t)Adxl345_Axis_x &&
+                    (uint8_t)Transport_Axis_Y == (uint8_t)Adxl345_Axis_y &&
+                    (uint8_t)Transport_Axis_Z == (uint8_t)Adxl345_Axis_z,
+                "ERROR: axis selection bits must match!");
+
+  // transfer only the selected axes' span of data registers
   struct Adxl345Transport_Acceleration sensorSample;
-  Adxl345_getAcceleration(&controllerHandle.sensor.handle, &sensorSample);
+  Adxl345_getAccelerationAxes(
+      &controllerHandle.sensor.handles[handle->sensor], &sensorSample,
+      controllerHandle.host.handle.toHost.axes);
 
   if (NULL != sample) {
+    static_assert(sizeof(struct Sampling_Acceleration) ==
+                      sizeof(struct Calibration_Acceleration),
+                  "ERROR: acceleration structs must match in size!");
+
     sample->x = sensorSample.x;
     sample->y = sensorSample.y;
     sample->z = sensorSample.z;
+    Calibration_apply(&calibration.stages[handle->sensor],
+                      (struct Calibration_Acceleration *)sample, 1);
   }
 }
 
+static int sampling_doFlushAccelerationBufferImpl() {
+  return TransportTx_TxAccelerationFlush(&controllerHandle.host.handle);
+}
+
+static uint8_t
+sampling_doGetFifoEntriesImpl(const struct Sampling_Handle *handle) {
+  struct Adxl345Register_FifoStatus status = {0};
+  Adxl345_getFifoStatus(&controllerHandle.sensor.handles[handle->sensor],
+                        &status);
+  return status.entries;
+}
+
 static void fault_onNmiFaultHandler() {
   TransportTx_TxFault(&controllerHandle.host.handle,
                       TransportTx_FaultCode_NmiHandler);
@@ -0,0 +1,13 @@
+#include "fw/crc_impl.h"
+#include <stm32f4xx_hal.h>
+
+void CrcImpl_init() { __HAL_RCC_CRC_CLK_ENABLE(); }
+
+uint32_t CrcImpl_doCrc32WordsImpl(const uint32_t *words, uint16_t count) {
+  // HAL_CRC is not enabled by CubeMX: the unit is simple enough to drive
+  CRC->CR = CRC_CR_RESET;
+  for (uint16_t idx = 0; idx < count; idx++) {
+    CRC->DR = words[idx];
+  }
+  return CRC->DR;
+}
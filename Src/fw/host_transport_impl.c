@@ -10,6 +10,7 @@
 #include <errno.h>
 #include <host_transport.h>
 #include <host_transport_types.h>
+#include <stm32f4xx_hal.h>
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 extern struct Controller_Handle controllerHandle;
@@ -33,6 +34,12 @@ volatile bool HostTransportImpl_isTransmitBusyImpl() {
   return HostTransport_Status_Busy == HostTransportImpl_doTransmitImpl(NULL, 0);
 }
 
+uint16_t HostTransportImpl_getFrameNumber() {
+  const USB_OTG_DeviceTypeDef *device = {
+      (USB_OTG_DeviceTypeDef *)(USB_OTG_FS_PERIPH_BASE + USB_OTG_DEVICE_BASE)};
+  return (device->DSTS & USB_OTG_DSTS_FNSOF) >> USB_OTG_DSTS_FNSOF_Pos;
+}
+
 int HostTransportImpl_onTakeReceivedImpl(const uint8_t *buffer) {
   if (NULL == buffer) {
     return -EINVAL;
@@ -48,16 +55,14 @@ int HostTransportImpl_onTakeReceivedImpl(const uint8_t *buffer) {
     controllerHandle.host.onRequestGetOutputDataRate();
     return 0;
   case Transport_HeaderId_Rx_SetOutputDataRate:
-    controllerHandle.host.onRequestSetOutputDatatRate(
+    return controllerHandle.host.onRequestSetOutputDatatRate(
         request->asRxFrame.asSetOutputDataRate.rate);
-    return 0;
   case Transport_HeaderId_Rx_GetRange:
     controllerHandle.host.onRequestGetRange();
     return 0;
   case Transport_HeaderId_Rx_SetRange:
-    controllerHandle.host.onRequestSetRange(
+    return controllerHandle.host.onRequestSetRange(
         request->asRxFrame.asSetRange.range);
-    return 0;
   case Transport_HeaderId_Rx_GetScale:
     controllerHandle.host.onRequestGetScale();
     return 0;
@@ -77,6 +82,44 @@ int HostTransportImpl_onTakeReceivedImpl(const uint8_t *buffer) {
   case Transport_HeaderId_Rx_SamplingStop:
     controllerHandle.host.onRequestSamplingStop();
     return 0;
+  case Transport_HeaderId_Rx_ConfigureAndStart:
+    return controllerHandle.host.onRequestConfigureAndStart(
+        &request->asRxFrame.asConfigureAndStart);
+  case Transport_HeaderId_Rx_CaptureStart:
+    return controllerHandle.host.onRequestCaptureStart(
+        request->asRxFrame.asCaptureStart.max_samples_count);
+  case Transport_HeaderId_Rx_CaptureRead:
+    return controllerHandle.host.onRequestCaptureRead(
+        request->asRxFrame.asCaptureRead.offset);
+  case Transport_HeaderId_Rx_SetAxes:
+    return controllerHandle.host.onRequestSetAxes(
+        request->asRxFrame.asSetAxes.axes);
+  case Transport_HeaderId_Rx_SetFraming:
+    return controllerHandle.host.onRequestSetFraming(
+        0 != request->asRxFrame.asSetFraming.enable);
+  case Transport_HeaderId_Rx_SetMaxLatency:
+    return controllerHandle.host.onRequestSetMaxLatency(
+        request->asRxFrame.asSetMaxLatency.maxLatencyMs);
+  case Transport_HeaderId_Rx_SetCalibration:
+    return controllerHandle.host.onRequestSetCalibration(
+        &request->asRxFrame.asSetCalibration.calibration);
+  case Transport_HeaderId_Rx_GetCalibration:
+    return controllerHandle.host.onRequestGetCalibration(
+        request->asRxFrame.asGetCalibration.sensor);
+  case Transport_HeaderId_Rx_GetSpiClock:
+    controllerHandle.host.onRequestGetSpiClock();
+    return 0;
+  case Transport_HeaderId_Rx_SaveConfiguration:
+    return controllerHandle.host.onRequestSaveConfiguration();
+  case Transport_HeaderId_Rx_RecorderStart:
+    return controllerHandle.host.onRequestRecorderStart(
+        &request->asRxFrame.asRecorderStart);
+  case Transport_HeaderId_Rx_SequenceAppend:
+    return controllerHandle.host.onRequestSequenceAppend(
+        &request->asRxFrame.asSequenceAppend);
+  case Transport_HeaderId_Rx_SequenceMarker:
+    controllerHandle.host.onRequestSequenceMarker();
+    return 0;
   case Transport_HeaderId_Rx_GetUptime:
     controllerHandle.host.onRequestUptime();
     return 0;
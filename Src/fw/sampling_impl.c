@@ -12,8 +12,14 @@ void SamplingImpl_doWaitDelay5usImpl(struct Sampling_Handle *handle) {
 
   HAL_TIM_Base_Start_IT(&htim3);
 
+  // sleep instead of spinning; masked interrupts still wake the core
+  __disable_irq();
   while (handle->state.waitFor5usTimer) {
+    __WFI();
+    __enable_irq();
+    __disable_irq();
   }
+  __enable_irq();
 
   HAL_TIM_Base_Stop_IT(&htim3);
 }
@@ -26,6 +26,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "fw/clock_profile_impl.h"
 #include "fw/controller_impl.h"
 /* USER CODE END Includes */
 
@@ -84,7 +85,9 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+  if (0 != ClockProfileImpl_apply()) {
+    Error_Handler();
+  }
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
@@ -21,7 +21,7 @@
 #include "spi.h"
 
 /* USER CODE BEGIN 0 */
-
+#include "fw/clock_profile_impl.h"
 /* USER CODE END 0 */
 
 SPI_HandleTypeDef hspi1;
@@ -54,7 +54,12 @@ void MX_SPI1_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN SPI1_Init 2 */
-
+  // retune to the bus clock of the selected clock profile
+  hspi1.Init.BaudRatePrescaler =
+      ClockProfileImpl_spiBaudRatePrescaler(ClockProfileImpl_spiRatedDivisor());
+  if (HAL_SPI_Init(&hspi1) != HAL_OK) {
+    Error_Handler();
+  }
   /* USER CODE END SPI1_Init 2 */
 
 }
@@ -189,6 +189,7 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  controllerHandle.sampling.doTickMillisecond();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -207,9 +208,9 @@ void EXTI2_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI2_IRQn 0 */
   if (GPIO_PIN_SET == HAL_GPIO_ReadPin(FIFO_WMARK_GPIO_Port, FIFO_WMARK_Pin))
-    controllerHandle.sampling.doSetFifoWatermark();
+    controllerHandle.sampling.doSetFifoWatermark(0);
   else
-    controllerHandle.sampling.doClearFifoWatermark();
+    controllerHandle.sampling.doClearFifoWatermark(0);
   /* USER CODE END EXTI2_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(FIFO_WMARK_Pin);
   /* USER CODE BEGIN EXTI2_IRQn 1 */
@@ -227,7 +228,7 @@ void EXTI3_IRQHandler(void)
   if (GPIO_PIN_SET == HAL_GPIO_ReadPin(FIFO_OVFL_GPIO_Port, FIFO_OVFL_Pin))
   {
     USER_DEBUG1_HIGH; // mark start of FiFo overflow
-    controllerHandle.sampling.doSetFifoOverflow();
+    controllerHandle.sampling.doSetFifoOverflow(0);
   } else
   {
     USER_DEBUG1_LOW; // mark end of FiFo overflow
@@ -254,13 +255,47 @@ void TIM3_IRQHandler(void)
   /* USER CODE END TIM3_IRQn 1 */
 }
 
+/**
+  * @brief This function handles EXTI line[15:10] interrupts.
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI15_10_IRQn 0 */
+  // both lines of the second sensor share this interrupt
+  if (__HAL_GPIO_EXTI_GET_IT(FIFO_WMARK1_Pin))
+  {
+    if (GPIO_PIN_SET ==
+        HAL_GPIO_ReadPin(FIFO_WMARK1_GPIO_Port, FIFO_WMARK1_Pin))
+      controllerHandle.sampling.doSetFifoWatermark(1);
+    else
+      controllerHandle.sampling.doClearFifoWatermark(1);
+  }
+
+  if (__HAL_GPIO_EXTI_GET_IT(FIFO_OVFL1_Pin) &&
+      GPIO_PIN_SET == HAL_GPIO_ReadPin(FIFO_OVFL1_GPIO_Port, FIFO_OVFL1_Pin))
+  {
+    controllerHandle.sampling.doSetFifoOverflow(1);
+  }
+  /* USER CODE END EXTI15_10_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(FIFO_WMARK1_Pin);
+  HAL_GPIO_EXTI_IRQHandler(FIFO_OVFL1_Pin);
+  /* USER CODE BEGIN EXTI15_10_IRQn 1 */
+
+  /* USER CODE END EXTI15_10_IRQn 1 */
+}
+
 /**
   * @brief This function handles USB On The Go FS global interrupt.
   */
 void OTG_FS_IRQHandler(void)
 {
   /* USER CODE BEGIN OTG_FS_IRQn 0 */
-
+  // HAL_PCD_SOFCallback() in usbd_conf.c has no USER CODE section, CubeMX
+  // would drop a hook there on regeneration: read the flag before the HAL
+  // clears it
+  if (__HAL_PCD_GET_FLAG(&hpcd_USB_OTG_FS, USB_OTG_GINTSTS_SOF)) {
+    controllerHandle.host.doNotifyStartOfFrame();
+  }
   /* USER CODE END OTG_FS_IRQn 0 */
   HAL_PCD_IRQHandler(&hpcd_USB_OTG_FS);
   /* USER CODE BEGIN OTG_FS_IRQn 1 */
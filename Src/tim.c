@@ -21,7 +21,7 @@
 #include "tim.h"
 
 /* USER CODE BEGIN 0 */
-
+#include "fw/clock_profile_impl.h"
 /* USER CODE END 0 */
 
 TIM_HandleTypeDef htim3;
@@ -62,7 +62,12 @@ void MX_TIM3_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM3_Init 2 */
-
+  // retune to the timer clock of the selected clock profile, re-initializing
+  // loads the auto-reload register immediately
+  htim3.Init.Period = ClockProfileImpl_tim3Period();
+  if (HAL_TIM_Base_Init(&htim3) != HAL_OK) {
+    Error_Handler();
+  }
   /* USER CODE END TIM3_Init 2 */
 
 }
@@ -24,6 +24,7 @@
 /* USER CODE BEGIN INCLUDE */
 #include "fw/debug.h"
 #include <controller.h>
+#include <ramfunc.h>
 /* USER CODE END INCLUDE */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -130,6 +131,9 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
 
+// streaming hot path: the attribute applies to the generated definition below
+RAMFUNC uint8_t CDC_Transmit_FS(uint8_t *Buf, uint16_t Len);
+
 /* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
 
 /**
@@ -156,6 +160,7 @@ static int8_t CDC_Init_FS(void)
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceFS, UserTxBufferFS, 0);
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
+  controllerHandle.host.doResetReception();
   return (USBD_OK);
   /* USER CODE END 3 */
 }
@@ -324,6 +329,7 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
   uint8_t result = USBD_OK;
   /* USER CODE BEGIN 13 */
   // USER_DEBUG0_LOW; // mark end of transmission
+  controllerHandle.host.doNotifyTransmitComplete();
   UNUSED(Buf);
   UNUSED(Len);
   UNUSED(epnum);
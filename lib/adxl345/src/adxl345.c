@@ -9,6 +9,8 @@
 #include "adxl345_transport_types.h"
 #include <adxl345_spi_types.h>
 #include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 static void readRegister(struct Adxl345_Handle *handle,
                          enum Adxl345Flags_Address addr,
@@ -120,7 +122,50 @@ int Adxl345_init(struct Adxl345_Handle *handle) {
   return 0;
 }
 
-int Adxl345_setOutputDataRate(struct Adxl345_Handle *handle, uint8_t rate) {
+int Adxl345_probe(struct Adxl345_Handle *handle) {
+  union Adxl345Register reg = {0};
+  readRegister(handle, Adxl345Flags_Address_devId, &reg);
+
+  return ADXL345_DEVICE_ID == reg.asDeviceId ? 0 : -ENODEV;
+}
+
+int Adxl345_verifyTransfer(struct Adxl345_Handle *handle) {
+  static const enum Adxl345Flags_Address offsets[] = {
+      Adxl345Flags_Address_offsX, Adxl345Flags_Address_offsY,
+      Adxl345Flags_Address_offsZ};
+  // alternating and uniform bits, each register sees every pattern
+  static const uint8_t patterns[] = {0x55U, 0xAAU, 0xFFU, 0x00U};
+  const uint8_t offsetsCount = {sizeof(offsets) / sizeof(offsets[0])};
+  const uint8_t patternsCount = {sizeof(patterns) / sizeof(patterns[0])};
+
+  if (0 != Adxl345_probe(handle)) {
+    return -ENODEV;
+  }
+
+  int ret = {0};
+  for (uint8_t round = 0; 0 == ret && round < patternsCount; round++) {
+    for (uint8_t idx = 0; idx < offsetsCount; idx++) {
+      const union Adxl345Register reg = {
+          .asOffset = patterns[(round + idx) % patternsCount]};
+      writeRegister(handle, offsets[idx], &reg);
+    }
+    for (uint8_t idx = 0; idx < offsetsCount; idx++) {
+      union Adxl345Register reg = {0};
+      readRegister(handle, offsets[idx], &reg);
+      if (patterns[(round + idx) % patternsCount] != reg.asOffset) {
+        ret = -EIO;
+      }
+    }
+  }
+
+  for (uint8_t idx = 0; idx < offsetsCount; idx++) {
+    const union Adxl345Register reg = {.asOffset = 0};
+    writeRegister(handle, offsets[idx], &reg);
+  }
+  return ret;
+}
+
+static bool isOutputDataRateValid(uint8_t rate) {
   switch ((enum Adxl345Flags_BwRate_Rate)rate) {
   case Adxl345Flags_BwRate_Rate_normalPowerOdr3200:
   case Adxl345Flags_BwRate_Rate_normalPowerOdr1600:
@@ -137,16 +182,92 @@ int Adxl345_setOutputDataRate(struct Adxl345_Handle *handle, uint8_t rate) {
   case Adxl345Flags_BwRate_Rate_normalPowerOdr0_78:
   case Adxl345Flags_BwRate_Rate_normalPowerOdr0_39:
   case Adxl345Flags_BwRate_Rate_normalPowerOdr0_20:
-  case Adxl345Flags_BwRate_Rate_normalPowerOdr0_10: {
-    union Adxl345Register reg = {0};
-    readRegister(handle, Adxl345Flags_Address_bwRate, &reg);
-    reg.asBwRate.rate = (enum Adxl345Flags_BwRate_Rate)rate;
-    writeRegister(handle, Adxl345Flags_Address_bwRate, &reg);
-  } break;
+  case Adxl345Flags_BwRate_Rate_normalPowerOdr0_10:
+    return true;
+  default:
+    return false;
+  }
+}
 
+static bool isRangeValid(uint8_t range) {
+  switch ((enum Adxl345Flags_DataFormat_Range)range) {
+  case Adxl345Flags_DataFormat_Range_2g:
+  case Adxl345Flags_DataFormat_Range_4g:
+  case Adxl345Flags_DataFormat_Range_8g:
+  case Adxl345Flags_DataFormat_Range_16g:
+    return true;
   default:
+    return false;
+  }
+}
+
+static bool isScaleValid(uint8_t scale) {
+  switch ((enum Adxl345Flags_DataFormat_FullResBit)scale) {
+  case Adxl345Flags_DataFormat_FullResBit_10bit:
+  case Adxl345Flags_DataFormat_FullResBit_fullRes_4mg:
+    return true;
+  default:
+    return false;
+  }
+}
+
+int Adxl345_validateSetup(uint8_t rate,
+                          // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+                          uint8_t range, uint8_t scale, uint8_t watermark) {
+  if (!isOutputDataRateValid(rate) || !isRangeValid(range) ||
+      !isScaleValid(scale) || 0 == watermark ||
+      watermark >= ADXL345_FIFO_ENTRIES) {
     return -EINVAL;
   }
+  return 0;
+}
+
+int Adxl345_configure(struct Adxl345_Handle *handle, uint8_t rate,
+                      // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+                      uint8_t range, uint8_t scale, uint8_t watermark) {
+  const int ret = {Adxl345_validateSetup(rate, range, scale, watermark)};
+  if (0 != ret) {
+    return ret;
+  }
+
+  { // bandwidth rate: whole register is known, no need to read it first
+    union Adxl345Register reg = {
+        .asBwRate = {.rate = (enum Adxl345Flags_BwRate_Rate)rate,
+                     .lowPower = Adxl345Flags_BwRate_LowPower_normal,
+                     ._zeroD5 = 0,
+                     ._zeroD6 = 0,
+                     ._zeroD7 = 0}};
+    writeRegister(handle, Adxl345Flags_Address_bwRate, &reg);
+  }
+
+  { // data format: keep SPI and interrupt settings
+    union Adxl345Register reg = {0};
+    readRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
+    reg.asDataFormat.range = (enum Adxl345Flags_DataFormat_Range)range;
+    reg.asDataFormat.fullRes = (enum Adxl345Flags_DataFormat_FullResBit)scale;
+    writeRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
+  }
+
+  { // fifo control: whole register is known, no need to read it first
+    union Adxl345Register reg = {
+        .asFifoCtl = {.samples = watermark,
+                      .trigger = Adxl345Flags_FifoCtl_Trigger_int1,
+                      .fifoMode = Adxl345Flags_FifoCtl_FifoMode_fifo}};
+    writeRegister(handle, Adxl345Flags_Address_fifoCtl, &reg);
+  }
+
+  return 0;
+}
+
+int Adxl345_setOutputDataRate(struct Adxl345_Handle *handle, uint8_t rate) {
+  if (!isOutputDataRateValid(rate)) {
+    return -EINVAL;
+  }
+
+  union Adxl345Register reg = {0};
+  readRegister(handle, Adxl345Flags_Address_bwRate, &reg);
+  reg.asBwRate.rate = (enum Adxl345Flags_BwRate_Rate)rate;
+  writeRegister(handle, Adxl345Flags_Address_bwRate, &reg);
 
   return 0;
 }
@@ -166,21 +287,15 @@ int Adxl345_getOutputDataRate(struct Adxl345_Handle *handle,
 }
 
 int Adxl345_setRange(struct Adxl345_Handle *handle, uint8_t range) {
-  switch ((enum Adxl345Flags_DataFormat_Range)range) {
-  case Adxl345Flags_DataFormat_Range_2g:
-  case Adxl345Flags_DataFormat_Range_4g:
-  case Adxl345Flags_DataFormat_Range_8g:
-  case Adxl345Flags_DataFormat_Range_16g: {
-    union Adxl345Register reg = {0};
-    readRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
-    reg.asDataFormat.range = (enum Adxl345Flags_BwRate_Rate)range;
-    writeRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
-  } break;
-
-  default:
+  if (!isRangeValid(range)) {
     return -EINVAL;
   }
 
+  union Adxl345Register reg = {0};
+  readRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
+  reg.asDataFormat.range = (enum Adxl345Flags_BwRate_Rate)range;
+  writeRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
+
   return 0;
 }
 
@@ -211,19 +326,81 @@ int Adxl345_getScale(struct Adxl345_Handle *handle,
 }
 
 int Adxl345_setScale(struct Adxl345_Handle *handle, uint8_t scale) {
-  switch ((enum Adxl345Flags_DataFormat_FullResBit)scale) {
-  case Adxl345Flags_DataFormat_FullResBit_10bit:
-  case Adxl345Flags_DataFormat_FullResBit_fullRes_4mg: {
+  if (!isScaleValid(scale)) {
+    return -EINVAL;
+  }
+
+  union Adxl345Register reg = {0};
+  readRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
+  reg.asDataFormat.fullRes = (enum Adxl345Flags_DataFormat_FullResBit)scale;
+  writeRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
+
+  return 0;
+}
+
+int Adxl345_setActivityDetection(struct Adxl345_Handle *handle,
+                                 uint8_t threshold) {
+  const bool isEnabled = {0 < threshold};
+
+  if (isEnabled) {
+    union Adxl345Register reg = {.asThreshold = threshold};
+    writeRegister(handle, Adxl345Flags_Address_thresAct, &reg);
+  }
+
+  { // activity control: keep inactivity settings
     union Adxl345Register reg = {0};
-    readRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
-    reg.asDataFormat.fullRes = (enum Adxl345Flags_DataFormat_FullResBit)scale;
-    writeRegister(handle, Adxl345Flags_Address_dataFormat, &reg);
-  } break;
+    readRegister(handle, Adxl345Flags_Address_actInactCtl, &reg);
+    reg.asActInactCtl.actAcDc = Adxl345Flags_ActInactCtl_AcDc_ac;
+    reg.asActInactCtl.actX = isEnabled
+                                 ? Adxl345Flags_ActInactCtl_Enable_enable
+                                 : Adxl345Flags_ActInactCtl_Enable_disable;
+    reg.asActInactCtl.actY = reg.asActInactCtl.actX;
+    reg.asActInactCtl.actZ = reg.asActInactCtl.actX;
+    writeRegister(handle, Adxl345Flags_Address_actInactCtl, &reg);
+  }
 
-  default:
+  { // interrupt map: activity -> INT2 (shared with overrun)
+    union Adxl345Register reg = {0};
+    readRegister(handle, Adxl345Flags_Address_intMap, &reg);
+    reg.asIntMap.activity = Adxl345Flags_IntMap_Activity_int2;
+    writeRegister(handle, Adxl345Flags_Address_intMap, &reg);
+  }
+
+  { // interrupt enable
+    union Adxl345Register reg = {0};
+    readRegister(handle, Adxl345Flags_Address_intEnable, &reg);
+    reg.asIntEnable.activity = isEnabled
+                                   ? Adxl345Flags_IntEnable_Activity_enable
+                                   : Adxl345Flags_IntEnable_Activity_disable;
+    writeRegister(handle, Adxl345Flags_Address_intEnable, &reg);
+  }
+
+  return 0;
+}
+
+int Adxl345_getFifoStatus(struct Adxl345_Handle *handle,
+                          struct Adxl345Register_FifoStatus *status) {
+  if (NULL == status) {
     return -EINVAL;
   }
 
+  union Adxl345Register reg = {0};
+  readRegister(handle, Adxl345Flags_Address_fifoStatus, &reg);
+  *status = reg.asFifoStatus;
+
+  return 0;
+}
+
+int Adxl345_getInterruptSource(struct Adxl345_Handle *handle,
+                               struct Adxl345Register_IntSource *source) {
+  if (NULL == source) {
+    return -EINVAL;
+  }
+
+  union Adxl345Register reg = {0};
+  readRegister(handle, Adxl345Flags_Address_intSource, &reg);
+  *source = reg.asIntSource;
+
   return 0;
 }
 
@@ -256,3 +433,44 @@ int Adxl345_getAcceleration(struct Adxl345_Handle *handle,
 
   return 0;
 }
+
+int Adxl345_getAccelerationAxes(struct Adxl345_Handle *handle,
+                                struct Adxl345Transport_Acceleration *acc,
+                                uint8_t axes) {
+  if (NULL == acc || 0 == (axes & Adxl345_Axis_all)) {
+    return -EINVAL;
+  }
+
+  if (Adxl345_Axis_all == (axes & Adxl345_Axis_all)) {
+    return Adxl345_getAcceleration(handle, acc);
+  }
+
+  uint8_t first = {UINT8_MAX};
+  uint8_t last = {0};
+  for (uint8_t idx = 0; idx < 3U; idx++) {
+    if (axes & (1U << idx)) {
+      first = (UINT8_MAX == first) ? idx : first;
+      last = idx;
+    }
+  }
+
+  union Adxl345Transport_TxFrame tx_frame = {
+      .asAddress = Adxl345Flags_Address_dataX0 + first * sizeof(int16_t)};
+  union Adxl345Transport_RxFrame rx_frame = {0};
+  handle->doTransmitReceiveFrameImpl(&tx_frame, &rx_frame,
+                                     (last - first + 1U) * sizeof(int16_t));
+
+  // register order is x, y, z: shift the span into place
+  const int16_t read[3] = {rx_frame.asAcceleration.x,
+                           rx_frame.asAcceleration.y,
+                           rx_frame.asAcceleration.z};
+  int16_t values[3] = {0};
+  for (uint8_t idx = first; idx <= last; idx++) {
+    values[idx] = read[idx - first];
+  }
+  acc->x = values[0];
+  acc->y = values[1];
+  acc->z = values[2];
+
+  return 0;
+}
@@ -17,6 +17,8 @@ enum Adxl345Spi_RwFlags;
 enum Adxl345Flags_BwRate_Rate;
 enum Adxl345Flags_DataFormat_Range;
 enum Adxl345Flags_DataFormat_FullResBit;
+struct Adxl345Register_IntSource;
+struct Adxl345Register_FifoStatus;
 
 //@{
 /**
@@ -35,6 +37,12 @@ enum Adxl345Flags_DataFormat_FullResBit;
 #define ADXL345_WATERMARK_LEVEL 24U ///< about 75% of FiFo
 //@}
 
+/**
+ * Fixed content of DEVID register (Address 0x00).
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define ADXL345_DEVICE_ID 0xE5U
+
 // NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
 static_assert(ADXL345_WATERMARK_LEVEL <= ADXL345_FIFO_ENTRIES,
               "ERROR: maximum allowed watermark level: ADXL345_FIFO_ENTRIES");
@@ -43,6 +51,16 @@ static_assert(ADXL345_WATERMARK_LEVEL <= ADXL345_FIFO_ENTRIES,
 static_assert(ADXL345_WATERMARK_LEVEL >= 0,
               "ERROR: minimum allowed watermark level: 0");
 
+/**
+ * Axis selection bits for partial acceleration reads.
+ */
+enum Adxl345_Axis {
+  Adxl345_Axis_x = 1U << 0U,
+  Adxl345_Axis_y = 1U << 1U,
+  Adxl345_Axis_z = 1U << 2U,
+  Adxl345_Axis_all = Adxl345_Axis_x | Adxl345_Axis_y | Adxl345_Axis_z,
+};
+
 /**
  * The HW handle pointing to the underlying SPI communication implementation.
  */
@@ -76,6 +94,64 @@ struct Adxl345_Handle {
  */
 int Adxl345_init(struct Adxl345_Handle *handle);
 
+/**
+ * Tests whether an ADXL345 responds on the handle's chip select.
+ *
+ * An unpopulated chip select reads back a floating or idle MISO line which
+ * never matches the device ID.
+ *
+ * @param handle
+ * @return -ENODEV if DEVID does not match ADXL345_DEVICE_ID, 0 otherwise
+ */
+int Adxl345_probe(struct Adxl345_Handle *handle);
+
+/**
+ * Verifies SPI transfers at the current SPI clock.
+ *
+ * Reads DEVID, then writes test patterns to the offset registers OFSX, OFSY
+ * and OFSZ and reads them back. The offsets are left cleared: samples are
+ * calibrated by the controller, not by the sensor.
+ *
+ * @param handle
+ * @return -ENODEV if DEVID does not match ADXL345_DEVICE_ID, -EIO if a
+ * pattern reads back differently, 0 otherwise
+ */
+int Adxl345_verifyTransfer(struct Adxl345_Handle *handle);
+
+/**
+ * Validates a setup for Adxl345_configure() without touching any sensor.
+ *
+ * @param rate output data rate
+ * @param range measurement range
+ * @param scale resolution
+ * @param watermark FiFo watermark level in [1, ADXL345_FIFO_ENTRIES)
+ * @return -EINVAL if any argument is invalid, 0 otherwise
+ */
+int Adxl345_validateSetup(uint8_t rate, uint8_t range, uint8_t scale,
+                          uint8_t watermark);
+
+/**
+ * Applies output data rate, range, scale and FiFo watermark level at once.
+ *
+ * All values are validated before the sensor is touched
+ * \see Adxl345_validateSetup(), hence either the complete setup is applied or
+ * nothing. Registers which are fully determined
+ * by the arguments are written without reading them first.
+ *
+ * \see Adxl345Flags_BwRate_Rate
+ * \see Adxl345Flags_DataFormat_Range
+ * \see Adxl345Flags_DataFormat_FullResBit
+ *
+ * @param handle sensor pimpl
+ * @param rate output data rate
+ * @param range measurement range
+ * @param scale resolution
+ * @param watermark FiFo watermark level in [1, ADXL345_FIFO_ENTRIES)
+ * @return -EINVAL if any argument is invalid, 0 otherwise
+ */
+int Adxl345_configure(struct Adxl345_Handle *handle, uint8_t rate,
+                      uint8_t range, uint8_t scale, uint8_t watermark);
+
 //@{
 /**
  * Output data rate (ODR) setter/getter.
@@ -114,6 +190,46 @@ int Adxl345_getScale(struct Adxl345_Handle *handle,
 int Adxl345_setScale(struct Adxl345_Handle *handle, uint8_t scale);
 //@}
 
+/**
+ * Enables or disables the activity detection.
+ *
+ * Activity is detected AC-coupled on all axes and mapped to INT2 which is
+ * shared with the FiFo overrun interrupt. Hence on INT2 the interrupt source
+ * must be read to tell both apart.
+ *
+ * \see Adxl345_getInterruptSource()
+ *
+ * @param handle sensor pimpl
+ * @param threshold activity threshold (62.5 mg/LSB), 0 disables the detection
+ * @return 0
+ */
+int Adxl345_setActivityDetection(struct Adxl345_Handle *handle,
+                                 uint8_t threshold);
+
+/**
+ * Reads the FiFo status register.
+ *
+ * At least 5us must have passed since the last read of the data registers.
+ *
+ * @param handle sensor pimpl
+ * @param status output
+ * @return -EINVAL if status is NULL, 0 otherwise
+ */
+int Adxl345_getFifoStatus(struct Adxl345_Handle *handle,
+                          struct Adxl345Register_FifoStatus *status);
+
+/**
+ * Reads the interrupt source register.
+ *
+ * Reading clears the latched activity related bits.
+ *
+ * @param handle sensor pimpl
+ * @param source output
+ * @return -EINVAL if source is NULL, 0 otherwise
+ */
+int Adxl345_getInterruptSource(struct Adxl345_Handle *handle,
+                               struct Adxl345Register_IntSource *source);
+
 //@{
 /**
  * Sensor power mode.
@@ -132,3 +248,19 @@ void Adxl345_setPowerCtlMeasure(struct Adxl345_Handle *handle);
  */
 int Adxl345_getAcceleration(struct Adxl345_Handle *handle,
                             struct Adxl345Transport_Acceleration *acc);
+
+/**
+ * Read next acceleration from FiFo but transfer selected axes only.
+ *
+ * The data registers are read in a single burst spanning from the lowest to
+ * the highest selected axis, i.e. selecting x and z still transfers y.
+ * Axes not transferred are set to 0.
+ *
+ * @param handle
+ * @param acc output
+ * @param axes \see Adxl345_Axis
+ * @return -EINVAL if no axis is selected, 0 otherwise
+ */
+int Adxl345_getAccelerationAxes(struct Adxl345_Handle *handle,
+                                struct Adxl345Transport_Acceleration *acc,
+                                uint8_t axes);
@@ -366,6 +366,26 @@ enum Adxl345Flags_BwRate_LowPower {
   Adxl345Flags_BwRate_LowPower_reduced = 1U
 };
 
+/**
+ * ADXL345 register flags.
+ *
+ * See section Register Map in ADXL345 Data Sheet Rev.G (pp.24-28)
+ */
+enum Adxl345Flags_ActInactCtl_AcDc {
+  Adxl345Flags_ActInactCtl_AcDc_dc = 0,
+  Adxl345Flags_ActInactCtl_AcDc_ac = 1U
+};
+
+/**
+ * ADXL345 register flags.
+ *
+ * See section Register Map in ADXL345 Data Sheet Rev.G (pp.24-28)
+ */
+enum Adxl345Flags_ActInactCtl_Enable {
+  Adxl345Flags_ActInactCtl_Enable_disable = 0,
+  Adxl345Flags_ActInactCtl_Enable_enable = 1U
+};
+
 /**
  * ADXL345 register flags.
  *
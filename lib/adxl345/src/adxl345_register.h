@@ -52,6 +52,41 @@ struct Adxl345Register_IntEnable {
   uint8_t dataReady : 1;  ///< \see Adxl345Register_IntEnable_DataReady
 } __attribute__((packed));
 
+/**
+ * ADXL345 register.
+ *
+ * Same layout as Adxl345Register_IntEnable. Activity related bits are cleared
+ * by reading the register, watermark and overrun by reading the FiFo.
+ *
+ * See section Register Map in ADXL345 Data Sheet Rev.G (pp.24-28)
+ */
+struct Adxl345Register_IntSource {
+  uint8_t overrun : 1;
+  uint8_t watermark : 1;
+  uint8_t freeFall : 1;
+  uint8_t inactivity : 1;
+  uint8_t activity : 1;
+  uint8_t doubleTap : 1;
+  uint8_t singleTap : 1;
+  uint8_t dataReady : 1;
+} __attribute__((packed));
+
+/**
+ * ADXL345 register.
+ *
+ * See section Register Map in ADXL345 Data Sheet Rev.G (pp.24-28)
+ */
+struct Adxl345Register_ActInactCtl {
+  uint8_t inactZ : 1;    ///< \see Adxl345Register_ActInactCtl_Enable
+  uint8_t inactY : 1;    ///< \see Adxl345Register_ActInactCtl_Enable
+  uint8_t inactX : 1;    ///< \see Adxl345Register_ActInactCtl_Enable
+  uint8_t inactAcDc : 1; ///< \see Adxl345Register_ActInactCtl_AcDc
+  uint8_t actZ : 1;      ///< \see Adxl345Register_ActInactCtl_Enable
+  uint8_t actY : 1;      ///< \see Adxl345Register_ActInactCtl_Enable
+  uint8_t actX : 1;      ///< \see Adxl345Register_ActInactCtl_Enable
+  uint8_t actAcDc : 1;   ///< \see Adxl345Register_ActInactCtl_AcDc
+} __attribute__((packed));
+
 /**
  * ADXL345 register.
  *
@@ -123,6 +158,13 @@ union Adxl345Register {
   struct Adxl345Register_IntEnable
       asIntEnable;                        ///< cast to Adxl345Register_IntEnable
   struct Adxl345Register_IntMap asIntMap; ///< cast to Adxl345Register_IntMap
+  struct Adxl345Register_IntSource
+      asIntSource; ///< cast to Adxl345Register_IntSource
+  struct Adxl345Register_ActInactCtl
+      asActInactCtl;    ///< cast to Adxl345Register_ActInactCtl
+  uint8_t asThreshold; ///< THRESH_ACT/THRESH_INACT, 62.5 mg/LSB
+  uint8_t asDeviceId;  ///< DEVID, \see ADXL345_DEVICE_ID
+  uint8_t asOffset;    ///< OFSX/OFSY/OFSZ, two's complement, 15.6 mg/LSB
   struct Adxl345Register_FifoCtl asFifoCtl; ///< cast to Adxl345Register_FifoCtl
   struct Adxl345Register_FifoStatus
       asFifoStatus; ///< cast to Adxl345Register_FifoStatus
@@ -0,0 +1,136 @@
+/**
+ * \file calibration.c
+ *
+ * Fixed-point calibration of acceleration samples.
+ */
+
+#include "calibration.h"
+#include <errno.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <arm_acle.h>
+#define CALIBRATION_DSP 1
+#else
+#define CALIBRATION_DSP 0
+#endif
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CALIBRATION_AXES 3U
+
+static uint32_t packHalfWords(const int16_t lower, const int16_t upper) {
+  return (uint32_t)(uint16_t)lower | ((uint32_t)(uint16_t)upper << 16U);
+}
+
+int Calibration_configure(struct Calibration *calibration,
+                          const struct Calibration_Setup *setup) {
+  if (CALIBRATION_MAX_SHIFT < setup->shift) {
+    return -EINVAL;
+  }
+
+  calibration->rightShift = CALIBRATION_MAX_SHIFT - setup->shift;
+  calibration->rounding =
+      0 == calibration->rightShift
+          ? 0
+          : (int32_t)(1UL << (calibration->rightShift - 1U));
+  for (uint8_t row = 0; row < CALIBRATION_AXES; row++) {
+    calibration->rowsXy[row] =
+        packHalfWords(setup->matrix[row][0], setup->matrix[row][1]);
+    calibration->rowsZ[row] = setup->matrix[row][2];
+    calibration->offset[row] = setup->offset[row];
+  }
+  calibration->isEnabled = true;
+  return 0;
+}
+
+void Calibration_disable(struct Calibration *calibration) {
+  calibration->isEnabled = false;
+}
+
+int Calibration_setInputShift(struct Calibration *calibration,
+                              const uint8_t inputShift) {
+  if (CALIBRATION_MAX_INPUT_SHIFT < inputShift) {
+    return -EINVAL;
+  }
+  calibration->inputShift = inputShift;
+  return 0;
+}
+
+bool Calibration_isEnabled(const struct Calibration *calibration) {
+  return calibration->isEnabled;
+}
+
+/**
+ * Saturates the accumulated sum of three products, which exceeds 32 bit at
+ * full scale. The right shift is 15 bit at most, hence saturating before the
+ * shift still saturates the 16 bit result.
+ */
+static int32_t saturate32(const int64_t value) {
+  if (INT32_MAX < value) {
+    return INT32_MAX;
+  }
+  if (INT32_MIN > value) {
+    return INT32_MIN;
+  }
+  return (int32_t)value;
+}
+
+#if CALIBRATION_DSP
+
+static int16_t calibrateAxis(const struct Calibration *calibration,
+                             const uint8_t row, const uint32_t xy,
+                             const int16_t z) {
+  int64_t sum = {__smlald((int32_t)calibration->rowsXy[row], (int32_t)xy,
+                          calibration->rounding)};
+  sum += (int64_t)calibration->rowsZ[row] * z;
+  return (int16_t)__ssat((saturate32(sum) >> calibration->rightShift) +
+                             calibration->offset[row],
+                         16U);
+}
+
+#else
+
+static int16_t saturate16(const int32_t value) {
+  if (INT16_MAX < value) {
+    return INT16_MAX;
+  }
+  if (INT16_MIN > value) {
+    return INT16_MIN;
+  }
+  return (int16_t)value;
+}
+
+static int16_t calibrateAxis(const struct Calibration *calibration,
+                             const uint8_t row, const uint32_t xy,
+                             const int16_t z) {
+  const uint32_t coefficients = {calibration->rowsXy[row]};
+  const int64_t sum = {
+      (int64_t)(int16_t)(coefficients & 0xffffU) * (int16_t)(xy & 0xffffU) +
+      (int64_t)(int16_t)(coefficients >> 16U) * (int16_t)(xy >> 16U) +
+      (int64_t)calibration->rowsZ[row] * z + calibration->rounding};
+  // arithmetic shift, as the DSP path
+  return saturate16((saturate32(sum) >> calibration->rightShift) +
+                    calibration->offset[row]);
+}
+
+#endif
+
+void Calibration_apply(const struct Calibration *calibration,
+                       struct Calibration_Acceleration *samples,
+                       const uint16_t count) {
+  if (!calibration->isEnabled) {
+    return;
+  }
+
+  const uint8_t inputShift = {calibration->inputShift};
+  for (uint16_t idx = 0; idx < count; idx++) {
+    struct Calibration_Acceleration *sample = {&samples[idx]};
+    const int16_t x = {(int16_t)(sample->x * (1 << inputShift))};
+    const int16_t y = {(int16_t)(sample->y * (1 << inputShift))};
+    const int16_t z = {(int16_t)(sample->z * (1 << inputShift))};
+    const uint32_t xy = {packHalfWords(x, y)};
+
+    sample->x = calibrateAxis(calibration, 0, xy, z);
+    sample->y = calibrateAxis(calibration, 1, xy, z);
+    sample->z = calibrateAxis(calibration, 2, xy, z);
+  }
+}
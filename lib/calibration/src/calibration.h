@@ -0,0 +1,130 @@
+/**
+ * \file calibration.h
+ *
+ * Fixed-point calibration of acceleration samples.
+ *
+ * Each sample is mapped per output axis i by
+ *
+ *   out[i] = saturate16(((sum_j M[i][j] * in[j]) >> (15 - shift)) + offset[i])
+ *
+ * M holds Q15 coefficients combining the mounting rotation and the per-axis
+ * gain, shift widens M beyond +-1 and offset is given in output LSB. The
+ * right shift rounds to nearest. The input is normalized to the full
+ * resolution LSB (3.9mg) before, \see Calibration_setInputShift(), hence one
+ * setup holds for every range and scale.
+ *
+ * On cores with DSP extension (Cortex-M4) a row takes one dual and one single
+ * 16 bit multiply-accumulate and one saturation, the C fallback yields the
+ * same results.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/**
+ * Largest widening of the matrix: coefficients up to +-2^15.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CALIBRATION_MAX_SHIFT 15U
+
+/**
+ * Largest input normalization: 10 bit resolution at +-16g.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CALIBRATION_MAX_INPUT_SHIFT 3U
+
+struct Calibration_Acceleration {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} __attribute__((packed));
+
+/**
+ * Calibration as uploaded by the host.
+ */
+struct Calibration_Setup {
+  int16_t matrix[3][3]; ///< Q15, one row per output axis x, y, z
+  int16_t offset[3];    ///< added to each output axis, output LSB
+  uint8_t shift;        ///< left shift of M, 0 to CALIBRATION_MAX_SHIFT
+};
+
+/**
+ * Calibration state.
+ *
+ * Example, mounted rotated by 90 degrees about z, gain 1, no offset:
+ * \code
+ * struct Calibration calibration = CALIBRATION_INITIALIZER;
+ * const struct Calibration_Setup setup = {
+ *     .matrix = {{0, 16384, 0}, {-16384, 0, 0}, {0, 0, 16384}},
+ *     .offset = {0, 0, 0},
+ *     .shift = 1};
+ * Calibration_configure(&calibration, &setup);
+ *
+ * Calibration_apply(&calibration, samples, count);
+ * \endcode
+ */
+struct Calibration {
+  bool isEnabled;
+  uint8_t inputShift; ///< normalizes the input to full resolution LSB
+  uint8_t rightShift; ///< 15 - Calibration_Setup.shift
+  int32_t rounding;   ///< half of the right shift's LSB
+  uint32_t rowsXy[3]; ///< M[i][0] in lower, M[i][1] in upper half word
+  int32_t rowsZ[3];   ///< M[i][2]
+  int16_t offset[3];
+};
+
+#define CALIBRATION_INITIALIZER                                                \
+  {                                                                            \
+    .isEnabled = false, .inputShift = 0, .rightShift = 0, .rounding = 0,       \
+    .rowsXy = {0}, .rowsZ = {0}, .offset = {0},                                \
+  }
+
+/**
+ * Applies a setup and enables the calibration.
+ *
+ * @param calibration
+ * @param setup
+ * @return 0 on success, -EINVAL if the shift exceeds CALIBRATION_MAX_SHIFT
+ */
+int Calibration_configure(struct Calibration *calibration,
+                          const struct Calibration_Setup *setup);
+
+/**
+ * Disables the calibration, samples pass unchanged.
+ *
+ * @param calibration
+ */
+void Calibration_disable(struct Calibration *calibration);
+
+/**
+ * Sets the normalization of the input to full resolution LSB.
+ *
+ * In 10 bit mode the LSB doubles with each range step, hence the shift is the
+ * range \see Adxl345Register_DataFormat_Range; in full resolution mode it is
+ * 0. Inputs are expected within 13 bit after normalization.
+ *
+ * @param calibration
+ * @param inputShift 0 to CALIBRATION_MAX_INPUT_SHIFT
+ * @return 0 on success, -EINVAL if out of range
+ */
+int Calibration_setInputShift(struct Calibration *calibration,
+                              uint8_t inputShift);
+
+/**
+ * @param calibration
+ * @return true if samples are calibrated
+ */
+bool Calibration_isEnabled(const struct Calibration *calibration);
+
+/**
+ * Calibrates samples in place, leaves them unchanged if disabled.
+ *
+ * @param calibration
+ * @param samples
+ * @param count number of samples
+ */
+void Calibration_apply(const struct Calibration *calibration,
+                       struct Calibration_Acceleration *samples,
+                       uint16_t count);
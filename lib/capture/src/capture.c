@@ -0,0 +1,77 @@
+/**
+ * \file capture.c
+ *
+ * Linear capture buffer implementation.
+ */
+
+#include "capture.h"
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+
+int Capture_init(struct Capture *capture, uint8_t *storage,
+                 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+                 uint16_t capacity, uint8_t itemSizeBytes) {
+  if (NULL == capture || NULL == storage || 0 == itemSizeBytes) {
+    return -EINVAL;
+  }
+
+  capture->storage = storage;
+  capture->capacity = capacity;
+  capture->count = 0;
+  capture->itemSizeBytes = itemSizeBytes;
+
+  return 0;
+}
+
+int Capture_append(struct Capture *capture, const void *items,
+                   uint16_t count) {
+  if (NULL == items) {
+    return -EINVAL;
+  }
+
+  const uint16_t freeCount = {capture->capacity - capture->count};
+  const uint16_t storeCount = {count < freeCount ? count : freeCount};
+
+  memcpy(capture->storage + ((uint32_t)capture->count * capture->itemSizeBytes),
+         items, (uint32_t)storeCount * capture->itemSizeBytes);
+  capture->count += storeCount;
+
+  return storeCount < count ? -ENOMEM : 0;
+}
+
+const void *Capture_itemsAt(const struct Capture *capture, uint16_t offset,
+                            uint16_t *availableCount) {
+  if (offset >= capture->count) {
+    if (NULL != availableCount) {
+      *availableCount = 0;
+    }
+    return NULL;
+  }
+
+  if (NULL != availableCount) {
+    *availableCount = capture->count - offset;
+  }
+  return capture->storage + ((uint32_t)offset * capture->itemSizeBytes);
+}
+
+uint16_t Capture_count(const struct Capture *capture) { return capture->count; }
+
+uint16_t Capture_capacity(const struct Capture *capture) {
+  return capture->capacity;
+}
+
+bool Capture_isFull(const struct Capture *capture) {
+  return capture->count >= capture->capacity;
+}
+
+int Capture_setCount(struct Capture *capture, uint16_t count) {
+  if (count > capture->capacity) {
+    return -EINVAL;
+  }
+
+  capture->count = count;
+  return 0;
+}
+
+void Capture_reset(struct Capture *capture) { capture->count = 0; }
@@ -0,0 +1,112 @@
+/**
+ * \file capture.h
+ *
+ * Linear buffer for capturing items of constant size to RAM.
+ *
+ * Items are appended until the buffer is exhausted and read back at arbitrary
+ * offsets afterwards. Unlike Ringbuffer items are not consumed by reading,
+ * hence an interrupted read out can be resumed at any offset.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/**
+ * Capture buffer state.
+ *
+ * Example:
+ * \code
+ * #define CAPACITY 16
+ *
+ * struct Foo {
+ *   uint16_t data;
+ * };
+ *
+ * struct Foo storage[CAPACITY];
+ * struct Capture capture;
+ * Capture_init(&capture, (uint8_t *)&storage, CAPACITY, sizeof(struct Foo));
+ *
+ * struct Foo item = {};
+ * Capture_append(&capture, &item, 1);
+ *
+ * uint16_t available = {0};
+ * const struct Foo *first = Capture_itemsAt(&capture, 0, &available);
+ * \endcode
+ */
+struct Capture {
+  uint8_t *storage;      ///< must be uint8_t for proper pointer arithmetics
+  uint16_t capacity;     ///< maximum number of storable items
+  uint16_t count;        ///< currently stored items
+  uint8_t itemSizeBytes; ///< size of one item in bytes
+};
+
+#define CAPTURE_INITIALIZER(STORAGE_NAME, CAPACITY, ITEM_SIZE_BYTES)           \
+  {                                                                            \
+    .storage = (STORAGE_NAME), .capacity = (CAPACITY), .count = 0,             \
+    .itemSizeBytes = (ITEM_SIZE_BYTES),                                        \
+  }
+
+int Capture_init(struct Capture *capture, uint8_t *storage, uint16_t capacity,
+                 uint8_t itemSizeBytes);
+
+/**
+ * Appends items as long as capacity is left.
+ *
+ * @param capture
+ * @param items input data, count * itemSizeBytes
+ * @param count number of items
+ * @return -ENOMEM if not all items fit (the fitting ones are stored), 0
+ * otherwise
+ */
+int Capture_append(struct Capture *capture, const void *items,
+                   uint16_t count);
+
+/**
+ * Provides direct access to stored items starting at offset.
+ *
+ * @param capture
+ * @param offset index of first item
+ * @param availableCount output: number of items stored from offset on
+ * @return pointer to item at offset, NULL if offset is beyond stored items
+ */
+const void *Capture_itemsAt(const struct Capture *capture, uint16_t offset,
+                            uint16_t *availableCount);
+
+/**
+ * @param capture
+ * @return number of stored items
+ */
+uint16_t Capture_count(const struct Capture *capture);
+
+/**
+ * @param capture
+ * @return maximum number of storable items
+ */
+uint16_t Capture_capacity(const struct Capture *capture);
+
+/**
+ * Tests whether the capacity is exhausted.
+ *
+ * @param capture
+ * @return true if no further item can be appended
+ */
+bool Capture_isFull(const struct Capture *capture);
+
+/**
+ * Adopts items which were written to the storage by other means, i.e. by a
+ * linearized Ringbuffer sharing the same storage.
+ *
+ * @param capture
+ * @param count number of valid items at the beginning of the storage
+ * @return -EINVAL if count exceeds the capacity, 0 otherwise
+ */
+int Capture_setCount(struct Capture *capture, uint16_t count);
+
+/**
+ * Discards all items without zeroing out the storage.
+ *
+ * @param capture
+ */
+void Capture_reset(struct Capture *capture);
@@ -0,0 +1,409 @@
+/**
+ * \file capture_file.c
+ */
+
+#define _GNU_SOURCE
+#include "capture_file.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define PAGE_BYTES 4096U
+
+/**
+ * Size of a block's columns.
+ */
+#define BLOCK_BYTES(BLOCK_SAMPLES)                                             \
+  ((uint64_t)CAPTUREFILE_AXES * (BLOCK_SAMPLES) * sizeof(int16_t))
+
+static_assert(sizeof(struct CaptureFile_Header) <= CAPTUREFILE_HEADER_BYTES,
+              "ERROR: header exceeds its room");
+static_assert(0 == BLOCK_BYTES(CAPTUREFILE_BLOCK_SAMPLES) / CAPTUREFILE_AXES %
+                       PAGE_BYTES,
+              "ERROR: columns must stay page aligned");
+
+static uint64_t nowNs(clockid_t clock) {
+  struct timespec now;
+  clock_gettime(clock, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static struct CaptureFile_Header *mutableHeader(struct CaptureFile *file) {
+  return (struct CaptureFile_Header *)file->map;
+}
+
+static struct CaptureFile_Block *mutableBlocks(struct CaptureFile *file) {
+  return (struct CaptureFile_Block *)&file
+      ->map[mutableHeader(file)->indexOffset];
+}
+
+static struct CaptureFile_Marker *mutableMarkers(struct CaptureFile *file) {
+  return (struct CaptureFile_Marker *)&file
+      ->map[mutableHeader(file)->markersOffset];
+}
+
+static int16_t *mutableColumn(struct CaptureFile *file, uint32_t block,
+                              enum CaptureFile_Axis axis) {
+  const struct CaptureFile_Header *header = {mutableHeader(file)};
+  return (int16_t *)&file->map[header->blocksOffset +
+                               block * BLOCK_BYTES(header->blockSamples) +
+                               axis * header->blockSamples * sizeof(int16_t)];
+}
+
+/**
+ * Grows file and mapping to hold at least requiredBytes.
+ *
+ * @param file
+ * @param requiredBytes
+ * @param stepBytes granularity of growth
+ * @return 0 on success, negative errno on failure
+ */
+static int grow(struct CaptureFile *file, size_t requiredBytes,
+                size_t stepBytes) {
+  size_t mapBytes = {file->mapBytes};
+  while (mapBytes < requiredBytes) {
+    mapBytes += stepBytes;
+  }
+  if (mapBytes == file->mapBytes) {
+    return 0;
+  }
+
+  if (0 != ftruncate(file->fd, (off_t)mapBytes)) {
+    return -errno;
+  }
+
+  void *map = {NULL == file->map
+                   ? mmap(NULL, mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          file->fd, 0)
+                   : mremap(file->map, file->mapBytes, mapBytes,
+                            MREMAP_MAYMOVE)};
+  if (MAP_FAILED == map) {
+    return -errno;
+  }
+
+  file->map = map;
+  file->mapBytes = mapBytes;
+  return 0;
+}
+
+int CaptureFile_create(struct CaptureFile *file, const char *path,
+                       const struct CaptureFile_Source *source) {
+  file->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (0 > file->fd) {
+    return -errno;
+  }
+  file->map = NULL;
+  file->mapBytes = 0;
+  file->isWritable = true;
+  file->resolvedMarkers = 0;
+
+  const uint64_t indexOffset = {CAPTUREFILE_HEADER_BYTES};
+  const uint64_t markersOffset = {
+      indexOffset + CAPTUREFILE_MAX_BLOCKS * sizeof(struct CaptureFile_Block)};
+  const uint64_t blocksOffset = {
+      (markersOffset +
+       CAPTUREFILE_MAX_MARKERS * sizeof(struct CaptureFile_Marker) +
+       PAGE_BYTES - 1U) /
+      PAGE_BYTES * PAGE_BYTES};
+
+  // the tables stay holes until written
+  const int result = {grow(file, blocksOffset, blocksOffset)};
+  if (0 != result) {
+    close(file->fd);
+    file->fd = -1;
+    return result;
+  }
+
+  struct CaptureFile_Header *header = {mutableHeader(file)};
+  memcpy(header->magic, CAPTUREFILE_MAGIC, sizeof(header->magic));
+  header->version = CAPTUREFILE_VERSION;
+  header->blockSamples = CAPTUREFILE_BLOCK_SAMPLES;
+  header->maxBlocks = CAPTUREFILE_MAX_BLOCKS;
+  header->maxMarkers = CAPTUREFILE_MAX_MARKERS;
+  header->indexOffset = indexOffset;
+  header->markersOffset = markersOffset;
+  header->blocksOffset = blocksOffset;
+  header->samplesCount = 0;
+  header->blocksCount = 0;
+  header->markersCount = 0;
+  header->periodNs = source->periodNs;
+  header->monotonicNs = nowNs(CLOCK_MONOTONIC);
+  header->realtimeNs = nowNs(CLOCK_REALTIME);
+  header->firmware = source->firmware;
+  header->setup = source->setup;
+  header->sensor = source->sensor;
+  strncpy(header->source, source->path, sizeof(header->source) - 1U);
+  return 0;
+}
+
+/**
+ * Places the markers not yet placed in front of the next sample of a block.
+ *
+ * @param file
+ * @param block number of block the next sample is appended to
+ */
+static void resolveMarkers(struct CaptureFile *file, uint32_t block) {
+  const uint32_t markersCount = {mutableHeader(file)->markersCount};
+  struct CaptureFile_Block *entry = {&mutableBlocks(file)[block]};
+
+  for (; file->resolvedMarkers < markersCount; file->resolvedMarkers++) {
+    struct CaptureFile_Marker *marker = {
+        &mutableMarkers(file)[file->resolvedMarkers]};
+    marker->position =
+        (uint64_t)block * mutableHeader(file)->blockSamples + entry->count;
+    marker->sampleIndex = entry->firstIndex + entry->count;
+    if (0 == entry->markersCount) {
+      entry->firstMarker = file->resolvedMarkers;
+    }
+    entry->markersCount++;
+  }
+}
+
+/**
+ * Begins a new block unless the current one continues with firstIndex.
+ *
+ * @param file
+ * @param firstIndex sample index of the next sample
+ * @param firstStampNs host time of the next sample
+ * @return number of block to append to, -ENOSPC if the block index is
+ * exhausted, negative errno if the file could not grow
+ */
+static int64_t blockFor(struct CaptureFile *file, uint64_t firstIndex,
+                        uint64_t firstStampNs) {
+  const struct CaptureFile_Header *header = {mutableHeader(file)};
+  const uint32_t blocksCount = {header->blocksCount};
+
+  if (0 < blocksCount) {
+    const struct CaptureFile_Block *last = {
+        &mutableBlocks(file)[blocksCount - 1U]};
+    const uint64_t nextIndex = {last->firstIndex + last->count};
+    if (nextIndex == firstIndex && last->count < header->blockSamples) {
+      return blocksCount - 1U;
+    }
+    if (nextIndex < firstIndex) {
+      CaptureFile_mark(file, CaptureFile_MarkerKind_Gap,
+                       (uint32_t)(firstIndex - nextIndex));
+    }
+  }
+
+  if (header->maxBlocks == blocksCount) {
+    return -ENOSPC;
+  }
+  const uint64_t blockBytes = {BLOCK_BYTES(header->blockSamples)};
+  const int result = {grow(file,
+                           header->blocksOffset +
+                               (blocksCount + 1U) * blockBytes,
+                           CAPTUREFILE_GROW_BLOCKS * blockBytes)};
+  if (0 != result) {
+    return result;
+  }
+
+  struct CaptureFile_Block *entry = {&mutableBlocks(file)[blocksCount]};
+  entry->firstIndex = firstIndex;
+  entry->firstStampNs = firstStampNs;
+  entry->lastStampNs = firstStampNs;
+  entry->count = 0;
+  entry->firstMarker = 0;
+  entry->markersCount = 0;
+  mutableHeader(file)->blocksCount = blocksCount + 1U;
+  return blocksCount;
+}
+
+int CaptureFile_append(struct CaptureFile *file,
+                       const struct Transport_Acceleration *samples,
+                       uint32_t count, uint64_t firstIndex,
+                       uint64_t firstStampNs) {
+  while (0 < count) {
+    const int64_t block = {blockFor(file, firstIndex, firstStampNs)};
+    if (0 > block) {
+      return (int)block;
+    }
+    resolveMarkers(file, block);
+
+    struct CaptureFile_Header *header = {mutableHeader(file)};
+    struct CaptureFile_Block *entry = {&mutableBlocks(file)[block]};
+    const uint32_t room = {header->blockSamples - entry->count};
+    const uint32_t takenCount = {count < room ? count : room};
+
+    const uint32_t offset = {entry->count};
+    int16_t *x = {&mutableColumn(file, block, CaptureFile_Axis_X)[offset]};
+    int16_t *y = {&mutableColumn(file, block, CaptureFile_Axis_Y)[offset]};
+    int16_t *z = {&mutableColumn(file, block, CaptureFile_Axis_Z)[offset]};
+    for (uint32_t idx = 0; idx < takenCount; idx++) {
+      x[idx] = samples[idx].x;
+      y[idx] = samples[idx].y;
+      z[idx] = samples[idx].z;
+    }
+
+    // publish after the samples are in place
+    entry->lastStampNs = firstStampNs + (takenCount - 1U) * header->periodNs;
+    entry->count += takenCount;
+    header->samplesCount += takenCount;
+
+    samples += takenCount;
+    count -= takenCount;
+    firstIndex += takenCount;
+    firstStampNs += takenCount * header->periodNs;
+  }
+
+  return 0;
+}
+
+int CaptureFile_mark(struct CaptureFile *file, enum CaptureFile_MarkerKind kind,
+                     uint32_t value) {
+  struct CaptureFile_Header *header = {mutableHeader(file)};
+  if (header->maxMarkers == header->markersCount) {
+    return -ENOSPC;
+  }
+
+  struct CaptureFile_Marker *marker = {
+      &mutableMarkers(file)[header->markersCount]};
+  marker->position = UINT64_MAX;
+  marker->sampleIndex = UINT64_MAX;
+  marker->kind = kind;
+  marker->value = value;
+  header->markersCount++;
+  return 0;
+}
+
+int CaptureFile_open(struct CaptureFile *file, const char *path) {
+  file->fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (0 > file->fd) {
+    return -errno;
+  }
+
+  struct stat status;
+  if (0 != fstat(file->fd, &status)) {
+    const int result = {-errno};
+    close(file->fd);
+    return result;
+  }
+
+  file->mapBytes = 0;
+  file->isWritable = false;
+  file->resolvedMarkers = 0;
+  file->map = MAP_FAILED;
+  if (CAPTUREFILE_HEADER_BYTES <= (size_t)status.st_size) {
+    file->map = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, file->fd, 0);
+  }
+  if (MAP_FAILED == file->map) {
+    close(file->fd);
+    return -EBADMSG;
+  }
+  file->mapBytes = status.st_size;
+
+  // the tables and blocks in use must lie within the file
+  const struct CaptureFile_Header *header = {CaptureFile_header(file)};
+  const uint64_t indexEnd = {header->indexOffset +
+                             (uint64_t)header->maxBlocks *
+                                 sizeof(struct CaptureFile_Block)};
+  const uint64_t markersEnd = {header->markersOffset +
+                               (uint64_t)header->maxMarkers *
+                                   sizeof(struct CaptureFile_Marker)};
+  const uint64_t blocksEnd = {header->blocksOffset +
+                              header->blocksCount *
+                                  BLOCK_BYTES(header->blockSamples)};
+  if (0 != memcmp(header->magic, CAPTUREFILE_MAGIC, sizeof(header->magic)) ||
+      CAPTUREFILE_VERSION != header->version || 0 == header->blockSamples ||
+      header->maxBlocks < header->blocksCount ||
+      header->maxMarkers < header->markersCount ||
+      header->indexOffset < CAPTUREFILE_HEADER_BYTES ||
+      header->markersOffset < indexEnd || header->blocksOffset < markersEnd ||
+      file->mapBytes < blocksEnd) {
+    munmap(file->map, file->mapBytes);
+    close(file->fd);
+    return -EBADMSG;
+  }
+
+  return 0;
+}
+
+const struct CaptureFile_Header *
+CaptureFile_header(const struct CaptureFile *file) {
+  return (const struct CaptureFile_Header *)file->map;
+}
+
+const struct CaptureFile_Block *
+CaptureFile_blocks(const struct CaptureFile *file) {
+  return (const struct CaptureFile_Block *)&file
+      ->map[CaptureFile_header(file)->indexOffset];
+}
+
+const struct CaptureFile_Marker *
+CaptureFile_markers(const struct CaptureFile *file) {
+  return (const struct CaptureFile_Marker *)&file
+      ->map[CaptureFile_header(file)->markersOffset];
+}
+
+const int16_t *CaptureFile_column(const struct CaptureFile *file,
+                                  uint32_t block, enum CaptureFile_Axis axis) {
+  const struct CaptureFile_Header *header = {CaptureFile_header(file)};
+  if (header->blocksCount <= block || CAPTUREFILE_AXES <= (unsigned)axis) {
+    return NULL;
+  }
+  return (const int16_t
+              *)&file->map[header->blocksOffset +
+                           block * BLOCK_BYTES(header->blockSamples) +
+                           axis * header->blockSamples * sizeof(int16_t)];
+}
+
+int CaptureFile_findBlock(const struct CaptureFile *file, uint32_t fromBlock,
+                          uint64_t sampleIndex) {
+  const uint32_t blocksCount = {CaptureFile_header(file)->blocksCount};
+  const struct CaptureFile_Block *blocks = {CaptureFile_blocks(file)};
+
+  for (uint32_t block = fromBlock; block < blocksCount; block++) {
+    if (blocks[block].firstIndex <= sampleIndex &&
+        sampleIndex - blocks[block].firstIndex < blocks[block].count) {
+      return (int)block;
+    }
+  }
+  return -ENOENT;
+}
+
+const struct CaptureFile_Marker *
+CaptureFile_findMarker(const struct CaptureFile *file,
+                       enum CaptureFile_MarkerKind kind, uint32_t value) {
+  const uint32_t markersCount = {CaptureFile_header(file)->markersCount};
+  const struct CaptureFile_Marker *markers = {CaptureFile_markers(file)};
+
+  for (uint32_t idx = 0; idx < markersCount; idx++) {
+    if (kind == markers[idx].kind && value == markers[idx].value) {
+      return &markers[idx];
+    }
+  }
+  return NULL;
+}
+
+void CaptureFile_close(struct CaptureFile *file) {
+  if (0 > file->fd) {
+    return;
+  }
+
+  uint64_t fileBytes = {0};
+  if (file->isWritable) {
+    struct CaptureFile_Header *header = {mutableHeader(file)};
+    fileBytes = header->blocksOffset +
+                header->blocksCount * BLOCK_BYTES(header->blockSamples);
+
+    // markers trailing the last sample
+    if (0 < header->blocksCount) {
+      resolveMarkers(file, header->blocksCount - 1U);
+    }
+  }
+
+  munmap(file->map, file->mapBytes);
+  // drop the room reserved for growing
+  if (file->isWritable && 0 != ftruncate(file->fd, (off_t)fileBytes)) {
+    file->isWritable = false;
+  }
+  close(file->fd);
+  file->fd = -1;
+  file->map = NULL;
+  file->mapBytes = 0;
+}
@@ -0,0 +1,285 @@
+/**
+ * \file capture_file.h
+ *
+ * Memory-mapped columnar capture file of one sensor's samples.
+ *
+ * Layout, all little endian and packed:
+ *
+ *   - CaptureFile_Header, padded to CAPTUREFILE_HEADER_BYTES
+ *   - block index: CaptureFile_Header.maxBlocks entries of CaptureFile_Block
+ *     at CaptureFile_Header.indexOffset
+ *   - marker table: CaptureFile_Header.maxMarkers entries of
+ *     CaptureFile_Marker at CaptureFile_Header.markersOffset
+ *   - blocks at CaptureFile_Header.blocksOffset, each holding one int16_t
+ *     column per axis of CaptureFile_Header.blockSamples samples
+ *
+ * Columns start page aligned, hence a column can be handed over to numpy or
+ * an FFT straight from the mapping. A block holds consecutive sample indices
+ * only: lost samples and restarts begin a new block, which may leave the
+ * previous one partially filled. Unused index and marker entries are holes
+ * in the file and take no disk space.
+ *
+ * Counts in the header are updated after the data they refer to, hence a
+ * file can be read while it grows.
+ *
+ * Example, reading the samples of a sequence segment:
+ * \code
+ * struct CaptureFile file = CAPTUREFILE_INITIALIZER;
+ * CaptureFile_open(&file, "sensor0.cap");
+ *
+ * const struct CaptureFile_Marker *marker = {
+ *     CaptureFile_findMarker(&file, CaptureFile_MarkerKind_Segment, 3)};
+ * const uint32_t block = {
+ *     marker->position / CaptureFile_header(&file)->blockSamples};
+ * const int16_t *x = {CaptureFile_column(&file, block, CaptureFile_Axis_X)};
+ * \endcode
+ */
+
+#pragma once
+
+#include <host_transport_types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Identifies the file type.
+ */
+#define CAPTUREFILE_MAGIC "3DPAXCAP"
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTUREFILE_VERSION 1U
+
+/**
+ * Room reserved for the header, keeps the tables page aligned.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTUREFILE_HEADER_BYTES 4096U
+
+/**
+ * Samples per block, each column takes two pages.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTUREFILE_BLOCK_SAMPLES 4096U
+
+/**
+ * Capacity of the block index, about 23h at 3200Hz.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTUREFILE_MAX_BLOCKS 65536U
+
+/**
+ * Capacity of the marker table.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTUREFILE_MAX_MARKERS 65536U
+
+/**
+ * The file grows by this number of blocks while recording.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTUREFILE_GROW_BLOCKS 64U
+
+enum CaptureFile_Axis {
+  CaptureFile_Axis_X = 0,
+  CaptureFile_Axis_Y = 1,
+  CaptureFile_Axis_Z = 2,
+};
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTUREFILE_AXES 3U
+
+/**
+ * Events recorded in between samples.
+ */
+enum CaptureFile_MarkerKind {
+  CaptureFile_MarkerKind_Start = 1U,   ///< sampling started
+  CaptureFile_MarkerKind_Stop = 2U,    ///< sampling stopped or finished
+  CaptureFile_MarkerKind_Segment = 3U, ///< value: sequence segment
+  CaptureFile_MarkerKind_Gap = 4U,     ///< value: number of samples lost
+};
+
+struct CaptureFile_Header {
+  char magic[8];          ///< CAPTUREFILE_MAGIC without termination
+  uint32_t version;       ///< CAPTUREFILE_VERSION
+  uint32_t blockSamples;  ///< samples per block
+  uint32_t maxBlocks;     ///< capacity of the block index
+  uint32_t maxMarkers;    ///< capacity of the marker table
+  uint64_t indexOffset;   ///< file offset of the block index
+  uint64_t markersOffset; ///< file offset of the marker table
+  uint64_t blocksOffset;  ///< file offset of the first block
+  uint64_t samplesCount;  ///< number of samples in all blocks
+  uint32_t blocksCount;   ///< number of blocks in use
+  uint32_t markersCount;  ///< number of markers
+  uint64_t periodNs;      ///< sample period
+  uint64_t monotonicNs;   ///< CLOCK_MONOTONIC at creation
+  uint64_t realtimeNs;    ///< CLOCK_REALTIME at creation
+  struct TransportTx_FirmwareVersion firmware; ///< of the recording device
+  struct TransportTx_DeviceSetup setup;        ///< sensor setup at start
+  uint8_t sensor;     ///< sensor ID within the device
+  uint8_t padding[3]; ///< zero
+  char source[64];    ///< device path, zero terminated
+} __attribute__((packed));
+
+/**
+ * Entry of the block index.
+ */
+struct CaptureFile_Block {
+  uint64_t firstIndex;   ///< sample index of the first sample, unwrapped
+  uint64_t firstStampNs; ///< host time of the first sample
+  uint64_t lastStampNs;  ///< host time of the last sample
+  uint32_t count;        ///< number of samples in the block
+  uint32_t firstMarker;  ///< first marker placed within the block
+  uint32_t markersCount; ///< number of markers placed within the block
+} __attribute__((packed));
+
+/**
+ * Event placed in front of a sample.
+ *
+ * Position and sample index are UINT64_MAX until the next sample is appended.
+ */
+struct CaptureFile_Marker {
+  uint64_t position;    ///< block * blockSamples + offset of next sample
+  uint64_t sampleIndex; ///< sample index of next sample, unwrapped
+  uint32_t kind;        ///< \see CaptureFile_MarkerKind
+  uint32_t value;       ///< depends on kind
+} __attribute__((packed));
+
+/**
+ * Device and sensor a file is recorded from.
+ */
+struct CaptureFile_Source {
+  const char *path;                            ///< device path
+  uint8_t sensor;                              ///< sensor ID within device
+  uint64_t periodNs;                           ///< sample period
+  struct TransportTx_FirmwareVersion firmware; ///< zero if unknown
+  struct TransportTx_DeviceSetup setup;        ///< sensor setup at start
+};
+
+struct CaptureFile {
+  int fd;
+  uint8_t *map;             ///< whole file
+  size_t mapBytes;          ///< size of mapping and file while recording
+  bool isWritable;          ///< created for recording
+  uint32_t resolvedMarkers; ///< markers placed at a sample already
+};
+
+#define CAPTUREFILE_INITIALIZER                                                \
+  {                                                                            \
+    .fd = -1, .map = NULL, .mapBytes = 0, .isWritable = false,                 \
+    .resolvedMarkers = 0,                                                      \
+  }
+
+/**
+ * Creates a file for recording, replaces an existing one.
+ *
+ * @param file
+ * @param path
+ * @param source written to the header
+ * @return 0 on success, negative errno on failure
+ */
+int CaptureFile_create(struct CaptureFile *file, const char *path,
+                       const struct CaptureFile_Source *source);
+
+/**
+ * Appends consecutive samples.
+ *
+ * A new block is begun if firstIndex does not follow the last sample
+ * appended. The lost samples are marked if firstIndex lies ahead.
+ *
+ * @param file created by CaptureFile_create()
+ * @param samples
+ * @param count number of samples
+ * @param firstIndex sample index of the first sample, unwrapped
+ * @param firstStampNs host time of the first sample
+ * @return 0 on success, -ENOSPC if the block index is exhausted, negative
+ * errno if the file could not grow
+ */
+int CaptureFile_append(struct CaptureFile *file,
+                       const struct Transport_Acceleration *samples,
+                       uint32_t count, uint64_t firstIndex,
+                       uint64_t firstStampNs);
+
+/**
+ * Places a marker in front of the next sample appended.
+ *
+ * @param file created by CaptureFile_create()
+ * @param kind \see CaptureFile_MarkerKind
+ * @param value depends on kind
+ * @return 0 on success, -ENOSPC if the marker table is exhausted
+ */
+int CaptureFile_mark(struct CaptureFile *file, enum CaptureFile_MarkerKind kind,
+                     uint32_t value);
+
+/**
+ * Maps an existing file for reading.
+ *
+ * @param file
+ * @param path
+ * @return 0 on success, -EBADMSG if no capture file, negative errno on other
+ * failures
+ */
+int CaptureFile_open(struct CaptureFile *file, const char *path);
+
+/**
+ * @param file opened or created
+ * @return header of the mapped file
+ */
+const struct CaptureFile_Header *
+CaptureFile_header(const struct CaptureFile *file);
+
+/**
+ * @param file opened or created
+ * @return first of CaptureFile_Header.blocksCount index entries
+ */
+const struct CaptureFile_Block *
+CaptureFile_blocks(const struct CaptureFile *file);
+
+/**
+ * @param file opened or created
+ * @return first of CaptureFile_Header.markersCount markers
+ */
+const struct CaptureFile_Marker *
+CaptureFile_markers(const struct CaptureFile *file);
+
+/**
+ * @param file opened or created
+ * @param block number of block
+ * @param axis \see CaptureFile_Axis
+ * @return CaptureFile_Block.count values of one axis, NULL if block is not in
+ * use
+ */
+const int16_t *CaptureFile_column(const struct CaptureFile *file,
+                                  uint32_t block, enum CaptureFile_Axis axis);
+
+/**
+ * Looks up the block holding a sample.
+ *
+ * Sample indices restart with sampling, hence the search starts at a known
+ * block, i.e. the one of a CaptureFile_MarkerKind_Start marker.
+ *
+ * @param file opened or created
+ * @param fromBlock first block to search
+ * @param sampleIndex unwrapped sample index
+ * @return number of first block from fromBlock on holding the sample, -ENOENT
+ * if none
+ */
+int CaptureFile_findBlock(const struct CaptureFile *file, uint32_t fromBlock,
+                          uint64_t sampleIndex);
+
+/**
+ * @param file opened or created
+ * @param kind \see CaptureFile_MarkerKind
+ * @param value value to match
+ * @return first marker of kind and value, NULL if none
+ */
+const struct CaptureFile_Marker *
+CaptureFile_findMarker(const struct CaptureFile *file,
+                       enum CaptureFile_MarkerKind kind, uint32_t value);
+
+/**
+ * Truncates a recorded file to the blocks in use and unmaps it.
+ *
+ * @param file
+ */
+void CaptureFile_close(struct CaptureFile *file);
@@ -0,0 +1,173 @@
+/**
+ * \file clock_profile.c
+ *
+ * Implementation of the clock profile calculations.
+ */
+
+#include "clock_profile.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MIN_VCO_INPUT_HZ 1000000U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_VCO_INPUT_HZ 2000000U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MIN_VCO_OUTPUT_HZ 100000000U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_VCO_OUTPUT_HZ 432000000U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MIN_PLLN 50U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_PLLN 432U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MIN_PLLQ 2U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_PLLQ 15U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_SPI_DIVISOR 256U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_NS_PER_S 1000000000ULL
+
+/**
+ * Largest HCLK per regulator voltage scale 3 and 2, RM0383/RM0368 PWR_CR.VOS.
+ */
+#if defined(STM32F401xC) || defined(STM32F401xE)
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_SCALE3_HZ 60000000U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_SCALE2_HZ 84000000U
+#else
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_SCALE3_HZ 64000000U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_SCALE2_HZ 84000000U
+#endif
+
+static bool isBusDivider(uint8_t divider) {
+  return 1U == divider || 2U == divider || 4U == divider || 8U == divider ||
+         16U == divider;
+}
+
+static uint64_t vcoOutputHz(const struct ClockProfile *profile) {
+  return (uint64_t)CLOCKPROFILE_HSE_HZ * profile->pllN / profile->pllM;
+}
+
+int ClockProfile_validate(const struct ClockProfile *profile) {
+  if (NULL == profile || 0 == profile->pllM) {
+    return -EINVAL;
+  }
+
+  const uint32_t vcoInputHz = {CLOCKPROFILE_HSE_HZ / profile->pllM};
+  if (CLOCKPROFILE_MIN_VCO_INPUT_HZ > vcoInputHz ||
+      CLOCKPROFILE_MAX_VCO_INPUT_HZ < vcoInputHz) {
+    return -EINVAL;
+  }
+
+  const uint64_t vcoHz = {vcoOutputHz(profile)};
+  if (CLOCKPROFILE_MIN_PLLN > profile->pllN ||
+      CLOCKPROFILE_MAX_PLLN < profile->pllN ||
+      CLOCKPROFILE_MIN_VCO_OUTPUT_HZ > vcoHz ||
+      CLOCKPROFILE_MAX_VCO_OUTPUT_HZ < vcoHz) {
+    return -EINVAL;
+  }
+
+  if ((2U != profile->pllP && 4U != profile->pllP && 6U != profile->pllP &&
+       8U != profile->pllP) ||
+      CLOCKPROFILE_MIN_PLLQ > profile->pllQ ||
+      CLOCKPROFILE_MAX_PLLQ < profile->pllQ) {
+    return -EINVAL;
+  }
+
+  // USB requires 48MHz exactly
+  if (0 != vcoHz % profile->pllQ ||
+      CLOCKPROFILE_USB_HZ != ClockProfile_usbHz(profile)) {
+    return -EINVAL;
+  }
+
+  if (!isBusDivider(profile->apb1Divider) ||
+      !isBusDivider(profile->apb2Divider)) {
+    return -EINVAL;
+  }
+
+  const uint32_t hclkHz = {ClockProfile_sysclkHz(profile)};
+  if (CLOCKPROFILE_MAX_SYSCLK_HZ < hclkHz ||
+      CLOCKPROFILE_MAX_SYSCLK_HZ / 2U < hclkHz / profile->apb1Divider) {
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+uint32_t ClockProfile_sysclkHz(const struct ClockProfile *profile) {
+  return (uint32_t)(vcoOutputHz(profile) / profile->pllP);
+}
+
+uint32_t ClockProfile_usbHz(const struct ClockProfile *profile) {
+  return (uint32_t)(vcoOutputHz(profile) / profile->pllQ);
+}
+
+uint8_t ClockProfile_flashLatency(uint32_t hclkHz) {
+  if (0 == hclkHz) {
+    return 0;
+  }
+  return (uint8_t)((hclkHz - 1U) / CLOCKPROFILE_FLASH_HZ_PER_WAIT_STATE);
+}
+
+uint8_t ClockProfile_voltageScale(uint32_t hclkHz) {
+  if (CLOCKPROFILE_MAX_SCALE3_HZ >= hclkHz) {
+    return 3;
+  }
+  if (CLOCKPROFILE_MAX_SCALE2_HZ >= hclkHz) {
+    return 2;
+  }
+  return 1;
+}
+
+uint32_t ClockProfile_timerClockHz(uint32_t hclkHz, uint8_t apbDivider) {
+  if (1U >= apbDivider) {
+    return hclkHz;
+  }
+  return hclkHz / apbDivider * 2U;
+}
+
+uint16_t ClockProfile_spiDivisor(uint32_t pclkHz, uint32_t maxSpiHz) {
+  for (uint16_t divisor = 2; divisor <= CLOCKPROFILE_MAX_SPI_DIVISOR;
+       divisor *= 2U) {
+    if (pclkHz / divisor <= maxSpiHz) {
+      return divisor;
+    }
+  }
+  return 0;
+}
+
+uint16_t ClockProfile_calibrateSpiDivisor(uint16_t ratedDivisor, uint8_t rounds,
+                                          int (*doVerifyImpl)(uint16_t),
+                                          uint16_t *fastestDivisor) {
+  *fastestDivisor = 0;
+  for (uint16_t divisor = ratedDivisor;
+       0 != divisor && divisor <= CLOCKPROFILE_MAX_SPI_DIVISOR; divisor *= 2U) {
+    bool isReliable = {true};
+    for (uint8_t round = 0; isReliable && round < rounds; round++) {
+      isReliable = 0 == doVerifyImpl(divisor);
+    }
+    if (!isReliable) {
+      continue;
+    }
+
+    *fastestDivisor = divisor;
+    if (divisor == ratedDivisor || CLOCKPROFILE_MAX_SPI_DIVISOR == divisor) {
+      return divisor;
+    }
+    return divisor * 2U;
+  }
+  return ratedDivisor;
+}
+
+uint16_t ClockProfile_timerPeriod(uint32_t timerHz, uint32_t periodNs) {
+  const uint64_t ticks = {((uint64_t)timerHz * periodNs +
+                           CLOCKPROFILE_NS_PER_S - 1U) /
+                          CLOCKPROFILE_NS_PER_S};
+  return UINT16_MAX < ticks ? UINT16_MAX : (uint16_t)ticks;
+}
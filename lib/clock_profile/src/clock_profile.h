@@ -0,0 +1,171 @@
+/**
+ * \file clock_profile.h
+ *
+ * System clock profiles and the peripheral settings derived from them.
+ *
+ * A profile configures the main PLL fed by the 25MHz HSE of the BlackPill:
+ *
+ *   SYSCLK = HSE / pllM * pllN / pllP
+ *   USB    = HSE / pllM * pllN / pllQ
+ *
+ * Every profile keeps the 48MHz USB clock. HCLK equals SYSCLK, flash latency,
+ * regulator voltage scale, SPI prescaler and timer periods follow from the
+ * bus clocks, hence peripherals keep their timing in each profile.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_HSE_HZ 25000000U
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_USB_HZ 48000000U
+
+/**
+ * Largest SYSCLK, the APB1 bus runs at half of it at most.
+ */
+#if defined(STM32F401xC) || defined(STM32F401xE)
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_SYSCLK_HZ 84000000U
+#else
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_MAX_SYSCLK_HZ 100000000U
+#endif
+
+/**
+ * HCLK per flash wait state at 2.7V to 3.6V supply.
+ *
+ * Conservative for the STM32F411 which allows 64MHz at 1 wait state.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CLOCKPROFILE_FLASH_HZ_PER_WAIT_STATE 30000000U
+
+struct ClockProfile {
+  uint8_t pllM;        ///< VCO input HSE / pllM, 1MHz to 2MHz
+  uint16_t pllN;       ///< VCO output input * pllN, 100MHz to 432MHz
+  uint8_t pllP;        ///< SYSCLK divider of VCO output: 2, 4, 6 or 8
+  uint8_t pllQ;        ///< USB clock divider of VCO output: 2 to 15
+  uint8_t apb1Divider; ///< PCLK1 divider of HCLK: 1, 2, 4, 8 or 16
+  uint8_t apb2Divider; ///< PCLK2 divider of HCLK: 1, 2, 4, 8 or 16
+};
+
+/**
+ * 60MHz as generated by CubeMX, see cubemx.ioc.
+ */
+#define CLOCKPROFILE_BALANCED_INITIALIZER                                      \
+  {.pllM = 15,                                                                 \
+   .pllN = 144,                                                                \
+   .pllP = 4,                                                                  \
+   .pllQ = 5,                                                                  \
+   .apb1Divider = 2,                                                           \
+   .apb2Divider = 1}
+
+/**
+ * Fastest SYSCLK that is a divisor of a 48MHz multiple: 96MHz on the
+ * STM32F411, 84MHz on the STM32F401.
+ */
+#if defined(STM32F401xC) || defined(STM32F401xE)
+#define CLOCKPROFILE_MAX_PERFORMANCE_INITIALIZER                               \
+  {.pllM = 25,                                                                 \
+   .pllN = 336,                                                                \
+   .pllP = 4,                                                                  \
+   .pllQ = 7,                                                                  \
+   .apb1Divider = 2,                                                           \
+   .apb2Divider = 1}
+#else
+#define CLOCKPROFILE_MAX_PERFORMANCE_INITIALIZER                               \
+  {.pllM = 25,                                                                 \
+   .pllN = 384,                                                                \
+   .pllP = 4,                                                                  \
+   .pllQ = 8,                                                                  \
+   .apb1Divider = 2,                                                           \
+   .apb2Divider = 1}
+#endif
+
+/**
+ * 24MHz: the slowest VCO output feeding USB (192MHz) by the largest SYSCLK
+ * divider.
+ */
+#define CLOCKPROFILE_LOW_POWER_INITIALIZER                                     \
+  {.pllM = 25,                                                                 \
+   .pllN = 192,                                                                \
+   .pllP = 8,                                                                  \
+   .pllQ = 4,                                                                  \
+   .apb1Divider = 1,                                                           \
+   .apb2Divider = 1}
+
+/**
+ * Checks the PLL and bus limits of the MCU.
+ *
+ * @param profile
+ * @return -EINVAL if any limit is exceeded or the USB clock is not 48MHz, 0
+ * otherwise
+ */
+int ClockProfile_validate(const struct ClockProfile *profile);
+
+/**
+ * @param profile
+ * @return SYSCLK and HCLK
+ */
+uint32_t ClockProfile_sysclkHz(const struct ClockProfile *profile);
+
+/**
+ * @param profile
+ * @return clock of the USB OTG FS peripheral
+ */
+uint32_t ClockProfile_usbHz(const struct ClockProfile *profile);
+
+/**
+ * @param hclkHz
+ * @return flash wait states required at hclkHz
+ */
+uint8_t ClockProfile_flashLatency(uint32_t hclkHz);
+
+/**
+ * @param hclkHz
+ * @return lowest power regulator voltage scale (1 to 3) supporting hclkHz
+ */
+uint8_t ClockProfile_voltageScale(uint32_t hclkHz);
+
+/**
+ * @param hclkHz
+ * @param apbDivider divider of the APB bus the timer is attached to
+ * @return timer kernel clock, twice the bus clock if the bus is divided
+ */
+uint32_t ClockProfile_timerClockHz(uint32_t hclkHz, uint8_t apbDivider);
+
+/**
+ * @param pclkHz clock of the APB bus the SPI is attached to
+ * @param maxSpiHz fastest SPI clock the slave supports
+ * @return smallest SPI prescaler (2 to 256) not exceeding maxSpiHz, 0 if none
+ */
+uint16_t ClockProfile_spiDivisor(uint32_t pclkHz, uint32_t maxSpiHz);
+
+/**
+ * Finds the fastest reliable SPI prescaler.
+ *
+ * Steps from ratedDivisor towards slower clocks until rounds consecutive
+ * verifications pass. Clocks faster than the slave's rating are never tried.
+ * If the rated clock fails, the wiring is marginal: one step slower than the
+ * fastest passing prescaler is picked as margin.
+ *
+ * @param ratedDivisor fastest prescaler within the slave's rating \see
+ * ClockProfile_spiDivisor()
+ * @param rounds verifications per prescaler
+ * @param doVerifyImpl applies the prescaler and verifies transfers, returns 0
+ * if they are reliable
+ * @param fastestDivisor output, fastest prescaler passing, 0 if none
+ * @return prescaler to use, ratedDivisor if none passes
+ */
+uint16_t ClockProfile_calibrateSpiDivisor(uint16_t ratedDivisor, uint8_t rounds,
+                                          int (*doVerifyImpl)(uint16_t),
+                                          uint16_t *fastestDivisor);
+
+/**
+ * @param timerHz timer kernel clock, prescaler 0
+ * @param periodNs
+ * @return timer ticks lasting at least periodNs, capped at UINT16_MAX
+ */
+uint16_t ClockProfile_timerPeriod(uint32_t timerHz, uint32_t periodNs);
@@ -0,0 +1,216 @@
+/**
+ * \file codec.c
+ *
+ * Delta, zig-zag and bit-packing block codec.
+ */
+
+#include "codec.h"
+#include <errno.h>
+#include <ramfunc.h>
+#include <stddef.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CODEC_AXES 3U
+
+/**
+ * Accumulates values of arbitrary width into bytes, LSB first.
+ */
+struct BitWriter {
+  uint8_t *out;
+  uint16_t bytes;  ///< bytes written to out
+  uint32_t bits;   ///< pending bits, not yet written to out
+  uint8_t pending; ///< number of pending bits, always less than 8
+};
+
+struct BitReader {
+  const uint8_t *in;
+  uint16_t available; ///< readable bytes of in
+  uint16_t bytes;     ///< bytes consumed from in
+  uint32_t bits;
+  uint8_t pending;
+};
+
+RAMFUNC static int16_t axisOf(const struct Codec_Acceleration *sample,
+                              uint8_t axis) {
+  switch (axis) {
+  case 0:
+    return sample->x;
+  case 1:
+    return sample->y;
+  default:
+    return sample->z;
+  }
+}
+
+static void setAxisOf(struct Codec_Acceleration *sample, uint8_t axis,
+                      int16_t value) {
+  switch (axis) {
+  case 0:
+    sample->x = value;
+    break;
+  case 1:
+    sample->y = value;
+    break;
+  default:
+    sample->z = value;
+    break;
+  }
+}
+
+RAMFUNC static uint32_t zigZag(int32_t value) {
+  return ((uint32_t)value << 1U) ^ (uint32_t)(value >> 31U);
+}
+
+static int32_t unZigZag(uint32_t value) {
+  return (int32_t)(value >> 1U) ^ -(int32_t)(value & 1U);
+}
+
+RAMFUNC static uint8_t bitWidth(uint32_t value) {
+  return 0 == value ? 0 : (uint8_t)(32U - __builtin_clz(value));
+}
+
+RAMFUNC static void writeBits(struct BitWriter *writer, uint32_t value,
+                               uint8_t width) {
+  writer->bits |= value << writer->pending;
+  writer->pending += width;
+  while (8U <= writer->pending) {
+    writer->out[writer->bytes++] = (uint8_t)writer->bits;
+    writer->bits >>= 8U;
+    writer->pending -= 8U;
+  }
+}
+
+RAMFUNC static void flushBits(struct BitWriter *writer) {
+  if (0 < writer->pending) {
+    writer->out[writer->bytes++] = (uint8_t)writer->bits;
+    writer->bits = 0;
+    writer->pending = 0;
+  }
+}
+
+static int readBits(struct BitReader *reader, uint8_t width, uint32_t *value) {
+  while (reader->pending < width) {
+    if (reader->bytes >= reader->available) {
+      return -EINVAL;
+    }
+    reader->bits |= (uint32_t)reader->in[reader->bytes++] << reader->pending;
+    reader->pending += 8U;
+  }
+
+  *value = reader->bits & ((1UL << width) - 1U);
+  reader->bits >>= width;
+  reader->pending -= width;
+  return 0;
+}
+
+RAMFUNC static void writeRaw(uint8_t *out, int16_t value) {
+  out[0] = (uint8_t)((uint16_t)value & 0xFFU);
+  out[1] = (uint8_t)((uint16_t)value >> 8U);
+}
+
+static int16_t readRaw(const uint8_t *in) {
+  return (int16_t)((uint16_t)in[0] | ((uint16_t)in[1] << 8U));
+}
+
+RAMFUNC int Codec_encodeBlock(const struct Codec_Acceleration *samples,
+                              uint8_t count, uint8_t *block) {
+  if (NULL == samples || NULL == block || 0 == count ||
+      CODEC_BLOCK_MAX_SAMPLES < count) {
+    return -EINVAL;
+  }
+
+  // first pass: widest delta per axis
+  uint8_t widths[CODEC_AXES] = {0};
+  for (uint8_t axis = 0; axis < CODEC_AXES; axis++) {
+    uint32_t merged = {0};
+    for (uint8_t idx = 1; idx < count; idx++) {
+      merged |= zigZag((int32_t)axisOf(&samples[idx], axis) -
+                       axisOf(&samples[idx - 1U], axis));
+    }
+    widths[axis] = bitWidth(merged);
+  }
+
+  block[0] = count;
+  for (uint8_t axis = 0; axis < CODEC_AXES; axis++) {
+    block[1U + axis] = widths[axis];
+    writeRaw(&block[4U + 2U * axis], axisOf(&samples[0], axis));
+  }
+
+  // second pass: pack deltas
+  struct BitWriter writer = {
+      .out = block, .bytes = CODEC_BLOCK_HEADER_BYTES, .bits = 0, .pending = 0};
+  for (uint8_t axis = 0; axis < CODEC_AXES; axis++) {
+    if (0 == widths[axis]) {
+      continue;
+    }
+    for (uint8_t idx = 1; idx < count; idx++) {
+      writeBits(&writer,
+                zigZag((int32_t)axisOf(&samples[idx], axis) -
+                       axisOf(&samples[idx - 1U], axis)),
+                widths[axis]);
+    }
+  }
+  flushBits(&writer);
+
+  return writer.bytes;
+}
+
+int Codec_blockSizeBytes(const uint8_t *block, uint16_t availableBytes) {
+  if (NULL == block) {
+    return -EINVAL;
+  }
+  if (availableBytes < CODEC_BLOCK_HEADER_BYTES) {
+    return -EAGAIN;
+  }
+
+  const uint8_t count = {block[0]};
+  if (0 == count || CODEC_BLOCK_MAX_SAMPLES < count) {
+    return -EINVAL;
+  }
+
+  uint16_t bits = {0};
+  for (uint8_t axis = 0; axis < CODEC_AXES; axis++) {
+    if (CODEC_DELTA_MAX_BITS < block[1U + axis]) {
+      return -EINVAL;
+    }
+    bits += block[1U + axis] * (count - 1U);
+  }
+
+  return CODEC_BLOCK_HEADER_BYTES + (bits + 7U) / 8U;
+}
+
+int Codec_decodeBlock(const uint8_t *block, uint16_t availableBytes,
+                      struct Codec_Acceleration *samples, uint8_t maxCount) {
+  const int sizeBytes = {Codec_blockSizeBytes(block, availableBytes)};
+  if (0 > sizeBytes || availableBytes < sizeBytes || NULL == samples) {
+    return -EINVAL;
+  }
+
+  const uint8_t count = {block[0]};
+  if (maxCount < count) {
+    return -ENOMEM;
+  }
+
+  struct BitReader reader = {.in = block,
+                             .available = sizeBytes,
+                             .bytes = CODEC_BLOCK_HEADER_BYTES,
+                             .bits = 0,
+                             .pending = 0};
+
+  for (uint8_t axis = 0; axis < CODEC_AXES; axis++) {
+    const uint8_t width = {block[1U + axis]};
+    int16_t value = {readRaw(&block[4U + 2U * axis])};
+    setAxisOf(&samples[0], axis, value);
+
+    for (uint8_t idx = 1; idx < count; idx++) {
+      uint32_t delta = {0};
+      if (0 != readBits(&reader, width, &delta)) {
+        return -EINVAL;
+      }
+      value = (int16_t)(value + unZigZag(delta));
+      setAxisOf(&samples[idx], axis, value);
+    }
+  }
+
+  return count;
+}
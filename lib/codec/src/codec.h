@@ -0,0 +1,91 @@
+/**
+ * \file codec.h
+ *
+ * Lossless block codec for acceleration samples.
+ *
+ * A block carries up to CODEC_BLOCK_MAX_SAMPLES samples. The first sample is
+ * stored raw, subsequent samples as per-axis first-order deltas. Deltas are
+ * zig-zag mapped to unsigned values and bit-packed with one width per axis
+ * and block. Blocks do not depend on each other, hence a lost block does not
+ * corrupt the following ones.
+ *
+ * Block layout (little endian, bit stream LSB first):
+ *   - uint8_t count
+ *   - uint8_t width[3], bits per delta of x, y, z
+ *   - int16_t x, y, z of the first sample
+ *   - (count - 1) deltas of x, then of y, then of z
+ *
+ * The module has no hardware dependencies and is meant to be compiled for the
+ * host decoder as well.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+/**
+ * Maximum number of samples per block: one sensor FiFo.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CODEC_BLOCK_MAX_SAMPLES 32U
+
+/**
+ * Size of the block header in bytes: count, widths and first sample.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CODEC_BLOCK_HEADER_BYTES 10U
+
+/**
+ * Bits of the widest possible zig-zag mapped delta of two int16_t values.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CODEC_DELTA_MAX_BITS 17U
+
+/**
+ * Upper bound of the encoded size of a block of COUNT samples.
+ */
+#define CODEC_BLOCK_MAX_BYTES(COUNT)                                           \
+  (CODEC_BLOCK_HEADER_BYTES +                                                  \
+   ((3U * CODEC_DELTA_MAX_BITS * ((COUNT)-1U)) + 7U) / 8U)
+
+struct Codec_Acceleration {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} __attribute__((packed));
+
+/**
+ * Encodes samples into one block.
+ *
+ * @param samples input
+ * @param count number of samples, 1 to CODEC_BLOCK_MAX_SAMPLES
+ * @param block output, at least CODEC_BLOCK_MAX_BYTES(count) bytes
+ * @return number of bytes written, -EINVAL on invalid arguments
+ */
+int Codec_encodeBlock(const struct Codec_Acceleration *samples, uint8_t count,
+                      uint8_t *block);
+
+/**
+ * Determines the size of an encoded block from its header.
+ *
+ * Allows to split a byte stream of consecutive blocks.
+ *
+ * @param block encoded block
+ * @param availableBytes number of readable bytes at block
+ * @return size of block in bytes, -EAGAIN if availableBytes do not cover the
+ * header, -EINVAL if the header is malformed
+ */
+int Codec_blockSizeBytes(const uint8_t *block, uint16_t availableBytes);
+
+/**
+ * Decodes one block.
+ *
+ * @param block encoded block
+ * @param availableBytes number of readable bytes at block
+ * @param samples output
+ * @param maxCount capacity of samples
+ * @return number of decoded samples, -EINVAL if the block is malformed or
+ * incomplete, -ENOMEM if samples are too few
+ */
+int Codec_decodeBlock(const uint8_t *block, uint16_t availableBytes,
+                      struct Codec_Acceleration *samples, uint8_t maxCount);
@@ -0,0 +1,84 @@
+/**
+ * \file codec_packed.c
+ *
+ * Table driven bit packing of acceleration samples.
+ */
+
+#include "codec_packed.h"
+#include <ramfunc.h>
+
+/**
+ * Fixed layout of one packed sample.
+ */
+struct PackedLayout {
+  uint8_t bits;      ///< bits per axis
+  uint8_t bytes;     ///< bytes per sample
+  uint8_t shifts[3]; ///< bit offset of x, y, z
+};
+
+static const struct PackedLayout layouts[] = {
+    [Codec_Packing_13bit] = {.bits = 13, .bytes = 5, .shifts = {0, 13, 26}},
+    [Codec_Packing_10bit] = {.bits = 10, .bytes = 4, .shifts = {0, 10, 20}},
+};
+
+RAMFUNC static uint32_t saturate(int16_t value, uint8_t bits) {
+  const int32_t max = {(1L << (bits - 1U)) - 1};
+  const int32_t min = {-max - 1};
+  const int32_t clamped = {value > max ? max : (value < min ? min : value)};
+  return (uint32_t)clamped & ((1UL << bits) - 1U);
+}
+
+static int16_t signExtend(uint32_t field, uint8_t bits) {
+  const int32_t signBit = {1L << (bits - 1U)};
+  return (int16_t)(((int32_t)field ^ signBit) - signBit);
+}
+
+uint8_t Codec_packedSizeBytes(enum Codec_Packing packing) {
+  return layouts[packing].bytes;
+}
+
+RAMFUNC uint16_t Codec_pack(enum Codec_Packing packing,
+                            const struct Codec_Acceleration *samples,
+                            uint16_t count, uint8_t *packed) {
+  const struct PackedLayout *layout = {&layouts[packing]};
+  uint8_t *next = {packed};
+
+  for (uint16_t idx = 0; idx < count; idx++) {
+    const int16_t values[3] = {samples[idx].x, samples[idx].y,
+                               samples[idx].z};
+    uint64_t word = {0};
+    for (uint8_t axis = 0; axis < 3U; axis++) {
+      word |= (uint64_t)saturate(values[axis], layout->bits)
+              << layout->shifts[axis];
+    }
+
+    for (uint8_t byte = 0; byte < layout->bytes; byte++) {
+      *next++ = (uint8_t)(word >> (8U * byte));
+    }
+  }
+
+  return next - packed;
+}
+
+uint16_t Codec_unpack(enum Codec_Packing packing, const uint8_t *packed,
+                      uint16_t count, struct Codec_Acceleration *samples) {
+  const struct PackedLayout *layout = {&layouts[packing]};
+  const uint32_t mask = {(1UL << layout->bits) - 1U};
+  const uint8_t *next = {packed};
+
+  for (uint16_t idx = 0; idx < count; idx++) {
+    uint64_t word = {0};
+    for (uint8_t byte = 0; byte < layout->bytes; byte++) {
+      word |= (uint64_t)*next++ << (8U * byte);
+    }
+
+    samples[idx].x = signExtend((word >> layout->shifts[0]) & mask,
+                                layout->bits);
+    samples[idx].y = signExtend((word >> layout->shifts[1]) & mask,
+                                layout->bits);
+    samples[idx].z = signExtend((word >> layout->shifts[2]) & mask,
+                                layout->bits);
+  }
+
+  return next - packed;
+}
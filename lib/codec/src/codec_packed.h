@@ -0,0 +1,53 @@
+/**
+ * \file codec_packed.h
+ *
+ * Constant rate bit packing of acceleration samples.
+ *
+ * The sensor delivers fewer significant bits than int16_t provides: 13 bits in
+ * full resolution mode at +-16g and 10 bits in 10 bit mode. Packing the three
+ * axes of a sample back to back saves 17% (13 bit, 5 bytes) respectively 33%
+ * (10 bit, 4 bytes) compared to Codec_Acceleration.
+ *
+ * Sample layout (little endian): x in the lowest bits, followed by y and z.
+ */
+
+#pragma once
+
+#include "codec.h"
+#include <inttypes.h>
+
+enum Codec_Packing {
+  Codec_Packing_13bit = 0, ///< 5 bytes per sample
+  Codec_Packing_10bit = 1, ///< 4 bytes per sample
+};
+
+/**
+ * @param packing
+ * @return bytes per packed sample
+ */
+uint8_t Codec_packedSizeBytes(enum Codec_Packing packing);
+
+/**
+ * Packs samples, values exceeding the packed width saturate.
+ *
+ * @param packing
+ * @param samples input
+ * @param count number of samples
+ * @param packed output, count * Codec_packedSizeBytes() bytes
+ * @return number of bytes written
+ */
+uint16_t Codec_pack(enum Codec_Packing packing,
+                    const struct Codec_Acceleration *samples, uint16_t count,
+                    uint8_t *packed);
+
+/**
+ * Unpacks and sign extends samples.
+ *
+ * @param packing
+ * @param packed input, count * Codec_packedSizeBytes() bytes
+ * @param count number of samples
+ * @param samples output
+ * @return number of bytes consumed
+ */
+uint16_t Codec_unpack(enum Codec_Packing packing, const uint8_t *packed,
+                      uint16_t count, struct Codec_Acceleration *samples);
@@ -0,0 +1,109 @@
+/**
+ * \file config_store.c
+ *
+ * Implementation of the wear-levelled configuration store.
+ */
+
+#include "config_store.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONFIGSTORE_RECORD_WORDS                                               \
+  (sizeof(struct ConfigStore_Record) / sizeof(uint32_t))
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONFIGSTORE_CRC_WORDS (CONFIGSTORE_RECORD_WORDS - 1U)
+
+static const uint32_t *recordWords(const struct ConfigStore_Record *record) {
+  return (const uint32_t *)record;
+}
+
+static bool isErased(const struct ConfigStore_Record *record) {
+  const uint32_t *words = {recordWords(record)};
+  for (uint16_t idx = 0; idx < CONFIGSTORE_RECORD_WORDS; idx++) {
+    if (CONFIGSTORE_ERASED_WORD != words[idx]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool isValid(const struct ConfigStore_Handle *handle,
+                    const struct ConfigStore_Record *record) {
+  return CONFIGSTORE_MAGIC == record->magic &&
+         record->crc == handle->doCrc32WordsImpl(recordWords(record),
+                                                 CONFIGSTORE_CRC_WORDS);
+}
+
+/**
+ * Scans the sector up to the first erased record.
+ *
+ * @param handle
+ * @param freeIndex output: index of the first erased record, capacity if the
+ * sector is exhausted
+ * @return last valid record, NULL if none
+ */
+static const struct ConfigStore_Record *
+scan(const struct ConfigStore_Handle *handle, uint16_t *freeIndex) {
+  const struct ConfigStore_Record *current = {NULL};
+  uint16_t idx = {0};
+  // records are appended in order, torn ones are skipped
+  for (; idx < handle->capacity && !isErased(&handle->records[idx]); idx++) {
+    if (isValid(handle, &handle->records[idx])) {
+      current = &handle->records[idx];
+    }
+  }
+  *freeIndex = idx;
+  return current;
+}
+
+static bool isSameConfig(const struct ConfigStore_Config *lhs,
+                         const struct ConfigStore_Config *rhs) {
+  return lhs->outputDataRate == rhs->outputDataRate &&
+         lhs->range == rhs->range && lhs->scale == rhs->scale;
+}
+
+int ConfigStore_load(const struct ConfigStore_Handle *handle,
+                     struct ConfigStore_Config *config) {
+  uint16_t freeIndex = {0};
+  const struct ConfigStore_Record *current = {scan(handle, &freeIndex)};
+  if (NULL == current) {
+    return -ENOENT;
+  }
+  *config = current->config;
+  return 0;
+}
+
+int ConfigStore_save(const struct ConfigStore_Handle *handle,
+                     const struct ConfigStore_Config *config) {
+  uint16_t freeIndex = {0};
+  const struct ConfigStore_Record *current = {scan(handle, &freeIndex)};
+  if (NULL != current && isSameConfig(&current->config, config)) {
+    return 0;
+  }
+
+  if (handle->capacity <= freeIndex) {
+    if (0 != handle->doEraseImpl()) {
+      return -EIO;
+    }
+    freeIndex = 0;
+  }
+
+  struct ConfigStore_Record record = {.magic = CONFIGSTORE_MAGIC,
+                                      .config = *config};
+  record.config._reserved = 0;
+  record.crc =
+      handle->doCrc32WordsImpl(recordWords(&record), CONFIGSTORE_CRC_WORDS);
+
+  const uint32_t *words = {recordWords(&record)};
+  const uint32_t offset = {(uint32_t)freeIndex * CONFIGSTORE_RECORD_WORDS};
+  for (uint16_t idx = 0; idx < CONFIGSTORE_RECORD_WORDS; idx++) {
+    if (0 != handle->doProgramWordImpl(offset + idx, words[idx])) {
+      return -EIO;
+    }
+  }
+
+  return isValid(handle, &handle->records[freeIndex]) ? 0 : -EIO;
+}
@@ -0,0 +1,127 @@
+/**
+ * \file config_store.h
+ *
+ * Wear-levelled store of the sensor configuration in one flash sector.
+ *
+ * Records are appended to the erased sector one after another; the last
+ * valid record is the current configuration. The sector is erased only once
+ * it is exhausted, hence each save costs one record instead of one sector
+ * erase. A record is valid if its magic and CRC match, so records torn by a
+ * reset while programming are skipped.
+ *
+ * Example:
+ * \code
+ * struct ConfigStore_Handle store = CONFIGSTORE_INITIALIZER(
+ *     sector, sizeof(sector), doEraseImpl, doProgramWordImpl, crcImpl);
+ *
+ * struct ConfigStore_Config config = {0};
+ * if (0 == ConfigStore_load(&store, &config)) {
+ *   // apply config
+ * }
+ * ConfigStore_save(&store, &config);
+ * \endcode
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <inttypes.h>
+
+/**
+ * Erased flash reads as all bits set.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONFIGSTORE_ERASED_WORD 0xFFFFFFFFUL
+
+/**
+ * Marks a record, the lowest byte denotes the layout version of
+ * ConfigStore_Config.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONFIGSTORE_MAGIC 0xC0F16501UL
+
+/**
+ * Persisted sensor configuration shared by all sensors.
+ */
+struct ConfigStore_Config {
+  uint8_t outputDataRate; ///< \see TransportRx_SetOutputDataRate_Rate
+  uint8_t range;          ///< \see TransportRx_SetRange_Range
+  uint8_t scale;          ///< \see TransportRx_SetScale_Scale
+  uint8_t _reserved;      ///< zero
+};
+
+/**
+ * One record as programmed to flash.
+ */
+struct ConfigStore_Record {
+  uint32_t magic; ///< CONFIGSTORE_MAGIC
+  struct ConfigStore_Config config;
+  uint32_t crc; ///< over the preceding words
+};
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(0 == sizeof(struct ConfigStore_Record) % sizeof(uint32_t),
+              "ERROR: records must be programmable in words");
+
+struct ConfigStore_Handle {
+  /// memory mapped sector, word aligned
+  const struct ConfigStore_Record *const records;
+  const uint16_t capacity; ///< number of records fitting into the sector
+
+  /**
+   * Erases the whole sector.
+   *
+   * @return 0 on success, negative errno otherwise
+   */
+  int (*const doEraseImpl)();
+
+  /**
+   * Programs one word of the sector.
+   *
+   * @param offset word offset from the sector start
+   * @param word data to program
+   * @return 0 on success, negative errno otherwise
+   */
+  int (*const doProgramWordImpl)(uint32_t offset, uint32_t word);
+
+  /**
+   * Computes the record CRC over 32-bit words \see Crc_crc32Words().
+   */
+  uint32_t (*const doCrc32WordsImpl)(const uint32_t *, uint16_t);
+};
+
+#define CONFIGSTORE_INITIALIZER(SECTOR, SECTOR_BYTES, ERASE_IMPL,              \
+                                PROGRAM_WORD_IMPL, CRC32_WORDS_IMPL)           \
+  {                                                                            \
+    .records = (const struct ConfigStore_Record *)(SECTOR),                    \
+    .capacity =                                                                \
+        (uint16_t)((SECTOR_BYTES) / sizeof(struct ConfigStore_Record)),        \
+    .doEraseImpl = (ERASE_IMPL), .doProgramWordImpl = (PROGRAM_WORD_IMPL),     \
+    .doCrc32WordsImpl = (CRC32_WORDS_IMPL),                                    \
+  }
+
+/**
+ * Reads the current configuration.
+ *
+ * @param handle
+ * @param config output, untouched if none is stored
+ * @return -ENOENT if no valid record is stored, 0 otherwise
+ */
+int ConfigStore_load(const struct ConfigStore_Handle *handle,
+                     struct ConfigStore_Config *config);
+
+/**
+ * Appends config as new current configuration.
+ *
+ * Nothing is programmed if config equals the current configuration. The
+ * sector is erased before if no erased record is left.
+ *
+ * Note: erasing stalls instruction fetches from the same flash bank for the
+ * duration of the erase.
+ *
+ * @param handle
+ * @param config
+ * @return -EIO if erasing, programming or the read back fails, 0 otherwise
+ */
+int ConfigStore_save(const struct ConfigStore_Handle *handle,
+                     const struct ConfigStore_Config *config);
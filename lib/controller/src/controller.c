@@ -3,3 +3,51 @@
  *
  * Implements generic parts of the controller API.
  */
+
+#include "controller.h"
+#include <errno.h>
+
+/**
+ * Maps a response to its bit: highest priority (0) is the most significant
+ * bit.
+ */
+static uint32_t responseBit(uint8_t response) {
+  return 0x80000000U >> response;
+}
+
+void Controller_postEvents(struct Controller_Events *events, uint32_t mask) {
+  __atomic_fetch_or(&events->pending, mask, __ATOMIC_SEQ_CST);
+}
+
+uint32_t Controller_takeEvents(struct Controller_Events *events) {
+  return __atomic_exchange_n(&events->pending, 0U, __ATOMIC_SEQ_CST);
+}
+
+bool Controller_hasEvents(const struct Controller_Events *events) {
+  return 0U != events->pending;
+}
+
+void Controller_requestResponse(struct Controller_Responses *responses,
+                                enum Controller_Response response) {
+  __atomic_fetch_or(&responses->pending, responseBit(response),
+                    __ATOMIC_SEQ_CST);
+}
+
+int Controller_takeResponse(struct Controller_Responses *responses) {
+  const uint32_t pending = {responses->pending};
+
+  if (0U == pending) {
+    return -ENODATA;
+  }
+
+  // compiles to a single CLZ instruction on Cortex-M4
+  const uint8_t response = {(uint8_t)__builtin_clz(pending)};
+  __atomic_fetch_and(&responses->pending, ~responseBit(response),
+                     __ATOMIC_SEQ_CST);
+
+  return response;
+}
+
+bool Controller_hasResponses(const struct Controller_Responses *responses) {
+  return 0U != responses->pending;
+}
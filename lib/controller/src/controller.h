@@ -10,6 +10,7 @@
  */
 
 #pragma once
+#include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
 
@@ -17,28 +18,118 @@
 #include <host_transport.h>
 #include <sampling_types.h>
 
+/**
+ * Maximum number of sensors sharing the SPI bus; sensor 0 is the primary.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CONTROLLER_SENSORS 2U
+
 enum TransportRx_SetOutputDataRate_Rate;
 enum TransportRx_SetScale_Scale;
 enum TransportRx_SetRange_Range;
+struct TransportRx_ConfigureAndStart;
+struct TransportRx_RecorderStart;
+struct TransportRx_SequenceAppend;
+
+/**
+ * Event bits posted by interrupts to wake up the main loop.
+ *
+ * The main loop serves pending events and sleeps (WFI) if there is nothing
+ * left to do.
+ */
+enum Controller_Event {
+  Controller_Event_FifoWatermark = 1U << 0U,    ///< EXTI2_IRQHandler(),
+                                                ///< EXTI15_10_IRQHandler()
+  Controller_Event_FifoOverflow = 1U << 1U,     ///< EXTI3_IRQHandler(),
+                                                ///< EXTI15_10_IRQHandler()
+  Controller_Event_HostRequest = 1U << 2U,      ///< CDC_Receive_FS()
+  Controller_Event_TransmitComplete = 1U << 3U, ///< CDC_TransmitCplt_FS()
+  Controller_Event_InterruptSource = 1U << 4U,  ///< EXTI3_IRQHandler() if
+                                                ///< INT2 is shared
+  Controller_Event_LatencyDeadline = 1U << 5U,  ///< SysTick_Handler()
+};
+
+/**
+ * Pending event bits; set from interrupt context, consumed in main().
+ */
+struct Controller_Events {
+  volatile uint32_t pending; ///< Context: main() and interrupts
+};
+
+/**
+ * Deferred responses to the host.
+ *
+ * The enumeration order denotes the priority: lower value is transmitted
+ * first. Each response maps to one bit (bit 31 for value 0) so that the next
+ * response to transmit is found by counting leading zeros.
+ */
+enum Controller_Response {
+  Controller_Response_FirmwareVersion = 0,
+  Controller_Response_OutputDataRate,
+  Controller_Response_Range,
+  Controller_Response_Scale,
+  Controller_Response_Uptime,
+  Controller_Response_BufferStatus,
+  Controller_Response_DeviceSetup,
+  Controller_Response_SamplingStopped,
+  Controller_Response_SamplingAborted,
+  Controller_Response_SamplingFinished,
+  Controller_Response_FifoOverflow,
+  Controller_Response_BufferOverflow,
+  Controller_Response_TransmissionError,
+  Controller_Response_RecorderFinished,
+  Controller_Response_ClockCorrelation,
+  Controller_Response_Calibration,
+  Controller_Response_SpiClock,
+  Controller_Response_ConfigurationSaved,
+  Controller_Response_StreamSetup,
+  Controller_Response_CaptureChunk, ///< bulk read out, after all status
+  Controller_Response_Count ///< number of responses; not a response
+};
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(Controller_Response_Count <= 32U,
+              "ERROR: each response must map to one bit of uint32_t");
+
+/**
+ * Pending responses; requesting an already pending response is coalesced.
+ */
+struct Controller_Responses {
+  volatile uint32_t pending; ///< Context: main() and interrupts
+};
 
 struct Controller_Sensor {
-  struct Adxl345_Handle handle;
+  struct Adxl345_Handle handles[CONTROLLER_SENSORS]; ///< indexed by sensor ID
+
+  /**
+   * Number of sensors found at init: sensor IDs 0 to count - 1.
+   *
+   * Context: main()
+   */
+  uint8_t count;
 
   void (*const init)(); ///< Context: main()
 };
 
 struct Controller_Sampling {
-  struct Sampling_Handle handle; ///< device specific pimpl
+  /**
+   * Device specific pimpl, one per sensor: indexed by sensor ID.
+   */
+  struct Sampling_Handle handles[CONTROLLER_SENSORS];
 
   /**
    * Device API for sampling module.
    *
+   * The sensor ID selects the handle. Sensor 0 signals via EXTI2/3, sensor 1
+   * via EXTI15_10.
+   *
    * @{
    */
-  void (*const doSetFifoWatermark)();   ///< Context: EXTI2_IRQHandler()
-  void (*const doClearFifoWatermark)(); ///< Context: EXTI2_IRQHandler()
-  void (*const doSetFifoOverflow)();    ///< Context: EXTI3_IRQHandler()
-  void (*const doSet5usTimerExpired)(); ///< Context: TIM3_IRQHandler()
+  void (*const doSetFifoWatermark)(uint8_t);   ///< Context: EXTI handlers
+  void (*const doClearFifoWatermark)(uint8_t); ///< Context: EXTI handlers
+  void (*const doSetFifoOverflow)(uint8_t);    ///< Context: EXTI handlers
+  void (*const doSet5usTimerExpired)();        ///< Context: TIM3_IRQHandler()
+  void (*const doTickMillisecond)();           ///< Context: SysTick_Handler()
   /// @}
 };
 
@@ -52,11 +143,36 @@ struct Controller_Host {
    */
   void (*const doTakeBytes)(const uint8_t *, uint16_t);
 
+  /**
+   * Device API for notifying about a completed IN transfer.
+   *
+   * Context: CDC_TransmitCplt_FS(uint8_t *, uint32_t *, uint8_t)
+   */
+  void (*const doNotifyTransmitComplete)();
+
+  /**
+   * Device API for discarding partially received requests when the host
+   * (re-)connects.
+   *
+   * Context: CDC_Init_FS()
+   */
+  void (*const doResetReception)();
+
+  /**
+   * Device API for notifying about a USB start-of-frame.
+   *
+   * Context: OTG_FS_IRQHandler()
+   */
+  void (*const doNotifyStartOfFrame)();
+
   /**
    * Device API for Host-Transport callbacks upon doTakeBytes(uint8_t *,
    * uint16_t).
    *
-   * Context: CDC_Receive_FS(uint8_t*, uint32_t *)
+   * Requests are queued in interrupt context and dispatched in main() in
+   * between sampling batches. Setters return -EBUSY while sampling.
+   *
+   * Context: main()
    * @{
    */
   void (*const onRequestGetFirmwareVersion)();
@@ -70,6 +186,21 @@ struct Controller_Host {
   void (*const onRequestGetDeviceSetup)();
   void (*const onRequestSamplingStart)(uint16_t);
   void (*const onRequestSamplingStop)();
+  int (*const onRequestConfigureAndStart)(
+      const struct TransportRx_ConfigureAndStart *);
+  int (*const onRequestCaptureStart)(uint16_t);
+  int (*const onRequestCaptureRead)(uint16_t);
+  int (*const onRequestSetAxes)(uint8_t);
+  int (*const onRequestSetFraming)(bool);
+  int (*const onRequestSetMaxLatency)(uint16_t);
+  int (*const onRequestSetCalibration)(const struct Transport_Calibration *);
+  int (*const onRequestGetCalibration)(uint8_t);
+  void (*const onRequestGetSpiClock)();
+  int (*const onRequestSaveConfiguration)();
+  int (*const onRequestRecorderStart)(const struct TransportRx_RecorderStart *);
+  int (*const onRequestSequenceAppend)(
+      const struct TransportRx_SequenceAppend *);
+  void (*const onRequestSequenceMarker)();
   void (*const onRequestUptime)();
   void (*const onRequestBufferStatus)();
   /// @}
@@ -100,6 +231,16 @@ struct Controller_Handle {
    */
   struct Controller_Host host;
 
+  /**
+   * Events posted by interrupts and served by the main loop.
+   */
+  struct Controller_Events events;
+
+  /**
+   * Responses requested by interrupts or main loop and transmitted in main().
+   */
+  struct Controller_Responses responses;
+
   /**
    * Public device API.
    * @{
@@ -117,3 +258,66 @@ struct Controller_Handle {
 
   /// @}
 };
+
+/**
+ * Posts event bits (atomic read-modify-write).
+ *
+ * Context: main() and interrupts
+ *
+ * @param events event state
+ * @param mask bitwise or of Controller_Event
+ */
+void Controller_postEvents(struct Controller_Events *events, uint32_t mask);
+
+/**
+ * Takes and clears all pending event bits (atomic exchange).
+ *
+ * Context: main()
+ *
+ * @param events event state
+ * @return bitwise or of pending Controller_Event
+ */
+uint32_t Controller_takeEvents(struct Controller_Events *events);
+
+/**
+ * Tests whether event bits are pending without clearing them.
+ *
+ * Context: main()
+ *
+ * @param events event state
+ * @return true if at least one event is pending
+ */
+bool Controller_hasEvents(const struct Controller_Events *events);
+
+/**
+ * Marks a response as pending (atomic read-modify-write).
+ *
+ * Requesting a response which is pending already has no further effect.
+ *
+ * Context: main() and interrupts
+ *
+ * @param responses response state
+ * @param response response to transmit later on
+ */
+void Controller_requestResponse(struct Controller_Responses *responses,
+                                enum Controller_Response response);
+
+/**
+ * Takes the pending response with highest priority and clears its bit.
+ *
+ * Context: main()
+ *
+ * @param responses response state
+ * @return -ENODATA if nothing is pending, the Controller_Response otherwise
+ */
+int Controller_takeResponse(struct Controller_Responses *responses);
+
+/**
+ * Tests whether responses are pending without clearing them.
+ *
+ * Context: main()
+ *
+ * @param responses response state
+ * @return true if at least one response is pending
+ */
+bool Controller_hasResponses(const struct Controller_Responses *responses);
@@ -0,0 +1,27 @@
+/**
+ * \file crc.h
+ *
+ * Software CRC-32 matching the STM32F4 CRC calculation unit.
+ *
+ * The unit processes 32-bit words MSB first with polynomial 0x04C11DB7 and
+ * initial value 0xFFFFFFFF, neither reflected nor finally inverted. This
+ * implementation computes the same value with a 256 entry table, i.e. for
+ * native builds or targets without the unit.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CRC_CRC32_INITIAL 0xFFFFFFFFUL
+
+/**
+ * Computes the CRC over 32-bit words.
+ *
+ * @param words input, as the words are written to the CRC unit's data
+ * register
+ * @param count number of words
+ * @return CRC
+ */
+uint32_t Crc_crc32Words(const uint32_t *words, uint16_t count);
@@ -0,0 +1,720 @@
+/**
+ * \file host_decoder.c
+ */
+
+#include "host_decoder.h"
+#include <codec.h>
+#include <codec_packed.h>
+#include <crc.h>
+#include <errno.h>
+#include <string.h>
+
+/**
+ * First byte of a stream frame on the wire (little endian sync word).
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define STREAM_SYNC_FIRST_BYTE ((uint8_t)(TRANSPORT_STREAM_SYNC & 0xFFU))
+
+/**
+ * Total frame length (header including payload) per TX header id.
+ *
+ * Zero for IDs which are no valid responses or whose length depends on the
+ * payload.
+ */
+static const uint8_t txFrameLengths[] = {
+    [Transport_HeaderId_Tx_OutputDataRate] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_OutputDataRate),
+    [Transport_HeaderId_Tx_Range] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Range),
+    [Transport_HeaderId_Tx_Scale] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Scale),
+    [Transport_HeaderId_Tx_DeviceSetup] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_DeviceSetup),
+    [Transport_HeaderId_Tx_FirmwareVersion] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_FirmwareVersion),
+    [Transport_HeaderId_Tx_Uptime] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Uptime),
+    [Transport_HeaderId_Tx_BufferStatus] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_BufferStatus),
+    [Transport_HeaderId_Tx_FifoOverflow] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_FifoOverflow),
+    [Transport_HeaderId_Tx_SamplingStarted] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_SamplingStarted),
+    [Transport_HeaderId_Tx_SamplingFinished] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_SamplingFinished),
+    [Transport_HeaderId_Tx_SamplingStopped] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_SamplingStopped),
+    [Transport_HeaderId_Tx_SamplingAborted] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_SamplingAborted),
+    [Transport_HeaderId_Tx_Acceleration] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration),
+    [Transport_HeaderId_Tx_Fault] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Fault),
+    [Transport_HeaderId_Tx_BufferOverflow] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_BufferOverflow),
+    [Transport_HeaderId_Tx_TransmissionError] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_TransmissionError),
+    [Transport_HeaderId_Tx_SamplingConfiguredStarted] =
+        SIZEOF_HEADER_INCL_PAYLOAD(
+            struct TransportTx_SamplingConfiguredStarted),
+    [Transport_HeaderId_Tx_RecorderFinished] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_RecorderFinished),
+    [Transport_HeaderId_Tx_SequenceSegment] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_SequenceSegment),
+    [Transport_HeaderId_Tx_ClockCorrelation] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_ClockCorrelation),
+    [Transport_HeaderId_Tx_AccelerationSensor] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSensor),
+    [Transport_HeaderId_Tx_Calibration] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Calibration),
+    [Transport_HeaderId_Tx_SpiClock] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_SpiClock),
+    [Transport_HeaderId_Tx_ConfigurationSaved] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_ConfigurationSaved),
+    [Transport_HeaderId_Tx_StreamSetup] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_StreamSetup),
+};
+
+/**
+ * Looks up the fixed frame length.
+ *
+ * @param headerId first byte of frame
+ * @return total frame length in bytes, 0 if unknown or variable
+ */
+static uint8_t txFrameLength(uint8_t headerId) {
+  if (headerId >= sizeof(txFrameLengths)) {
+    return 0;
+  }
+  return txFrameLengths[headerId];
+}
+
+/**
+ * Determines the size of a stream frame \see Transport_StreamFrameHeader.
+ *
+ * @param bytes start of frame
+ * @param count number of readable bytes
+ * @return same as HostDecoder_frameSizeBytes()
+ */
+static int streamFrameSizeBytes(const uint8_t *bytes, uint16_t count) {
+  const uint32_t sync = {TRANSPORT_STREAM_SYNC};
+  for (uint16_t idx = 0; idx < count && idx < sizeof(sync); idx++) {
+    if (((const uint8_t *)&sync)[idx] != bytes[idx]) {
+      return -EBADMSG;
+    }
+  }
+
+  if (count < sizeof(struct Transport_StreamFrameHeader)) {
+    return 0;
+  }
+
+  const struct Transport_StreamFrameHeader *header = {
+      (const struct Transport_StreamFrameHeader *)bytes};
+  if (TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES < header->length) {
+    return -EBADMSG;
+  }
+
+  return sizeof(struct Transport_StreamFrameHeader) +
+         ((header->length + 3U) & ~3U) + sizeof(uint32_t);
+}
+
+/**
+ * Determines the size of a frame whose size depends on its payload.
+ *
+ * @param handle
+ * @param frame start of frame
+ * @param count number of readable bytes
+ * @return same as HostDecoder_frameSizeBytes()
+ */
+static int blockFrameSizeBytes(const struct HostDecoder_Handle *handle,
+                               const struct TransportFrame *frame,
+                               uint16_t count) {
+  const union TransportTxFrame *tx = {&frame->asTxFrame};
+
+  switch (frame->header.id) {
+  case Transport_HeaderId_Tx_CaptureChunk: {
+    const uint16_t headerBytes = {
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_CaptureChunk)};
+    if (count < headerBytes) {
+      return 0;
+    }
+    return headerBytes +
+           tx->asCaptureChunk.count * Transport_sampleSizeBytes(handle->axes);
+  }
+
+  case Transport_HeaderId_Tx_AccelerationAxes: {
+    const uint16_t headerBytes = {
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationAxes)};
+    if (count < headerBytes) {
+      return 0;
+    }
+    const uint8_t axes = {tx->asAccelerationAxes.axes};
+    if (0 == (axes & Transport_Axis_All) || 0 != (axes & ~Transport_Axis_All)) {
+      return -EBADMSG;
+    }
+    return headerBytes +
+           tx->asAccelerationAxes.count * Transport_sampleSizeBytes(axes);
+  }
+
+  case Transport_HeaderId_Tx_AccelerationDelta: {
+    const uint16_t headerBytes = {
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationDelta)};
+    if (count < headerBytes) {
+      return 0;
+    }
+    const int blockBytes = {Codec_blockSizeBytes(
+        &((const uint8_t *)frame)[headerBytes], count - headerBytes)};
+    if (-EAGAIN == blockBytes) {
+      return 0;
+    }
+    if (0 > blockBytes) {
+      return -EBADMSG;
+    }
+    return headerBytes + blockBytes;
+  }
+
+  case Transport_HeaderId_Tx_AccelerationPacked: {
+    const uint16_t headerBytes = {
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationPacked)};
+    if (count < headerBytes) {
+      return 0;
+    }
+    const uint8_t format = {tx->asAccelerationPacked.format};
+    if (!Transport_isPackedFormat(format)) {
+      return -EBADMSG;
+    }
+    return headerBytes +
+           tx->asAccelerationPacked.count *
+               Codec_packedSizeBytes(Transport_SampleFormat_Packed13 == format
+                                         ? Codec_Packing_13bit
+                                         : Codec_Packing_10bit);
+  }
+
+  case Transport_HeaderId_Tx_AccelerationSoa: {
+    const uint16_t headerBytes = {
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSoa)};
+    if (count < headerBytes) {
+      return 0;
+    }
+    return headerBytes +
+           3U * TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(tx->asAccelerationSoa.count);
+  }
+
+  default:
+    return -EBADMSG;
+  }
+}
+
+int HostDecoder_frameSizeBytes(const struct HostDecoder_Handle *handle,
+                               const uint8_t *bytes, uint16_t count,
+                               bool isStreamContent) {
+  if (0 == count) {
+    return 0;
+  }
+
+  if (STREAM_SYNC_FIRST_BYTE == bytes[0]) {
+    return isStreamContent ? -EBADMSG : streamFrameSizeBytes(bytes, count);
+  }
+
+  int size = {txFrameLength(bytes[0])};
+  if (0 == size) {
+    size = blockFrameSizeBytes(handle, (const struct TransportFrame *)bytes,
+                               count);
+  }
+
+  if (0 < size && HOSTDECODER_FRAME_MAX_BYTES < (size_t)size) {
+    return -EBADMSG;
+  }
+  return size;
+}
+
+static void feed(struct HostDecoder_Handle *handle,
+                 struct HostDecoder_Assembler *assembler, bool isStreamContent,
+                 const uint8_t *bytes, size_t count);
+
+/**
+ * Hands out the pending samples as one block.
+ *
+ * @param handle
+ */
+static void flushBlock(struct HostDecoder_Handle *handle) {
+  if (0 == handle->block.count) {
+    return;
+  }
+  handle->statistics.blocksCount++;
+  if (NULL != handle->onBlockImpl) {
+    handle->onBlockImpl(handle->context, &handle->block);
+  }
+  handle->block.count = 0;
+}
+
+/**
+ * Prepares the pending block for samples starting at firstIndex.
+ *
+ * The block is handed out before if it is full or firstIndex does not follow
+ * its last sample.
+ *
+ * @param handle
+ * @param firstIndex running index of the next sample
+ * @return number of samples the block takes before it is full
+ */
+static uint16_t blockRoom(struct HostDecoder_Handle *handle,
+                          uint16_t firstIndex) {
+  struct HostDecoder_Block *block = {&handle->block};
+  if (0 < block->count &&
+      (HOSTDECODER_BLOCK_SAMPLES == block->count ||
+       (uint16_t)(block->firstIndex + block->count) != firstIndex)) {
+    flushBlock(handle);
+  }
+  if (0 == block->count) {
+    block->sensor = handle->sensor;
+    block->firstIndex = firstIndex;
+  }
+  return HOSTDECODER_BLOCK_SAMPLES - block->count;
+}
+
+/**
+ * Takes count samples written behind the pending ones into the block.
+ *
+ * @param handle
+ * @param count number of samples written
+ */
+static void commitSamples(struct HostDecoder_Handle *handle, uint16_t count) {
+  struct HostDecoder_Block *block = {&handle->block};
+  handle->statistics.samplesCount += count;
+
+  if (NULL != handle->onSampleImpl) {
+    for (uint16_t idx = block->count; idx < block->count + count; idx++) {
+      const struct HostDecoder_Sample sample = {
+          .sensor = block->sensor,
+          .index = block->firstIndex + idx,
+          .values = {
+              .x = block->x[idx], .y = block->y[idx], .z = block->z[idx]}};
+      handle->onSampleImpl(handle->context, &sample);
+    }
+  }
+  block->count += count;
+}
+
+/**
+ * Appends consecutive samples to the pending block.
+ *
+ * @param handle
+ * @param firstIndex running index of the first sample
+ * @param samples
+ * @param count number of samples
+ */
+static void appendSamples(struct HostDecoder_Handle *handle,
+                          uint16_t firstIndex,
+                          const struct Codec_Acceleration *samples,
+                          uint16_t count) {
+  struct HostDecoder_Block *block = {&handle->block};
+  uint16_t done = {0};
+
+  while (done < count) {
+    uint16_t room = {blockRoom(handle, firstIndex + done)};
+    if (count - done < room) {
+      room = count - done;
+    }
+    for (uint16_t idx = 0; idx < room; idx++) {
+      block->x[block->count + idx] = samples[done + idx].x;
+      block->y[block->count + idx] = samples[done + idx].y;
+      block->z[block->count + idx] = samples[done + idx].z;
+    }
+    commitSamples(handle, room);
+    done += room;
+  }
+}
+
+/**
+ * Decodes a run of TransportTx_Acceleration frames.
+ *
+ * The run is split at index discontinuities only, each part is transposed
+ * into the columns of the block in one loop.
+ *
+ * @param handle
+ * @param bytes start of first frame
+ * @param count number of readable bytes
+ * @return number of bytes consumed by complete frames
+ */
+static size_t decodeAccelerationRun(struct HostDecoder_Handle *handle,
+                                    const uint8_t *bytes, size_t count) {
+  const size_t frameBytes = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration)};
+  size_t framesCount = {0};
+  while ((framesCount + 1U) * frameBytes <= count &&
+         Transport_HeaderId_Tx_Acceleration ==
+             bytes[framesCount * frameBytes]) {
+    framesCount++;
+  }
+  handle->statistics.framesCount += framesCount;
+
+  struct HostDecoder_Block *block = {&handle->block};
+  size_t done = {0};
+  while (done < framesCount) {
+    const struct TransportTx_Acceleration *first = {
+        &((const struct TransportFrame *)&bytes[done * frameBytes])
+             ->asTxFrame.asAcceleration};
+    const uint16_t room = {blockRoom(handle, first->index)};
+
+    uint16_t consecutive = {1};
+    while (consecutive < room && done + consecutive < framesCount &&
+           ((const struct TransportFrame *)&bytes[(done + consecutive) *
+                                                  frameBytes])
+                   ->asTxFrame.asAcceleration.index ==
+               (uint16_t)(first->index + consecutive)) {
+      consecutive++;
+    }
+
+    int16_t *x = {&block->x[block->count]};
+    int16_t *y = {&block->y[block->count]};
+    int16_t *z = {&block->z[block->count]};
+    const uint8_t *frame = {&bytes[done * frameBytes]};
+    for (uint16_t idx = 0; idx < consecutive; idx++) {
+      const struct Transport_Acceleration *values = {
+          &((const struct TransportFrame *)&frame[idx * frameBytes])
+               ->asTxFrame.asAcceleration.values};
+      x[idx] = values->x;
+      y[idx] = values->y;
+      z[idx] = values->z;
+    }
+    commitSamples(handle, consecutive);
+    done += consecutive;
+  }
+
+  return framesCount * frameBytes;
+}
+
+/**
+ * Decodes a TransportTx_AccelerationAxes frame, axes not transmitted are 0.
+ *
+ * @param handle
+ * @param payload
+ */
+static void decodeAxes(struct HostDecoder_Handle *handle,
+                       const struct TransportTx_AccelerationAxes *payload) {
+  const uint8_t axisBits[] = {Transport_Axis_X, Transport_Axis_Y,
+                              Transport_Axis_Z};
+  const uint8_t *values = {(const uint8_t *)&payload[1]};
+  struct HostDecoder_Block *block = {&handle->block};
+  uint16_t done = {0};
+
+  while (done < payload->count) {
+    uint16_t room = {blockRoom(handle, payload->firstIndex + done)};
+    if (payload->count - done < room) {
+      room = payload->count - done;
+    }
+    for (uint16_t idx = block->count; idx < block->count + room; idx++) {
+      int16_t sample[3] = {0};
+      for (uint8_t axis = 0; axis < 3U; axis++) {
+        if (0 != (payload->axes & axisBits[axis])) {
+          memcpy(&sample[axis], values, sizeof(int16_t));
+          values += sizeof(int16_t);
+        }
+      }
+      block->x[idx] = sample[0];
+      block->y[idx] = sample[1];
+      block->z[idx] = sample[2];
+    }
+    commitSamples(handle, room);
+    done += room;
+  }
+}
+
+/**
+ * Decodes a TransportTx_AccelerationSoa frame column by column.
+ *
+ * @param handle
+ * @param payload
+ */
+static void decodeSoa(struct HostDecoder_Handle *handle,
+                      const struct TransportTx_AccelerationSoa *payload) {
+  const size_t strideBytes = {
+      TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(payload->count)};
+  const uint8_t *x = {(const uint8_t *)&payload[1]};
+  const uint8_t *y = {&x[strideBytes]};
+  const uint8_t *z = {&y[strideBytes]};
+  struct HostDecoder_Block *block = {&handle->block};
+  uint16_t done = {0};
+
+  while (done < payload->count) {
+    uint16_t room = {blockRoom(handle, payload->firstIndex + done)};
+    if (payload->count - done < room) {
+      room = payload->count - done;
+    }
+    const size_t offset = {done * sizeof(int16_t)};
+    memcpy(&block->x[block->count], &x[offset], room * sizeof(int16_t));
+    memcpy(&block->y[block->count], &y[offset], room * sizeof(int16_t));
+    memcpy(&block->z[block->count], &z[offset], room * sizeof(int16_t));
+    commitSamples(handle, room);
+    done += room;
+  }
+}
+
+/**
+ * Decodes a TransportTx_AccelerationPacked frame.
+ *
+ * @param handle
+ * @param payload
+ */
+static void decodePacked(struct HostDecoder_Handle *handle,
+                         const struct TransportTx_AccelerationPacked *payload) {
+  const enum Codec_Packing packing = {
+      Transport_SampleFormat_Packed13 == payload->format ? Codec_Packing_13bit
+                                                         : Codec_Packing_10bit};
+  const uint8_t *packed = {(const uint8_t *)&payload[1]};
+  struct Codec_Acceleration samples[CODEC_BLOCK_MAX_SAMPLES];
+  uint16_t done = {0};
+
+  while (done < payload->count) {
+    uint16_t count = {payload->count - done};
+    if (CODEC_BLOCK_MAX_SAMPLES < count) {
+      count = CODEC_BLOCK_MAX_SAMPLES;
+    }
+    packed += Codec_unpack(packing, packed, count, samples);
+    appendSamples(handle, payload->firstIndex + done, samples, count);
+    done += count;
+  }
+}
+
+/**
+ * Decodes a TransportTx_AccelerationDelta frame.
+ *
+ * @param handle
+ * @param payload
+ * @param blockBytes size of the codec block following the payload
+ */
+static void decodeDelta(struct HostDecoder_Handle *handle,
+                        const struct TransportTx_AccelerationDelta *payload,
+                        uint16_t blockBytes) {
+  struct Codec_Acceleration samples[CODEC_BLOCK_MAX_SAMPLES];
+  const int count = {Codec_decodeBlock((const uint8_t *)&payload[1],
+                                       blockBytes, samples,
+                                       CODEC_BLOCK_MAX_SAMPLES)};
+  if (0 > count) {
+    handle->statistics.discardedBytes +=
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationDelta) +
+        blockBytes;
+    return;
+  }
+  appendSamples(handle, payload->firstIndex, samples, count);
+}
+
+/**
+ * Hands out one complete frame.
+ *
+ * @param handle
+ * @param bytes start of frame
+ * @param frameBytes size of frame
+ */
+static void processFrame(struct HostDecoder_Handle *handle,
+                         const uint8_t *bytes, uint16_t frameBytes) {
+  const struct TransportFrame *frame = {(const struct TransportFrame *)bytes};
+  const union TransportTxFrame *tx = {&frame->asTxFrame};
+  handle->statistics.framesCount++;
+
+  switch (frame->header.id) {
+  case Transport_HeaderId_Tx_Acceleration: {
+    const struct Codec_Acceleration sample = {
+        .x = tx->asAcceleration.values.x,
+        .y = tx->asAcceleration.values.y,
+        .z = tx->asAcceleration.values.z};
+    appendSamples(handle, tx->asAcceleration.index, &sample, 1);
+    return;
+  }
+  case Transport_HeaderId_Tx_AccelerationAxes:
+    decodeAxes(handle, &tx->asAccelerationAxes);
+    return;
+  case Transport_HeaderId_Tx_AccelerationSoa:
+    decodeSoa(handle, &tx->asAccelerationSoa);
+    return;
+  case Transport_HeaderId_Tx_AccelerationPacked:
+    decodePacked(handle, &tx->asAccelerationPacked);
+    return;
+  case Transport_HeaderId_Tx_AccelerationDelta:
+    decodeDelta(handle, &tx->asAccelerationDelta,
+                frameBytes - SIZEOF_HEADER_INCL_PAYLOAD(
+                                 struct TransportTx_AccelerationDelta));
+    return;
+  default:
+    break;
+  }
+
+  // events stay in order with the samples around them
+  flushBlock(handle);
+
+  switch (frame->header.id) {
+  case Transport_HeaderId_Tx_AccelerationSensor:
+    handle->sensor = tx->asAccelerationSensor.sensor;
+    break;
+  case Transport_HeaderId_Tx_SamplingStarted:
+  case Transport_HeaderId_Tx_SamplingConfiguredStarted:
+    handle->sensor = 0;
+    break;
+  default:
+    break;
+  }
+
+  if (NULL != handle->onFrameImpl) {
+    handle->onFrameImpl(handle->context, frame, frameBytes);
+  }
+}
+
+/**
+ * Verifies a stream frame and decodes the chunk it wraps.
+ *
+ * A frame failing the CRC is dropped as a whole, its content is not trusted.
+ *
+ * @param handle
+ * @param bytes start of frame, word aligned
+ * @param frameBytes size of frame
+ */
+static void processStreamFrame(struct HostDecoder_Handle *handle,
+                               const uint8_t *bytes, uint16_t frameBytes) {
+  const uint16_t crcOffset = {frameBytes - sizeof(uint32_t)};
+  uint32_t crc = {0};
+  memcpy(&crc, &bytes[crcOffset], sizeof(crc));
+  if (crc != Crc_crc32Words((const uint32_t *)bytes,
+                            crcOffset / sizeof(uint32_t))) {
+    handle->statistics.crcErrorCount++;
+    handle->statistics.discardedBytes += frameBytes;
+    return;
+  }
+
+  // sequence restarts with each sampling start
+  const struct Transport_StreamFrameHeader *header = {
+      (const struct Transport_StreamFrameHeader *)bytes};
+  if (handle->hasSequence && 0 != header->sequence &&
+      handle->expectedSequence != header->sequence) {
+    handle->statistics.lostStreamFramesCount +=
+        (uint16_t)(header->sequence - handle->expectedSequence);
+    // remainder of a frame split across the lost stream frames
+    handle->inner.count = 0;
+  }
+  handle->hasSequence = true;
+  handle->expectedSequence = header->sequence + 1U;
+
+  feed(handle, &handle->inner, true,
+       &bytes[sizeof(struct Transport_StreamFrameHeader)], header->length);
+}
+
+/**
+ * Hands out one complete frame or stream frame.
+ *
+ * @param handle
+ * @param bytes start of frame, word aligned if stream frame
+ * @param frameBytes size of frame
+ * @param isStreamContent \see HostDecoder_frameSizeBytes()
+ */
+static void dispatch(struct HostDecoder_Handle *handle, const uint8_t *bytes,
+                     uint16_t frameBytes, bool isStreamContent) {
+  if (!isStreamContent && STREAM_SYNC_FIRST_BYTE == bytes[0]) {
+    processStreamFrame(handle, bytes, frameBytes);
+  } else {
+    processFrame(handle, bytes, frameBytes);
+  }
+}
+
+/**
+ * Decodes the reassembled frames and drops bytes not starting a frame.
+ *
+ * @param handle
+ * @param assembler
+ * @param isStreamContent \see HostDecoder_frameSizeBytes()
+ * @return number of bytes still missing for the next frame
+ */
+static uint16_t drain(struct HostDecoder_Handle *handle,
+                      struct HostDecoder_Assembler *assembler,
+                      bool isStreamContent) {
+  while (0 < assembler->count) {
+    const int size = {HostDecoder_frameSizeBytes(
+        handle, assembler->bytes, assembler->count, isStreamContent)};
+    if (0 == size) {
+      return 1;
+    }
+    if (0 < size && assembler->count < size) {
+      return size - assembler->count;
+    }
+
+    uint16_t consumed = {1};
+    if (0 < size) {
+      dispatch(handle, assembler->bytes, size, isStreamContent);
+      consumed = size;
+    } else {
+      handle->statistics.discardedBytes++;
+    }
+
+    assembler->count -= consumed;
+    memmove(assembler->bytes, &assembler->bytes[consumed], assembler->count);
+  }
+  return 1;
+}
+
+/**
+ * Decodes bytes, in place as far as frames do not span chunks.
+ *
+ * @param handle
+ * @param assembler holds the frame spanning chunks
+ * @param isStreamContent \see HostDecoder_frameSizeBytes()
+ * @param bytes
+ * @param count
+ */
+static void feed(struct HostDecoder_Handle *handle,
+                 struct HostDecoder_Assembler *assembler, bool isStreamContent,
+                 const uint8_t *bytes, size_t count) {
+  size_t offset = {0};
+
+  while (offset < count) {
+    const size_t remaining = {count - offset};
+
+    // stream frames are reassembled, the CRC is computed over aligned words
+    if (0 == assembler->count &&
+        (isStreamContent || STREAM_SYNC_FIRST_BYTE != bytes[offset])) {
+      if (Transport_HeaderId_Tx_Acceleration == bytes[offset]) {
+        const size_t consumed = {
+            decodeAccelerationRun(handle, &bytes[offset], remaining)};
+        if (0 < consumed) {
+          offset += consumed;
+          continue;
+        }
+      }
+
+      const uint16_t available = {
+          remaining < UINT16_MAX ? (uint16_t)remaining : UINT16_MAX};
+      const int size = {HostDecoder_frameSizeBytes(handle, &bytes[offset],
+                                                   available, isStreamContent)};
+      if (-EBADMSG == size) {
+        handle->statistics.discardedBytes++;
+        offset++;
+        continue;
+      }
+      if (0 < size && size <= available) {
+        processFrame(handle, &bytes[offset], size);
+        offset += size;
+        continue;
+      }
+    }
+
+    uint16_t missing = {drain(handle, assembler, isStreamContent)};
+    if (remaining < missing) {
+      missing = remaining;
+    }
+    memcpy(&assembler->bytes[assembler->count], &bytes[offset], missing);
+    assembler->count += missing;
+    offset += missing;
+    drain(handle, assembler, isStreamContent);
+  }
+}
+
+void HostDecoder_feed(struct HostDecoder_Handle *handle, const uint8_t *bytes,
+                      size_t count) {
+  feed(handle, &handle->outer, false, bytes, count);
+  flushBlock(handle);
+}
+
+void HostDecoder_reset(struct HostDecoder_Handle *handle) {
+  handle->outer.count = 0;
+  handle->inner.count = 0;
+  handle->block.count = 0;
+  handle->hasSequence = false;
+  handle->sensor = 0;
+}
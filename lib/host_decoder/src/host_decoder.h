@@ -0,0 +1,199 @@
+/**
+ * \file host_decoder.h
+ *
+ * Host side decoder of the byte stream received from the controller.
+ *
+ * Splits the stream into TransportFrame, unwraps stream frames \see
+ * Transport_StreamFrameHeader and hands out acceleration samples. Frame sizes
+ * are derived from the payload types of host_transport_types.h and the codecs
+ * of the firmware, hence host and controller share one definition of the
+ * protocol.
+ *
+ * Bytes may be fed in chunks of arbitrary size, frames spanning chunks are
+ * reassembled. Bytes not starting a known frame are skipped until the decoder
+ * is in sync again.
+ *
+ * Samples of all sample formats are collected into blocks of separate axis
+ * columns \see HostDecoder_Block. Runs of TransportTx_Acceleration frames
+ * within a chunk are decoded in one pass without dispatching frame by frame.
+ */
+
+#pragma once
+
+#include <host_transport.h>
+#include <host_transport_types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Largest frame to reassemble: a stream frame of a complete transmit chunk.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define HOSTDECODER_FRAME_MAX_BYTES                                            \
+  (TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES +                           \
+   sizeof(struct Transport_StreamFrameHeader) + sizeof(uint32_t))
+
+/**
+ * One decoded acceleration sample.
+ */
+struct HostDecoder_Sample {
+  uint8_t sensor; ///< sensor ID, \see TransportTx_AccelerationSensor
+  uint16_t index; ///< running sample index of the sensor
+  struct Transport_Acceleration values;
+};
+
+/**
+ * Capacity of HostDecoder_Block.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define HOSTDECODER_BLOCK_SAMPLES 256U
+
+/**
+ * Consecutive samples of one sensor as structure of arrays.
+ *
+ * Sample idx has the running index firstIndex + idx (modulo 2^16).
+ */
+struct HostDecoder_Block {
+  uint8_t sensor;      ///< sensor ID, \see TransportTx_AccelerationSensor
+  uint16_t firstIndex; ///< running sample index of the first sample
+  uint16_t count;      ///< number of samples
+  int16_t x[HOSTDECODER_BLOCK_SAMPLES];
+  int16_t y[HOSTDECODER_BLOCK_SAMPLES];
+  int16_t z[HOSTDECODER_BLOCK_SAMPLES];
+};
+
+/**
+ * Partially received frame.
+ */
+struct HostDecoder_Assembler {
+  uint8_t bytes[HOSTDECODER_FRAME_MAX_BYTES] __attribute__((aligned(4)));
+  uint16_t count; ///< number of bytes received so far
+};
+
+/**
+ * Decoder counters, never reset by the decoder itself.
+ */
+struct HostDecoder_Statistics {
+  uint32_t framesCount;           ///< decoded frames except stream frames
+  uint32_t samplesCount;          ///< decoded acceleration samples
+  uint32_t blocksCount;           ///< handed out sample blocks
+  uint32_t discardedBytes;        ///< bytes dropped while out of sync
+  uint32_t crcErrorCount;         ///< stream frames with CRC mismatch
+  uint32_t lostStreamFramesCount; ///< gaps in the stream frame sequence
+};
+
+/**
+ * Decoder state.
+ *
+ * Example:
+ * \code
+ * static void onBlock(void *context,
+ *                     const struct HostDecoder_Block *block) {}
+ *
+ * struct HostDecoder_Handle decoder = HOSTDECODER_INITIALIZER(
+ *     NULL, NULL, onBlock, NULL);
+ *
+ * // per chunk received
+ * HostDecoder_feed(&decoder, bytes, count);
+ * \endcode
+ */
+struct HostDecoder_Handle {
+  /**
+   * Called for each decoded frame except sample and stream frames.
+   *
+   * Samples decoded before are handed out first.
+   *
+   * @param context HostDecoder_Handle.context
+   * @param frame complete frame, valid during the call only
+   * @param frameBytes size of frame including header and trailing data
+   */
+  void (*onFrameImpl)(void *context, const struct TransportFrame *frame,
+                      uint16_t frameBytes);
+
+  /**
+   * Called for each decoded acceleration sample.
+   *
+   * @param context HostDecoder_Handle.context
+   * @param sample valid during the call only
+   */
+  void (*onSampleImpl)(void *context, const struct HostDecoder_Sample *sample);
+
+  /**
+   * Called for each block of consecutive samples.
+   *
+   * A block is handed out when full, at discontinuities of the sample index,
+   * in front of any other frame and at the end of HostDecoder_feed().
+   *
+   * @param context HostDecoder_Handle.context
+   * @param block valid during the call only
+   */
+  void (*onBlockImpl)(void *context, const struct HostDecoder_Block *block);
+
+  void *context; ///< passed to the callbacks as is
+
+  /**
+   * Axes selected by the host, sizes TransportTx_CaptureChunk frames.
+   * \see Transport_Axis
+   */
+  uint8_t axes;
+
+  uint8_t sensor;            ///< sensor of following acceleration frames
+  bool hasSequence;          ///< expectedSequence is valid
+  uint16_t expectedSequence; ///< sequence of next stream frame
+
+  struct HostDecoder_Statistics statistics;
+
+  struct HostDecoder_Block block;     ///< samples not handed out yet
+  struct HostDecoder_Assembler outer; ///< frame of the plain byte stream
+  struct HostDecoder_Assembler inner; ///< frame within stream frames
+};
+
+#define HOSTDECODER_INITIALIZER(ON_FRAME_CB, ON_SAMPLE_CB, ON_BLOCK_CB,        \
+                                CONTEXT)                                       \
+  {                                                                            \
+    .onFrameImpl = (ON_FRAME_CB), .onSampleImpl = (ON_SAMPLE_CB),              \
+    .onBlockImpl = (ON_BLOCK_CB), .context = (CONTEXT),                        \
+    .axes = Transport_Axis_All, .sensor = 0, .hasSequence = false,             \
+    .expectedSequence = 0, .statistics = {0}, .block = {.count = 0},           \
+    .outer = {.count = 0}, .inner = {.count = 0},                              \
+  }
+
+/**
+ * Decodes the next chunk of received bytes.
+ *
+ * Callbacks are invoked in stream order before returning, samples pending
+ * in HostDecoder_Handle.block are handed out.
+ *
+ * @param handle
+ * @param bytes received bytes
+ * @param count number of bytes
+ */
+void HostDecoder_feed(struct HostDecoder_Handle *handle, const uint8_t *bytes,
+                      size_t count);
+
+/**
+ * Drops partially received frames, i.e. after the device was re-opened.
+ *
+ * Statistics are kept.
+ *
+ * @param handle
+ */
+void HostDecoder_reset(struct HostDecoder_Handle *handle);
+
+/**
+ * Determines the size of the frame at bytes.
+ *
+ * @param handle
+ * @param bytes start of frame
+ * @param count number of readable bytes
+ * @param isStreamContent bytes are the content of a stream frame, which must
+ * not contain stream frames again
+ * @return
+ *   - size of frame in bytes, may exceed count
+ *   - 0 if count does not cover the fields the size depends on
+ *   - -EBADMSG if bytes do not start a frame
+ */
+int HostDecoder_frameSizeBytes(const struct HostDecoder_Handle *handle,
+                               const uint8_t *bytes, uint16_t count,
+                               bool isStreamContent);
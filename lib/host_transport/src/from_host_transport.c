@@ -4,10 +4,135 @@
  * Implementation for processing data from host to controller.
  */
 
+#include "from_host_transport.h"
 #include "host_transport.h"
 #include "host_transport_types.h"
 #include <errno.h>
 #include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Total request length (header including payload) per RX header id.
+ *
+ * Zero for IDs which are not valid requests.
+ */
+static const uint8_t rxFrameLengths[] = {
+    [Transport_HeaderId_Rx_SetOutputDataRate] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetOutputDataRate),
+    [Transport_HeaderId_Rx_GetOutputDataRate] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetOutputDataRate),
+    [Transport_HeaderId_Rx_SetRange] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetRange),
+    [Transport_HeaderId_Rx_GetRange] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetRange),
+    [Transport_HeaderId_Rx_SetScale] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetScale),
+    [Transport_HeaderId_Rx_GetScale] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetScale),
+    [Transport_HeaderId_Rx_GetDeviceSetup] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetDeviceSetup),
+    [Transport_HeaderId_Rx_GetFirmwareVersion] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetFirmwareVersion),
+    [Transport_HeaderId_Rx_GetUptime] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetUptime),
+    [Transport_HeaderId_Rx_GetBufferStatus] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetBufferStatus),
+    [Transport_HeaderId_Rx_DeviceReboot] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_DeviceReboot),
+    [Transport_HeaderId_Rx_SamplingStart] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SamplingStart),
+    [Transport_HeaderId_Rx_SamplingStop] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SamplingStop),
+    [Transport_HeaderId_Rx_ConfigureAndStart] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_ConfigureAndStart),
+    [Transport_HeaderId_Rx_CaptureStart] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_CaptureStart),
+    [Transport_HeaderId_Rx_CaptureRead] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_CaptureRead),
+    [Transport_HeaderId_Rx_RecorderStart] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_RecorderStart),
+    [Transport_HeaderId_Rx_SequenceAppend] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SequenceAppend),
+    [Transport_HeaderId_Rx_SequenceMarker] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SequenceMarker),
+    [Transport_HeaderId_Rx_SetAxes] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetAxes),
+    [Transport_HeaderId_Rx_SetFraming] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetFraming),
+    [Transport_HeaderId_Rx_SetMaxLatency] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetMaxLatency),
+    [Transport_HeaderId_Rx_SetCalibration] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetCalibration),
+    [Transport_HeaderId_Rx_GetCalibration] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetCalibration),
+    [Transport_HeaderId_Rx_GetSpiClock] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetSpiClock),
+    [Transport_HeaderId_Rx_SaveConfiguration] =
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SaveConfiguration),
+};
+
+/**
+ * Looks up the expected request length.
+ *
+ * @param headerId first byte of request
+ * @return total request length in bytes, 0 if header id is unknown
+ */
+static uint8_t rxFrameLength(uint8_t headerId) {
+  if (headerId >= sizeof(rxFrameLengths)) {
+    return 0;
+  }
+  return rxFrameLengths[headerId];
+}
+
+/**
+ * Copies the request to the queue (producer side).
+ *
+ * @param queue request queue
+ * @param buffer validated request
+ * @param length request length; must not exceed sizeof(struct TransportFrame)
+ * @return -ENOMEM if queue is full, 0 otherwise
+ */
+static int enqueueRequest(struct HostTransport_RequestQueue *queue,
+                          const uint8_t *buffer, uint16_t length) {
+  const uint8_t head = {queue->head};
+  const uint8_t tail = {__atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)};
+
+  if ((uint8_t)(head - tail) >= TRANSPORTRX_REQUEST_QUEUE_ITEMS) {
+    queue->droppedCount++;
+    return -ENOMEM;
+  }
+
+  uint8_t *slot = {
+      (uint8_t *)&queue->items[head & (TRANSPORTRX_REQUEST_QUEUE_ITEMS - 1U)]};
+
+  // avoid memcpy until clear where allowed to use due to un-alignment issues
+  for (uint16_t idx = 0; idx < length; idx++) {
+    slot[idx] = buffer[idx];
+  }
+
+  // publish slot only after it is completely written
+  __atomic_store_n(&queue->head, (uint8_t)(head + 1U), __ATOMIC_RELEASE);
+  return 0;
+}
+
+/**
+ * Queues a complete request and merges the outcome into the overall result.
+ *
+ * @param handle host transport pimpl
+ * @param buffer complete request
+ * @param length request length
+ * @param result result so far: number of queued requests or first error
+ * @return updated result
+ */
+static int takeRequest(struct HostTransport_Handle *handle,
+                       const uint8_t *buffer, uint8_t length, int result) {
+  const int queued = {enqueueRequest(&handle->fromHost.queue, buffer, length)};
+
+  if (0 > result) {
+    return result;
+  }
+  return (0 > queued) ? queued : result + 1;
+}
 
 int TransportRx_Process(struct HostTransport_Handle *handle,
                         const uint8_t *buffer, uint16_t length) {
@@ -15,66 +140,71 @@ int TransportRx_Process(struct HostTransport_Handle *handle,
     return -EINVAL;
   }
 
-  bool sizeOk = {false};
-
-  struct TransportFrame *request = (struct TransportFrame *)buffer;
-
-  switch (request->header.id) {
-    // NOLINTNEXTLINE(bugprone-branch-clone)
-  case Transport_HeaderId_Rx_GetFirmwareVersion:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(
-                 struct TransportRx_GetFirmwareVersion) == length;
-    break;
-  case Transport_HeaderId_Rx_GetOutputDataRate:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetOutputDataRate) ==
-             length;
-    break;
-  case Transport_HeaderId_Rx_SetOutputDataRate:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetOutputDataRate) ==
-             length;
-    break;
-  case Transport_HeaderId_Rx_GetRange:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetRange) == length;
-    break;
-  case Transport_HeaderId_Rx_SetRange:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetRange) == length;
-    break;
-  case Transport_HeaderId_Rx_GetScale:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetScale) == length;
-    break;
-  case Transport_HeaderId_Rx_SetScale:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SetScale) == length;
-    break;
-  case Transport_HeaderId_Rx_GetDeviceSetup:
-    sizeOk =
-        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetDeviceSetup) == length;
-    break;
-  case Transport_HeaderId_Rx_DeviceReboot:
-    sizeOk =
-        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_DeviceReboot) == length;
-    break;
-  case Transport_HeaderId_Rx_SamplingStart:
-    sizeOk =
-        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SamplingStart) == length;
-    break;
-  case Transport_HeaderId_Rx_SamplingStop:
-    sizeOk =
-        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_SamplingStop) == length;
-    break;
-  case Transport_HeaderId_Rx_GetUptime:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetUptime) == length;
-    break;
-  case Transport_HeaderId_Rx_GetBufferStatus:
-    sizeOk = SIZEOF_HEADER_INCL_PAYLOAD(struct TransportRx_GetBufferStatus) ==
-             length;
-    break;
-
-  default:
-    return -EINVAL;
+  struct HostTransport_RequestParser *parser = {&handle->fromHost.parser};
+  int result = {0};
+  uint16_t offset = {0};
+
+  while (offset < length) {
+    if (0 == parser->length) {
+      const uint8_t expectedLength = {rxFrameLength(buffer[offset])};
+
+      if (0 == expectedLength) {
+        // skip byte by byte until a known header id shows up again
+        parser->discardedBytes++;
+        offset++;
+        result = (0 <= result) ? -EINVAL : result;
+        continue;
+      }
+
+      if (expectedLength <= length - offset) {
+        // common case: request is complete, no need to copy it twice
+        result = takeRequest(handle, &buffer[offset], expectedLength, result);
+        offset += expectedLength;
+        continue;
+      }
+
+      parser->expectedLength = expectedLength;
+    }
+
+    // fragmented request: collect until complete
+    while (offset < length && parser->length < parser->expectedLength) {
+      parser->frame[parser->length++] = buffer[offset++];
+    }
+
+    if (parser->length == parser->expectedLength) {
+      result = takeRequest(handle, parser->frame, parser->length, result);
+      parser->length = 0;
+      parser->expectedLength = 0;
+    }
   }
 
-  if (sizeOk) {
-    return handle->fromHost.doTakeReceivedPacketImpl(buffer);
+  return result;
+}
+
+void TransportRx_ResetParser(struct HostTransport_Handle *handle) {
+  handle->fromHost.parser.length = 0;
+  handle->fromHost.parser.expectedLength = 0;
+}
+
+uint8_t TransportRx_DispatchPending(struct HostTransport_Handle *handle) {
+  struct HostTransport_RequestQueue *queue = {&handle->fromHost.queue};
+  uint8_t dispatchedCount = {0};
+
+  while (TransportRx_hasPending(handle)) {
+    const uint8_t tail = {queue->tail};
+
+    handle->fromHost.doTakeReceivedPacketImpl((const uint8_t *)&queue->items[(
+        uint8_t)(tail & (TRANSPORTRX_REQUEST_QUEUE_ITEMS - 1U))]);
+
+    // release slot only after it is completely consumed
+    __atomic_store_n(&queue->tail, (uint8_t)(tail + 1U), __ATOMIC_RELEASE);
+    dispatchedCount++;
   }
-  return -EINVAL;
+
+  return dispatchedCount;
+}
+
+bool TransportRx_hasPending(const struct HostTransport_Handle *handle) {
+  return __atomic_load_n(&handle->fromHost.queue.head, __ATOMIC_ACQUIRE) !=
+         handle->fromHost.queue.tail;
 }
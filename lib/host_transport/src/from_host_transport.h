@@ -6,15 +6,21 @@
 
 #pragma once
 #include <inttypes.h>
+#include <stdbool.h>
 
 struct HostTransport_Handle;
 
 /**
- * Processes received package from the OUT endpoint of host.
+ * Processes received bytes from the OUT endpoint of host.
  *
  * Shall be called in CDC_Receive_FS(uint8_t* Buf, uint32_t *Len).
- * Performs simple check on the recieved buffer and forwards of the data package
- * header ID is one of:
+ * The received bytes are treated as stream: a request may be fragmented
+ * across several calls and one call may carry several concatenated requests.
+ * The expected length of each request is derived from its header ID. Bytes
+ * which do not start a known request are skipped until the next known header
+ * ID. Each complete request is queued for
+ * TransportRx_DispatchPending(struct HostTransport_Handle *) if the header ID
+ * is one of:
  *
  *   - TransportHeader_Id_Rx_GetFirmwareVersion
  *   - TransportHeader_Id_Rx_GetOutputDataRate
@@ -27,13 +33,62 @@ struct HostTransport_Handle;
  *   - TransportHeader_Id_Rx_DeviceReboot
  *   - TransportHeader_Id_Rx_SamplingStart
  *   - TransportHeader_Id_Rx_SamplingStop
+ *   - TransportHeader_Id_Rx_GetUptime
+ *   - TransportHeader_Id_Rx_GetBufferStatus
+ *   - TransportHeader_Id_Rx_ConfigureAndStart
+ *   - TransportHeader_Id_Rx_CaptureStart
+ *   - TransportHeader_Id_Rx_CaptureRead
+ *   - TransportHeader_Id_Rx_RecorderStart
+ *   - TransportHeader_Id_Rx_SequenceAppend
+ *   - TransportHeader_Id_Rx_SequenceMarker
+ *   - TransportHeader_Id_Rx_SetAxes
+ *   - TransportHeader_Id_Rx_SetFraming
+ *   - TransportHeader_Id_Rx_SetMaxLatency
+ *   - TransportHeader_Id_Rx_SetCalibration
+ *   - TransportHeader_Id_Rx_GetCalibration
+ *   - TransportHeader_Id_Rx_GetSpiClock
+ *   - TransportHeader_Id_Rx_SaveConfiguration
+ *
+ * The interrupt context only copies the package; it does not touch the
+ * sensor or USB TX path.
  *
  * @param handle host transport pimpl
- * @param buffer received package (as a whole, must not be fragmented)
- * @param length received package length
+ * @param buffer received bytes (fragments and multiple requests allowed)
+ * @param length number of received bytes
  * @return
- *   - -EINVAL on invalid arguments
- *   - HostTransport_Handle.onReceived(uint8_t *, uint32_t *) otherwise
+ *   - -EINVAL on invalid arguments or if bytes had to be skipped
+ *   - -ENOMEM if the request queue is full (request dropped)
+ *   - number of queued requests otherwise
  */
 int TransportRx_Process(struct HostTransport_Handle *handle,
                         const uint8_t *buffer, uint16_t length);
+
+/**
+ * Discards a partially received request.
+ *
+ * Shall be called whenever the byte stream is interrupted, e.g. the host
+ * (re-)connects.
+ *
+ * @param handle host transport pimpl
+ */
+void TransportRx_ResetParser(struct HostTransport_Handle *handle);
+
+/**
+ * Dispatches all queued requests to
+ * HostTransport_FromHostApi.doTakeReceivedPacketImpl(const uint8_t *).
+ *
+ * Shall be called in main() at a safe point, i.e. in between two sampling
+ * batches.
+ *
+ * @param handle host transport pimpl
+ * @return number of dispatched requests
+ */
+uint8_t TransportRx_DispatchPending(struct HostTransport_Handle *handle);
+
+/**
+ * Tests whether requests are queued.
+ *
+ * @param handle host transport pimpl
+ * @return true if at least one request awaits dispatching
+ */
+bool TransportRx_hasPending(const struct HostTransport_Handle *handle);
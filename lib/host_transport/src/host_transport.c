@@ -3,8 +3,151 @@
  */
 
 #include "host_transport.h"
+#include <codec_packed.h>
+#include <errno.h>
+#include <ramfunc.h>
 
-void Transport_resetBuffer(struct HostTransport_Handle *handle) {
+/**
+ * Resets the transfer statistics and drops held back stream bytes.
+ *
+ * @param handle
+ */
+static void resetTxState(struct HostTransport_Handle *handle) {
   handle->toHost.largestTxChunkBytes = 0;
+  handle->toHost.txBytesCount = 0;
+  handle->toHost.txTransfersCount = 0;
+  handle->toHost.txCarryBytes = 0;
+  handle->toHost.txCarryOffset = 0;
+  handle->toHost.frameSequence = 0;
+}
+
+void Transport_resetBuffer(struct HostTransport_Handle *handle) {
+  resetTxState(handle);
   Ringbuffer_reset(&handle->toHost.ringbuffer);
 }
+
+uint16_t
+Transport_averageTxChunkBytes(const struct HostTransport_Handle *handle) {
+  if (0 == handle->toHost.txTransfersCount) {
+    return 0;
+  }
+  return handle->toHost.txBytesCount / handle->toHost.txTransfersCount;
+}
+
+/**
+ * Re-partitions the stream buffer for the selected axes and format.
+ *
+ * @param handle
+ * @param storageSizeBytes size of the stream buffer's storage
+ * @return same as Ringbuffer_init()
+ */
+static int initBuffer(struct HostTransport_Handle *handle,
+                      uint32_t storageSizeBytes) {
+  uint8_t itemSizeBytes = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration)};
+  if (Transport_isBlockFormat(handle->toHost.format)) {
+    itemSizeBytes = sizeof(uint8_t);
+  } else if (Transport_SampleFormat_Packed13 == handle->toHost.format) {
+    itemSizeBytes = Codec_packedSizeBytes(Codec_Packing_13bit);
+  } else if (Transport_SampleFormat_Packed10 == handle->toHost.format) {
+    itemSizeBytes = Codec_packedSizeBytes(Codec_Packing_10bit);
+  } else if (Transport_Axis_All != handle->toHost.axes) {
+    itemSizeBytes = Transport_sampleSizeBytes(handle->toHost.axes);
+  }
+
+  uint32_t capacity = {storageSizeBytes / itemSizeBytes};
+  if (UINT16_MAX < capacity) {
+    capacity = UINT16_MAX;
+  }
+
+  resetTxState(handle);
+  return Ringbuffer_init(&handle->toHost.ringbuffer,
+                         handle->toHost.ringbuffer.storage, capacity,
+                         itemSizeBytes);
+}
+
+int Transport_setAxes(struct HostTransport_Handle *handle, uint8_t axes,
+                      uint32_t storageSizeBytes) {
+  if (0 == (axes & Transport_Axis_All) || 0 != (axes & ~Transport_Axis_All) ||
+      (Transport_Axis_All != axes &&
+       Transport_SampleFormat_Acceleration != handle->toHost.format)) {
+    return -EINVAL;
+  }
+
+  handle->toHost.axes = axes;
+  return initBuffer(handle, storageSizeBytes);
+}
+
+int Transport_setFormat(struct HostTransport_Handle *handle, uint8_t format,
+                        uint32_t storageSizeBytes) {
+  // the codecs operate on complete samples
+  if (!Transport_isValidFormat(format) ||
+      (Transport_SampleFormat_Acceleration != format &&
+       Transport_Axis_All != handle->toHost.axes)) {
+    return -EINVAL;
+  }
+
+  handle->toHost.format = format;
+  return initBuffer(handle, storageSizeBytes);
+}
+
+void Transport_setFraming(struct HostTransport_Handle *handle, bool isFramed) {
+  handle->toHost.isFramed = isFramed;
+  handle->toHost.frameSequence = 0;
+}
+
+RAMFUNC bool Transport_isPackedFormat(uint8_t format) {
+  return Transport_SampleFormat_Packed13 == format ||
+         Transport_SampleFormat_Packed10 == format;
+}
+
+bool Transport_isBlockFormat(uint8_t format) {
+  return Transport_SampleFormat_AccelerationDelta == format ||
+         Transport_SampleFormat_AccelerationSoa == format;
+}
+
+bool Transport_isValidFormat(uint8_t format) {
+  return Transport_SampleFormat_Acceleration == format ||
+         Transport_isBlockFormat(format) || Transport_isPackedFormat(format);
+}
+
+uint8_t Transport_sampleSizeBytes(uint8_t axes) {
+  uint8_t size = {0};
+  for (uint8_t axis = Transport_Axis_X; axis <= Transport_Axis_Z; axis <<= 1U) {
+    size += (axes & axis) ? sizeof(int16_t) : 0;
+  }
+  return size;
+}
+
+/**
+ * Appends one axis value in little endian byte order.
+ *
+ * @param value
+ * @param packed output position
+ * @return next output position
+ */
+RAMFUNC static uint8_t *packValue(int16_t value, uint8_t *packed) {
+  packed[0] = (uint8_t)((uint16_t)value & 0xFFU);
+  packed[1] = (uint8_t)((uint16_t)value >> 8U);
+  return packed + sizeof(int16_t);
+}
+
+RAMFUNC uint16_t
+Transport_packAxes(uint8_t axes, const struct Transport_Acceleration *samples,
+                   uint16_t count, uint8_t *packed) {
+  uint8_t *next = {packed};
+
+  for (uint16_t idx = 0; idx < count; idx++) {
+    if (axes & Transport_Axis_X) {
+      next = packValue(samples[idx].x, next);
+    }
+    if (axes & Transport_Axis_Y) {
+      next = packValue(samples[idx].y, next);
+    }
+    if (axes & Transport_Axis_Z) {
+      next = packValue(samples[idx].z, next);
+    }
+  }
+
+  return next - packed;
+}
@@ -4,12 +4,43 @@
 
 #pragma once
 
+#include "host_transport_types.h"
 #include <inttypes.h>
 #include <ringbuffer.h>
 
 // NOLINTNEXTLINE(modernize-macro-to-enum)
 #define TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES 2048U
 
+/**
+ * Maximum packet size of the full-speed bulk IN endpoint.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TRANSPORTTX_USB_PACKET_BYTES 64U
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(0 == TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES %
+                       TRANSPORTTX_USB_PACKET_BYTES,
+              "ERROR: chunk buffer must hold whole USB packets");
+
+/**
+ * Longest time stream data is held back for filling up a USB packet before
+ * it is flushed in a short packet.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TRANSPORTTX_FLUSH_DEADLINE_MS 10U
+
+/**
+ * Number of received requests which can be queued until main() dispatches
+ * them. Must be a power of two.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TRANSPORTRX_REQUEST_QUEUE_ITEMS 8U
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(0 == (TRANSPORTRX_REQUEST_QUEUE_ITEMS &
+                    (TRANSPORTRX_REQUEST_QUEUE_ITEMS - 1U)),
+              "ERROR: TRANSPORTRX_REQUEST_QUEUE_ITEMS must be power of two");
+
 /**
  * Status returned by HostTransport_Handle.transmit(uint8_t *, uint16_t);
  */
@@ -20,9 +51,48 @@ enum HostTransport_Status {
   HostTransport_Status_Undefined
 };
 
+/**
+ * Lock-free single-producer single-consumer queue of received requests.
+ *
+ * The producer (USB interrupt) only writes HostTransport_RequestQueue.head,
+ * the consumer (main()) only writes HostTransport_RequestQueue.tail.
+ * Indices are free running and wrap at 256.
+ */
+struct HostTransport_RequestQueue {
+  struct TransportFrame items[TRANSPORTRX_REQUEST_QUEUE_ITEMS];
+  volatile uint8_t head; ///< Context: CDC_Receive_FS(uint8_t* , uint32_t *)
+  volatile uint8_t tail; ///< Context: main()
+  uint16_t droppedCount; ///< statistic: requests dropped due to full queue
+};
+
+/**
+ * Reassembles requests from the received byte stream.
+ *
+ * A request may be split across several OUT transfers and one OUT transfer
+ * may carry several requests. Only the fragment of a not yet complete request
+ * is kept here, complete requests are queued right away.
+ *
+ * Context: CDC_Receive_FS(uint8_t* , uint32_t *)
+ */
+struct HostTransport_RequestParser {
+  uint8_t frame[sizeof(struct TransportFrame)]; ///< incomplete request
+  uint8_t length;          ///< bytes of HostTransport_RequestParser.frame
+  uint8_t expectedLength;  ///< total length of incomplete request
+  uint16_t discardedBytes; ///< statistic: bytes skipped due to unknown id
+};
+
 struct HostTransport_FromHostApi {
-  int (*const doTakeReceivedPacketImpl)(
-      const uint8_t *); ///< Context: CDC_Receive_FS(uint8_t* , uint32_t *)
+  /**
+   * Byte stream reassembly state.
+   */
+  struct HostTransport_RequestParser parser;
+
+  /**
+   * Requests received in interrupt context and dispatched in main().
+   */
+  struct HostTransport_RequestQueue queue;
+
+  int (*const doTakeReceivedPacketImpl)(const uint8_t *); ///< Context: main()
 };
 
 struct HostTransport_ToHostApi {
@@ -49,6 +119,79 @@ struct HostTransport_ToHostApi {
    */
   uint16_t largestTxChunkBytes;
 
+  /**
+   * Bytes transmitted since sampling stream started.
+   */
+  uint32_t txBytesCount;
+
+  /**
+   * Transfers initiated since sampling stream started.
+   */
+  uint32_t txTransfersCount;
+
+  /**
+   * Stream bytes held back for the next USB packet.
+   *
+   * Transfers end on a packet boundary while enough data is buffered, the
+   * remainder of the last packet is kept in the transmit buffer until more
+   * data arrives, the deadline expires or the stream is flushed.
+   *
+   * Context: main()
+   */
+  uint8_t txCarryBytes;
+
+  /**
+   * Location of the held back bytes within the transmit buffer.
+   *
+   * Context: main()
+   */
+  uint16_t txCarryOffset;
+
+  /**
+   * Tick at which the held back bytes were kept back.
+   *
+   * Context: main()
+   */
+  uint32_t txCarrySinceMs;
+
+  /**
+   * Selected axes \see Transport_Axis.
+   *
+   * Determines the stream buffer's item layout: TransportTx_Acceleration
+   * frames for all axes, packed axis values otherwise.
+   *
+   * Context: main()
+   */
+  uint8_t axes;
+
+  /**
+   * Encoding of streamed samples \see Transport_SampleFormat.
+   *
+   * Compressed and structure of arrays blocks vary in size, hence the
+   * stream buffer holds single bytes for
+   * Transport_SampleFormat_AccelerationDelta and
+   * Transport_SampleFormat_AccelerationSoa. Bit-packed formats hold one
+   * packed sample per item.
+   *
+   * Context: main()
+   */
+  uint8_t format;
+
+  /**
+   * Wrap each transmitted stream chunk into a stream frame \see
+   * Transport_StreamFrameHeader.
+   *
+   * Context: main()
+   */
+  bool isFramed;
+
+  /**
+   * Sequence number of the next stream frame.
+   *
+   * Context: main()
+   */
+  uint16_t frameSequence;
+
   /**
    * Copies over buffer and goes into transmit mode.
    *
@@ -64,6 +207,20 @@ struct HostTransport_ToHostApi {
    * @return true until transmission is finished.
    */
   volatile bool (*const isTransmitBusyImpl)();
+
+  /**
+   * Computes the stream frame CRC over 32-bit words \see Crc_crc32Words().
+   *
+   * Context: main()
+   */
+  uint32_t (*const doCrc32WordsImpl)(const uint32_t *, uint16_t);
+
+  /**
+   * Context: main()
+   *
+   * @return monotonic milliseconds for the flush deadline
+   */
+  uint32_t (*const getTickMsImpl)();
 };
 
 /**
@@ -82,3 +239,86 @@ struct HostTransport_Handle {
  * @param handle
  */
 void Transport_resetBuffer(struct HostTransport_Handle *handle);
+
+/**
+ * @param handle
+ * @return average size of stream transfers since sampling stream started, 0
+ * if nothing was transmitted yet
+ */
+uint16_t
+Transport_averageTxChunkBytes(const struct HostTransport_Handle *handle);
+
+/**
+ * Selects the axes to transmit and re-partitions the stream buffer
+ * accordingly.
+ *
+ * Discards buffered data, hence shall not be called while sampling.
+ *
+ * @param handle
+ * @param axes \see Transport_Axis
+ * @param storageSizeBytes size of the stream buffer's storage
+ * @return -EINVAL if no axis is selected, 0 otherwise
+ */
+int Transport_setAxes(struct HostTransport_Handle *handle, uint8_t axes,
+                      uint32_t storageSizeBytes);
+
+/**
+ * Enables or disables the stream framing layer.
+ *
+ * @param handle
+ * @param isFramed
+ */
+void Transport_setFraming(struct HostTransport_Handle *handle, bool isFramed);
+
+/**
+ * @param axes \see Transport_Axis
+ * @return bytes per sample reduced to the selected axes
+ */
+uint8_t Transport_sampleSizeBytes(uint8_t axes);
+
+/**
+ * @param format \see Transport_SampleFormat
+ * @return true if format is one of the bit-packed formats
+ */
+bool Transport_isPackedFormat(uint8_t format);
+
+/**
+ * @param format \see Transport_SampleFormat
+ * @return true if format is buffered as whole frames of single bytes
+ */
+bool Transport_isBlockFormat(uint8_t format);
+
+/**
+ * @param format \see Transport_SampleFormat
+ * @return true if format is known
+ */
+bool Transport_isValidFormat(uint8_t format);
+
+/**
+ * Selects the encoding of streamed samples and re-partitions the stream
+ * buffer accordingly.
+ *
+ * Discards buffered data, hence shall not be called while sampling.
+ *
+ * @param handle
+ * @param format \see Transport_SampleFormat
+ * @param storageSizeBytes size of the stream buffer's storage
+ * @return -EINVAL if format is unknown or other than
+ * Transport_SampleFormat_Acceleration while not all axes are selected, 0
+ * otherwise
+ */
+int Transport_setFormat(struct HostTransport_Handle *handle, uint8_t format,
+                        uint32_t storageSizeBytes);
+
+/**
+ * Packs the selected axes of samples without padding (little endian).
+ *
+ * @param axes \see Transport_Axis
+ * @param samples input
+ * @param count number of samples
+ * @param packed output, count * Transport_sampleSizeBytes(uint8_t) bytes
+ * @return number of bytes written
+ */
+uint16_t Transport_packAxes(uint8_t axes,
+                            const struct Transport_Acceleration *samples,
+                            uint16_t count, uint8_t *packed);
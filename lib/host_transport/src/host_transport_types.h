@@ -42,6 +42,12 @@ enum Transport_HeaderId {
   Transport_HeaderId_Rx_GetFirmwareVersion = 8U,
   Transport_HeaderId_Rx_GetUptime = 9U,
   Transport_HeaderId_Rx_GetBufferStatus = 10U,
+  Transport_HeaderId_Rx_CaptureRead = 11U,
+  Transport_HeaderId_Rx_SetAxes = 12U,
+  Transport_HeaderId_Rx_SetFraming = 13U,
+  Transport_HeaderId_Rx_SetMaxLatency = 14U,
+  Transport_HeaderId_Rx_SetCalibration = 15U,
+  Transport_HeaderId_Rx_GetCalibration = 16U,
   /// @}
 
   /**
@@ -51,6 +57,11 @@ enum Transport_HeaderId {
   Transport_HeaderId_Rx_DeviceReboot = 17U,
   Transport_HeaderId_Rx_SamplingStart = 18U,
   Transport_HeaderId_Rx_SamplingStop = 19U,
+  Transport_HeaderId_Rx_ConfigureAndStart = 20U,
+  Transport_HeaderId_Rx_CaptureStart = 21U,
+  Transport_HeaderId_Rx_RecorderStart = 22U,
+  Transport_HeaderId_Rx_SequenceAppend = 23U,
+  Transport_HeaderId_Rx_SequenceMarker = 24U,
   /// @}
 
   /**
@@ -64,6 +75,7 @@ enum Transport_HeaderId {
   Transport_HeaderId_Tx_FirmwareVersion = 29U,
   Transport_HeaderId_Tx_Uptime = 30U,
   Transport_HeaderId_Tx_BufferStatus = 31U,
+  Transport_HeaderId_Tx_CaptureChunk = 32U,
   /// @}
 
   /**
@@ -79,6 +91,35 @@ enum Transport_HeaderId {
   Transport_HeaderId_Tx_Fault = 39U,
   Transport_HeaderId_Tx_BufferOverflow = 40U,
   Transport_HeaderId_Tx_TransmissionError = 41U,
+  Transport_HeaderId_Tx_SamplingConfiguredStarted = 42U,
+  Transport_HeaderId_Tx_RecorderFinished = 43U,
+  Transport_HeaderId_Tx_SequenceSegment = 44U,
+  Transport_HeaderId_Tx_AccelerationAxes = 45U,
+  Transport_HeaderId_Tx_AccelerationDelta = 46U,
+  Transport_HeaderId_Tx_AccelerationPacked = 47U,
+  Transport_HeaderId_Tx_AccelerationSoa = 48U,
+  Transport_HeaderId_Tx_ClockCorrelation = 49U,
+  Transport_HeaderId_Tx_AccelerationSensor = 50U,
+  Transport_HeaderId_Tx_Calibration = 51U,
+  /// @}
+
+  /**
+   * Request with dedicated unique response followed by its response,
+   * appended after the ranges above were exhausted.
+   * @{
+   */
+  Transport_HeaderId_Rx_GetSpiClock = 52U,
+  Transport_HeaderId_Tx_SpiClock = 53U,
+  Transport_HeaderId_Rx_SaveConfiguration = 54U,
+  Transport_HeaderId_Tx_ConfigurationSaved = 55U,
+  /// @}
+
+  /**
+   * Unique response of a request listed above, appended after the ranges
+   * above were exhausted.
+   * @{
+   */
+  Transport_HeaderId_Tx_StreamSetup = 56U,
   /// @}
 
 } __attribute__((__packed__));
@@ -142,6 +183,89 @@ enum TransportRx_SetScale_Scale {
 static_assert(sizeof(enum TransportRx_SetScale_Scale) == 1,
               "ERROR: unexpected size of TransportRx_SetScale_Scale");
 
+/**
+ * Encoding of the acceleration samples streamed to the host.
+ */
+enum Transport_SampleFormat {
+  Transport_SampleFormat_Acceleration = 0, ///< \see TransportTx_Acceleration
+  /// \see TransportTx_AccelerationDelta
+  Transport_SampleFormat_AccelerationDelta = 1,
+  /// \see TransportTx_AccelerationPacked, 13 bit per axis (full resolution)
+  Transport_SampleFormat_Packed13 = 2,
+  /// \see TransportTx_AccelerationPacked, 10 bit per axis
+  Transport_SampleFormat_Packed10 = 3,
+  /// \see TransportTx_AccelerationSoa
+  Transport_SampleFormat_AccelerationSoa = 4,
+} __attribute__((__packed__));
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(sizeof(enum Transport_SampleFormat) == 1,
+              "ERROR: unexpected size of Transport_SampleFormat");
+
+/**
+ * Axis selection bits for the acceleration stream and capture.
+ */
+enum Transport_Axis {
+  Transport_Axis_X = 1U << 0U,
+  Transport_Axis_Y = 1U << 1U,
+  Transport_Axis_Z = 1U << 2U,
+  /// all axes: per sample TransportTx_Acceleration frames (default)
+  Transport_Axis_All = Transport_Axis_X | Transport_Axis_Y | Transport_Axis_Z,
+} __attribute__((__packed__));
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(sizeof(enum Transport_Axis) == 1,
+              "ERROR: unexpected size of Transport_Axis");
+
+/**
+ * Trigger source of the pre-trigger (flight recorder) mode.
+ */
+enum Transport_TriggerSource {
+  /// deviation from first sample exceeds threshold (LSB)
+  Transport_TriggerSource_Threshold = 0,
+  /// sensor activity interrupt, threshold in 62.5 mg/LSB (max. 255)
+  Transport_TriggerSource_SensorActivity = 1U,
+} __attribute__((__packed__));
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(sizeof(enum Transport_TriggerSource) == 1,
+              "ERROR: unexpected size of Transport_TriggerSource");
+
+/**
+ * Trigger starting a segment of a capture sequence.
+ */
+enum Transport_SequenceTrigger {
+  /// delay in ms after previous segment (or sequence start)
+  Transport_SequenceTrigger_Delay = 0,
+  /// next Transport_HeaderId_Rx_SequenceMarker
+  Transport_SequenceTrigger_Marker = 1U,
+} __attribute__((__packed__));
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(sizeof(enum Transport_SequenceTrigger) == 1,
+              "ERROR: unexpected size of Transport_SequenceTrigger");
+
+/**
+ * Fixed-point calibration of one sensor's samples.
+ *
+ * Per output axis i:
+ *   out[i] = saturate16(((sum_j matrix[i*3+j] * in[j]) >> (15 - shift))
+ *                       + offset[i])
+ *
+ * The matrix holds Q15 coefficients (rotation times gain), in[] is the sample
+ * in full resolution LSB (3.9mg) regardless of range and scale. The output
+ * unit is chosen by the host and only declared by lsbMicroG, the device does
+ * not interpret it.
+ */
+struct Transport_Calibration {
+  uint8_t sensor;     ///< sensor ID, 0 denotes the primary sensor
+  uint8_t enable;     ///< 0 passes samples unchanged
+  uint8_t shift;      ///< left shift of the matrix, 0 to 15
+  int16_t matrix[9];  ///< Q15, row major, one row per output axis x, y, z
+  int16_t offset[3];  ///< added per output axis, output LSB
+  uint32_t lsbMicroG; ///< declared output LSB in ug, i.e. 3900 for 3.9mg
+} __attribute__((packed));
+
 /**
  * RX payload for retrieving sensor's ODR.
  */
@@ -150,6 +274,9 @@ struct TransportRx_GetOutputDataRate {
 
 /**
  * RX payload for setting sensor's ODR.
+ *
+ * Rejected while sampling: answered by TransportTx_OutputDataRate with the
+ * unchanged rate then.
  */
 struct TransportRx_SetOutputDataRate {
   enum TransportRx_SetOutputDataRate_Rate rate;
@@ -163,6 +290,9 @@ struct TransportRx_GetRange {
 
 /**
  * RX payload for setting sensor's range.
+ *
+ * Rejected while sampling: answered by TransportTx_Range with the unchanged
+ * range then.
  */
 struct TransportRx_SetRange {
   enum TransportRx_SetRange_Range range;
@@ -176,6 +306,9 @@ struct TransportRx_GetScale {
 
 /**
  * RX payload for setting sensor's scale.
+ *
+ * Rejected while sampling: answered by TransportTx_Scale with the unchanged
+ * scale then.
  */
 struct TransportRx_SetScale {
   enum TransportRx_SetScale_Scale scale;
@@ -194,6 +327,142 @@ struct TransportRx_SamplingStart {
   uint16_t max_samples_count;
 } __attribute__((packed));
 
+/**
+ * RX payload for configuring the sensor and starting sampling at once.
+ *
+ * Either the complete setup is applied or none of it.
+ */
+struct TransportRx_ConfigureAndStart {
+  enum TransportRx_SetOutputDataRate_Rate rate;
+  enum TransportRx_SetRange_Range range;
+  enum TransportRx_SetScale_Scale scale;
+  uint8_t watermark; ///< sensor FiFo watermark level, samples read at once
+  uint16_t max_samples_count;
+  enum Transport_SampleFormat format;
+} __attribute__((packed));
+
+/**
+ * RX payload selecting the axes to stream and capture.
+ *
+ * Any selection other than Transport_Axis_All switches the stream to
+ * TransportTx_AccelerationAxes blocks and packs captured samples likewise.
+ * Responded by TransportTx_StreamSetup.
+ */
+struct TransportRx_SetAxes {
+  uint8_t axes; ///< \see Transport_Axis, must not be 0
+} __attribute__((packed));
+
+/**
+ * RX payload enabling or disabling the stream framing layer.
+ *
+ * Responded by TransportTx_StreamSetup.
+ *
+ * \see Transport_StreamFrameHeader
+ */
+struct TransportRx_SetFraming {
+  uint8_t enable; ///< 0 disables framing, any other value enables it
+} __attribute__((packed));
+
+/**
+ * RX payload bounding the latency of streamed samples.
+ *
+ * Samples are drained from the sensor FiFo and flushed to the host at the
+ * latest after maxLatencyMs even if the watermark is not reached.
+ */
+struct TransportRx_SetMaxLatency {
+  uint16_t maxLatencyMs; ///< deadline in ms, 0 disables the deadline
+} __attribute__((packed));
+
+/**
+ * RX payload uploading the calibration of a sensor.
+ *
+ * Responded by TransportTx_Calibration. Rejected while sampling and if
+ * enabled while not all axes are selected. A rejection is answered with the
+ * unchanged calibration, or with the primary sensor's one for an unknown
+ * sensor.
+ */
+struct TransportRx_SetCalibration {
+  struct Transport_Calibration calibration;
+} __attribute__((packed));
+
+/**
+ * RX payload for retrieving the calibration of a sensor.
+ */
+struct TransportRx_GetCalibration {
+  uint8_t sensor; ///< sensor ID, 0 denotes the primary sensor
+} __attribute__((packed));
+
+/**
+ * RX payload for retrieving the SPI clock calibrated at startup.
+ */
+struct TransportRx_GetSpiClock {
+} __attribute__((packed));
+
+/**
+ * RX payload for persisting the current sensor setup to flash.
+ *
+ * Output data rate, range and scale are applied on every boot, no further
+ * setup requests are needed. Responded by TransportTx_ConfigurationSaved.
+ * Rejected while sampling.
+ */
+struct TransportRx_SaveConfiguration {
+} __attribute__((packed));
+
+/**
+ * RX payload for requesting a capture to RAM.
+ *
+ * Samples are stored on the controller without any USB transfer until the
+ * capture is finished. Read out by TransportRx_CaptureRead. Rejected while
+ * sampling, answered by TransportTx_SamplingConfiguredStarted then.
+ */
+struct TransportRx_CaptureStart {
+  uint16_t max_samples_count; ///< 0 to capture until RAM is exhausted
+} __attribute__((packed));
+
+/**
+ * RX payload for reading captured samples starting at offset.
+ *
+ * Answered by TransportTx_CaptureChunk, by an empty one while the capture is
+ * still running.
+ */
+struct TransportRx_CaptureRead {
+  uint16_t offset; ///< index of first sample to read
+} __attribute__((packed));
+
+/**
+ * RX payload for starting the pre-trigger (flight recorder) mode.
+ *
+ * Samples are kept in RAM, overwriting the oldest ones, until the trigger
+ * fires and post_samples_count further samples are recorded. The host link
+ * stays idle until TransportTx_RecorderFinished. Read out by
+ * TransportRx_CaptureRead.
+ */
+struct TransportRx_RecorderStart {
+  enum Transport_TriggerSource source;
+  uint16_t threshold;          ///< unit depends on source
+  uint16_t post_samples_count; ///< samples to record after trigger sample
+} __attribute__((packed));
+
+/**
+ * RX payload appending a segment to the capture sequence.
+ *
+ * The sequence runs all segments back to back without stopping the sampling
+ * in between. Each segment is preceded by TransportTx_SequenceSegment in the
+ * stream. The sequence is discarded once finished or stopped.
+ */
+struct TransportRx_SequenceAppend {
+  enum Transport_SequenceTrigger trigger;
+  uint16_t delay_ms;      ///< ignored for marker trigger
+  uint16_t samples_count; ///< samples of segment, must not be 0
+  uint8_t do_start;       ///< start sequence after appending if not 0
+} __attribute__((packed));
+
+/**
+ * RX payload triggering the next segment with marker trigger.
+ */
+struct TransportRx_SequenceMarker {
+} __attribute__((packed));
+
 /**
  * RX payload for requesting sampling stop.
  */
@@ -281,6 +550,25 @@ struct TransportTx_SamplingStarted {
   uint16_t maxSamples;
 } __attribute__((packed));
 
+/**
+ * TX payload indicating sampling started upon
+ * Transport_HeaderId_Rx_ConfigureAndStart.
+ *
+ * Echoes the setup effectively applied. A rejected request is answered as
+ * well: result is negative then, nothing was started and the setup fields
+ * echo the unchanged current setup. Also answers a rejected
+ * Transport_HeaderId_Rx_CaptureStart likewise.
+ */
+struct TransportTx_SamplingConfiguredStarted {
+  uint16_t maxSamples;
+  uint8_t outputDataRate : 4; ///< \see Adxl345Register_BwRate_Rate
+  uint8_t range : 2;          ///< \see Adxl345Register_DataFormat_Range
+  uint8_t scale : 1;          ///< \see Adxl345Register_DataFormat_FullResBit
+  uint8_t watermark;          ///< sensor FiFo watermark level
+  enum Transport_SampleFormat format;
+  int8_t result; ///< 0 if started, negative errno otherwise
+} __attribute__((packed));
+
 /**
  * TX payload indicating sampling stream has finished (all samples sent).
  *
@@ -338,6 +626,103 @@ struct TransportTx_Acceleration {
   struct Transport_Acceleration values;
 } __attribute__((packed));
 
+/**
+ * TX payload transporting a block of samples reduced to the selected axes.
+ *
+ * The payload is directly followed by count samples. Each sample consists of
+ * the selected axes' int16_t values in order x, y, z without padding.
+ */
+struct TransportTx_AccelerationAxes {
+  uint16_t firstIndex; ///< running sample index of first sample
+  uint16_t count;      ///< number of samples in block
+  uint8_t axes;        ///< \see Transport_Axis
+} __attribute__((packed));
+
+/**
+ * TX payload transporting a losslessly compressed block of samples.
+ *
+ * The payload is directly followed by one codec block, \see codec.h. The
+ * block is self-delimiting, its size is given by its header.
+ */
+struct TransportTx_AccelerationDelta {
+  uint16_t firstIndex; ///< running sample index of first sample
+} __attribute__((packed));
+
+/**
+ * TX payload transporting a block of bit-packed samples.
+ *
+ * The payload is directly followed by count samples of 5 bytes
+ * (Transport_SampleFormat_Packed13) respectively 4 bytes
+ * (Transport_SampleFormat_Packed10) each, \see codec_packed.h.
+ */
+struct TransportTx_AccelerationPacked {
+  uint16_t firstIndex; ///< running sample index of first sample
+  uint16_t count;      ///< number of samples in block
+  uint8_t format;      ///< \see Transport_SampleFormat
+} __attribute__((packed));
+
+/**
+ * Size of one axis array of a TransportTx_AccelerationSoa block of COUNT
+ * samples, padded to keep the next array 4-byte aligned.
+ */
+#define TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(COUNT)                               \
+  ((sizeof(int16_t) * (COUNT) + 3U) & ~3U)
+
+/**
+ * TX payload transporting a block of samples as structure of arrays.
+ *
+ * The payload is directly followed by the arrays x[count], y[count] and
+ * z[count] of int16_t. Each array starts 4-byte aligned relative to the
+ * frame start \see TRANSPORTTX_SOA_AXIS_STRIDE_BYTES so the host can convert
+ * each axis with vector instructions without de-interleaving.
+ */
+struct TransportTx_AccelerationSoa {
+  uint16_t firstIndex; ///< running sample index of first sample
+  uint8_t count;       ///< number of samples in block
+} __attribute__((packed));
+
+/**
+ * TX payload tagging the start of a sequence segment in the stream.
+ *
+ * Directly followed by TransportTx_SequenceSegment.samplesCount acceleration
+ * frames indexed from 0. Same size as TransportTx_Acceleration to share the
+ * stream buffer.
+ */
+struct TransportTx_SequenceSegment {
+  uint16_t segment;      ///< index of segment within sequence
+  uint16_t samplesCount; ///< number of samples of segment
+  uint32_t startMs;      ///< device uptime at segment start
+} __attribute__((packed));
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(sizeof(struct TransportTx_SequenceSegment) ==
+                  sizeof(struct TransportTx_Acceleration),
+              "ERROR: segment tag must fit into stream buffer item");
+
+/**
+ * TX payload transporting a chunk of captured samples.
+ *
+ * The payload is directly followed by TransportTx_CaptureChunk.count samples
+ * of type Transport_Acceleration.
+ */
+struct TransportTx_CaptureChunk {
+  uint16_t offset;     ///< index of first sample in chunk
+  uint16_t totalCount; ///< total number of captured samples, 0 if running
+  uint8_t count;       ///< number of samples in chunk, 0 if offset is beyond
+} __attribute__((packed));
+
+/**
+ * TX payload indicating the flight recorder finished.
+ *
+ * Sent when the post-trigger samples are recorded or upon stop request. The
+ * recorded window is read out by TransportRx_CaptureRead.
+ */
+struct TransportTx_RecorderFinished {
+  uint16_t totalCount;   ///< number of recorded samples (pre + post)
+  uint16_t triggerIndex; ///< index of trigger sample, totalCount if none
+  uint8_t isTriggered;   ///< 0 if stopped before trigger
+} __attribute__((packed));
+
 /**
  * TX payload transporting the firmware version.
  */
@@ -378,6 +763,83 @@ struct TransportTx_BufferStatus {
   uint16_t takeCount;       ///< total number of successful take() from buffer
   uint16_t largestTxChunkBytes; ///< largest chunk sent at once since last
                                 ///< sampling start
+  uint16_t averageTxChunkBytes; ///< average chunk size since last sampling
+                                ///< start
+} __attribute__((packed));
+
+/**
+ * TX payload correlating the device clock with the USB frame clock.
+ *
+ * Latched on every Nth USB start-of-frame while streaming, never during a
+ * capture to RAM or a flight recording. Frames are driven by the host's
+ * clock every 1ms, hence the host can estimate the offset and drift of the
+ * device's timer and of the sample index against its own clock, independent of
+ * the jitter of transfer arrival times.
+ */
+struct TransportTx_ClockCorrelation {
+  uint16_t frameNumber; ///< 11-bit USB frame number
+  uint16_t sampleIndex; ///< number of samples taken from the sensor so far
+  uint32_t timerTicks;  ///< free running timer at start-of-frame
+} __attribute__((packed));
+
+/**
+ * TX payload tagging the sensor of the acceleration frames following.
+ *
+ * Only streamed if more than one sensor samples. Directly followed by
+ * TransportTx_AccelerationSensor.count acceleration frames of that sensor,
+ * indexed by the sensor's own running sample index. Same size as
+ * TransportTx_Acceleration to share the stream buffer.
+ */
+struct TransportTx_AccelerationSensor {
+  uint8_t sensor;      ///< sensor ID, 0 denotes the primary sensor
+  uint8_t count;       ///< number of acceleration frames following
+  uint16_t firstIndex; ///< index of first acceleration frame following
+  uint32_t timerTicks; ///< free running timer when the batch was fetched
+} __attribute__((packed));
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(sizeof(struct TransportTx_AccelerationSensor) ==
+                  sizeof(struct TransportTx_Acceleration),
+              "ERROR: sensor tag must fit into stream buffer item");
+
+/**
+ * TX payload transporting the calibration of a sensor.
+ */
+struct TransportTx_Calibration {
+  struct Transport_Calibration calibration;
+} __attribute__((packed));
+
+/**
+ * TX payload transporting the SPI clock of the sensor bus.
+ *
+ * The clock is calibrated once at startup by read-back verification, see
+ * ClockProfile_calibrateSpiDivisor().
+ */
+struct TransportTx_SpiClock {
+  uint32_t clockHz;        ///< SPI clock in use
+  uint16_t divisor;        ///< SPI prescaler of PCLK2 in use
+  uint16_t fastestDivisor; ///< fastest prescaler verified, 0 if none passed
+} __attribute__((packed));
+
+/**
+ * TX payload transporting the sensor setup persisted to flash.
+ */
+struct TransportTx_ConfigurationSaved {
+  struct TransportTx_DeviceSetup setup; ///< setup as persisted
+  int8_t result; ///< 0 on success, negative errno otherwise
+} __attribute__((packed));
+
+/**
+ * TX payload transporting the axes selection and the stream framing.
+ *
+ * Answers TransportRx_SetAxes and TransportRx_SetFraming. A rejected request
+ * is answered as well: result is negative then and the fields echo the
+ * unchanged setup.
+ */
+struct TransportTx_StreamSetup {
+  uint8_t axes;   ///< \see Transport_Axis
+  uint8_t framed; ///< 1 if the stream framing layer is enabled, 0 otherwise
+  int8_t result;  ///< 0 on success, negative errno otherwise
 } __attribute__((packed));
 
 /* Frames --------------------------------------------------------------------*/
@@ -393,6 +855,7 @@ union TransportTxFrame {
   struct TransportTx_FifoOverflow asFifoOverflow;
   struct TransportTx_BufferOverflow asBufferOverflow;
   struct TransportTx_SamplingStarted asSamplingStarted;
+  struct TransportTx_SamplingConfiguredStarted asSamplingConfiguredStarted;
   struct TransportTx_SamplingFinished asSamplingFinished;
   struct TransportTx_SamplingStopped asSamplingStopped;
   struct TransportTx_SamplingAborted asSamplingAborted;
@@ -402,6 +865,19 @@ union TransportTxFrame {
   struct TransportTx_Uptime asUptime;
   struct TransportTx_TransmissionError asTransmissionError;
   struct TransportTx_BufferStatus asBufferStatus;
+  struct TransportTx_CaptureChunk asCaptureChunk;
+  struct TransportTx_RecorderFinished asRecorderFinished;
+  struct TransportTx_SequenceSegment asSequenceSegment;
+  struct TransportTx_AccelerationAxes asAccelerationAxes;
+  struct TransportTx_AccelerationDelta asAccelerationDelta;
+  struct TransportTx_AccelerationPacked asAccelerationPacked;
+  struct TransportTx_AccelerationSoa asAccelerationSoa;
+  struct TransportTx_ClockCorrelation asClockCorrelation;
+  struct TransportTx_AccelerationSensor asAccelerationSensor;
+  struct TransportTx_Calibration asCalibration;
+  struct TransportTx_SpiClock asSpiClock;
+  struct TransportTx_ConfigurationSaved asConfigurationSaved;
+  struct TransportTx_StreamSetup asStreamSetup;
 } __attribute__((packed));
 
 /**
@@ -418,6 +894,19 @@ union TransportRxFrame {
   struct TransportRx_DeviceReboot asDeviceReboot;
   struct TransportRx_SamplingStart asSamplingStart;
   struct TransportRx_SamplingStop asSamplingStop;
+  struct TransportRx_ConfigureAndStart asConfigureAndStart;
+  struct TransportRx_CaptureStart asCaptureStart;
+  struct TransportRx_CaptureRead asCaptureRead;
+  struct TransportRx_RecorderStart asRecorderStart;
+  struct TransportRx_SequenceAppend asSequenceAppend;
+  struct TransportRx_SequenceMarker asSequenceMarker;
+  struct TransportRx_SetAxes asSetAxes;
+  struct TransportRx_SetFraming asSetFraming;
+  struct TransportRx_SetMaxLatency asSetMaxLatency;
+  struct TransportRx_SetCalibration asSetCalibration;
+  struct TransportRx_GetCalibration asGetCalibration;
+  struct TransportRx_GetSpiClock asGetSpiClock;
+  struct TransportRx_SaveConfiguration asSaveConfiguration;
   struct TransportRx_GetFirmwareVersion asGetFirmwareVersion;
   struct TransportRx_GetUptime asGetUptime;
   struct TransportRx_GetBufferStatus asGetBufferStatus;
@@ -438,3 +927,35 @@ struct TransportFrame {
     union TransportRxFrame asRxFrame;
   };
 } __attribute__((packed));
+
+/**
+ * Marks the start of a stream frame.
+ *
+ * The first byte on the wire (0x3C) is not a valid Transport_HeaderId,
+ * hence framed stream chunks and unframed responses can be told apart.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TRANSPORT_STREAM_SYNC 0xA55AC33CUL
+
+/**
+ * Header of a stream frame wrapping one transmitted chunk of the
+ * acceleration stream if framing is enabled.
+ *
+ * Layout on the wire:
+ *   - Transport_StreamFrameHeader
+ *   - length bytes of chunk (a sequence of TransportFrame)
+ *   - zero padding to the next multiple of 4 bytes
+ *   - uint32_t CRC-32 over header, chunk and padding, \see crc.h
+ *
+ * After a reconnect or a lost transfer the host searches for the sync word,
+ * verifies the CRC and learns about lost frames from gaps in sequence.
+ */
+struct Transport_StreamFrameHeader {
+  uint32_t sync;     ///< TRANSPORT_STREAM_SYNC
+  uint16_t length;   ///< chunk bytes excluding padding and CRC
+  uint16_t sequence; ///< incremented per frame, reset on sampling start
+} __attribute__((packed));
+
+// NOLINTNEXTLINE(readability-redundant-declaration,clang-diagnostic-implicit-int)
+static_assert(0 == sizeof(struct Transport_StreamFrameHeader) % 4,
+              "ERROR: stream frame chunk must start word aligned");
@@ -5,22 +5,33 @@
  */
 
 #include "to_host_transport.h"
-#include "fw/debug.h"
 #include "host_transport.h"
 #include "host_transport_types.h"
+#include <codec.h>
+#include <codec_packed.h>
 #include <errno.h>
+#include <ramfunc.h>
+#include <stddef.h>
 
-static volatile bool
+RAMFUNC static volatile bool
 isTransmitBusy(const struct HostTransport_ToHostApi *toHostApi) {
   return toHostApi->isTransmitBusyImpl();
 }
 
+RAMFUNC static int
+transmitAccelerationBuffered(struct HostTransport_Handle *handle,
+                             struct TransportFrame *accelerationsChunk,
+                             uint16_t dataCount, bool isFlush);
+
 /**
  * Transmits data to the IN endpoint of host.
  *
  * The transmission blocks this function from returning until the transmission
  * has completely finished.
  *
+ * Stream bytes held back for the next USB packet are flushed first: the last
+ * stream transfer may have ended in the middle of an item.
+ *
  * @param handle underlying pimpl
  * @param buffer data to transmit
  * @param len data length
@@ -28,6 +39,9 @@ isTransmitBusy(const struct HostTransport_ToHostApi *toHostApi) {
  */
 static uint8_t transmit(struct HostTransport_Handle *handle, uint8_t *buffer,
                         uint16_t len) {
+  while (0 < handle->toHost.txCarryBytes) {
+    transmitAccelerationBuffered(handle, NULL, 0, true);
+  }
   return handle->toHost.doTransmitImpl(buffer, len);
 }
 
@@ -115,6 +129,45 @@ void TransportTx_TxSamplingStarted(struct HostTransport_Handle *handle,
   }
 }
 
+void TransportTx_TxSamplingConfiguredStarted(
+    struct HostTransport_Handle *handle, uint16_t maxSamples,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint8_t sensorOdr, uint8_t sensorScale, uint8_t sensorRange,
+    uint8_t watermark, enum Transport_SampleFormat format, int8_t result) {
+  struct TransportFrame data;
+  data.header.id = Transport_HeaderId_Tx_SamplingConfiguredStarted;
+  data.asTxFrame.asSamplingConfiguredStarted.maxSamples = maxSamples;
+  data.asTxFrame.asSamplingConfiguredStarted.outputDataRate = sensorOdr;
+  data.asTxFrame.asSamplingConfiguredStarted.scale = sensorScale;
+  data.asTxFrame.asSamplingConfiguredStarted.range = sensorRange;
+  data.asTxFrame.asSamplingConfiguredStarted.watermark = watermark;
+  data.asTxFrame.asSamplingConfiguredStarted.format = format;
+  data.asTxFrame.asSamplingConfiguredStarted.result = result;
+
+  while (HostTransport_Status_Busy ==
+         transmit(handle, (uint8_t *)&data,
+                  SIZEOF_HEADER_INCL_PAYLOAD(
+                      data.asTxFrame.asSamplingConfiguredStarted))) {
+  }
+}
+
+void TransportTx_TxRecorderFinished(
+    struct HostTransport_Handle *handle,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint16_t totalCount, uint16_t triggerIndex, bool isTriggered) {
+  struct TransportFrame data;
+  data.header.id = Transport_HeaderId_Tx_RecorderFinished;
+  data.asTxFrame.asRecorderFinished.totalCount = totalCount;
+  data.asTxFrame.asRecorderFinished.triggerIndex = triggerIndex;
+  data.asTxFrame.asRecorderFinished.isTriggered = isTriggered ? 1 : 0;
+
+  while (
+      HostTransport_Status_Busy ==
+      transmit(handle, (uint8_t *)&data,
+               SIZEOF_HEADER_INCL_PAYLOAD(data.asTxFrame.asRecorderFinished))) {
+  }
+}
+
 void TransportTx_TxSamplingFinished(struct HostTransport_Handle *handle) {
   struct TransportFrame data = {.header.id =
                                     Transport_HeaderId_Tx_SamplingFinished};
@@ -201,7 +254,8 @@ void TransportTx_TxBufferStatus(
     struct HostTransport_Handle *handle,
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     uint16_t sizeBytes, uint16_t capacityTotal, uint16_t capacityUsedMax,
-    uint16_t putCount, uint16_t takeCount, uint16_t largestTxChunkBytes) {
+    uint16_t putCount, uint16_t takeCount, uint16_t largestTxChunkBytes,
+    uint16_t averageTxChunkBytes) {
   struct TransportFrame data;
   data.header.id = Transport_HeaderId_Tx_BufferStatus;
   data.asTxFrame.asBufferStatus.sizeBytes = sizeBytes;
@@ -210,15 +264,130 @@ void TransportTx_TxBufferStatus(
   data.asTxFrame.asBufferStatus.putCount = putCount;
   data.asTxFrame.asBufferStatus.takeCount = takeCount;
   data.asTxFrame.asBufferStatus.largestTxChunkBytes = largestTxChunkBytes;
+  data.asTxFrame.asBufferStatus.averageTxChunkBytes = averageTxChunkBytes;
   while (HostTransport_Status_Busy ==
          transmit(handle, (uint8_t *)&data,
                   SIZEOF_HEADER_INCL_PAYLOAD(data.asTxFrame.asBufferStatus))) {
   }
 }
 
-static int pushToRingbuffer(struct HostTransport_Handle *handle,
-                            struct TransportFrame *accelerationsChunk,
-                            uint16_t dataCount) {
+void TransportTx_TxClockCorrelation(
+    struct HostTransport_Handle *handle,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint16_t frameNumber, uint16_t sampleIndex, uint32_t timerTicks) {
+  struct TransportFrame data;
+  data.header.id = Transport_HeaderId_Tx_ClockCorrelation;
+  data.asTxFrame.asClockCorrelation.frameNumber = frameNumber;
+  data.asTxFrame.asClockCorrelation.sampleIndex = sampleIndex;
+  data.asTxFrame.asClockCorrelation.timerTicks = timerTicks;
+  while (HostTransport_Status_Busy ==
+         transmit(handle, (uint8_t *)&data,
+                  SIZEOF_HEADER_INCL_PAYLOAD(
+                      data.asTxFrame.asClockCorrelation))) {
+  }
+}
+
+void TransportTx_TxCalibration(
+    struct HostTransport_Handle *handle,
+    const struct Transport_Calibration *calibration) {
+  struct TransportFrame data;
+  data.header.id = Transport_HeaderId_Tx_Calibration;
+  data.asTxFrame.asCalibration.calibration = *calibration;
+  while (HostTransport_Status_Busy ==
+         transmit(handle, (uint8_t *)&data,
+                  SIZEOF_HEADER_INCL_PAYLOAD(data.asTxFrame.asCalibration))) {
+  }
+}
+
+void TransportTx_TxSpiClock(
+    struct HostTransport_Handle *handle, uint32_t clockHz,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint16_t divisor, uint16_t fastestDivisor) {
+  struct TransportFrame data;
+  data.header.id = Transport_HeaderId_Tx_SpiClock;
+  data.asTxFrame.asSpiClock.clockHz = clockHz;
+  data.asTxFrame.asSpiClock.divisor = divisor;
+  data.asTxFrame.asSpiClock.fastestDivisor = fastestDivisor;
+  while (HostTransport_Status_Busy ==
+         transmit(handle, (uint8_t *)&data,
+                  SIZEOF_HEADER_INCL_PAYLOAD(data.asTxFrame.asSpiClock))) {
+  }
+}
+
+void TransportTx_TxConfigurationSaved(
+    struct HostTransport_Handle *handle,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint8_t outputDataRate, uint8_t range, uint8_t scale, int8_t result) {
+  struct TransportFrame data;
+  data.header.id = Transport_HeaderId_Tx_ConfigurationSaved;
+  data.asTxFrame.asConfigurationSaved.setup.outputDataRate = outputDataRate;
+  data.asTxFrame.asConfigurationSaved.setup.range = range;
+  data.asTxFrame.asConfigurationSaved.setup.scale = scale;
+  data.asTxFrame.asConfigurationSaved.result = result;
+  while (HostTransport_Status_Busy ==
+         transmit(handle, (uint8_t *)&data,
+                  SIZEOF_HEADER_INCL_PAYLOAD(
+                      data.asTxFrame.asConfigurationSaved))) {
+  }
+}
+
+void TransportTx_TxStreamSetup(struct HostTransport_Handle *handle,
+                               int8_t result) {
+  struct TransportFrame data;
+  data.header.id = Transport_HeaderId_Tx_StreamSetup;
+  data.asTxFrame.asStreamSetup.axes = handle->toHost.axes;
+  data.asTxFrame.asStreamSetup.framed = handle->toHost.isFramed ? 1U : 0U;
+  data.asTxFrame.asStreamSetup.result = result;
+  while (HostTransport_Status_Busy ==
+         transmit(handle, (uint8_t *)&data,
+                  SIZEOF_HEADER_INCL_PAYLOAD(data.asTxFrame.asStreamSetup))) {
+  }
+}
+
+int TransportTx_TxCaptureChunk(
+    struct HostTransport_Handle *handle,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint16_t offset, uint16_t totalCount, const void *samples, uint8_t count) {
+  if (TRANSPORTTX_CAPTURE_CHUNK_SAMPLES < count ||
+      (NULL == samples && 0 < count)) {
+    return -EINVAL;
+  }
+
+  // must stay valid until the transfer has completed
+  static uint8_t byteBuffer[SIZEOF_HEADER_INCL_PAYLOAD(
+                                struct TransportTx_CaptureChunk) +
+                            TRANSPORTTX_CAPTURE_CHUNK_SAMPLES *
+                                sizeof(struct Transport_Acceleration)] = {0};
+
+  // previous chunk may still be in flight
+  while (isTransmitBusy(&handle->toHost)) {
+  }
+
+  struct TransportFrame *frame = {(struct TransportFrame *)byteBuffer};
+  frame->header.id = Transport_HeaderId_Tx_CaptureChunk;
+  frame->asTxFrame.asCaptureChunk.offset = offset;
+  frame->asTxFrame.asCaptureChunk.totalCount = totalCount;
+  frame->asTxFrame.asCaptureChunk.count = count;
+
+  const uint16_t headerBytes = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_CaptureChunk)};
+  const uint16_t samplesBytes = {
+      count * Transport_sampleSizeBytes(handle->toHost.axes)};
+
+  for (uint16_t idx = 0; idx < samplesBytes; idx++) {
+    byteBuffer[headerBytes + idx] = ((const uint8_t *)samples)[idx];
+  }
+
+  while (HostTransport_Status_Busy ==
+         transmit(handle, byteBuffer, headerBytes + samplesBytes)) {
+  }
+
+  return 0;
+}
+
+RAMFUNC static int pushToRingbuffer(struct HostTransport_Handle *handle,
+                                    struct TransportFrame *accelerationsChunk,
+                                    uint16_t dataCount) {
   const uint16_t sizeofItem = {
       Ringbuffer_itemSizeBytes(&handle->toHost.ringbuffer)};
 
@@ -237,9 +406,67 @@ static int pushToRingbuffer(struct HostTransport_Handle *handle,
   return 0;
 }
 
-static uint16_t popDataFromRingbuffer(struct HostTransport_Handle *handle,
-                                      uint8_t *txBuffer,
-                                      uint16_t txBufferSize) {
+/**
+ * Determines the number of buffer items forming the oldest buffered frame.
+ *
+ * Compressed and structure of arrays frames vary in size and are buffered
+ * byte by byte \see Transport_isBlockFormat(), hence their size is read from
+ * their headers. Any other item is a frame or sample on its own.
+ *
+ * @param toHostApi
+ * @return number of items, at least 1
+ */
+RAMFUNC static uint16_t
+nextFrameItemsCount(const struct HostTransport_ToHostApi *toHostApi) {
+  if (!Transport_isBlockFormat(toHostApi->format)) {
+    return 1;
+  }
+
+  const bool isDelta = {Transport_SampleFormat_AccelerationDelta ==
+                        toHostApi->format};
+  const uint16_t headerBytes = {
+      isDelta ? SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationDelta)
+              : SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSoa)};
+  uint8_t head[SIZEOF_HEADER_INCL_PAYLOAD(
+                   struct TransportTx_AccelerationDelta) +
+               CODEC_BLOCK_HEADER_BYTES];
+  const uint16_t headBytes = {isDelta ? sizeof(head) : headerBytes};
+
+  // frames are buffered completely, hence the whole head is available
+  uint16_t peekedBytes = {0};
+  while (peekedBytes < headBytes &&
+         0 == Ringbuffer_peek(&toHostApi->ringbuffer, peekedBytes,
+                              &head[peekedBytes])) {
+    peekedBytes++;
+  }
+
+  if (!isDelta) {
+    const uint8_t count = {
+        head[sizeof(struct Transport_Header) +
+             offsetof(struct TransportTx_AccelerationSoa, count)]};
+    return headerBytes + 3U * TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(count);
+  }
+
+  const int blockBytes = {
+      Codec_blockSizeBytes(&head[headerBytes], peekedBytes - headerBytes)};
+  // never encoded malformed: drain byte by byte rather than stalling
+  return (0 > blockBytes) ? 1 : headerBytes + blockBytes;
+}
+
+/**
+ * Pops whole frames from the stream buffer.
+ *
+ * Transfers end on frame boundaries so that a response transmitted in
+ * between never lands inside a stream frame.
+ *
+ * @param handle
+ * @param txBuffer output
+ * @param txBufferSize size of txBuffer
+ * @return number of popped buffer items
+ */
+RAMFUNC static uint16_t
+popDataFromRingbuffer(struct HostTransport_Handle *handle, uint8_t *txBuffer,
+                      uint16_t txBufferSize) {
 
   const uint16_t sizeofItem = {
       Ringbuffer_itemSizeBytes(&handle->toHost.ringbuffer)};
@@ -248,19 +475,98 @@ static uint16_t popDataFromRingbuffer(struct HostTransport_Handle *handle,
   // pop data from buffer (if any) and store to TX-buffer
 
   // NOLINTNEXTLINE(altera-id-dependent-backward-branch)
-  while ((!Ringbuffer_isEmpty(&handle->toHost.ringbuffer)) &&
-         ((sizeofItem * (poppedItemsCount + 1)) < txBufferSize)) {
-
-    struct TransportFrame *nextInTxBuffer = (struct TransportFrame *)&txBuffer[(
-        uint16_t)(sizeofItem * poppedItemsCount)];
+  while (!Ringbuffer_isEmpty(&handle->toHost.ringbuffer)) {
+    const uint16_t frameItemsCount = {nextFrameItemsCount(&handle->toHost)};
+    if (txBufferSize <= sizeofItem * (poppedItemsCount + frameItemsCount)) {
+      break;
+    }
 
-    Ringbuffer_take(&handle->toHost.ringbuffer, nextInTxBuffer);
-    poppedItemsCount++;
+    for (uint16_t idx = 0; idx < frameItemsCount; idx++) {
+      Ringbuffer_take(&handle->toHost.ringbuffer,
+                      &txBuffer[(uint16_t)(sizeofItem * poppedItemsCount)]);
+      poppedItemsCount++;
+    }
   }
 
   return poppedItemsCount;
 }
 
+/**
+ * Determines the size of the header prefixed to each transmitted block.
+ *
+ * @param toHostApi
+ * @return 0 if buffer items are self-contained frames
+ */
+RAMFUNC static uint16_t
+blockHeaderBytes(const struct HostTransport_ToHostApi *toHostApi) {
+  if (Transport_isPackedFormat(toHostApi->format)) {
+    return SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationPacked);
+  }
+  if (Transport_SampleFormat_Acceleration == toHostApi->format &&
+      Transport_Axis_All != toHostApi->axes) {
+    return SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationAxes);
+  }
+  return 0;
+}
+
+/**
+ * Writes the header prefixed to a block of popped samples, if any.
+ *
+ * @param toHostApi
+ * @param frame output, blockHeaderBytes() bytes
+ * @param firstIndex running index of first sample in block
+ * @param count number of samples in block
+ */
+RAMFUNC static void
+writeBlockHeader(const struct HostTransport_ToHostApi *toHostApi,
+                 struct TransportFrame *frame,
+                 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+                 uint16_t firstIndex, uint16_t count) {
+  if (Transport_isPackedFormat(toHostApi->format)) {
+    frame->header.id = Transport_HeaderId_Tx_AccelerationPacked;
+    frame->asTxFrame.asAccelerationPacked.firstIndex = firstIndex;
+    frame->asTxFrame.asAccelerationPacked.count = count;
+    frame->asTxFrame.asAccelerationPacked.format = toHostApi->format;
+  } else if (0 < blockHeaderBytes(toHostApi)) {
+    frame->header.id = Transport_HeaderId_Tx_AccelerationAxes;
+    frame->asTxFrame.asAccelerationAxes.firstIndex = firstIndex;
+    frame->asTxFrame.asAccelerationAxes.count = count;
+    frame->asTxFrame.asAccelerationAxes.axes = toHostApi->axes;
+  }
+}
+
+/**
+ * Wraps a chunk into a stream frame \see Transport_StreamFrameHeader.
+ *
+ * @param toHostApi
+ * @param buffer word aligned buffer, the chunk starts right after the stream
+ * frame header; must provide room for padding and CRC
+ * @param chunkBytes size of chunk
+ * @return size of stream frame
+ */
+RAMFUNC static uint16_t
+wrapStreamFrame(struct HostTransport_ToHostApi *toHostApi, uint8_t *buffer,
+                uint16_t chunkBytes) {
+  const uint16_t headerBytes = {sizeof(struct Transport_StreamFrameHeader)};
+
+  struct Transport_StreamFrameHeader *header = {
+      (struct Transport_StreamFrameHeader *)buffer};
+  header->sync = TRANSPORT_STREAM_SYNC;
+  header->length = chunkBytes;
+  header->sequence = toHostApi->frameSequence++;
+
+  const uint16_t paddedBytes = {headerBytes + ((chunkBytes + 3U) & ~3U)};
+  for (uint16_t idx = headerBytes + chunkBytes; idx < paddedBytes; idx++) {
+    buffer[idx] = 0;
+  }
+
+  uint32_t *words = {(uint32_t *)buffer};
+  words[paddedBytes / sizeof(uint32_t)] = toHostApi->doCrc32WordsImpl(
+      words, paddedBytes / sizeof(uint32_t));
+
+  return paddedBytes + sizeof(uint32_t);
+}
+
 /**
  * Transmits or buffers acceleration data blocks to the IN endpoint of host or
  * in ringbuffer.
@@ -294,16 +600,32 @@ static uint16_t popDataFromRingbuffer(struct HostTransport_Handle *handle,
  * type: Transport_Header + TransportTx_Acceleration.
  * @param dataCount amount of items in buffer (Transport_Header +
  * TransportTx_Acceleration)
+ * @param isFlush transmit held back bytes in a short packet right away
+ *
+ * Unless all axes are selected or a bit-packed format is used the buffer items
+ * are packed samples instead, which are prefixed with a single
+ * TransportTx_AccelerationAxes respectively TransportTx_AccelerationPacked
+ * header per transmitted block.
+ *
+ * Transfers are sized to whole USB packets of TRANSPORTTX_USB_PACKET_BYTES
+ * while enough data is buffered: a short packet ends the transfer and the host
+ * would not poll again before its next interval. The remainder of the last
+ * packet is held back and leads the next transfer. It is sent in a short
+ * packet once TRANSPORTTX_FLUSH_DEADLINE_MS expired or the stream is flushed.
+ * Transfers of whole packets are terminated by a zero-length packet which the
+ * CDC class driver appends on its own, hence a zero length transfer is never
+ * initiated here.
+ *
  * @return
  *   - -ENOMEM if ringbuffer is exhausted
- *   - -ENODATA if all data is sent
+ *   - -ENODATA if all data is sent or less than a packet is held back
  *   - -EAGAIN if a subsequent call would send pending data
  *   - -EIO any other errors
  */
-static int
+RAMFUNC static int
 transmitAccelerationBuffered(struct HostTransport_Handle *handle,
                              struct TransportFrame *accelerationsChunk,
-                             uint16_t dataCount) {
+                             uint16_t dataCount, bool isFlush) {
 
   // store data to ringbuffer
 
@@ -317,43 +639,260 @@ transmitAccelerationBuffered(struct HostTransport_Handle *handle,
     return -EAGAIN;
   }
 
-  if (Ringbuffer_isEmpty(&handle->toHost.ringbuffer)) {
+  const uint8_t carryBytes = {handle->toHost.txCarryBytes};
+  const bool isEmpty = {Ringbuffer_isEmpty(&handle->toHost.ringbuffer)};
+  if (isEmpty && 0 == carryBytes) {
     return -ENODATA;
   }
 
+  const uint32_t nowMs = {handle->toHost.getTickMsImpl()};
+  if (0 < carryBytes && TRANSPORTTX_FLUSH_DEADLINE_MS <=
+                            nowMs - handle->toHost.txCarrySinceMs) {
+    isFlush = true;
+  }
+
+  if (isEmpty && !isFlush) {
+    return -ENODATA;
+  }
+
+  // word aligned for the stream frame CRC; the first packet is reserved for
+  // bytes held back by the previous transfer
+  static uint8_t byteBuffer[TRANSPORTTX_USB_PACKET_BYTES +
+                            TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES]
+      __attribute__((aligned(4))) = {0};
+
+  // move held back bytes right in front of the new chunk; the destination
+  // never lies behind the source
+  uint8_t *txBuffer = {&byteBuffer[TRANSPORTTX_USB_PACKET_BYTES - carryBytes]};
+  for (uint8_t idx = 0; idx < carryBytes; idx++) {
+    txBuffer[idx] = byteBuffer[handle->toHost.txCarryOffset + idx];
+  }
+
   // pop data from buffer and store to TX-buffer
 
-  static uint8_t byteBuffer[TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES] = {
-      0};
+  // leave room for held back bytes, stream frame header, padding and CRC
+  const bool isFramed = {handle->toHost.isFramed};
+  const uint16_t frameHeaderBytes = {
+      isFramed ? sizeof(struct Transport_StreamFrameHeader) : 0};
+  const uint16_t frameTrailerBytes = {isFramed ? 3U + sizeof(uint32_t) : 0};
+  uint8_t *frame = {&byteBuffer[TRANSPORTTX_USB_PACKET_BYTES]};
+  uint8_t *chunk = {&frame[frameHeaderBytes]};
 
-  uint16_t poppedItemsCount = {popDataFromRingbuffer(
-      handle, byteBuffer, TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES)};
+  const uint16_t headerBytes = {blockHeaderBytes(&handle->toHost)};
+  const uint16_t firstIndex = {
+      Ringbuffer_takeCount(&handle->toHost.ringbuffer)};
 
-  // transmit tx buffer
+  uint16_t poppedItemsCount = {popDataFromRingbuffer(
+      handle, &chunk[headerBytes],
+      TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES - carryBytes -
+          frameHeaderBytes - frameTrailerBytes - headerBytes)};
 
   const uint16_t sizeofItem = {
       Ringbuffer_itemSizeBytes(&handle->toHost.ringbuffer)};
 
+  uint16_t chunkBytes = {0};
+  if (0 < poppedItemsCount) {
+    writeBlockHeader(&handle->toHost, (struct TransportFrame *)chunk,
+                     firstIndex, poppedItemsCount);
+    chunkBytes = headerBytes + sizeofItem * poppedItemsCount;
+    if (isFramed) {
+      chunkBytes = wrapStreamFrame(&handle->toHost, frame, chunkBytes);
+    }
+  }
+
+  // whole packets only unless flushing, hold back the remainder
+
+  const uint16_t pendingBytes = {carryBytes + chunkBytes};
+  uint16_t txBytes = {pendingBytes};
+  if (!isFlush) {
+    txBytes -= pendingBytes % TRANSPORTTX_USB_PACKET_BYTES;
+  }
+
+  if (0 == carryBytes || 0 < txBytes) {
+    handle->toHost.txCarrySinceMs = nowMs;
+  }
+  handle->toHost.txCarryBytes = pendingBytes - txBytes;
+  handle->toHost.txCarryOffset = (txBuffer - byteBuffer) + txBytes;
+
+  if (0 == txBytes) {
+    return -ENODATA;
+  }
+
+  // transmit tx buffer
+
   // todo: enforce that no transmission can be initiated from isTransmitBusy()
   //   until transmission doTransmitImpl()
 
-  const uint16_t txBytes = {sizeofItem * poppedItemsCount};
-
   if (txBytes > handle->toHost.largestTxChunkBytes) {
     handle->toHost.largestTxChunkBytes = txBytes;
   }
+  handle->toHost.txBytesCount += txBytes;
+  handle->toHost.txTransfersCount++;
 
-  if (poppedItemsCount > 0) {
-    if (HostTransport_Status_Fail ==
-        handle->toHost.doTransmitImpl(byteBuffer, txBytes)) {
-      return -EIO;
-    }
+  if (HostTransport_Status_Fail ==
+      handle->toHost.doTransmitImpl(txBuffer, txBytes)) {
+    return -EIO;
   }
 
   return -EAGAIN;
 }
 
-int TransportTx_TxAccelerationBuffer(
+int TransportTx_TxSequenceSegment(
+    struct HostTransport_Handle *handle,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint16_t segment, uint16_t samplesCount, uint32_t startMs) {
+  if (Transport_Axis_All != handle->toHost.axes ||
+      Transport_SampleFormat_Acceleration != handle->toHost.format) {
+    return -EINVAL;
+  }
+
+  struct TransportFrame frame;
+  frame.header.id = Transport_HeaderId_Tx_SequenceSegment;
+  frame.asTxFrame.asSequenceSegment.segment = segment;
+  frame.asTxFrame.asSequenceSegment.samplesCount = samplesCount;
+  frame.asTxFrame.asSequenceSegment.startMs = startMs;
+
+  // occupies one stream buffer item just like an acceleration frame
+  return transmitAccelerationBuffered(handle, &frame, 1, false);
+}
+
+int TransportTx_TxAccelerationSensor(
+    struct HostTransport_Handle *handle,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint8_t sensor, uint8_t count, uint16_t firstIndex, uint32_t timerTicks) {
+  if (Transport_Axis_All != handle->toHost.axes ||
+      Transport_SampleFormat_Acceleration != handle->toHost.format) {
+    return -EINVAL;
+  }
+
+  struct TransportFrame frame;
+  frame.header.id = Transport_HeaderId_Tx_AccelerationSensor;
+  frame.asTxFrame.asAccelerationSensor.sensor = sensor;
+  frame.asTxFrame.asAccelerationSensor.count = count;
+  frame.asTxFrame.asAccelerationSensor.firstIndex = firstIndex;
+  frame.asTxFrame.asAccelerationSensor.timerTicks = timerTicks;
+
+  // occupies one stream buffer item just like an acceleration frame
+  return transmitAccelerationBuffered(handle, &frame, 1, false);
+}
+
+/**
+ * Forwards a variable sized frame to transmitAccelerationBuffered().
+ *
+ * The stream buffer holds bytes in this mode. A frame is either buffered
+ * completely or not at all and popped completely so that the stream stays
+ * decodable.
+ *
+ * @param handle
+ * @param frame frame to buffer
+ * @param frameBytes size of frame in bytes
+ * @return same as transmitAccelerationBuffered()
+ */
+RAMFUNC static int transmitBlockFrame(struct HostTransport_Handle *handle,
+                                      struct TransportFrame *frame,
+                                      uint16_t frameBytes) {
+  if (Ringbuffer_capacity(&handle->toHost.ringbuffer) -
+          Ringbuffer_itemsCount(&handle->toHost.ringbuffer) <
+      frameBytes) {
+    return -ENOMEM;
+  }
+
+  return transmitAccelerationBuffered(handle, frame, frameBytes, false);
+}
+
+/**
+ * Compresses samples into one TransportTx_AccelerationDelta frame.
+ *
+ * @param handle
+ * @param data samples
+ * @param count number of samples
+ * @param firstIndex the tracked index number of the first sample
+ * @return same as transmitBlockFrame()
+ */
+RAMFUNC static int transmitAccelerationDelta(
+    struct HostTransport_Handle *handle,
+    const struct Transport_Acceleration *data,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint8_t count, uint16_t firstIndex) {
+  static_assert(sizeof(struct Transport_Acceleration) ==
+                    sizeof(struct Codec_Acceleration),
+                "ERROR: acceleration structs must match in size!");
+  static_assert(TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES <=
+                    CODEC_BLOCK_MAX_SAMPLES,
+                "ERROR: samples per transmission exceed codec block");
+
+  const uint16_t headerBytes = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationDelta)};
+  uint8_t byteBuffer[SIZEOF_HEADER_INCL_PAYLOAD(
+                         struct TransportTx_AccelerationDelta) +
+                     CODEC_BLOCK_MAX_BYTES(
+                         TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES)];
+
+  struct TransportFrame *frame = {(struct TransportFrame *)byteBuffer};
+  frame->header.id = Transport_HeaderId_Tx_AccelerationDelta;
+  frame->asTxFrame.asAccelerationDelta.firstIndex = firstIndex;
+
+  const int blockBytes = {
+      Codec_encodeBlock((const struct Codec_Acceleration *)data, count,
+                        &byteBuffer[headerBytes])};
+  if (0 > blockBytes) {
+    return -EINVAL;
+  }
+
+  return transmitBlockFrame(handle, frame, headerBytes + blockBytes);
+}
+
+/**
+ * Rearranges samples into one TransportTx_AccelerationSoa frame.
+ *
+ * @param handle
+ * @param data samples
+ * @param count number of samples
+ * @param firstIndex the tracked index number of the first sample
+ * @return same as transmitBlockFrame()
+ */
+RAMFUNC static int transmitAccelerationSoa(
+    struct HostTransport_Handle *handle,
+    const struct Transport_Acceleration *data,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint8_t count, uint16_t firstIndex) {
+  static_assert(
+      0 == SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSoa) % 4U,
+      "ERROR: axis arrays must start 4-byte aligned");
+
+  const uint16_t headerBytes = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSoa)};
+  const uint16_t strideBytes = {TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(count)};
+  uint8_t byteBuffer[SIZEOF_HEADER_INCL_PAYLOAD(
+                         struct TransportTx_AccelerationSoa) +
+                     3U * TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(
+                              TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES)]
+      __attribute__((aligned(4)));
+
+  struct TransportFrame *frame = {(struct TransportFrame *)byteBuffer};
+  frame->header.id = Transport_HeaderId_Tx_AccelerationSoa;
+  frame->asTxFrame.asAccelerationSoa.firstIndex = firstIndex;
+  frame->asTxFrame.asAccelerationSoa.count = count;
+
+  int16_t *x = {(int16_t *)&byteBuffer[headerBytes]};
+  int16_t *y = {(int16_t *)&byteBuffer[headerBytes + strideBytes]};
+  int16_t *z = {(int16_t *)&byteBuffer[headerBytes + 2U * strideBytes]};
+  for (uint8_t idx = 0; idx < count; idx++) {
+    x[idx] = data[idx].x;
+    y[idx] = data[idx].y;
+    z[idx] = data[idx].z;
+  }
+  if (count & 1U) {
+    // zero padding up to the next 4-byte boundary
+    x[count] = 0;
+    y[count] = 0;
+    z[count] = 0;
+  }
+
+  return transmitBlockFrame(handle, frame, headerBytes + 3U * strideBytes);
+}
+
+RAMFUNC int TransportTx_TxAccelerationBuffer(
     struct HostTransport_Handle *handle,
     const struct Transport_Acceleration *data,
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
@@ -365,7 +904,7 @@ int TransportTx_TxAccelerationBuffer(
 
   if (0 == count || NULL == data) {
     // transmit pending data
-    return transmitAccelerationBuffered(handle, NULL, 0);
+    return transmitAccelerationBuffered(handle, NULL, 0, false);
   }
 
   // packed buffer containing: Transport_Header + TransportTx_Acceleration
@@ -373,6 +912,31 @@ int TransportTx_TxAccelerationBuffer(
       byteBuffer[TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES *
                  SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration)];
 
+  if (Transport_SampleFormat_AccelerationDelta == handle->toHost.format) {
+    return transmitAccelerationDelta(handle, data, count, firstIndex);
+  }
+
+  if (Transport_SampleFormat_AccelerationSoa == handle->toHost.format) {
+    return transmitAccelerationSoa(handle, data, count, firstIndex);
+  }
+
+  if (Transport_isPackedFormat(handle->toHost.format)) {
+    // bit-packed samples, one buffer item each
+    Codec_pack(Transport_SampleFormat_Packed13 == handle->toHost.format
+                   ? Codec_Packing_13bit
+                   : Codec_Packing_10bit,
+               (const struct Codec_Acceleration *)data, count, byteBuffer);
+    return transmitAccelerationBuffered(
+        handle, (struct TransportFrame *)byteBuffer, count, false);
+  }
+
+  if (Transport_Axis_All != handle->toHost.axes) {
+    // packed samples of the selected axes only, one buffer item each
+    Transport_packAxes(handle->toHost.axes, data, count, byteBuffer);
+    return transmitAccelerationBuffered(
+        handle, (struct TransportFrame *)byteBuffer, count, false);
+  }
+
   // pack a copy of samples inclusive sequence numbering
   for (uint8_t idx = 0; idx < count; idx++) {
 
@@ -389,5 +953,9 @@ int TransportTx_TxAccelerationBuffer(
     frame->header.id = Transport_HeaderId_Tx_Acceleration;
   }
   return transmitAccelerationBuffered(
-      handle, (struct TransportFrame *)byteBuffer, count);
+      handle, (struct TransportFrame *)byteBuffer, count, false);
+}
+
+int TransportTx_TxAccelerationFlush(struct HostTransport_Handle *handle) {
+  return transmitAccelerationBuffered(handle, NULL, 0, true);
 }
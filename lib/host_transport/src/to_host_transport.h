@@ -6,14 +6,24 @@
 
 #pragma once
 #include <inttypes.h>
+#include <stdbool.h>
 
 // NOLINTNEXTLINE(modernize-macro-to-enum)
 #define TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES 24U
 
+/**
+ * Maximum number of captured samples per TransportTx_CaptureChunk (about 1kB
+ * per transfer).
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TRANSPORTTX_CAPTURE_CHUNK_SAMPLES 168U
+
 struct HostTransport_Handle;
 struct Transport_Acceleration;
+struct Transport_Calibration;
 
 enum HostTransport_Status;
+enum Transport_SampleFormat;
 enum TransportTx_FaultCode;
 
 /**
@@ -88,6 +98,42 @@ void TransportTx_TxFirmwareVersion(struct HostTransport_Handle *handle,
 void TransportTx_TxSamplingStarted(struct HostTransport_Handle *handle,
                                    uint16_t max_samples);
 
+/**
+ * Transmits sampling started package TransportTx_SamplingConfiguredStarted
+ * including the effective setup to the IN endpoint of host. Also answers a
+ * rejected configure-and-start or capture start request.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param maxSamples amount of samples requested, infinite if 0
+ * @param sensorOdr sensor output data rate
+ * @param sensorScale sensor scale
+ * @param sensorRange sensor range
+ * @param watermark sensor FiFo watermark level
+ * @param format sample format of the stream
+ * @param result 0 if started, negative errno if rejected
+ */
+void TransportTx_TxSamplingConfiguredStarted(
+    struct HostTransport_Handle *handle, uint16_t maxSamples,
+    uint8_t sensorOdr, uint8_t sensorScale, uint8_t sensorRange,
+    uint8_t watermark, enum Transport_SampleFormat format, int8_t result);
+
+/**
+ * Transmits flight recorder finished package TransportTx_RecorderFinished to
+ * the IN endpoint of host.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param totalCount number of recorded samples
+ * @param triggerIndex index of trigger sample within recorded samples
+ * @param isTriggered false if stopped before trigger
+ */
+void TransportTx_TxRecorderFinished(struct HostTransport_Handle *handle,
+                                    uint16_t totalCount, uint16_t triggerIndex,
+                                    bool isTriggered);
+
 /**
  * Transmits sampling finished package TransportTx_SamplingFinished to the IN
  * endpoint of host.
@@ -166,12 +212,139 @@ void TransportTx_TxFault(struct HostTransport_Handle *handle,
  * @param capacityTotal maximum capacity (items/slots)
  * @param capacityUsedMax greatest items utilization since sampling start
  * @param largestTxChunkBytes largest chunk sent at once since sampling start
+ * @param averageTxChunkBytes average chunk size since sampling start
  */
 void TransportTx_TxBufferStatus(struct HostTransport_Handle *handle,
                                 uint16_t sizeBytes, uint16_t capacityTotal,
                                 uint16_t capacityUsedMax, uint16_t putCount,
                                 uint16_t takeCount,
-                                uint16_t largestTxChunkBytes);
+                                uint16_t largestTxChunkBytes,
+                                uint16_t averageTxChunkBytes);
+
+/**
+ * Transmits a clock correlation TransportTx_ClockCorrelation to the IN
+ * endpoint of host.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param frameNumber USB frame number latched at start-of-frame
+ * @param sampleIndex number of samples taken from the sensor at start-of-frame
+ * @param timerTicks free running timer latched at start-of-frame
+ */
+void TransportTx_TxClockCorrelation(struct HostTransport_Handle *handle,
+                                    uint16_t frameNumber, uint16_t sampleIndex,
+                                    uint32_t timerTicks);
+
+/**
+ * Transmits the calibration TransportTx_Calibration of a sensor to the IN
+ * endpoint of host.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param calibration calibration as stored on the controller
+ */
+void TransportTx_TxCalibration(struct HostTransport_Handle *handle,
+                               const struct Transport_Calibration *calibration);
+
+/**
+ * Transmits the SPI clock TransportTx_SpiClock to the IN endpoint of host.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param clockHz SPI clock in use
+ * @param divisor SPI prescaler in use
+ * @param fastestDivisor fastest prescaler verified at startup, 0 if none
+ */
+void TransportTx_TxSpiClock(struct HostTransport_Handle *handle,
+                            uint32_t clockHz, uint16_t divisor,
+                            uint16_t fastestDivisor);
+
+/**
+ * Transmits the persisted sensor setup TransportTx_ConfigurationSaved to the
+ * IN endpoint of host.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param outputDataRate \see TransportTx_DeviceSetup
+ * @param range \see TransportTx_DeviceSetup
+ * @param scale \see TransportTx_DeviceSetup
+ * @param result 0 on success, negative errno otherwise
+ */
+void TransportTx_TxConfigurationSaved(struct HostTransport_Handle *handle,
+                                      uint8_t outputDataRate, uint8_t range,
+                                      uint8_t scale, int8_t result);
+
+/**
+ * Transmits the axes selection and the stream framing in use
+ * TransportTx_StreamSetup to the IN endpoint of host.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param result 0 on success, negative errno if the request was rejected
+ */
+void TransportTx_TxStreamSetup(struct HostTransport_Handle *handle,
+                               int8_t result);
+
+/**
+ * Transmits a chunk of captured samples TransportTx_CaptureChunk to the IN
+ * endpoint of host.
+ *
+ * Transmission will block this function from returning until completion.
+ *
+ * @param handle host transport pimpl
+ * @param offset index of the first sample
+ * @param totalCount total number of captured samples
+ * @param samples captured samples starting at offset laid out as packed by
+ * Transport_packAxes() for HostTransport_ToHostApi.axes, may be NULL if count
+ * is 0
+ * @param count number of samples, at most TRANSPORTTX_CAPTURE_CHUNK_SAMPLES
+ * @return -EINVAL if count is too large, 0 otherwise
+ */
+int TransportTx_TxCaptureChunk(struct HostTransport_Handle *handle,
+                               uint16_t offset, uint16_t totalCount,
+                               const void *samples, uint8_t count);
+
+/**
+ * Tags the start of a sequence segment TransportTx_SequenceSegment in the
+ * acceleration stream.
+ *
+ * The tag is buffered in order with the acceleration data \see
+ * TransportTx_TxAccelerationBuffer().
+ *
+ * @param handle host transport pimpl
+ * @param segment index of segment
+ * @param samplesCount number of samples of segment
+ * @param startMs device uptime at segment start
+ * @return same as TransportTx_TxAccelerationBuffer(), -EINVAL if not all axes
+ * are selected or the stream is compressed
+ */
+int TransportTx_TxSequenceSegment(struct HostTransport_Handle *handle,
+                                  uint16_t segment, uint16_t samplesCount,
+                                  uint32_t startMs);
+
+/**
+ * Tags the next count acceleration frames TransportTx_AccelerationSensor with
+ * the sensor they were fetched from.
+ *
+ * The tag is buffered in order with the acceleration data \see
+ * TransportTx_TxAccelerationBuffer().
+ *
+ * @param handle host transport pimpl
+ * @param sensor sensor ID
+ * @param count number of acceleration frames following
+ * @param firstIndex index of first acceleration frame following
+ * @param timerTicks free running timer when the samples were fetched
+ * @return same as TransportTx_TxAccelerationBuffer(), -EINVAL if not all axes
+ * are selected or the stream is compressed
+ */
+int TransportTx_TxAccelerationSensor(struct HostTransport_Handle *handle,
+                                     uint8_t sensor, uint8_t count,
+                                     uint16_t firstIndex, uint32_t timerTicks);
 
 /**
  * Forwards acceleration data block to the IN endpoint of host.
@@ -179,19 +352,35 @@ void TransportTx_TxBufferStatus(struct HostTransport_Handle *handle,
  * Triggers sending data to the the IN endpoint.
  * If USB is busy the data is buffered for a later transmission.
  * To consume all buffered data this function shall be called until -ENODATA is
- * returned (with data and/or count being NULL and/or 0).
+ * returned (with data and/or count being NULL and/or 0). Less than a USB
+ * packet may remain held back \see TransportTx_TxAccelerationFlush().
  *
  * @param handle host transport pimpl
  * @param data tx buffer or NULL to consume remaining buffered data
  * @param count buffer size or 0 to consume remaining buffered data
  * @param firstIndex the tracked index number of the first acceleration in data
+ * buffer; unused unless all axes are selected since the index of packed blocks
+ * TransportTx_AccelerationAxes is derived from the samples taken from the
  * buffer
  * @return
  *   - 0 on success (data send in first run),
  *   - EBUSY if data was buffered,
- *   - ENODATA if no buffered data available (all data sent),
+ *   - ENODATA if no buffered data available (all data sent) or less than a
+ *     USB packet is held back until TRANSPORTTX_FLUSH_DEADLINE_MS expires,
  *   - -EINVAL otherwise
  */
 int TransportTx_TxAccelerationBuffer(struct HostTransport_Handle *handle,
                                      const struct Transport_Acceleration *data,
                                      uint8_t count, uint16_t firstIndex);
+
+/**
+ * Transmits buffered acceleration data including bytes held back for filling
+ * up a USB packet.
+ *
+ * Shall be called at the end of stream until -ENODATA is returned so that
+ * the last packet is not held back until the next stream.
+ *
+ * @param handle host transport pimpl
+ * @return same as TransportTx_TxAccelerationBuffer()
+ */
+int TransportTx_TxAccelerationFlush(struct HostTransport_Handle *handle);
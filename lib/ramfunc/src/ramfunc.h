@@ -0,0 +1,39 @@
+/**
+ * \file ramfunc.h
+ *
+ * Attribute for functions on the sampling and streaming hot path.
+ *
+ * Only active if RAMFUNC_ENABLE is defined (env:controller_performance):
+ *   - the function is linked to section .RamFunc, which the linker script
+ *     STM32F411CEUx_RAMFUNC.ld places in SRAM and the startup code copies
+ *     along with .data; flash is read with wait states at 60MHz, SRAM is not
+ *   - the function is optimized for speed regardless of the global level,
+ *     the remaining image is optimized for size
+ *
+ * Natively only the optimization level applies. Static helpers called from a
+ * RAMFUNC function shall be RAMFUNC as well: GCC does not inline across
+ * differing optimization levels and the helper would remain in flash.
+ *
+ * Example:
+ * \code
+ * RAMFUNC int Ringbuffer_put(struct Ringbuffer *buffer, const void *item) {
+ *   ...
+ * }
+ * \endcode
+ */
+
+#pragma once
+
+#if defined(RAMFUNC_ENABLE) && !defined(ENV_NATIVE)
+#define RAMFUNC_SECTION __attribute__((section(".RamFunc")))
+#else
+#define RAMFUNC_SECTION
+#endif
+
+#if defined(RAMFUNC_ENABLE) && defined(__GNUC__) && !defined(__clang__)
+#define RAMFUNC_OPTIMIZE __attribute__((optimize("O3")))
+#else
+#define RAMFUNC_OPTIMIZE
+#endif
+
+#define RAMFUNC RAMFUNC_SECTION RAMFUNC_OPTIMIZE
@@ -6,6 +6,7 @@
 
 #include "ringbuffer.h"
 #include <errno.h>
+#include <ramfunc.h>
 #include <string.h>
 
 /**
@@ -14,7 +15,7 @@
  * @param index
  * @return -EOVERFLOW if buffer is already full, 0 otherwise
  */
-static int advanceEnd(struct Ringbuffer_Index *index) {
+RAMFUNC static int advanceEnd(struct Ringbuffer_Index *index) {
   if (index->isFull) {
     return -EOVERFLOW;
   }
@@ -32,7 +33,7 @@ static int advanceEnd(struct Ringbuffer_Index *index) {
  * @param index
  * @return -ENODATA if buffer is already empty, 0 otherwise
  */
-static int advanceBegin(struct Ringbuffer_Index *index) {
+RAMFUNC static int advanceBegin(struct Ringbuffer_Index *index) {
   if (index->isEmpty) {
     return -ENODATA;
   }
@@ -51,7 +52,8 @@ static int advanceBegin(struct Ringbuffer_Index *index) {
  * @param index
  * @return pointer to the item
  */
-static uint8_t *itemAtIndex(struct Ringbuffer *buffer, uint16_t index) {
+RAMFUNC static uint8_t *itemAtIndex(struct Ringbuffer *buffer,
+                                    uint16_t index) {
   return buffer->storage + (index * buffer->index.itemSizeBytes);
 }
 
@@ -90,7 +92,7 @@ int Ringbuffer_init(struct Ringbuffer *buffer, uint8_t *storage,
   return 0;
 }
 
-int Ringbuffer_put(struct Ringbuffer *buffer, const void *item) {
+RAMFUNC int Ringbuffer_put(struct Ringbuffer *buffer, const void *item) {
   if (Ringbuffer_isFull(buffer)) {
     return -EOVERFLOW;
   }
@@ -113,7 +115,31 @@ int Ringbuffer_put(struct Ringbuffer *buffer, const void *item) {
   return 0;
 }
 
-int Ringbuffer_take(struct Ringbuffer *buffer, void *item) {
+int Ringbuffer_putOverwrite(struct Ringbuffer *buffer, const void *item,
+                            bool *isOverwritten) {
+  const bool isFull = {Ringbuffer_isFull(buffer)};
+  if (NULL != isOverwritten) {
+    *isOverwritten = isFull;
+  }
+
+  if (!isFull) {
+    return Ringbuffer_put(buffer, item);
+  }
+
+  // drop oldest item: begin and end move in lockstep while full
+  uint8_t *slot = {itemAtIndex(buffer, buffer->index.end)};
+  for (size_t idx = 0; idx < buffer->index.itemSizeBytes; idx++) {
+    slot[idx] = ((uint8_t *)item)[idx];
+  }
+
+  buffer->index.end = (buffer->index.end + 1) % buffer->index.capacity;
+  buffer->index.begin = buffer->index.end;
+  buffer->index.putCount++;
+
+  return 0;
+}
+
+RAMFUNC int Ringbuffer_take(struct Ringbuffer *buffer, void *item) {
   if (Ringbuffer_isEmpty(buffer)) {
     return -ENODATA;
   }
@@ -132,15 +158,32 @@ int Ringbuffer_take(struct Ringbuffer *buffer, void *item) {
   return 0;
 }
 
-bool Ringbuffer_isEmpty(const struct Ringbuffer *buffer) {
+RAMFUNC int Ringbuffer_peek(const struct Ringbuffer *buffer, uint16_t offset,
+                            void *item) {
+  if (buffer->index.itemsCount <= offset) {
+    return -ENODATA;
+  }
+
+  const uint16_t index = {(uint16_t)((buffer->index.begin + offset) %
+                                     buffer->index.capacity)};
+  const uint8_t *slot = {buffer->storage +
+                         (index * buffer->index.itemSizeBytes)};
+  for (size_t idx = 0; idx < buffer->index.itemSizeBytes; idx++) {
+    ((uint8_t *)item)[idx] = slot[idx];
+  }
+
+  return 0;
+}
+
+RAMFUNC bool Ringbuffer_isEmpty(const struct Ringbuffer *buffer) {
   return buffer->index.isEmpty;
 }
 
-bool Ringbuffer_isFull(const struct Ringbuffer *buffer) {
+RAMFUNC bool Ringbuffer_isFull(const struct Ringbuffer *buffer) {
   return buffer->index.isFull;
 }
 
-uint16_t Ringbuffer_itemsCount(const struct Ringbuffer *buffer) {
+RAMFUNC uint16_t Ringbuffer_itemsCount(const struct Ringbuffer *buffer) {
   return buffer->index.itemsCount;
 }
 
@@ -152,14 +195,54 @@ uint16_t Ringbuffer_putCount(const struct Ringbuffer *buffer) {
   return buffer->index.putCount;
 }
 
-uint16_t Ringbuffer_takeCount(const struct Ringbuffer *buffer) {
+RAMFUNC uint16_t Ringbuffer_takeCount(const struct Ringbuffer *buffer) {
   return buffer->index.takeCount;
 }
 
-uint16_t Ringbuffer_itemSizeBytes(const struct Ringbuffer *buffer) {
+RAMFUNC uint16_t Ringbuffer_capacity(const struct Ringbuffer *buffer) {
+  return buffer->index.capacity;
+}
+
+RAMFUNC uint16_t Ringbuffer_itemSizeBytes(const struct Ringbuffer *buffer) {
   return buffer->index.itemSizeBytes;
 }
 
+/**
+ * Reverses the order of the items in between first and last (inclusive).
+ *
+ * @param buffer
+ * @param first index of first item
+ * @param last index of last item
+ */
+static void reverseItems(struct Ringbuffer *buffer, uint16_t first,
+                         uint16_t last) {
+  while (first < last) {
+    uint8_t *lower = {itemAtIndex(buffer, first)};
+    uint8_t *upper = {itemAtIndex(buffer, last)};
+    for (size_t idx = 0; idx < buffer->index.itemSizeBytes; idx++) {
+      const uint8_t tmp = {lower[idx]};
+      lower[idx] = upper[idx];
+      upper[idx] = tmp;
+    }
+    first++;
+    last--;
+  }
+}
+
+void Ringbuffer_linearize(struct Ringbuffer *buffer) {
+  const uint16_t begin = {buffer->index.begin};
+
+  if (0 < begin) {
+    // rotate left by begin: reverse both parts, then reverse the whole
+    reverseItems(buffer, 0, begin - 1);
+    reverseItems(buffer, begin, buffer->index.capacity - 1);
+    reverseItems(buffer, 0, buffer->index.capacity - 1);
+  }
+
+  buffer->index.begin = 0;
+  buffer->index.end = buffer->index.itemsCount % buffer->index.capacity;
+}
+
 void Ringbuffer_reset(struct Ringbuffer *buffer) {
   buffer->index.begin = 0;
   buffer->index.end = 0;
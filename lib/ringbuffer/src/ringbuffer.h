@@ -75,6 +75,19 @@ int Ringbuffer_init(struct Ringbuffer *buffer, uint8_t *storage,
  */
 int Ringbuffer_put(struct Ringbuffer *buffer, const void *item);
 
+/**
+ * Stores one item to the buffer and drops the oldest item if the buffer is
+ * full (flight recorder mode).
+ *
+ * @param buffer
+ * @param item input data
+ * @param isOverwritten output: true if the oldest item was dropped, may be
+ * NULL
+ * @return 0
+ */
+int Ringbuffer_putOverwrite(struct Ringbuffer *buffer, const void *item,
+                            bool *isOverwritten);
+
 /**
  * Takes one item from the buffer if possible.
  *
@@ -84,6 +97,17 @@ int Ringbuffer_put(struct Ringbuffer *buffer, const void *item);
  */
 int Ringbuffer_take(struct Ringbuffer *buffer, void *item);
 
+/**
+ * Copies one item without taking it from the buffer.
+ *
+ * @param buffer
+ * @param offset position of item counted from the oldest one
+ * @param item output buffer
+ * @return -ENODATA if fewer than offset + 1 items are stored, 0 otherwise
+ */
+int Ringbuffer_peek(const struct Ringbuffer *buffer, uint16_t offset,
+                    void *item);
+
 /**
  * Tests whether the buffer is empty.
  *
@@ -134,12 +158,30 @@ uint16_t Ringbuffer_putCount(const struct Ringbuffer *buffer);
  */
 uint16_t Ringbuffer_takeCount(const struct Ringbuffer *buffer);
 
+/**
+ * @param buffer
+ * @return maximum number of storable items
+ */
+uint16_t Ringbuffer_capacity(const struct Ringbuffer *buffer);
+
 /**
  * @param buffer
  * @return size of item (slot) in bytes
  */
 uint16_t Ringbuffer_itemSizeBytes(const struct Ringbuffer *buffer);
 
+/**
+ * Rotates the storage in place so that the oldest item is located at the
+ * beginning of the storage and all items are stored contiguously.
+ *
+ * Afterwards the items can be accessed as plain array of
+ * Ringbuffer_itemsCount(const struct Ringbuffer *) items.
+ * Costs O(capacity) item swaps.
+ *
+ * @param buffer
+ */
+void Ringbuffer_linearize(struct Ringbuffer *buffer);
+
 /**
  * Invalidates the start/end indices without zeroing out the buffer.
  *
@@ -7,12 +7,14 @@
 #include "sampling.h"
 #include "sampling_types.h"
 #include <errno.h>
+#include <ramfunc.h>
+#include <stddef.h>
 
-static bool isNSamplesReadEnabled(struct Sampling_Handle *handle) {
+RAMFUNC static bool isNSamplesReadEnabled(struct Sampling_Handle *handle) {
   return handle->state.maxSamples > 0;
 }
 
-static bool checkStartRequest(struct Sampling_Handle *handle) {
+RAMFUNC static bool checkStartRequest(struct Sampling_Handle *handle) {
   if (!handle->state.doStart) {
     return false;
   }
@@ -26,14 +28,16 @@ static bool checkStartRequest(struct Sampling_Handle *handle) {
 
   handle->state.isFifoOverflowSet = false;
   handle->state.transactionsCount = 0;
+  handle->state.isLatencyDeadlineSet = false;
+  handle->state.latencyCountdownMs = handle->state.maxLatencyMs;
   handle->state.isStarted = true;
 
-  handle->doEnableSensorImpl();
+  handle->doEnableSensorImpl(handle);
 
   return true;
 }
 
-static bool checkStopRequest(struct Sampling_Handle *handle) {
+RAMFUNC static bool checkStopRequest(struct Sampling_Handle *handle) {
   if (!handle->state.doStop) {
     return false;
   }
@@ -48,11 +52,13 @@ static bool checkStopRequest(struct Sampling_Handle *handle) {
   }
   handle->onSamplingStoppedCb();
 
-  handle->doDisableSensorImpl();
+  handle->state.latencyCountdownMs = 0;
+  handle->state.isLatencyDeadlineSet = false;
+  handle->doDisableSensorImpl(handle);
 
   // clear watermark interrupt (fetch complete fifo)
   for (uint8_t idx = 0; idx < ADXL345_FIFO_ENTRIES; idx++) {
-    handle->doFetchSensorAccelerationImpl(NULL);
+    handle->doFetchSensorAccelerationImpl(handle, NULL);
   }
 
   handle->state.isStarted = false;
@@ -69,9 +75,9 @@ void Sampling_stop(struct Sampling_Handle *handle) {
   handle->state.doStop = true;
 }
 
-static bool transmitPending(struct Sampling_Handle *handle) {
+RAMFUNC static bool transmitPending(struct Sampling_Handle *handle) {
   // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
-  const int ret = {handle->doForwardAccelerationBufferImpl(NULL, 0, 0)};
+  const int ret = {handle->doForwardAccelerationBufferImpl(handle, NULL, 0, 0)};
 
   if (ret == -EAGAIN) {
     return true;
@@ -91,17 +97,34 @@ static bool transmitPending(struct Sampling_Handle *handle) {
 }
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-int Sampling_fetchForward(struct Sampling_Handle *handle) {
+RAMFUNC int Sampling_fetchForward(struct Sampling_Handle *handle) {
   int retState = {0};
   int retTx = {0};
 
   checkStartRequest(handle);
 
-  if (handle->state.isFifoWatermarkSet && handle->state.isStarted) {
+  const bool isDeadline = {handle->state.isLatencyDeadlineSet};
+
+  if ((handle->state.isFifoWatermarkSet || isDeadline) &&
+      handle->state.isStarted) {
     uint8_t rxCount = 0;
+    uint8_t fetchCount = {handle->state.samplesPerFetch};
+
+    if (isDeadline) {
+      handle->state.isLatencyDeadlineSet = false;
+      if (!handle->state.isFifoWatermarkSet) {
+        // below watermark: drain what is buffered so far
+        const uint8_t entries = {handle->doGetFifoEntriesImpl(handle)};
+        if (entries < fetchCount) {
+          fetchCount = entries;
+        }
+      }
+    }
+    // any drain restarts the deadline
+    handle->state.latencyCountdownMs = handle->state.maxLatencyMs;
 
     // fetch samples
-    while (rxCount < SAMPLING_NUM_SAMPLES_READ_AT_ONCE) {
+    while (rxCount < fetchCount) {
 
       if (checkStopRequest(handle)) {
         break;
@@ -133,14 +156,16 @@ int Sampling_fetchForward(struct Sampling_Handle *handle) {
       // a data register is signified by the transition from Register 0x37 to
       // Register 0x38 or by the CS pin going high.
       handle->doWaitDelay5usImpl(handle);
-      handle->doFetchSensorAccelerationImpl(&handle->state.rxBuffer[rxCount]);
+      handle->doFetchSensorAccelerationImpl(handle,
+                                            &handle->state.rxBuffer[rxCount]);
       rxCount++;
     }
 
     // forward chunk of samples
     if ((0 < rxCount) && handle->state.isStarted) {
       retTx = handle->doForwardAccelerationBufferImpl(
-          handle->state.rxBuffer, rxCount, handle->state.transactionsCount);
+          handle, handle->state.rxBuffer, rxCount,
+          handle->state.transactionsCount);
       handle->state.transactionsCount += rxCount;
     }
   }
@@ -150,6 +175,12 @@ int Sampling_fetchForward(struct Sampling_Handle *handle) {
     Sampling_stop(handle);
   }
 
+  if (isDeadline && handle->state.isStarted &&
+      -EIO == handle->doFlushAccelerationBufferImpl()) {
+    handle->onTransmissionErrorCb();
+    Sampling_stop(handle);
+  }
+
   if (handle->state.isStarted) {
     transmitPending(handle);
   }
@@ -180,6 +211,54 @@ int Sampling_fetchForward(struct Sampling_Handle *handle) {
   return retTx ? retState == 0 : retState;
 }
 
+int Sampling_setSamplesPerFetch(struct Sampling_Handle *handle,
+                                uint8_t count) {
+  if (0 == count || SAMPLING_NUM_SAMPLES_READ_AT_ONCE < count) {
+    return -EINVAL;
+  }
+
+  if (handle->state.isStarted) {
+    return -EBUSY;
+  }
+
+  handle->state.samplesPerFetch = count;
+  return 0;
+}
+
+int Sampling_setMaxLatency(struct Sampling_Handle *handle,
+                           uint16_t maxLatencyMs) {
+  if (handle->state.isStarted) {
+    return -EBUSY;
+  }
+
+  handle->state.maxLatencyMs = maxLatencyMs;
+  return 0;
+}
+
+bool Sampling_onMillisecondTick(struct Sampling_Handle *handle) {
+  if (0 == handle->state.latencyCountdownMs) {
+    return false;
+  }
+
+  handle->state.latencyCountdownMs--;
+  if (0 != handle->state.latencyCountdownMs) {
+    return false;
+  }
+
+  handle->state.isLatencyDeadlineSet = true;
+  return true;
+}
+
+bool Sampling_hasPendingWork(const struct Sampling_Handle *handle) {
+  if (handle->state.doStart || handle->state.doStop) {
+    return true;
+  }
+
+  return handle->state.isStarted && (handle->state.isFifoWatermarkSet ||
+                                     handle->state.isFifoOverflowSet ||
+                                     handle->state.isLatencyDeadlineSet);
+}
+
 void Sampling_setFifoWatermark(struct Sampling_Handle *handle) {
   handle->state.isFifoWatermarkSet = true;
 }
@@ -55,6 +55,65 @@ void Sampling_stop(struct Sampling_Handle *handle);
  */
 int Sampling_fetchForward(struct Sampling_Handle *handle);
 
+/**
+ * Sets how many samples are read from sensor's FiFo per watermark interrupt.
+ *
+ * Must match the sensor's FiFo watermark level: reading more samples than
+ * buffered would forward stale data.
+ *
+ * Called by main() while sampling is stopped.
+ *
+ * \param handle module internal state and device dependent pimpl
+ * \param count samples per fetch in [1, SAMPLING_NUM_SAMPLES_READ_AT_ONCE]
+ * \return
+ *   - -EINVAL if count is out of range
+ *   - -EBUSY if sampling is started
+ *   - 0 otherwise
+ */
+int Sampling_setSamplesPerFetch(struct Sampling_Handle *handle,
+                                uint8_t count);
+
+/**
+ * Sets the maximum latency of samples in between sensor and host.
+ *
+ * If no watermark interrupt occurs within maxLatencyMs the buffered FiFo
+ * entries are drained below the watermark and the transmission is flushed.
+ * At high rates the watermark always comes first, hence batching stays
+ * unaffected.
+ *
+ * Called by main() while sampling is stopped.
+ *
+ * \param handle module internal state and device dependent pimpl
+ * \param maxLatencyMs deadline in ms, 0 disables the deadline
+ * \return
+ *   - -EBUSY if sampling is started
+ *   - 0 otherwise
+ */
+int Sampling_setMaxLatency(struct Sampling_Handle *handle,
+                           uint16_t maxLatencyMs);
+
+/**
+ * Counts down the latency deadline.
+ *
+ * Called by the millisecond timer interrupt.
+ * Handler: SysTick_Handler()
+ *
+ * \param handle module internal state and device dependent pimpl
+ * \return true if the deadline expired right now
+ */
+bool Sampling_onMillisecondTick(struct Sampling_Handle *handle);
+
+/**
+ * Tests whether Sampling_fetchForward(struct Sampling_Handle *) has work left
+ * which does not depend on a new interrupt.
+ *
+ * Called by main() before going to sleep.
+ *
+ * \param handle module internal state and device dependent pimpl
+ * \return true if start/stop is requested or sensor FiFo needs to be drained
+ */
+bool Sampling_hasPendingWork(const struct Sampling_Handle *handle);
+
 /**
  * Sets the FiFo watermark flag.
  *
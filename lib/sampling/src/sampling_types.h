@@ -28,32 +28,46 @@ struct Sampling_Acceleration {
  */
 struct Sampling_State {
   volatile uint16_t maxSamples;  ///< Context: main() and interrupts
-  bool doStart;                  ///< Context: main()
-  bool doStop;                   ///< Context: main()
+  volatile bool doStart;         ///< Context: main() and interrupts
+  volatile bool doStop;          ///< Context: main() and interrupts
   bool isStarted;                ///< Context: main()
   volatile bool waitFor5usTimer; ///< Context: main() and interrupts
+  uint8_t samplesPerFetch;       ///< Context: main()
   struct Sampling_Acceleration
       rxBuffer[SAMPLING_NUM_SAMPLES_READ_AT_ONCE]; ///< Context: main()
   volatile bool isFifoOverflowSet;  ///< Context: main() and interrupts
   volatile bool isFifoWatermarkSet; ///< Context: main() and interrupts
   int transactionsCount;            ///< Context: main()
+  uint16_t maxLatencyMs;            ///< Context: main(), 0 if disabled
+  volatile uint16_t latencyCountdownMs; ///< Context: main() and interrupts
+  volatile bool isLatencyDeadlineSet;   ///< Context: main() and interrupts
 };
 
 /**
  * Internal module state and device specific implementation.
+ *
+ * One handle per sensor. Sensor specific implementations receive the handle
+ * to tell the sensors apart by Sampling_Handle.sensor.
  */
 struct Sampling_Handle {
   struct Sampling_State state;
+  const uint8_t sensor; ///< sensor ID, 0 denotes the primary sensor
 
-  void (*const doEnableSensorImpl)();  ///< Context: main()
-  void (*const doDisableSensorImpl)(); ///< Context: main()
+  void (*const doEnableSensorImpl)(
+      const struct Sampling_Handle *); ///< Context: main()
+  void (*const doDisableSensorImpl)(
+      const struct Sampling_Handle *); ///< Context: main()
   void (*const doFetchSensorAccelerationImpl)(
+      const struct Sampling_Handle *,
       struct Sampling_Acceleration *); ///< Context: main()
   void (*const doWaitDelay5usImpl)(
       struct Sampling_Handle *); ///< Context: main()
   int (*const doForwardAccelerationBufferImpl)(
-      const struct Sampling_Acceleration *, uint16_t,
-      uint16_t); ///< Context: main()
+      const struct Sampling_Handle *, const struct Sampling_Acceleration *,
+      uint16_t, uint16_t);                      ///< Context: main()
+  int (*const doFlushAccelerationBufferImpl)(); ///< Context: main()
+  uint8_t (*const doGetFifoEntriesImpl)(
+      const struct Sampling_Handle *); ///< Context: main()
 
   void (*const onSamplingStartedCb)();   ///< Context: main()
   void (*const onSamplingStoppedCb)();   ///< Context: main()
@@ -0,0 +1,131 @@
+/**
+ * \file sequencer.c
+ *
+ * Multi-segment capture sequencer implementation.
+ */
+
+#include "sequencer.h"
+#include <errno.h>
+#include <stddef.h>
+
+int Sequencer_append(struct Sequencer *sequencer,
+                     const struct Sequencer_Entry *entry) {
+  if (sequencer->isRunning) {
+    return -EBUSY;
+  }
+
+  if (NULL == entry || 0 == entry->samplesCount ||
+      (Sequencer_Trigger_Delay != entry->trigger &&
+       Sequencer_Trigger_Marker != entry->trigger)) {
+    return -EINVAL;
+  }
+
+  if (SEQUENCER_MAX_ENTRIES <= sequencer->count) {
+    return -ENOMEM;
+  }
+
+  sequencer->entries[sequencer->count] = *entry;
+  sequencer->count++;
+  return 0;
+}
+
+void Sequencer_clear(struct Sequencer *sequencer) {
+  sequencer->count = 0;
+  sequencer->current = 0;
+  sequencer->isRunning = false;
+  sequencer->isArmed = false;
+  sequencer->isMarked = false;
+  sequencer->remaining = 0;
+}
+
+/**
+ * Arms the current entry or finishes the sequence if none is left.
+ *
+ * @param sequencer
+ * @param nowMs
+ */
+static void arm(struct Sequencer *sequencer, uint32_t nowMs) {
+  sequencer->isRunning = sequencer->current < sequencer->count;
+  sequencer->isArmed = sequencer->isRunning;
+  sequencer->armedAtMs = nowMs;
+}
+
+int Sequencer_start(struct Sequencer *sequencer, uint32_t nowMs) {
+  if (sequencer->isRunning) {
+    return -EBUSY;
+  }
+
+  if (0 == sequencer->count) {
+    return -ENODATA;
+  }
+
+  sequencer->current = 0;
+  sequencer->isMarked = false;
+  arm(sequencer, nowMs);
+  return 0;
+}
+
+void Sequencer_mark(struct Sequencer *sequencer) {
+  sequencer->isMarked = true;
+}
+
+/**
+ * Tests the trigger of the current entry and starts the segment if fired.
+ *
+ * @param sequencer
+ * @param nowMs
+ * @return true if the segment has been started
+ */
+static bool checkTrigger(struct Sequencer *sequencer, uint32_t nowMs) {
+  const struct Sequencer_Entry *entry = {
+      &sequencer->entries[sequencer->current]};
+
+  if (Sequencer_Trigger_Marker == entry->trigger) {
+    if (!sequencer->isMarked) {
+      return false;
+    }
+    sequencer->isMarked = false;
+  } else if ((uint32_t)(nowMs - sequencer->armedAtMs) < entry->delayMs) {
+    return false;
+  }
+
+  sequencer->isArmed = false;
+  sequencer->remaining = entry->samplesCount;
+  return true;
+}
+
+bool Sequencer_next(struct Sequencer *sequencer, uint32_t nowMs,
+                    uint16_t available, struct Sequencer_Slice *slice) {
+  if (!sequencer->isRunning || 0 == available) {
+    return false;
+  }
+
+  slice->isFirst = false;
+  if (sequencer->isArmed) {
+    if (!checkTrigger(sequencer, nowMs)) {
+      return false;
+    }
+    slice->isFirst = true;
+  }
+
+  const uint16_t samplesCount = {
+      sequencer->entries[sequencer->current].samplesCount};
+
+  slice->count =
+      available < sequencer->remaining ? available : sequencer->remaining;
+  slice->segment = sequencer->current;
+  slice->samplesCount = samplesCount;
+  slice->firstIndex = samplesCount - sequencer->remaining;
+
+  sequencer->remaining -= slice->count;
+  if (0 == sequencer->remaining) {
+    sequencer->current++;
+    arm(sequencer, nowMs);
+  }
+
+  return true;
+}
+
+bool Sequencer_isRunning(const struct Sequencer *sequencer) {
+  return sequencer->isRunning;
+}
@@ -0,0 +1,145 @@
+/**
+ * \file sequencer.h
+ *
+ * Multi-segment capture sequencer.
+ *
+ * A sequence is a list of segments, each started by a trigger (delay or
+ * marker) and spanning a fixed number of samples. The sampling continues in
+ * between segments; samples outside of a segment are discarded. Thus the
+ * re-arm gap between two segments does not depend on the host round trip.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/**
+ * Maximum number of segments per sequence.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define SEQUENCER_MAX_ENTRIES 64U
+
+enum Sequencer_Trigger {
+  /// start segment after delay elapsed since previous segment (or start)
+  Sequencer_Trigger_Delay = 0,
+  /// start segment upon Sequencer_mark()
+  Sequencer_Trigger_Marker = 1,
+};
+
+struct Sequencer_Entry {
+  enum Sequencer_Trigger trigger;
+  uint16_t delayMs;      ///< ignored for Sequencer_Trigger_Marker
+  uint16_t samplesCount; ///< samples per segment, must not be 0
+};
+
+/**
+ * Part of a sampling batch belonging to one segment.
+ */
+struct Sequencer_Slice {
+  uint16_t count;        ///< number of samples in slice
+  uint16_t segment;      ///< index of segment
+  uint16_t samplesCount; ///< total samples of segment
+  uint16_t firstIndex;   ///< index of first sample within segment
+  bool isFirst;          ///< slice starts the segment
+};
+
+/**
+ * Sequencer state.
+ *
+ * Example:
+ * \code
+ * struct Sequencer sequencer = SEQUENCER_INITIALIZER;
+ * const struct Sequencer_Entry entry = {
+ *     .trigger = Sequencer_Trigger_Delay, .delayMs = 10, .samplesCount = 800};
+ * Sequencer_append(&sequencer, &entry);
+ * Sequencer_start(&sequencer, nowMs);
+ *
+ * // per sampling batch
+ * struct Sequencer_Slice slice;
+ * uint16_t offset = 0;
+ * while (offset < count &&
+ *        Sequencer_next(&sequencer, nowMs, count - offset, &slice)) {
+ *   // forward samples[offset .. offset + slice.count)
+ *   offset += slice.count;
+ * }
+ * \endcode
+ */
+struct Sequencer {
+  struct Sequencer_Entry entries[SEQUENCER_MAX_ENTRIES];
+  uint8_t count;      ///< number of entries
+  uint8_t current;    ///< index of current entry
+  bool isRunning;     ///< sequence started and not yet complete
+  bool isArmed;       ///< waiting for trigger of current entry
+  bool isMarked;      ///< latched marker
+  uint32_t armedAtMs; ///< reference for delay trigger
+  uint16_t remaining; ///< samples left in current segment
+};
+
+#define SEQUENCER_INITIALIZER                                                  \
+  {                                                                            \
+    .entries = {{.trigger = Sequencer_Trigger_Delay,                           \
+                 .delayMs = 0,                                                 \
+                 .samplesCount = 0}},                                          \
+    .count = 0, .current = 0, .isRunning = false, .isArmed = false,            \
+    .isMarked = false, .armedAtMs = 0, .remaining = 0,                         \
+  }
+
+/**
+ * Appends a segment.
+ *
+ * @param sequencer
+ * @param entry
+ * @return
+ *   - -EBUSY if running
+ *   - -EINVAL if entry is invalid
+ *   - -ENOMEM if all entries are used
+ *   - 0 otherwise
+ */
+int Sequencer_append(struct Sequencer *sequencer,
+                     const struct Sequencer_Entry *entry);
+
+/**
+ * Removes all segments and stops the sequence.
+ *
+ * @param sequencer
+ */
+void Sequencer_clear(struct Sequencer *sequencer);
+
+/**
+ * Arms the first segment.
+ *
+ * @param sequencer
+ * @param nowMs current time
+ * @return -ENODATA if no segment is appended, -EBUSY if running, 0 otherwise
+ */
+int Sequencer_start(struct Sequencer *sequencer, uint32_t nowMs);
+
+/**
+ * Latches a marker which starts the next segment with marker trigger.
+ *
+ * @param sequencer
+ */
+void Sequencer_mark(struct Sequencer *sequencer);
+
+/**
+ * Assigns the next samples to the current segment.
+ *
+ * Triggers are evaluated at batch granularity: a segment starts with the
+ * first sample of the batch the trigger is seen in. Segments end exactly
+ * after their number of samples.
+ *
+ * @param sequencer
+ * @param nowMs current time
+ * @param available number of samples left in batch
+ * @param slice output
+ * @return false if the remaining samples do not belong to any segment
+ */
+bool Sequencer_next(struct Sequencer *sequencer, uint32_t nowMs,
+                    uint16_t available, struct Sequencer_Slice *slice);
+
+/**
+ * @param sequencer
+ * @return true if started and not all segments are complete
+ */
+bool Sequencer_isRunning(const struct Sequencer *sequencer);
@@ -0,0 +1,79 @@
+/**
+ * \file trigger.c
+ *
+ * Trigger detection implementation.
+ */
+
+#include "trigger.h"
+
+void Trigger_arm(struct Trigger *trigger, enum Trigger_Source source,
+                 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+                 uint16_t threshold, uint16_t postSamplesCount) {
+  trigger->source = source;
+  trigger->thresholdSquared = (uint32_t)threshold * threshold;
+  trigger->hasBaseline = false;
+  trigger->isFired = false;
+  trigger->isTriggered = false;
+  trigger->postSamplesCount = postSamplesCount;
+  trigger->postSamplesAccepted = 0;
+}
+
+void Trigger_fire(struct Trigger *trigger) { trigger->isFired = true; }
+
+/**
+ * Tests the deviation from the baseline against the threshold.
+ *
+ * @param trigger
+ * @param sample
+ * @return true if the squared deviation magnitude exceeds the threshold
+ */
+static bool exceedsThreshold(struct Trigger *trigger,
+                             const struct Trigger_Acceleration *sample) {
+  if (!trigger->hasBaseline) {
+    trigger->baseline = *sample;
+    trigger->hasBaseline = true;
+    return false;
+  }
+
+  // a full scale deviation squared exceeds 32 bit
+  const int64_t dx = {(int64_t)sample->x - trigger->baseline.x};
+  const int64_t dy = {(int64_t)sample->y - trigger->baseline.y};
+  const int64_t dz = {(int64_t)sample->z - trigger->baseline.z};
+  const uint64_t magnitudeSquared = {
+      (uint64_t)(dx * dx) + (uint64_t)(dy * dy) + (uint64_t)(dz * dz)};
+
+  return magnitudeSquared > trigger->thresholdSquared;
+}
+
+uint16_t Trigger_feed(struct Trigger *trigger,
+                      const struct Trigger_Acceleration *samples,
+                      uint16_t count) {
+  for (uint16_t idx = 0; idx < count; idx++) {
+    if (!trigger->isTriggered) {
+      trigger->isTriggered =
+          trigger->isFired || (Trigger_Source_Threshold == trigger->source &&
+                               exceedsThreshold(trigger, &samples[idx]));
+    } else if (Trigger_isComplete(trigger)) {
+      return idx;
+    }
+
+    if (trigger->isTriggered) {
+      trigger->postSamplesAccepted++;
+    }
+  }
+
+  return count;
+}
+
+bool Trigger_isTriggered(const struct Trigger *trigger) {
+  return trigger->isTriggered;
+}
+
+bool Trigger_isComplete(const struct Trigger *trigger) {
+  return trigger->isTriggered &&
+         trigger->postSamplesAccepted > trigger->postSamplesCount;
+}
+
+uint16_t Trigger_postSamplesAccepted(const struct Trigger *trigger) {
+  return trigger->postSamplesAccepted;
+}
@@ -0,0 +1,115 @@
+/**
+ * \file trigger.h
+ *
+ * Trigger detection for pre-trigger (flight recorder) captures.
+ *
+ * The trigger decides which samples of a continuous stream belong to the
+ * recording: all samples until the trigger event plus a configured number of
+ * post-trigger samples. Samples before the trigger are expected to be kept in
+ * an overwriting buffer by the caller, so only the most recent ones survive.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+struct Trigger_Acceleration {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} __attribute__((packed));
+
+enum Trigger_Source {
+  /// Fires if the deviation from the first sample after arming exceeds the
+  /// threshold (AC-coupled magnitude test, same as sensor activity detection).
+  Trigger_Source_Threshold = 0,
+  /// Fires on Trigger_fire(), i.e. on the sensor's activity interrupt.
+  Trigger_Source_External = 1,
+};
+
+/**
+ * Trigger state.
+ *
+ * Example:
+ * \code
+ * struct Trigger trigger;
+ * Trigger_arm(&trigger, Trigger_Source_Threshold, 64, 100);
+ *
+ * const uint16_t accepted = Trigger_feed(&trigger, samples, count);
+ * // store samples[0 .. accepted) in an overwriting buffer
+ * if (Trigger_isComplete(&trigger)) {
+ *   // stop sampling and read out the buffer
+ * }
+ * \endcode
+ */
+struct Trigger {
+  enum Trigger_Source source;
+  uint32_t thresholdSquared;            ///< squared magnitude threshold
+  struct Trigger_Acceleration baseline; ///< reference for the deviation
+  bool hasBaseline;
+  bool isFired;                 ///< set by Trigger_fire(), Context: main()
+  bool isTriggered;             ///< trigger sample was seen
+  uint16_t postSamplesCount;    ///< configured post-trigger samples
+  uint16_t postSamplesAccepted; ///< accepted samples including trigger sample
+};
+
+#define TRIGGER_INITIALIZER                                                    \
+  {                                                                            \
+    .source = Trigger_Source_Threshold, .thresholdSquared = 0,                 \
+    .baseline = {0}, .hasBaseline = false, .isFired = false,                   \
+    .isTriggered = false, .postSamplesCount = 0, .postSamplesAccepted = 0,     \
+  }
+
+/**
+ * Resets the trigger state and arms it.
+ *
+ * @param trigger
+ * @param source
+ * @param threshold deviation threshold in LSB, ignored for external source
+ * @param postSamplesCount number of samples to record after the trigger
+ * sample
+ */
+void Trigger_arm(struct Trigger *trigger, enum Trigger_Source source,
+                 uint16_t threshold, uint16_t postSamplesCount);
+
+/**
+ * Requests the trigger to fire at the next fed sample.
+ *
+ * Used for external trigger sources, the latency is bounded by the size of
+ * the batch fed afterwards.
+ *
+ * @param trigger
+ */
+void Trigger_fire(struct Trigger *trigger);
+
+/**
+ * Evaluates the trigger condition on a batch of consecutive samples.
+ *
+ * @param trigger
+ * @param samples input data
+ * @param count number of samples
+ * @return number of leading samples which belong to the recording, less than
+ * count once the post-trigger window is complete
+ */
+uint16_t Trigger_feed(struct Trigger *trigger,
+                      const struct Trigger_Acceleration *samples,
+                      uint16_t count);
+
+/**
+ * @param trigger
+ * @return true if the trigger sample was seen
+ */
+bool Trigger_isTriggered(const struct Trigger *trigger);
+
+/**
+ * @param trigger
+ * @return true if the trigger sample and all post-trigger samples were seen
+ */
+bool Trigger_isComplete(const struct Trigger *trigger);
+
+/**
+ * @param trigger
+ * @return number of accepted samples from the trigger sample (inclusive) on
+ */
+uint16_t Trigger_postSamplesAccepted(const struct Trigger *trigger);
@@ -0,0 +1,17 @@
+"""
+Link time optimization for env:controller_performance.
+
+PlatformIO passes -flto to the compiler only, the link step needs it as well.
+Libraries are archived before linking, hence the archiver must be the LTO
+plugin aware gcc-ar.
+"""
+
+Import("env")  # noqa: F821 pylint: disable=undefined-variable
+
+for tool, lto_tool in (("AR", "gcc-ar"), ("RANLIB", "gcc-ranlib")):
+    command = env.subst("$" + tool)  # noqa: F821 pylint: disable=undefined-variable
+    if not command.endswith(lto_tool):
+        prefix = command[: command.rfind("-") + 1]
+        env.Replace(**{tool: prefix + lto_tool})  # noqa: F821 pylint: disable=undefined-variable
+
+env.Append(LINKFLAGS=["-flto", "-Os"])  # noqa: F821 pylint: disable=undefined-variable
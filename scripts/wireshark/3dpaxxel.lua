@@ -29,10 +29,21 @@ local headerNameToId = {
     ["TX_GET_FIRMWARE_VERSION"]     =  8,
     ["TX_GET_UPTIME"]               =  9,
     ["TX_GET_BUFFER_STATUS"]        = 10,
+    ["TX_CAPTURE_READ"]             = 11,
+    ["TX_SET_AXES"]                 = 12,
+    ["TX_SET_FRAMING"]              = 13,
+    ["TX_SET_MAX_LATENCY"]          = 14,
+    ["TX_SET_CALIBRATION"]          = 15,
+    ["TX_GET_CALIBRATION"]          = 16,
     -- sampling (tx)
     ["TX_DEVICE_REBOOT"]            = 17,
     ["TX_SAMPLING_START"]           = 18,
     ["TX_SAMPLING_STOP"]            = 19,
+    ["TX_CONFIGURE_AND_START"]      = 20,
+    ["TX_CAPTURE_START"]            = 21,
+    ["TX_RECORDER_START"]           = 22,
+    ["TX_SEQUENCE_APPEND"]          = 23,
+    ["TX_SEQUENCE_MARKER"]          = 24,
     -- configuration (rx)
     ["RX_OUTPUT_DATA_RATE"]         = 25,
     ["RX_RANGE"]                    = 26,
@@ -41,6 +52,7 @@ local headerNameToId = {
     ["RX_FIRMWARE_VERSION"]         = 29,
     ["RX_UPTIME"]                   = 30,
     ["RX_BUFFER_STATUS"]            = 31,
+    ["RX_CAPTURE_CHUNK"]            = 32,
     -- sampling (rx)
     ["RX_SAMPLING_FIFO_OVERFLOW"]   = 33,
     ["RX_SAMPLING_STARTED"]         = 34,
@@ -51,6 +63,23 @@ local headerNameToId = {
     ["RX_FAULT"]                    = 39,
     ["RX_SAMPLING_BUFFER_OVERFLOW"] = 40,
     ["RX_TRANSMISSION_ERROR"]       = 41,
+    ["RX_SAMPLING_CONFIGURED_STARTED"] = 42,
+    ["RX_RECORDER_FINISHED"]        = 43,
+    ["RX_SEQUENCE_SEGMENT"]         = 44,
+    ["RX_ACCELERATION_AXES"]        = 45,
+    ["RX_ACCELERATION_DELTA"]       = 46,
+    ["RX_ACCELERATION_PACKED"]      = 47,
+    ["RX_ACCELERATION_SOA"]         = 48,
+    ["RX_CLOCK_CORRELATION"]        = 49,
+    ["RX_ACCELERATION_SENSOR"]      = 50,
+    ["RX_CALIBRATION"]              = 51,
+    -- appended request and response
+    ["TX_GET_SPI_CLOCK"]            = 52,
+    ["RX_SPI_CLOCK"]                = 53,
+    ["TX_SAVE_CONFIGURATION"]       = 54,
+    ["RX_CONFIGURATION_SAVED"]      = 55,
+    -- appended response
+    ["RX_STREAM_SETUP"]             = 56,
 }
 
 -- header ID to name mapping for each known 3DP Accelerometer package
@@ -66,10 +95,21 @@ local headerIdToName = {
     [headerNameToId.TX_GET_FIRMWARE_VERSION]     = "TX_GET_FIRMWARE_VERSION",
     [headerNameToId.TX_GET_UPTIME]               = "TX_GET_UPTIME",
     [headerNameToId.TX_GET_BUFFER_STATUS]        = "TX_GET_BUFFER_STATUS",
+    [headerNameToId.TX_CAPTURE_READ]             = "TX_CAPTURE_READ",
+    [headerNameToId.TX_SET_AXES]                 = "TX_SET_AXES",
+    [headerNameToId.TX_SET_FRAMING]              = "TX_SET_FRAMING",
+    [headerNameToId.TX_SET_MAX_LATENCY]          = "TX_SET_MAX_LATENCY",
+    [headerNameToId.TX_SET_CALIBRATION]          = "TX_SET_CALIBRATION",
+    [headerNameToId.TX_GET_CALIBRATION]          = "TX_GET_CALIBRATION",
     -- sampling (tx)
     [headerNameToId.TX_DEVICE_REBOOT]            = "TX_DEVICE_REBOOT",
     [headerNameToId.TX_SAMPLING_START]           = "TX_SAMPLING_START",
     [headerNameToId.TX_SAMPLING_STOP]            = "TX_SAMPLING_STOP",
+    [headerNameToId.TX_CONFIGURE_AND_START]      = "TX_CONFIGURE_AND_START",
+    [headerNameToId.TX_CAPTURE_START]            = "TX_CAPTURE_START",
+    [headerNameToId.TX_RECORDER_START]           = "TX_RECORDER_START",
+    [headerNameToId.TX_SEQUENCE_APPEND]          = "TX_SEQUENCE_APPEND",
+    [headerNameToId.TX_SEQUENCE_MARKER]          = "TX_SEQUENCE_MARKER",
     -- configuration (rx)
     [headerNameToId.RX_OUTPUT_DATA_RATE]         = "RX_OUTPUT_DATA_RATE",
     [headerNameToId.RX_RANGE]                    = "RX_RANGE",
@@ -78,6 +118,7 @@ local headerIdToName = {
     [headerNameToId.RX_FIRMWARE_VERSION]         = "RX_FIRMWARE_VERSION",
     [headerNameToId.RX_UPTIME]                   = "RX_UPTIME",
     [headerNameToId.RX_BUFFER_STATUS]            = "RX_BUFFER_STATUS",
+    [headerNameToId.RX_CAPTURE_CHUNK]            = "RX_CAPTURE_CHUNK",
     -- sampling (rx)
     [headerNameToId.RX_SAMPLING_FIFO_OVERFLOW]   = "RX_SAMPLING_FIFO_OVERFLOW",
     [headerNameToId.RX_SAMPLING_STARTED]         = "RX_SAMPLING_STARTED",
@@ -88,6 +129,23 @@ local headerIdToName = {
     [headerNameToId.RX_FAULT]                    = "RX_FAULT",
     [headerNameToId.RX_SAMPLING_BUFFER_OVERFLOW] = "RX_SAMPLING_BUFFER_OVERFLOW",
     [headerNameToId.RX_TRANSMISSION_ERROR]       = "RX_TRANSMISSION_ERROR",
+    [headerNameToId.RX_SAMPLING_CONFIGURED_STARTED] = "RX_SAMPLING_CONFIGURED_STARTED",
+    [headerNameToId.RX_RECORDER_FINISHED]        = "RX_RECORDER_FINISHED",
+    [headerNameToId.RX_SEQUENCE_SEGMENT]         = "RX_SEQUENCE_SEGMENT",
+    [headerNameToId.RX_ACCELERATION_AXES]        = "RX_ACCELERATION_AXES",
+    [headerNameToId.RX_ACCELERATION_DELTA]       = "RX_ACCELERATION_DELTA",
+    [headerNameToId.RX_ACCELERATION_PACKED]      = "RX_ACCELERATION_PACKED",
+    [headerNameToId.RX_ACCELERATION_SOA]         = "RX_ACCELERATION_SOA",
+    [headerNameToId.RX_CLOCK_CORRELATION]        = "RX_CLOCK_CORRELATION",
+    [headerNameToId.RX_ACCELERATION_SENSOR]      = "RX_ACCELERATION_SENSOR",
+    [headerNameToId.RX_CALIBRATION]              = "RX_CALIBRATION",
+    -- appended request and response
+    [headerNameToId.TX_GET_SPI_CLOCK]            = "TX_GET_SPI_CLOCK",
+    [headerNameToId.RX_SPI_CLOCK]                = "RX_SPI_CLOCK",
+    [headerNameToId.TX_SAVE_CONFIGURATION]       = "TX_SAVE_CONFIGURATION",
+    [headerNameToId.RX_CONFIGURATION_SAVED]      = "RX_CONFIGURATION_SAVED",
+    -- appended response
+    [headerNameToId.RX_STREAM_SETUP]             = "RX_STREAM_SETUP",
 }
 
 -- sensor ODR field names
@@ -115,6 +173,15 @@ local sensorScaleToName = {
     [1] = "FULL_RES_4MG_LSB"
 }
 
+-- sample format names
+local sampleFormatToName = {
+    [0] = "ACCELERATION",
+    [1] = "ACCELERATION_DELTA",
+    [2] = "PACKED_13BIT",
+    [3] = "PACKED_10BIT",
+    [4] = "ACCELERATION_SOA"
+}
+
 -- device fault codes
 local faultCodeToName = {
     [0] = "NmiHandler",
@@ -133,6 +200,7 @@ pfBufferStatusCapacityUsedMax     = ProtoField.uint16("axxel.bufferStatus.capaci
 pfBufferStatusPutCount            = ProtoField.uint16("axxel.bufferStatus.putCount",            "putCount",            base.DEC)
 pfBufferStatusTakeCount           = ProtoField.uint16("axxel.bufferStatus.takeCount",           "takeCount",           base.DEC)
 pfBufferStatusLargestTxChunkBytes = ProtoField.uint16("axxel.bufferStatus.largestTxChunkBytes", "largestTxChunkBytes", base.DEC)
+pfBufferStatusAverageTxChunkBytes = ProtoField.uint16("axxel.bufferStatus.averageTxChunkBytes", "averageTxChunkBytes", base.DEC)
 -- RX firmware version fields
 pfFirmwareVersionMajor = ProtoField.uint8("axxel.firmwareVersion.major", "major", base.DEC)
 pfFirmwareVersionMinor = ProtoField.uint8("axxel.firmwareVersion.minor", "minor", base.DEC)
@@ -145,6 +213,70 @@ pfSensorScale = ProtoField.uint8("axxel.sensor.scale", "scale",       base.HEX,
 pfDeviceSetupSensorOutputDataRate = ProtoField.uint8("axxel.deviceSetup.outputDataRate", "outputDataRate", base.HEX, sensorOutputDataRateFlagToName, 0x0f)
 pfDeviceSetupSensorRange = ProtoField.uint8("axxel.deviceSetup.range", "range",                            base.HEX, sensorRangeFlagToName, 0x30)
 pfDeviceSetupSensorScale = ProtoField.uint8("axxel.deviceSetup.scale", "scale",                            base.HEX, sensorScaleToName,              0x40)
+-- RX sampling configured started
+pfConfiguredStartedMaxSamples = ProtoField.uint16("axxel.configuredStarted.maxSamples", "maxSamples", base.DEC)
+pfConfiguredStartedWatermark  = ProtoField.uint8("axxel.configuredStarted.watermark",   "watermark",  base.DEC)
+pfConfiguredStartedFormat     = ProtoField.uint8("axxel.configuredStarted.format",      "format",     base.HEX, sampleFormatToName)
+-- RX capture chunk
+pfCaptureChunkOffset     = ProtoField.uint16("axxel.captureChunk.offset",     "offset",     base.DEC)
+pfCaptureChunkTotalCount = ProtoField.uint16("axxel.captureChunk.totalCount", "totalCount", base.DEC)
+pfCaptureChunkCount      = ProtoField.uint8("axxel.captureChunk.count",       "count",      base.DEC)
+-- RX recorder finished
+pfRecorderFinishedTotalCount   = ProtoField.uint16("axxel.recorderFinished.totalCount",   "totalCount",   base.DEC)
+pfRecorderFinishedTriggerIndex = ProtoField.uint16("axxel.recorderFinished.triggerIndex", "triggerIndex", base.DEC)
+pfRecorderFinishedIsTriggered  = ProtoField.uint8("axxel.recorderFinished.isTriggered",   "isTriggered",  base.DEC)
+-- RX sequence segment
+pfSequenceSegmentSegment      = ProtoField.uint16("axxel.sequenceSegment.segment",      "segment",      base.DEC)
+pfSequenceSegmentSamplesCount = ProtoField.uint16("axxel.sequenceSegment.samplesCount", "samplesCount", base.DEC)
+pfSequenceSegmentStartMs      = ProtoField.uint32("axxel.sequenceSegment.startMs",      "startMs",      base.DEC)
+-- RX acceleration axes block
+pfAccelerationAxesFirstIndex = ProtoField.uint16("axxel.accelerationAxes.firstIndex", "firstIndex", base.DEC)
+pfAccelerationAxesCount      = ProtoField.uint16("axxel.accelerationAxes.count",      "count",      base.DEC)
+pfAccelerationAxesAxes       = ProtoField.uint8("axxel.accelerationAxes.axes",        "axes",       base.HEX)
+-- RX acceleration delta block
+pfAccelerationDeltaFirstIndex = ProtoField.uint16("axxel.accelerationDelta.firstIndex", "firstIndex", base.DEC)
+pfAccelerationDeltaCount      = ProtoField.uint8("axxel.accelerationDelta.count",       "count",      base.DEC)
+pfAccelerationDeltaWidthX     = ProtoField.uint8("axxel.accelerationDelta.widthX",      "widthX",     base.DEC)
+pfAccelerationDeltaWidthY     = ProtoField.uint8("axxel.accelerationDelta.widthY",      "widthY",     base.DEC)
+pfAccelerationDeltaWidthZ     = ProtoField.uint8("axxel.accelerationDelta.widthZ",      "widthZ",     base.DEC)
+-- RX acceleration packed block
+pfAccelerationPackedFirstIndex = ProtoField.uint16("axxel.accelerationPacked.firstIndex", "firstIndex", base.DEC)
+pfAccelerationPackedCount      = ProtoField.uint16("axxel.accelerationPacked.count",      "count",      base.DEC)
+pfAccelerationPackedFormat     = ProtoField.uint8("axxel.accelerationPacked.format",      "format",     base.HEX, sampleFormatToName)
+-- RX acceleration structure of arrays block
+pfAccelerationSoaFirstIndex = ProtoField.uint16("axxel.accelerationSoa.firstIndex", "firstIndex", base.DEC)
+pfAccelerationSoaCount      = ProtoField.uint8("axxel.accelerationSoa.count",       "count",      base.DEC)
+-- RX clock correlation
+pfClockCorrelationFrameNumber = ProtoField.uint16("axxel.clockCorrelation.frameNumber", "frameNumber", base.DEC)
+pfClockCorrelationSampleIndex = ProtoField.uint16("axxel.clockCorrelation.sampleIndex", "sampleIndex", base.DEC)
+pfClockCorrelationTimerTicks  = ProtoField.uint32("axxel.clockCorrelation.timerTicks",  "timerTicks",  base.DEC)
+-- RX acceleration sensor tag
+pfAccelerationSensorSensor     = ProtoField.uint8("axxel.accelerationSensor.sensor",      "sensor",     base.DEC)
+pfAccelerationSensorCount      = ProtoField.uint8("axxel.accelerationSensor.count",       "count",      base.DEC)
+pfAccelerationSensorFirstIndex = ProtoField.uint16("axxel.accelerationSensor.firstIndex", "firstIndex", base.DEC)
+pfAccelerationSensorTimerTicks = ProtoField.uint32("axxel.accelerationSensor.timerTicks", "timerTicks", base.DEC)
+-- RX calibration
+pfCalibrationSensor    = ProtoField.uint8("axxel.calibration.sensor",     "sensor",    base.DEC)
+pfCalibrationEnable    = ProtoField.uint8("axxel.calibration.enable",     "enable",    base.DEC)
+pfCalibrationShift     = ProtoField.uint8("axxel.calibration.shift",      "shift",     base.DEC)
+pfCalibrationMatrix    = ProtoField.int16("axxel.calibration.matrix",     "matrix",    base.DEC)
+pfCalibrationOffset    = ProtoField.int16("axxel.calibration.offset",     "offset",    base.DEC)
+pfCalibrationLsbMicroG = ProtoField.uint32("axxel.calibration.lsbMicroG", "lsbMicroG", base.DEC)
+-- RX SPI clock
+pfSpiClockClockHz        = ProtoField.uint32("axxel.spiClock.clockHz",        "clockHz",        base.DEC)
+pfSpiClockDivisor        = ProtoField.uint16("axxel.spiClock.divisor",        "divisor",        base.DEC)
+pfSpiClockFastestDivisor = ProtoField.uint16("axxel.spiClock.fastestDivisor", "fastestDivisor", base.DEC)
+-- RX configuration saved
+pfConfigurationSavedResult = ProtoField.int8("axxel.configurationSaved.result", "result", base.DEC)
+-- RX stream setup
+pfStreamSetupAxes   = ProtoField.uint8("axxel.streamSetup.axes",   "axes",   base.HEX)
+pfStreamSetupFramed = ProtoField.uint8("axxel.streamSetup.framed", "framed", base.DEC)
+pfStreamSetupResult = ProtoField.int8("axxel.streamSetup.result",  "result", base.DEC)
+-- RX stream frame
+pfStreamFrameSync     = ProtoField.uint32("axxel.streamFrame.sync",     "sync",     base.HEX)
+pfStreamFrameLength   = ProtoField.uint16("axxel.streamFrame.length",   "length",   base.DEC)
+pfStreamFrameSequence = ProtoField.uint16("axxel.streamFrame.sequence", "sequence", base.DEC)
+pfStreamFrameCrc      = ProtoField.uint32("axxel.streamFrame.crc",      "crc",      base.HEX)
 -- RX device uptime
 pfDeviceUptime = ProtoField.uint32("axxel.deviceUptime.elapsedMs", "elapsedMs", base.DEC)
 -- RX device fault codes
@@ -165,6 +297,7 @@ axxelProtocol.fields = {
     pfBufferStatusPutCount,
     pfBufferStatusTakeCount,
     pfBufferStatusLargestTxChunkBytes,
+    pfBufferStatusAverageTxChunkBytes,
     pfFirmwareVersionMajor,
     pfFirmwareVersionMinor,
     pfFirmwareVersionPatch,
@@ -174,6 +307,55 @@ axxelProtocol.fields = {
     pfDeviceSetupSensorOutputDataRate,
     pfDeviceSetupSensorRange,
     pfDeviceSetupSensorScale,
+    pfConfiguredStartedMaxSamples,
+    pfConfiguredStartedWatermark,
+    pfConfiguredStartedFormat,
+    pfCaptureChunkOffset,
+    pfCaptureChunkTotalCount,
+    pfCaptureChunkCount,
+    pfRecorderFinishedTotalCount,
+    pfRecorderFinishedTriggerIndex,
+    pfRecorderFinishedIsTriggered,
+    pfSequenceSegmentSegment,
+    pfSequenceSegmentSamplesCount,
+    pfSequenceSegmentStartMs,
+    pfAccelerationAxesFirstIndex,
+    pfAccelerationAxesCount,
+    pfAccelerationAxesAxes,
+    pfAccelerationDeltaFirstIndex,
+    pfAccelerationDeltaCount,
+    pfAccelerationDeltaWidthX,
+    pfAccelerationDeltaWidthY,
+    pfAccelerationDeltaWidthZ,
+    pfAccelerationPackedFirstIndex,
+    pfAccelerationPackedCount,
+    pfAccelerationPackedFormat,
+    pfAccelerationSoaFirstIndex,
+    pfAccelerationSoaCount,
+    pfClockCorrelationFrameNumber,
+    pfClockCorrelationSampleIndex,
+    pfClockCorrelationTimerTicks,
+    pfAccelerationSensorSensor,
+    pfAccelerationSensorCount,
+    pfAccelerationSensorFirstIndex,
+    pfAccelerationSensorTimerTicks,
+    pfCalibrationSensor,
+    pfCalibrationEnable,
+    pfCalibrationShift,
+    pfCalibrationMatrix,
+    pfCalibrationOffset,
+    pfCalibrationLsbMicroG,
+    pfSpiClockClockHz,
+    pfSpiClockDivisor,
+    pfSpiClockFastestDivisor,
+    pfConfigurationSavedResult,
+    pfStreamSetupAxes,
+    pfStreamSetupFramed,
+    pfStreamSetupResult,
+    pfStreamFrameSync,
+    pfStreamFrameLength,
+    pfStreamFrameSequence,
+    pfStreamFrameCrc,
     pfDeviceUptime,
     pfDeviceFault,
     pfAccelerationX,
@@ -199,6 +381,7 @@ function decodeBufferStatus(buffer, tree)
     payloadTree:add_le(pfBufferStatusPutCount,            buffer( 6,2))
     payloadTree:add_le(pfBufferStatusTakeCount,           buffer( 8,2))
     payloadTree:add_le(pfBufferStatusLargestTxChunkBytes, buffer(10,2))
+    payloadTree:add_le(pfBufferStatusAverageTxChunkBytes, buffer(12,2))
 end
 
 -- decode the firmware version payload
@@ -217,6 +400,147 @@ function decodeDeviceSetup(buffer, tree)
     payloadTree:add_le(pfDeviceSetupSensorScale,          buffer(0,1))
 end
 
+-- decode the sampling configured started payload
+function decodeSamplingConfiguredStarted(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Sampling Configured Started")
+    payloadTree:add_le(pfConfiguredStartedMaxSamples,     buffer(0,2))
+    payloadTree:add_le(pfDeviceSetupSensorOutputDataRate, buffer(2,1))
+    payloadTree:add_le(pfDeviceSetupSensorRange,          buffer(2,1))
+    payloadTree:add_le(pfDeviceSetupSensorScale,          buffer(2,1))
+    payloadTree:add_le(pfConfiguredStartedWatermark,      buffer(3,1))
+    payloadTree:add_le(pfConfiguredStartedFormat,         buffer(4,1))
+end
+
+-- decode the capture chunk payload (header only, samples follow)
+function decodeCaptureChunk(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Capture Chunk")
+    payloadTree:add_le(pfCaptureChunkOffset,     buffer(0,2))
+    payloadTree:add_le(pfCaptureChunkTotalCount, buffer(2,2))
+    payloadTree:add_le(pfCaptureChunkCount,      buffer(4,1))
+end
+
+-- decode the recorder finished payload
+function decodeRecorderFinished(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Recorder Finished")
+    payloadTree:add_le(pfRecorderFinishedTotalCount,   buffer(0,2))
+    payloadTree:add_le(pfRecorderFinishedTriggerIndex, buffer(2,2))
+    payloadTree:add_le(pfRecorderFinishedIsTriggered,  buffer(4,1))
+end
+
+-- decode the sequence segment payload (acceleration frames follow)
+function decodeSequenceSegment(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Sequence Segment")
+    payloadTree:add_le(pfSequenceSegmentSegment,      buffer(0,2))
+    payloadTree:add_le(pfSequenceSegmentSamplesCount, buffer(2,2))
+    payloadTree:add_le(pfSequenceSegmentStartMs,      buffer(4,4))
+end
+
+-- decode the acceleration axes block payload (header only, packed samples follow)
+function decodeAccelerationAxes(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Acceleration Axes")
+    payloadTree:add_le(pfAccelerationAxesFirstIndex, buffer(0,2))
+    payloadTree:add_le(pfAccelerationAxesCount,      buffer(2,2))
+    payloadTree:add_le(pfAccelerationAxesAxes,       buffer(4,1))
+end
+
+-- decode the acceleration delta payload (codec block header only, first sample and deltas follow)
+function decodeAccelerationDelta(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Acceleration Delta")
+    payloadTree:add_le(pfAccelerationDeltaFirstIndex, buffer(0,2))
+    payloadTree:add_le(pfAccelerationDeltaCount,      buffer(2,1))
+    payloadTree:add_le(pfAccelerationDeltaWidthX,     buffer(3,1))
+    payloadTree:add_le(pfAccelerationDeltaWidthY,     buffer(4,1))
+    payloadTree:add_le(pfAccelerationDeltaWidthZ,     buffer(5,1))
+end
+
+-- decode the acceleration packed block payload (header only, packed samples follow)
+function decodeAccelerationPacked(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Acceleration Packed")
+    payloadTree:add_le(pfAccelerationPackedFirstIndex, buffer(0,2))
+    payloadTree:add_le(pfAccelerationPackedCount,      buffer(2,2))
+    payloadTree:add_le(pfAccelerationPackedFormat,     buffer(4,1))
+end
+
+-- decode the acceleration structure of arrays payload (header only, x[], y[], z[] follow 4-byte aligned)
+function decodeAccelerationSoa(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Acceleration SoA")
+    payloadTree:add_le(pfAccelerationSoaFirstIndex, buffer(0,2))
+    payloadTree:add_le(pfAccelerationSoaCount,      buffer(2,1))
+end
+
+-- decode the clock correlation payload
+function decodeClockCorrelation(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Clock Correlation")
+    payloadTree:add_le(pfClockCorrelationFrameNumber, buffer(0,2))
+    payloadTree:add_le(pfClockCorrelationSampleIndex, buffer(2,2))
+    payloadTree:add_le(pfClockCorrelationTimerTicks,  buffer(4,4))
+end
+
+-- decode the acceleration sensor tag payload
+function decodeAccelerationSensor(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Acceleration Sensor")
+    payloadTree:add_le(pfAccelerationSensorSensor,     buffer(0,1))
+    payloadTree:add_le(pfAccelerationSensorCount,      buffer(1,1))
+    payloadTree:add_le(pfAccelerationSensorFirstIndex, buffer(2,2))
+    payloadTree:add_le(pfAccelerationSensorTimerTicks, buffer(4,4))
+end
+
+-- decode the calibration payload (matrix row major, Q15)
+function decodeCalibration(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Calibration")
+    payloadTree:add_le(pfCalibrationSensor, buffer(0,1))
+    payloadTree:add_le(pfCalibrationEnable, buffer(1,1))
+    payloadTree:add_le(pfCalibrationShift,  buffer(2,1))
+    for idx = 0, 8 do
+        payloadTree:add_le(pfCalibrationMatrix, buffer(3 + 2 * idx, 2))
+    end
+    for idx = 0, 2 do
+        payloadTree:add_le(pfCalibrationOffset, buffer(21 + 2 * idx, 2))
+    end
+    payloadTree:add_le(pfCalibrationLsbMicroG, buffer(27,4))
+end
+
+-- decode the SPI clock calibrated at startup
+function decodeSpiClock(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "SpiClock")
+    payloadTree:add_le(pfSpiClockClockHz,        buffer(0,4))
+    payloadTree:add_le(pfSpiClockDivisor,        buffer(4,2))
+    payloadTree:add_le(pfSpiClockFastestDivisor, buffer(6,2))
+end
+
+-- decode the sensor setup persisted to flash
+function decodeConfigurationSaved(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Configuration Saved")
+    payloadTree:add_le(pfDeviceSetupSensorOutputDataRate, buffer(0,1))
+    payloadTree:add_le(pfDeviceSetupSensorRange,          buffer(0,1))
+    payloadTree:add_le(pfDeviceSetupSensorScale,          buffer(0,1))
+    payloadTree:add_le(pfConfigurationSavedResult,        buffer(1,1))
+end
+
+-- decode the axes selection and stream framing
+function decodeStreamSetup(buffer, tree)
+    local payloadTree = tree:add(axxelProtocol, buffer(), "Stream Setup")
+    payloadTree:add_le(pfStreamSetupAxes,   buffer(0,1))
+    payloadTree:add_le(pfStreamSetupFramed, buffer(1,1))
+    payloadTree:add_le(pfStreamSetupResult, buffer(2,1))
+end
+
+-- stream frame sync word (little endian), see TRANSPORT_STREAM_SYNC
+local streamFrameSync = 0xA55AC33C
+
+-- decode the stream frame wrapping a chunk of the acceleration stream
+function decodeStreamFrame(buffer, tree)
+    local length = buffer(4,2):le_uint()
+    local paddedLength = 8 + math.floor((length + 3) / 4) * 4
+    local frameTree = tree:add(axxelProtocol, buffer(), "Stream Frame")
+    frameTree:add_le(pfStreamFrameSync,     buffer(0,4))
+    frameTree:add_le(pfStreamFrameLength,   buffer(4,2))
+    frameTree:add_le(pfStreamFrameSequence, buffer(6,2))
+    if buffer:len() >= paddedLength + 4 then
+        frameTree:add_le(pfStreamFrameCrc, buffer(paddedLength,4))
+    end
+end
+
 -- decode the sensor output data rate payload
 function decodeSensorOutputDataRate(buffer, tree)
     local payloadTree = tree:add(axxelProtocol, buffer(), "Sensor Output Data Rate")
@@ -283,6 +607,10 @@ function axxelProtocol.dissector(buffer, pinfo, tree)
         pinfo.cols.protocol = axxelProtocol.name
 
         local dataTree = tree:add(axxelProtocol, buffer(), "3DP Axxel Data (response)")
+        if length >= 8 and buffer(0,4):le_uint() == streamFrameSync then
+            decodeStreamFrame(buffer, dataTree)
+            buffer = buffer(8)
+        end
         local id = buffer(0,1):uint()
         dataTree:add_le(pfHeaderId, id)
 
@@ -301,6 +629,34 @@ function axxelProtocol.dissector(buffer, pinfo, tree)
             decodeSensorScale(buffer(1), dataTree)
         elseif id == headerNameToId.RX_UPTIME then
             decodeDeviceUptime(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_CAPTURE_CHUNK then
+            decodeCaptureChunk(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_SAMPLING_CONFIGURED_STARTED then
+            decodeSamplingConfiguredStarted(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_RECORDER_FINISHED then
+            decodeRecorderFinished(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_SEQUENCE_SEGMENT then
+            decodeSequenceSegment(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_ACCELERATION_AXES then
+            decodeAccelerationAxes(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_ACCELERATION_DELTA then
+            decodeAccelerationDelta(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_ACCELERATION_PACKED then
+            decodeAccelerationPacked(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_ACCELERATION_SOA then
+            decodeAccelerationSoa(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_CLOCK_CORRELATION then
+            decodeClockCorrelation(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_ACCELERATION_SENSOR then
+            decodeAccelerationSensor(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_CALIBRATION then
+            decodeCalibration(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_SPI_CLOCK then
+            decodeSpiClock(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_CONFIGURATION_SAVED then
+            decodeConfigurationSaved(buffer(1), dataTree)
+        elseif id == headerNameToId.RX_STREAM_SETUP then
+            decodeStreamSetup(buffer(1), dataTree)
         else
             dataTree:add_proto_expert_info(efBadResponse, "unknown response headerId (" .. string.format("0x%x", id) .. ")")
         end
@@ -0,0 +1,147 @@
+#include "../../lib/calibration/src/calibration.h"
+#include <errno.h>
+#include <unity.h>
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct Calibration calibration;
+
+static const struct Calibration_Setup identity = {
+    .matrix = {{16384, 0, 0}, {0, 16384, 0}, {0, 0, 16384}},
+    .offset = {0, 0, 0},
+    .shift = 1};
+
+void test_identity_leavesSamplesUnchanged() {
+  struct Calibration_Acceleration samples[] = {
+      {.x = 1, .y = -2, .z = 3}, {.x = 4095, .y = -4096, .z = 256}};
+  TEST_ASSERT_EQUAL(0, Calibration_configure(&calibration, &identity));
+  Calibration_apply(&calibration, samples, 2);
+
+  TEST_ASSERT_EQUAL(1, samples[0].x);
+  TEST_ASSERT_EQUAL(-2, samples[0].y);
+  TEST_ASSERT_EQUAL(3, samples[0].z);
+  TEST_ASSERT_EQUAL(4095, samples[1].x);
+  TEST_ASSERT_EQUAL(-4096, samples[1].y);
+  TEST_ASSERT_EQUAL(256, samples[1].z);
+}
+
+void test_rotationAboutZ_swapsAxes() {
+  const struct Calibration_Setup rotation = {
+      .matrix = {{0, 16384, 0}, {-16384, 0, 0}, {0, 0, 16384}},
+      .offset = {0, 0, 0},
+      .shift = 1};
+  struct Calibration_Acceleration sample = {.x = 100, .y = 200, .z = 256};
+  TEST_ASSERT_EQUAL(0, Calibration_configure(&calibration, &rotation));
+  Calibration_apply(&calibration, &sample, 1);
+
+  TEST_ASSERT_EQUAL(200, sample.x);
+  TEST_ASSERT_EQUAL(-100, sample.y);
+  TEST_ASSERT_EQUAL(256, sample.z);
+}
+
+void test_gainAndOffset_saturate() {
+  // gain 16: Q15 0.5 widened by 2^5
+  const struct Calibration_Setup gain = {
+      .matrix = {{16384, 0, 0}, {0, 16384, 0}, {0, 0, 16384}},
+      .offset = {10, -10, 0},
+      .shift = 5};
+  struct Calibration_Acceleration sample = {.x = 4000, .y = -4000, .z = 7};
+  TEST_ASSERT_EQUAL(0, Calibration_configure(&calibration, &gain));
+  Calibration_apply(&calibration, &sample, 1);
+
+  TEST_ASSERT_EQUAL(INT16_MAX, sample.x);
+  TEST_ASSERT_EQUAL(INT16_MIN, sample.y);
+  TEST_ASSERT_EQUAL(7 * 16, sample.z);
+}
+
+void test_fullScale_saturatesBeyond32Bit() {
+  // the sum of three full scale products exceeds 32 bit
+  const struct Calibration_Setup mixing = {
+      .matrix = {{INT16_MAX, INT16_MAX, INT16_MAX},
+                 {INT16_MAX, INT16_MAX, INT16_MAX},
+                 {INT16_MIN, INT16_MIN, INT16_MIN}},
+      .offset = {0, 0, 0},
+      .shift = 0};
+  struct Calibration_Acceleration samples[] = {
+      {.x = INT16_MAX, .y = INT16_MAX, .z = INT16_MAX},
+      {.x = INT16_MIN, .y = INT16_MIN, .z = INT16_MIN}};
+  TEST_ASSERT_EQUAL(0, Calibration_configure(&calibration, &mixing));
+  Calibration_apply(&calibration, samples, 2);
+
+  TEST_ASSERT_EQUAL(INT16_MAX, samples[0].x);
+  TEST_ASSERT_EQUAL(INT16_MAX, samples[0].y);
+  TEST_ASSERT_EQUAL(INT16_MIN, samples[0].z);
+  TEST_ASSERT_EQUAL(INT16_MIN, samples[1].x);
+  TEST_ASSERT_EQUAL(INT16_MIN, samples[1].y);
+  TEST_ASSERT_EQUAL(INT16_MAX, samples[1].z);
+}
+
+void test_rightShift_roundsToNearest() {
+  // gain 0.5
+  const struct Calibration_Setup half = {
+      .matrix = {{16384, 0, 0}, {0, 16384, 0}, {0, 0, 16384}},
+      .offset = {0, 0, 0},
+      .shift = 0};
+  struct Calibration_Acceleration sample = {.x = 3, .y = -3, .z = 5};
+  TEST_ASSERT_EQUAL(0, Calibration_configure(&calibration, &half));
+  Calibration_apply(&calibration, &sample, 1);
+
+  // halves round up
+  TEST_ASSERT_EQUAL(2, sample.x);
+  TEST_ASSERT_EQUAL(-1, sample.y);
+  TEST_ASSERT_EQUAL(3, sample.z);
+}
+
+void test_inputShift_normalizesToFullResolution() {
+  struct Calibration_Acceleration sample = {.x = 512, .y = -1, .z = 0};
+  TEST_ASSERT_EQUAL(0, Calibration_configure(&calibration, &identity));
+  TEST_ASSERT_EQUAL(0, Calibration_setInputShift(&calibration, 3));
+  Calibration_apply(&calibration, &sample, 1);
+
+  TEST_ASSERT_EQUAL(4096, sample.x);
+  TEST_ASSERT_EQUAL(-8, sample.y);
+  TEST_ASSERT_EQUAL(-EINVAL, Calibration_setInputShift(&calibration, 4));
+}
+
+void test_configure_rejectsShift() {
+  struct Calibration_Setup setup = identity;
+  setup.shift = CALIBRATION_MAX_SHIFT + 1U;
+  TEST_ASSERT_EQUAL(-EINVAL, Calibration_configure(&calibration, &setup));
+  TEST_ASSERT_FALSE(Calibration_isEnabled(&calibration));
+}
+
+void test_disabled_leavesSamplesUnchanged() {
+  const struct Calibration_Setup zero = {
+      .matrix = {{0}}, .offset = {1, 1, 1}, .shift = 0};
+  struct Calibration_Acceleration sample = {.x = 1, .y = 2, .z = 3};
+  Calibration_apply(&calibration, &sample, 1);
+  TEST_ASSERT_EQUAL(1, sample.x);
+
+  TEST_ASSERT_EQUAL(0, Calibration_configure(&calibration, &zero));
+  Calibration_disable(&calibration);
+  Calibration_apply(&calibration, &sample, 1);
+  TEST_ASSERT_EQUAL(1, sample.x);
+  TEST_ASSERT_EQUAL(2, sample.y);
+  TEST_ASSERT_EQUAL(3, sample.z);
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_identity_leavesSamplesUnchanged);
+  RUN_TEST(test_rotationAboutZ_swapsAxes);
+  RUN_TEST(test_gainAndOffset_saturate);
+  RUN_TEST(test_fullScale_saturatesBeyond32Bit);
+  RUN_TEST(test_rightShift_roundsToNearest);
+  RUN_TEST(test_inputShift_normalizesToFullResolution);
+  RUN_TEST(test_configure_rejectsShift);
+  RUN_TEST(test_disabled_leavesSamplesUnchanged);
+  return UNITY_END();
+}
+
+void setUp() {
+  const struct Calibration initial = CALIBRATION_INITIALIZER;
+  calibration = initial;
+}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
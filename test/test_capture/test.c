@@ -0,0 +1,117 @@
+#include "../../lib/capture/src/capture.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unity.h>
+
+struct Foo {
+  uint16_t data;
+  uint8_t tag;
+} __attribute__((packed));
+
+#define DECLARE_CAPTURE_CAPACITY4                                              \
+  struct Foo storage[4] = {0};                                                 \
+  struct Capture capture;                                                      \
+  Capture_init(&capture, (uint8_t *)storage, 4, sizeof(struct Foo))
+
+void test_init_invalidArgs() {
+  struct Foo storage[1];
+  struct Capture capture;
+
+  TEST_ASSERT_EQUAL(-EINVAL, Capture_init(NULL, (uint8_t *)storage, 1, 1));
+  TEST_ASSERT_EQUAL(-EINVAL, Capture_init(&capture, NULL, 1, 1));
+  TEST_ASSERT_EQUAL(-EINVAL, Capture_init(&capture, (uint8_t *)storage, 1, 0));
+}
+
+void test_empty_nothingAvailable() {
+  DECLARE_CAPTURE_CAPACITY4;
+  uint16_t available = {42};
+
+  TEST_ASSERT_EQUAL(0, Capture_count(&capture));
+  TEST_ASSERT_EQUAL(4, Capture_capacity(&capture));
+  TEST_ASSERT_EQUAL(false, Capture_isFull(&capture));
+  TEST_ASSERT_NULL(Capture_itemsAt(&capture, 0, &available));
+  TEST_ASSERT_EQUAL(0, available);
+}
+
+void test_append_readAtOffsets() {
+  DECLARE_CAPTURE_CAPACITY4;
+  const struct Foo items[3] = {{.data = 1000, .tag = 1},
+                               {.data = 2000, .tag = 2},
+                               {.data = 3000, .tag = 3}};
+  uint16_t available = {0};
+
+  TEST_ASSERT_EQUAL(0, Capture_append(&capture, items, 3));
+  TEST_ASSERT_EQUAL(3, Capture_count(&capture));
+
+  const struct Foo *first = Capture_itemsAt(&capture, 0, &available);
+  TEST_ASSERT_EQUAL(3, available);
+  TEST_ASSERT_EQUAL(1000, first[0].data);
+  TEST_ASSERT_EQUAL(3, first[2].tag);
+
+  // reading does not consume: resume at any offset
+  const struct Foo *second = Capture_itemsAt(&capture, 1, &available);
+  TEST_ASSERT_EQUAL(2, available);
+  TEST_ASSERT_EQUAL(2000, second[0].data);
+  TEST_ASSERT_EQUAL_PTR(second, Capture_itemsAt(&capture, 1, NULL));
+
+  TEST_ASSERT_NULL(Capture_itemsAt(&capture, 3, &available));
+  TEST_ASSERT_EQUAL(0, available);
+}
+
+void test_appendBeyondCapacity_storesFittingItems() {
+  DECLARE_CAPTURE_CAPACITY4;
+  const struct Foo items[3] = {{.data = 1}, {.data = 2}, {.data = 3}};
+  uint16_t available = {0};
+
+  TEST_ASSERT_EQUAL(0, Capture_append(&capture, items, 3));
+  TEST_ASSERT_EQUAL(-ENOMEM, Capture_append(&capture, items, 3));
+  TEST_ASSERT_EQUAL(true, Capture_isFull(&capture));
+  TEST_ASSERT_EQUAL(4, Capture_count(&capture));
+
+  const struct Foo *last = Capture_itemsAt(&capture, 3, &available);
+  TEST_ASSERT_EQUAL(1, available);
+  TEST_ASSERT_EQUAL(1, last->data);
+
+  TEST_ASSERT_EQUAL(-ENOMEM, Capture_append(&capture, items, 1));
+  TEST_ASSERT_EQUAL(4, Capture_count(&capture));
+}
+
+void test_reset_discardsItems() {
+  DECLARE_CAPTURE_CAPACITY4;
+  const struct Foo item = {.data = 7};
+
+  TEST_ASSERT_EQUAL(0, Capture_append(&capture, &item, 1));
+  Capture_reset(&capture);
+  TEST_ASSERT_EQUAL(0, Capture_count(&capture));
+  TEST_ASSERT_NULL(Capture_itemsAt(&capture, 0, NULL));
+}
+
+void test_setCount_adoptsStorage() {
+  DECLARE_CAPTURE_CAPACITY4;
+  uint16_t available = {0};
+
+  TEST_ASSERT_EQUAL(-EINVAL, Capture_setCount(&capture, 5));
+  TEST_ASSERT_EQUAL(0, Capture_count(&capture));
+
+  TEST_ASSERT_EQUAL(0, Capture_setCount(&capture, 3));
+  TEST_ASSERT_NOT_NULL(Capture_itemsAt(&capture, 2, &available));
+  TEST_ASSERT_EQUAL(1, available);
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_init_invalidArgs);
+  RUN_TEST(test_empty_nothingAvailable);
+  RUN_TEST(test_append_readAtOffsets);
+  RUN_TEST(test_appendBeyondCapacity_storesFittingItems);
+  RUN_TEST(test_reset_discardsItems);
+  RUN_TEST(test_setCount_adoptsStorage);
+  return UNITY_END();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
@@ -0,0 +1,154 @@
+#include "../../lib/capture_file/src/capture_file.h"
+#include "../../lib/host_transport/src/host_transport_types.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unity.h>
+
+#define PATH "/tmp/test_capture_file.cap"
+
+#define SAMPLES_COUNT 5000U
+
+static struct Transport_Acceleration samples[SAMPLES_COUNT];
+
+static const struct CaptureFile_Source source = {
+    .path = "/dev/ttyACM0",
+    .sensor = 1,
+    .periodNs = 312500,
+    .firmware = {.major = 0, .minor = 1, .patch = 10},
+    .setup = {.outputDataRate = 0b1111U, .range = 0b11U, .scale = 1}};
+
+void test_append_fillsBlocksColumnwise() {
+  struct CaptureFile file = CAPTUREFILE_INITIALIZER;
+  TEST_ASSERT_EQUAL(0, CaptureFile_create(&file, PATH, &source));
+  // chunks not aligned to blocks
+  for (uint32_t offset = 0; offset < SAMPLES_COUNT; offset += 1000U) {
+    TEST_ASSERT_EQUAL(0, CaptureFile_append(&file, &samples[offset], 1000U,
+                                            offset, 1000000000ULL));
+  }
+  CaptureFile_close(&file);
+
+  TEST_ASSERT_EQUAL(0, CaptureFile_open(&file, PATH));
+  const struct CaptureFile_Header *header = {CaptureFile_header(&file)};
+  TEST_ASSERT_EQUAL(SAMPLES_COUNT, header->samplesCount);
+  TEST_ASSERT_EQUAL(2, header->blocksCount);
+  TEST_ASSERT_EQUAL(0, header->markersCount);
+  TEST_ASSERT_EQUAL(1, header->sensor);
+  TEST_ASSERT_EQUAL(10, header->firmware.patch);
+  TEST_ASSERT_EQUAL(0b1111U, header->setup.outputDataRate);
+  TEST_ASSERT_EQUAL_STRING("/dev/ttyACM0", header->source);
+
+  const struct CaptureFile_Block *blocks = {CaptureFile_blocks(&file)};
+  TEST_ASSERT_EQUAL(CAPTUREFILE_BLOCK_SAMPLES, blocks[0].count);
+  TEST_ASSERT_EQUAL(SAMPLES_COUNT - CAPTUREFILE_BLOCK_SAMPLES,
+                    blocks[1].count);
+  TEST_ASSERT_EQUAL(CAPTUREFILE_BLOCK_SAMPLES, blocks[1].firstIndex);
+  // the fifth chunk starts within the second block
+  TEST_ASSERT_EQUAL(1000000000ULL + 96U * 312500ULL, blocks[1].firstStampNs);
+
+  const int16_t *x = {CaptureFile_column(&file, 1, CaptureFile_Axis_X)};
+  const int16_t *z = {CaptureFile_column(&file, 1, CaptureFile_Axis_Z)};
+  TEST_ASSERT_EQUAL(0, (uintptr_t)x % 4096U);
+  TEST_ASSERT_EQUAL(samples[CAPTUREFILE_BLOCK_SAMPLES].x, x[0]);
+  TEST_ASSERT_EQUAL(samples[SAMPLES_COUNT - 1U].z,
+                    z[SAMPLES_COUNT - CAPTUREFILE_BLOCK_SAMPLES - 1U]);
+  TEST_ASSERT_NULL(CaptureFile_column(&file, 2, CaptureFile_Axis_X));
+
+  // room reserved for growing is dropped
+  struct stat status;
+  stat(PATH, &status);
+  TEST_ASSERT_EQUAL(header->blocksOffset +
+                        2U * CAPTUREFILE_AXES * CAPTUREFILE_BLOCK_SAMPLES *
+                            sizeof(int16_t),
+                    status.st_size);
+  CaptureFile_close(&file);
+}
+
+void test_gap_beginsBlockAndIsMarked() {
+  struct CaptureFile file = CAPTUREFILE_INITIALIZER;
+  TEST_ASSERT_EQUAL(0, CaptureFile_create(&file, PATH, &source));
+  TEST_ASSERT_EQUAL(0, CaptureFile_append(&file, samples, 10, 100, 0));
+  TEST_ASSERT_EQUAL(0, CaptureFile_append(&file, samples, 10, 115, 0));
+  // restart: index goes back, no gap
+  TEST_ASSERT_EQUAL(0, CaptureFile_append(&file, samples, 10, 0, 0));
+  CaptureFile_close(&file);
+
+  TEST_ASSERT_EQUAL(0, CaptureFile_open(&file, PATH));
+  TEST_ASSERT_EQUAL(3, CaptureFile_header(&file)->blocksCount);
+  TEST_ASSERT_EQUAL(1, CaptureFile_header(&file)->markersCount);
+
+  const struct CaptureFile_Marker *gap = {
+      CaptureFile_findMarker(&file, CaptureFile_MarkerKind_Gap, 5)};
+  TEST_ASSERT_NOT_NULL(gap);
+  TEST_ASSERT_EQUAL(CAPTUREFILE_BLOCK_SAMPLES, gap->position);
+  TEST_ASSERT_EQUAL(115, gap->sampleIndex);
+  TEST_ASSERT_EQUAL(0, CaptureFile_blocks(&file)[1].firstMarker);
+  TEST_ASSERT_EQUAL(1, CaptureFile_blocks(&file)[1].markersCount);
+
+  TEST_ASSERT_EQUAL(0, CaptureFile_findBlock(&file, 0, 105));
+  TEST_ASSERT_EQUAL(-ENOENT, CaptureFile_findBlock(&file, 0, 112));
+  TEST_ASSERT_EQUAL(2, CaptureFile_findBlock(&file, 0, 5));
+  CaptureFile_close(&file);
+}
+
+void test_markers_placedInFrontOfNextSample() {
+  struct CaptureFile file = CAPTUREFILE_INITIALIZER;
+  TEST_ASSERT_EQUAL(0, CaptureFile_create(&file, PATH, &source));
+  TEST_ASSERT_EQUAL(0, CaptureFile_mark(&file, CaptureFile_MarkerKind_Start,
+                                        0));
+  TEST_ASSERT_EQUAL(0, CaptureFile_append(&file, samples, 20, 0, 0));
+  TEST_ASSERT_EQUAL(0, CaptureFile_mark(&file, CaptureFile_MarkerKind_Segment,
+                                        3));
+  TEST_ASSERT_EQUAL(UINT64_MAX,
+                    CaptureFile_markers(&file)[1].position);
+  TEST_ASSERT_EQUAL(0, CaptureFile_append(&file, &samples[20], 20, 20, 0));
+  TEST_ASSERT_EQUAL(0, CaptureFile_mark(&file, CaptureFile_MarkerKind_Stop,
+                                        0));
+  CaptureFile_close(&file);
+
+  TEST_ASSERT_EQUAL(0, CaptureFile_open(&file, PATH));
+  const struct CaptureFile_Marker *segment = {
+      CaptureFile_findMarker(&file, CaptureFile_MarkerKind_Segment, 3)};
+  TEST_ASSERT_NOT_NULL(segment);
+  TEST_ASSERT_EQUAL(20, segment->position);
+  TEST_ASSERT_EQUAL(20, segment->sampleIndex);
+  TEST_ASSERT_EQUAL(40, CaptureFile_markers(&file)[2].position);
+  TEST_ASSERT_EQUAL(3, CaptureFile_blocks(&file)[0].markersCount);
+  TEST_ASSERT_NULL(
+      CaptureFile_findMarker(&file, CaptureFile_MarkerKind_Segment, 4));
+  CaptureFile_close(&file);
+}
+
+void test_open_rejectsOtherFiles() {
+  struct CaptureFile file = CAPTUREFILE_INITIALIZER;
+  FILE *other = {fopen(PATH, "w")};
+  fputs("timestamp\tx\ty\tz\n", other);
+  fclose(other);
+
+  TEST_ASSERT_EQUAL(-EBADMSG, CaptureFile_open(&file, PATH));
+  TEST_ASSERT_EQUAL(-ENOENT, CaptureFile_open(&file, "/nonexistent.cap"));
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_append_fillsBlocksColumnwise);
+  RUN_TEST(test_gap_beginsBlockAndIsMarked);
+  RUN_TEST(test_markers_placedInFrontOfNextSample);
+  RUN_TEST(test_open_rejectsOtherFiles);
+  return UNITY_END();
+}
+
+void setUp() {
+  for (uint32_t idx = 0; idx < SAMPLES_COUNT; idx++) {
+    samples[idx].x = (int16_t)idx;
+    samples[idx].y = (int16_t)-idx;
+    samples[idx].z = (int16_t)(idx * 3U);
+  }
+}
+
+void tearDown() { unlink(PATH); }
+
+#include "../utils/run-tests.h"
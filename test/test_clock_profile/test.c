@@ -0,0 +1,182 @@
+#include "../../lib/clock_profile/src/clock_profile.h"
+#include <errno.h>
+#include <unity.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define ADXL345_MAX_SPI_HZ 5000000U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define SAMPLING_DELAY_NS 5000U
+
+void test_balanced_matchesCubeMx() {
+  const struct ClockProfile profile = CLOCKPROFILE_BALANCED_INITIALIZER;
+  TEST_ASSERT_EQUAL(0, ClockProfile_validate(&profile));
+
+  const uint32_t hclkHz = {ClockProfile_sysclkHz(&profile)};
+  TEST_ASSERT_EQUAL_UINT32(60000000U, hclkHz);
+  TEST_ASSERT_EQUAL_UINT32(CLOCKPROFILE_USB_HZ, ClockProfile_usbHz(&profile));
+  TEST_ASSERT_EQUAL(1, ClockProfile_flashLatency(hclkHz));
+  // SPI_BAUDRATEPRESCALER_16 and period 300 as generated
+  TEST_ASSERT_EQUAL(16, ClockProfile_spiDivisor(hclkHz / profile.apb2Divider,
+                                                ADXL345_MAX_SPI_HZ));
+  TEST_ASSERT_EQUAL(
+      300, ClockProfile_timerPeriod(
+               ClockProfile_timerClockHz(hclkHz, profile.apb1Divider),
+               SAMPLING_DELAY_NS));
+}
+
+void test_maxPerformance_keepsUsbClock() {
+  const struct ClockProfile profile = CLOCKPROFILE_MAX_PERFORMANCE_INITIALIZER;
+  TEST_ASSERT_EQUAL(0, ClockProfile_validate(&profile));
+
+  const uint32_t hclkHz = {ClockProfile_sysclkHz(&profile)};
+  TEST_ASSERT_EQUAL_UINT32(96000000U, hclkHz);
+  TEST_ASSERT_EQUAL_UINT32(CLOCKPROFILE_USB_HZ, ClockProfile_usbHz(&profile));
+  TEST_ASSERT_EQUAL(3, ClockProfile_flashLatency(hclkHz));
+  TEST_ASSERT_EQUAL(1, ClockProfile_voltageScale(hclkHz));
+  TEST_ASSERT_EQUAL(32, ClockProfile_spiDivisor(hclkHz / profile.apb2Divider,
+                                                ADXL345_MAX_SPI_HZ));
+  TEST_ASSERT_EQUAL(
+      480, ClockProfile_timerPeriod(
+               ClockProfile_timerClockHz(hclkHz, profile.apb1Divider),
+               SAMPLING_DELAY_NS));
+}
+
+void test_lowPower_keepsUsbClock() {
+  const struct ClockProfile profile = CLOCKPROFILE_LOW_POWER_INITIALIZER;
+  TEST_ASSERT_EQUAL(0, ClockProfile_validate(&profile));
+
+  const uint32_t hclkHz = {ClockProfile_sysclkHz(&profile)};
+  TEST_ASSERT_EQUAL_UINT32(24000000U, hclkHz);
+  TEST_ASSERT_EQUAL_UINT32(CLOCKPROFILE_USB_HZ, ClockProfile_usbHz(&profile));
+  TEST_ASSERT_EQUAL(0, ClockProfile_flashLatency(hclkHz));
+  TEST_ASSERT_EQUAL(3, ClockProfile_voltageScale(hclkHz));
+  TEST_ASSERT_EQUAL(8, ClockProfile_spiDivisor(hclkHz / profile.apb2Divider,
+                                               ADXL345_MAX_SPI_HZ));
+  TEST_ASSERT_EQUAL(
+      120, ClockProfile_timerPeriod(
+               ClockProfile_timerClockHz(hclkHz, profile.apb1Divider),
+               SAMPLING_DELAY_NS));
+}
+
+void test_validate_rejectsInvalidUsbClock() {
+  // 100MHz SYSCLK, USB 400MHz / 8 = 50MHz
+  const struct ClockProfile profile = {.pllM = 25,
+                                       .pllN = 400,
+                                       .pllP = 4,
+                                       .pllQ = 8,
+                                       .apb1Divider = 2,
+                                       .apb2Divider = 1};
+  TEST_ASSERT_EQUAL(-EINVAL, ClockProfile_validate(&profile));
+}
+
+void test_validate_rejectsPllLimits() {
+  struct ClockProfile profile = CLOCKPROFILE_LOW_POWER_INITIALIZER;
+  profile.pllP = 3;
+  TEST_ASSERT_EQUAL(-EINVAL, ClockProfile_validate(&profile));
+
+  // VCO input 500kHz
+  const struct ClockProfile slowInput = {.pllM = 50,
+                                         .pllN = 384,
+                                         .pllP = 8,
+                                         .pllQ = 4,
+                                         .apb1Divider = 1,
+                                         .apb2Divider = 1};
+  TEST_ASSERT_EQUAL(-EINVAL, ClockProfile_validate(&slowInput));
+}
+
+void test_validate_rejectsBusLimits() {
+  struct ClockProfile profile = CLOCKPROFILE_MAX_PERFORMANCE_INITIALIZER;
+  profile.apb1Divider = 1;
+  TEST_ASSERT_EQUAL(-EINVAL, ClockProfile_validate(&profile));
+
+  profile.apb1Divider = 3;
+  TEST_ASSERT_EQUAL(-EINVAL, ClockProfile_validate(&profile));
+}
+
+void test_flashLatency_boundaries() {
+  TEST_ASSERT_EQUAL(0, ClockProfile_flashLatency(30000000U));
+  TEST_ASSERT_EQUAL(1, ClockProfile_flashLatency(30000001U));
+  TEST_ASSERT_EQUAL(2, ClockProfile_flashLatency(84000000U));
+  TEST_ASSERT_EQUAL(3, ClockProfile_flashLatency(100000000U));
+}
+
+void test_spiDivisor_unreachable() {
+  TEST_ASSERT_EQUAL(2, ClockProfile_spiDivisor(10000000U, ADXL345_MAX_SPI_HZ));
+  TEST_ASSERT_EQUAL(0, ClockProfile_spiDivisor(2000000000U, 5000U));
+}
+
+void test_timerPeriod_roundsUp() {
+  TEST_ASSERT_EQUAL(2, ClockProfile_timerPeriod(1000000U, 1001U));
+  TEST_ASSERT_EQUAL(UINT16_MAX, ClockProfile_timerPeriod(100000000U, 1000000U));
+}
+
+/**
+ * Slowest prescaler the fake wiring fails at, 0 if reliable at all.
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t failingDivisor;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t verifyCount;
+
+static int doVerifyImpl(uint16_t divisor) {
+  verifyCount++;
+  return divisor <= failingDivisor ? -EIO : 0;
+}
+
+void test_calibrateSpiDivisor_keepsRatedClock() {
+  uint16_t fastest = {0};
+  TEST_ASSERT_EQUAL(16, ClockProfile_calibrateSpiDivisor(16, 4, doVerifyImpl,
+                                                         &fastest));
+  TEST_ASSERT_EQUAL(16, fastest);
+  TEST_ASSERT_EQUAL(4, verifyCount);
+}
+
+void test_calibrateSpiDivisor_addsMarginToSlowWiring() {
+  uint16_t fastest = {0};
+  failingDivisor = 32;
+  TEST_ASSERT_EQUAL(128, ClockProfile_calibrateSpiDivisor(16, 4, doVerifyImpl,
+                                                          &fastest));
+  TEST_ASSERT_EQUAL(64, fastest);
+
+  failingDivisor = 128;
+  TEST_ASSERT_EQUAL(256, ClockProfile_calibrateSpiDivisor(16, 4, doVerifyImpl,
+                                                          &fastest));
+  TEST_ASSERT_EQUAL(256, fastest);
+}
+
+void test_calibrateSpiDivisor_fallsBackToRatedClock() {
+  uint16_t fastest = {0};
+  failingDivisor = 256;
+  TEST_ASSERT_EQUAL(8, ClockProfile_calibrateSpiDivisor(8, 4, doVerifyImpl,
+                                                        &fastest));
+  TEST_ASSERT_EQUAL(0, fastest);
+  // one failing round per prescaler from 8 to 256
+  TEST_ASSERT_EQUAL(6, verifyCount);
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_balanced_matchesCubeMx);
+  RUN_TEST(test_maxPerformance_keepsUsbClock);
+  RUN_TEST(test_lowPower_keepsUsbClock);
+  RUN_TEST(test_validate_rejectsInvalidUsbClock);
+  RUN_TEST(test_validate_rejectsPllLimits);
+  RUN_TEST(test_validate_rejectsBusLimits);
+  RUN_TEST(test_flashLatency_boundaries);
+  RUN_TEST(test_spiDivisor_unreachable);
+  RUN_TEST(test_timerPeriod_roundsUp);
+  RUN_TEST(test_calibrateSpiDivisor_keepsRatedClock);
+  RUN_TEST(test_calibrateSpiDivisor_addsMarginToSlowWiring);
+  RUN_TEST(test_calibrateSpiDivisor_fallsBackToRatedClock);
+  return UNITY_END();
+}
+
+void setUp() {
+  failingDivisor = 0;
+  verifyCount = 0;
+}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
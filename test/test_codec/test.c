@@ -0,0 +1,121 @@
+#include "../../lib/codec/src/codec.h"
+#include "../../lib/codec/src/codec_packed.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unity.h>
+
+static void assertRoundTrip(const struct Codec_Acceleration *samples,
+                            uint8_t count, int expectedBytes) {
+  uint8_t block[CODEC_BLOCK_MAX_BYTES(CODEC_BLOCK_MAX_SAMPLES)] = {0};
+  struct Codec_Acceleration decoded[CODEC_BLOCK_MAX_SAMPLES] = {0};
+
+  const int bytes = {Codec_encodeBlock(samples, count, block)};
+  TEST_ASSERT_LESS_OR_EQUAL(CODEC_BLOCK_MAX_BYTES(count), bytes);
+  if (0 <= expectedBytes) {
+    TEST_ASSERT_EQUAL(expectedBytes, bytes);
+  }
+  TEST_ASSERT_EQUAL(bytes, Codec_blockSizeBytes(block, bytes));
+  TEST_ASSERT_EQUAL(count, Codec_decodeBlock(block, bytes, decoded,
+                                             CODEC_BLOCK_MAX_SAMPLES));
+  TEST_ASSERT_EQUAL_MEMORY(samples, decoded,
+                           count * sizeof(struct Codec_Acceleration));
+}
+
+void test_constantSignal_headerOnly() {
+  struct Codec_Acceleration samples[24];
+  for (uint8_t idx = 0; idx < 24; idx++) {
+    samples[idx] = (struct Codec_Acceleration){.x = -3, .y = 7, .z = 256};
+  }
+
+  assertRoundTrip(samples, 24, CODEC_BLOCK_HEADER_BYTES);
+  assertRoundTrip(samples, 1, CODEC_BLOCK_HEADER_BYTES);
+}
+
+void test_noisySignal_roundTripExact() {
+  struct Codec_Acceleration samples[CODEC_BLOCK_MAX_SAMPLES];
+  uint32_t seed = {12345};
+  for (uint8_t idx = 0; idx < CODEC_BLOCK_MAX_SAMPLES; idx++) {
+    seed = seed * 1103515245U + 12345U;
+    samples[idx].x = (int16_t)(100 + (int16_t)((seed >> 16U) % 31U) - 15);
+    samples[idx].y = (int16_t)(-200 + (int16_t)((seed >> 8U) % 7U) - 3);
+    samples[idx].z = (int16_t)(idx * 40);
+  }
+
+  // x: deltas within +-30 -> 6 bits, y: within +-6 -> 4 bits, z: 40 -> 7 bits
+  assertRoundTrip(samples, CODEC_BLOCK_MAX_SAMPLES,
+                  CODEC_BLOCK_HEADER_BYTES + (17 * 31 + 7) / 8);
+}
+
+void test_extremeDeltas_roundTripExact() {
+  const struct Codec_Acceleration samples[4] = {
+      {.x = INT16_MIN, .y = INT16_MAX, .z = 0},
+      {.x = INT16_MAX, .y = INT16_MIN, .z = -1},
+      {.x = INT16_MIN, .y = INT16_MAX, .z = 1},
+      {.x = 0, .y = 0, .z = 0}};
+
+  assertRoundTrip(samples, 4, -1);
+}
+
+void test_invalidBlocks_rejected() {
+  const struct Codec_Acceleration samples[2] = {{.x = 0}, {.x = 1000}};
+  uint8_t block[CODEC_BLOCK_MAX_BYTES(2)] = {0};
+  struct Codec_Acceleration decoded[2];
+
+  TEST_ASSERT_EQUAL(-EINVAL, Codec_encodeBlock(samples, 0, block));
+  TEST_ASSERT_EQUAL(-EINVAL, Codec_encodeBlock(
+                                 samples, CODEC_BLOCK_MAX_SAMPLES + 1, block));
+
+  const int bytes = {Codec_encodeBlock(samples, 2, block)};
+  TEST_ASSERT_EQUAL(-EAGAIN, Codec_blockSizeBytes(block, 3));
+  TEST_ASSERT_EQUAL(-EINVAL, Codec_decodeBlock(block, bytes - 1, decoded, 2));
+  TEST_ASSERT_EQUAL(-ENOMEM, Codec_decodeBlock(block, bytes, decoded, 1));
+
+  block[1] = CODEC_DELTA_MAX_BITS + 1;
+  TEST_ASSERT_EQUAL(-EINVAL, Codec_blockSizeBytes(block, bytes));
+}
+
+void test_packed13_roundTripAndSaturate() {
+  const struct Codec_Acceleration samples[2] = {
+      {.x = 4095, .y = -4096, .z = -1}, {.x = 0, .y = 1, .z = 5000}};
+  const struct Codec_Acceleration expected[2] = {
+      {.x = 4095, .y = -4096, .z = -1}, {.x = 0, .y = 1, .z = 4095}};
+  uint8_t packed[2 * 5] = {0};
+  struct Codec_Acceleration unpacked[2];
+
+  TEST_ASSERT_EQUAL(5, Codec_packedSizeBytes(Codec_Packing_13bit));
+  TEST_ASSERT_EQUAL(10, Codec_pack(Codec_Packing_13bit, samples, 2, packed));
+  TEST_ASSERT_EQUAL(0xFF, packed[0]);
+  TEST_ASSERT_EQUAL(0x0F, packed[1]);
+  TEST_ASSERT_EQUAL(10, Codec_unpack(Codec_Packing_13bit, packed, 2, unpacked));
+  TEST_ASSERT_EQUAL_MEMORY(expected, unpacked, sizeof(expected));
+}
+
+void test_packed10_roundTrip() {
+  const struct Codec_Acceleration samples[3] = {
+      {.x = 511, .y = -512, .z = 0}, {.x = -1, .y = 1, .z = -300}, {0}};
+  uint8_t packed[3 * 4] = {0};
+  struct Codec_Acceleration unpacked[3];
+
+  TEST_ASSERT_EQUAL(4, Codec_packedSizeBytes(Codec_Packing_10bit));
+  TEST_ASSERT_EQUAL(12, Codec_pack(Codec_Packing_10bit, samples, 3, packed));
+  TEST_ASSERT_EQUAL(12, Codec_unpack(Codec_Packing_10bit, packed, 3, unpacked));
+  TEST_ASSERT_EQUAL_MEMORY(samples, unpacked, sizeof(samples));
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_constantSignal_headerOnly);
+  RUN_TEST(test_noisySignal_roundTripExact);
+  RUN_TEST(test_extremeDeltas_roundTripExact);
+  RUN_TEST(test_invalidBlocks_rejected);
+  RUN_TEST(test_packed13_roundTripAndSaturate);
+  RUN_TEST(test_packed10_roundTrip);
+  return UNITY_END();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
@@ -0,0 +1,124 @@
+#include "../../lib/config_store/src/config_store.h"
+#include "../../lib/crc/src/crc.h"
+#include <errno.h>
+#include <string.h>
+#include <unity.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define RECORDS 4U
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct ConfigStore_Record sector[RECORDS];
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t eraseCount;
+
+/**
+ * Word offset at which programming fails, UINT32_MAX if never.
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint32_t failingOffset;
+
+static int doEraseImpl() {
+  memset(sector, 0xFF, sizeof(sector));
+  eraseCount++;
+  return 0;
+}
+
+static int doProgramWordImpl(uint32_t offset, uint32_t word) {
+  if (offset == failingOffset) {
+    return -EIO;
+  }
+  // programming only clears bits
+  ((uint32_t *)sector)[offset] &= word;
+  return 0;
+}
+
+static const struct ConfigStore_Handle store =
+    CONFIGSTORE_INITIALIZER(sector, sizeof(sector), doEraseImpl,
+                            doProgramWordImpl, Crc_crc32Words);
+
+void test_load_emptySector() {
+  struct ConfigStore_Config config = {.outputDataRate = 1};
+  TEST_ASSERT_EQUAL(-ENOENT, ConfigStore_load(&store, &config));
+  TEST_ASSERT_EQUAL(1, config.outputDataRate);
+}
+
+void test_save_loadsLastRecord() {
+  const struct ConfigStore_Config first = {
+      .outputDataRate = 15, .range = 3, .scale = 1};
+  const struct ConfigStore_Config second = {
+      .outputDataRate = 10, .range = 1, .scale = 0};
+  TEST_ASSERT_EQUAL(0, ConfigStore_save(&store, &first));
+  TEST_ASSERT_EQUAL(0, ConfigStore_save(&store, &second));
+
+  struct ConfigStore_Config config = {0};
+  TEST_ASSERT_EQUAL(0, ConfigStore_load(&store, &config));
+  TEST_ASSERT_EQUAL(10, config.outputDataRate);
+  TEST_ASSERT_EQUAL(1, config.range);
+  TEST_ASSERT_EQUAL(0, config.scale);
+  TEST_ASSERT_EQUAL(CONFIGSTORE_ERASED_WORD, sector[2].magic);
+  TEST_ASSERT_EQUAL(0, eraseCount);
+}
+
+void test_save_skipsUnchanged() {
+  const struct ConfigStore_Config config = {
+      .outputDataRate = 15, .range = 3, .scale = 1};
+  TEST_ASSERT_EQUAL(0, ConfigStore_save(&store, &config));
+  TEST_ASSERT_EQUAL(0, ConfigStore_save(&store, &config));
+  TEST_ASSERT_EQUAL(CONFIGSTORE_ERASED_WORD, sector[1].magic);
+}
+
+void test_save_erasesExhaustedSector() {
+  for (uint8_t idx = 0; idx <= RECORDS; idx++) {
+    const struct ConfigStore_Config config = {.outputDataRate = idx};
+    TEST_ASSERT_EQUAL(0, ConfigStore_save(&store, &config));
+  }
+  TEST_ASSERT_EQUAL(1, eraseCount);
+
+  struct ConfigStore_Config config = {0};
+  TEST_ASSERT_EQUAL(0, ConfigStore_load(&store, &config));
+  TEST_ASSERT_EQUAL(RECORDS, config.outputDataRate);
+  TEST_ASSERT_EQUAL(CONFIGSTORE_ERASED_WORD, sector[1].magic);
+}
+
+void test_load_skipsTornRecord() {
+  const struct ConfigStore_Config first = {.outputDataRate = 7};
+  const struct ConfigStore_Config second = {.outputDataRate = 8};
+  const struct ConfigStore_Config third = {.outputDataRate = 9};
+  TEST_ASSERT_EQUAL(0, ConfigStore_save(&store, &first));
+
+  // reset while programming the CRC of the second record
+  failingOffset = 2 * sizeof(struct ConfigStore_Record) / sizeof(uint32_t) - 1;
+  TEST_ASSERT_EQUAL(-EIO, ConfigStore_save(&store, &second));
+  failingOffset = UINT32_MAX;
+
+  struct ConfigStore_Config config = {0};
+  TEST_ASSERT_EQUAL(0, ConfigStore_load(&store, &config));
+  TEST_ASSERT_EQUAL(7, config.outputDataRate);
+
+  TEST_ASSERT_EQUAL(0, ConfigStore_save(&store, &third));
+  TEST_ASSERT_EQUAL(0, ConfigStore_load(&store, &config));
+  TEST_ASSERT_EQUAL(9, config.outputDataRate);
+  TEST_ASSERT_EQUAL(CONFIGSTORE_MAGIC, sector[2].magic);
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_load_emptySector);
+  RUN_TEST(test_save_loadsLastRecord);
+  RUN_TEST(test_save_skipsUnchanged);
+  RUN_TEST(test_save_erasesExhaustedSector);
+  RUN_TEST(test_load_skipsTornRecord);
+  return UNITY_END();
+}
+
+void setUp() {
+  memset(sector, 0xFF, sizeof(sector));
+  eraseCount = 0;
+  failingOffset = UINT32_MAX;
+}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
@@ -0,0 +1,92 @@
+#include "../../lib/controller/src/controller.h"
+#include <errno.h>
+#include <unity.h>
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct Controller_Responses responses;
+
+void test_takeResponse_empty() {
+  TEST_ASSERT_FALSE(Controller_hasResponses(&responses));
+  TEST_ASSERT_EQUAL(-ENODATA, Controller_takeResponse(&responses));
+}
+
+void test_takeResponse_priorityOrder() {
+  Controller_requestResponse(&responses, Controller_Response_CaptureChunk);
+  Controller_requestResponse(&responses, Controller_Response_Uptime);
+  Controller_requestResponse(&responses, Controller_Response_FirmwareVersion);
+  Controller_requestResponse(&responses, Controller_Response_FifoOverflow);
+
+  TEST_ASSERT_TRUE(Controller_hasResponses(&responses));
+  TEST_ASSERT_EQUAL(Controller_Response_FirmwareVersion,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(Controller_Response_Uptime,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(Controller_Response_FifoOverflow,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(Controller_Response_CaptureChunk,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(-ENODATA, Controller_takeResponse(&responses));
+}
+
+void test_takeResponse_coalescesDuplicates() {
+  Controller_requestResponse(&responses, Controller_Response_BufferStatus);
+  Controller_requestResponse(&responses, Controller_Response_BufferStatus);
+  Controller_requestResponse(&responses, Controller_Response_BufferStatus);
+
+  TEST_ASSERT_EQUAL(Controller_Response_BufferStatus,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(-ENODATA, Controller_takeResponse(&responses));
+}
+
+void test_takeResponse_stopSequence() {
+  // requested in reverse, transmitted in order of the stop sequence
+  Controller_requestResponse(&responses, Controller_Response_SamplingStopped);
+  Controller_requestResponse(&responses, Controller_Response_DeviceSetup);
+  Controller_requestResponse(&responses, Controller_Response_BufferStatus);
+  Controller_requestResponse(&responses, Controller_Response_FirmwareVersion);
+
+  TEST_ASSERT_EQUAL(Controller_Response_FirmwareVersion,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(Controller_Response_BufferStatus,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(Controller_Response_DeviceSetup,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_EQUAL(Controller_Response_SamplingStopped,
+                    Controller_takeResponse(&responses));
+  TEST_ASSERT_FALSE(Controller_hasResponses(&responses));
+}
+
+void test_takeResponse_lastResponse() {
+  const enum Controller_Response last = {Controller_Response_Count - 1};
+  Controller_requestResponse(&responses, last);
+  TEST_ASSERT_EQUAL(last, Controller_takeResponse(&responses));
+}
+
+void test_events_takeClears() {
+  struct Controller_Events events = {.pending = 0};
+  Controller_postEvents(&events, Controller_Event_FifoWatermark);
+  Controller_postEvents(&events, Controller_Event_HostRequest);
+
+  TEST_ASSERT_TRUE(Controller_hasEvents(&events));
+  TEST_ASSERT_EQUAL_HEX32(Controller_Event_FifoWatermark |
+                              Controller_Event_HostRequest,
+                          Controller_takeEvents(&events));
+  TEST_ASSERT_FALSE(Controller_hasEvents(&events));
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_takeResponse_empty);
+  RUN_TEST(test_takeResponse_priorityOrder);
+  RUN_TEST(test_takeResponse_coalescesDuplicates);
+  RUN_TEST(test_takeResponse_stopSequence);
+  RUN_TEST(test_takeResponse_lastResponse);
+  RUN_TEST(test_events_takeClears);
+  return UNITY_END();
+}
+
+void setUp() { responses.pending = 0; }
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
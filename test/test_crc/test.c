@@ -0,0 +1,29 @@
+#include "../../lib/crc/src/crc.h"
+#include <inttypes.h>
+#include <unity.h>
+
+void test_empty_initialValue() {
+  TEST_ASSERT_EQUAL_HEX32(CRC_CRC32_INITIAL, Crc_crc32Words(NULL, 0));
+}
+
+void test_words_matchCrcUnit() {
+  // reference values as computed by the STM32F4 CRC unit
+  const uint32_t single[] = {0x12345678UL};
+  const uint32_t ascii[] = {0x34333231UL, 0x38373635UL};
+
+  TEST_ASSERT_EQUAL_HEX32(0xDF8A8A2BUL, Crc_crc32Words(single, 1));
+  TEST_ASSERT_EQUAL_HEX32(0xFEFC54F9UL, Crc_crc32Words(ascii, 2));
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_initialValue);
+  RUN_TEST(test_words_matchCrcUnit);
+  return UNITY_END();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
@@ -0,0 +1,200 @@
+#include "../../lib/host_transport/src/from_host_transport.h"
+#include "../../lib/host_transport/src/host_transport.h"
+#include "../../lib/host_transport/src/host_transport_types.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unity.h>
+
+#define MAX_TAKEN_REQUESTS 32
+
+static uint8_t takenIds[MAX_TAKEN_REQUESTS];
+static uint16_t takenSamplesCount[MAX_TAKEN_REQUESTS];
+static uint8_t takenCount;
+
+static int takeReceivedPacket(const uint8_t *buffer) {
+  const struct TransportFrame *request = (const struct TransportFrame *)buffer;
+  if (takenCount < MAX_TAKEN_REQUESTS) {
+    takenIds[takenCount] = request->header.id;
+    takenSamplesCount[takenCount] =
+        request->asRxFrame.asSamplingStart.max_samples_count;
+    takenCount++;
+  }
+  return 0;
+}
+
+#define DECLARE_HANDLE                                                         \
+  struct HostTransport_Handle handle = {                                       \
+      .fromHost = {.queue = {.head = 0, .tail = 0, .droppedCount = 0},         \
+                   .doTakeReceivedPacketImpl = takeReceivedPacket}}
+
+void test_empty_nothingDispatched() {
+  DECLARE_HANDLE;
+
+  TEST_ASSERT_EQUAL(false, TransportRx_hasPending(&handle));
+  TEST_ASSERT_EQUAL(0, TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(0, takenCount);
+}
+
+void test_invalidRequest_notQueued() {
+  DECLARE_HANDLE;
+  const uint8_t unknown[] = {Transport_HeaderId_Tx_Acceleration};
+
+  TEST_ASSERT_EQUAL(-EINVAL, TransportRx_Process(&handle, NULL, 1));
+  TEST_ASSERT_EQUAL(-EINVAL, TransportRx_Process(&handle, unknown, 1));
+  TEST_ASSERT_EQUAL(false, TransportRx_hasPending(&handle));
+  TEST_ASSERT_EQUAL(1, handle.fromHost.parser.discardedBytes);
+}
+
+void test_requests_dispatchedInOrder() {
+  DECLARE_HANDLE;
+  const uint8_t getUptime[] = {Transport_HeaderId_Rx_GetUptime};
+  const uint8_t start[] = {Transport_HeaderId_Rx_SamplingStart, 0x34, 0x12};
+
+  TEST_ASSERT_EQUAL(1, TransportRx_Process(&handle, getUptime, 1));
+  TEST_ASSERT_EQUAL(1, TransportRx_Process(&handle, start, 3));
+  TEST_ASSERT_EQUAL(true, TransportRx_hasPending(&handle));
+  TEST_ASSERT_EQUAL(0, takenCount);
+
+  TEST_ASSERT_EQUAL(2, TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(false, TransportRx_hasPending(&handle));
+  TEST_ASSERT_EQUAL(2, takenCount);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_GetUptime, takenIds[0]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_SamplingStart, takenIds[1]);
+  TEST_ASSERT_EQUAL(0x1234, takenSamplesCount[1]);
+}
+
+void test_concatenatedRequests_allQueued() {
+  DECLARE_HANDLE;
+  const uint8_t setup[] = {
+      Transport_HeaderId_Rx_SetOutputDataRate,
+      TransportRx_SetOutputDataRate_Rate3200,
+      Transport_HeaderId_Rx_SetRange,
+      TransportRx_SetRange_Range_16g,
+      Transport_HeaderId_Rx_SetScale,
+      TransportRx_SetScale_Scale_full4mg,
+      Transport_HeaderId_Rx_SamplingStart,
+      0x00,
+      0x10,
+  };
+
+  TEST_ASSERT_EQUAL(4, TransportRx_Process(&handle, setup, sizeof(setup)));
+  TEST_ASSERT_EQUAL(4, TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_SetOutputDataRate, takenIds[0]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_SetRange, takenIds[1]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_SetScale, takenIds[2]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_SamplingStart, takenIds[3]);
+  TEST_ASSERT_EQUAL(0x1000, takenSamplesCount[3]);
+}
+
+void test_fragmentedRequest_reassembled() {
+  DECLARE_HANDLE;
+  const uint8_t first[] = {Transport_HeaderId_Rx_GetRange,
+                           Transport_HeaderId_Rx_SamplingStart};
+  const uint8_t second[] = {0x78};
+  const uint8_t third[] = {0x56, Transport_HeaderId_Rx_SamplingStop};
+
+  TEST_ASSERT_EQUAL(1, TransportRx_Process(&handle, first, sizeof(first)));
+  TEST_ASSERT_EQUAL(0, TransportRx_Process(&handle, second, sizeof(second)));
+  TEST_ASSERT_EQUAL(2, TransportRx_Process(&handle, third, sizeof(third)));
+
+  TEST_ASSERT_EQUAL(3, TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_GetRange, takenIds[0]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_SamplingStart, takenIds[1]);
+  TEST_ASSERT_EQUAL(0x5678, takenSamplesCount[1]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_SamplingStop, takenIds[2]);
+}
+
+void test_configureAndStart_queuedAsOneRequest() {
+  DECLARE_HANDLE;
+  const uint8_t request[] = {Transport_HeaderId_Rx_ConfigureAndStart,
+                             TransportRx_SetOutputDataRate_Rate1600,
+                             TransportRx_SetRange_Range_4g,
+                             TransportRx_SetScale_Scale_10bit,
+                             16,
+                             0x00,
+                             0x20,
+                             Transport_SampleFormat_Acceleration,
+                             Transport_HeaderId_Rx_GetUptime};
+
+  TEST_ASSERT_EQUAL(2, TransportRx_Process(&handle, request, sizeof(request)));
+  TEST_ASSERT_EQUAL(2, TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_ConfigureAndStart, takenIds[0]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_GetUptime, takenIds[1]);
+}
+
+void test_garbage_skippedUntilKnownId() {
+  DECLARE_HANDLE;
+  const uint8_t bytes[] = {0x00, 0xFF, Transport_HeaderId_Tx_Uptime,
+                           Transport_HeaderId_Rx_GetScale};
+
+  TEST_ASSERT_EQUAL(-EINVAL, TransportRx_Process(&handle, bytes, 4));
+  TEST_ASSERT_EQUAL(3, handle.fromHost.parser.discardedBytes);
+  TEST_ASSERT_EQUAL(1, TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_GetScale, takenIds[0]);
+}
+
+void test_resetParser_discardsFragment() {
+  DECLARE_HANDLE;
+  const uint8_t fragment[] = {Transport_HeaderId_Rx_SamplingStart, 0x01};
+  const uint8_t getUptime[] = {Transport_HeaderId_Rx_GetUptime};
+
+  TEST_ASSERT_EQUAL(0, TransportRx_Process(&handle, fragment, 2));
+  TransportRx_ResetParser(&handle);
+  TEST_ASSERT_EQUAL(1, TransportRx_Process(&handle, getUptime, 1));
+
+  TEST_ASSERT_EQUAL(1, TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Rx_GetUptime, takenIds[0]);
+}
+
+void test_fullQueue_dropsAndRecovers() {
+  DECLARE_HANDLE;
+  const uint8_t getUptime[] = {Transport_HeaderId_Rx_GetUptime};
+
+  for (uint8_t idx = 0; idx < TRANSPORTRX_REQUEST_QUEUE_ITEMS; idx++) {
+    TEST_ASSERT_EQUAL(1, TransportRx_Process(&handle, getUptime, 1));
+  }
+  TEST_ASSERT_EQUAL(-ENOMEM, TransportRx_Process(&handle, getUptime, 1));
+  TEST_ASSERT_EQUAL(1, handle.fromHost.queue.droppedCount);
+
+  TEST_ASSERT_EQUAL(TRANSPORTRX_REQUEST_QUEUE_ITEMS,
+                    TransportRx_DispatchPending(&handle));
+  TEST_ASSERT_EQUAL(1, TransportRx_Process(&handle, getUptime, 1));
+  TEST_ASSERT_EQUAL(1, TransportRx_DispatchPending(&handle));
+}
+
+void test_indexWrapAround_keepsOrder() {
+  DECLARE_HANDLE;
+  uint8_t start[] = {Transport_HeaderId_Rx_SamplingStart, 0, 0};
+
+  // run indices across the uint8_t boundary several times
+  for (uint16_t idx = 0; idx < 1000; idx++) {
+    start[1] = idx & 0xFFU;
+    start[2] = idx >> 8U;
+    TEST_ASSERT_EQUAL(1, TransportRx_Process(&handle, start, 3));
+    takenCount = 0;
+    TEST_ASSERT_EQUAL(1, TransportRx_DispatchPending(&handle));
+    TEST_ASSERT_EQUAL(idx, takenSamplesCount[0]);
+  }
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_nothingDispatched);
+  RUN_TEST(test_invalidRequest_notQueued);
+  RUN_TEST(test_requests_dispatchedInOrder);
+  RUN_TEST(test_concatenatedRequests_allQueued);
+  RUN_TEST(test_fragmentedRequest_reassembled);
+  RUN_TEST(test_configureAndStart_queuedAsOneRequest);
+  RUN_TEST(test_garbage_skippedUntilKnownId);
+  RUN_TEST(test_resetParser_discardsFragment);
+  RUN_TEST(test_fullQueue_dropsAndRecovers);
+  RUN_TEST(test_indexWrapAround_keepsOrder);
+  return UNITY_END();
+}
+
+void setUp() { takenCount = 0; }
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
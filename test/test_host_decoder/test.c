@@ -0,0 +1,327 @@
+#include "../../lib/codec/src/codec.h"
+#include "../../lib/codec/src/codec_packed.h"
+#include "../../lib/crc/src/crc.h"
+#include "../../lib/host_decoder/src/host_decoder.h"
+#include "../../lib/host_transport/src/host_transport_types.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unity.h>
+
+#define MAX_EVENTS 16U
+
+#define MAX_BLOCKS 4U
+
+static struct HostDecoder_Sample samples[MAX_EVENTS];
+static uint8_t samplesCount;
+static uint8_t frameIds[MAX_EVENTS];
+static uint8_t framesCount;
+static struct HostDecoder_Block blocks[MAX_BLOCKS];
+static uint8_t blocksCount;
+/// number of blocks handed out before each frame
+static uint8_t blocksBeforeFrame[MAX_EVENTS];
+
+static void onFrame(void *context, const struct TransportFrame *frame,
+                    uint16_t frameBytes) {
+  if (framesCount < MAX_EVENTS) {
+    blocksBeforeFrame[framesCount] = blocksCount;
+    frameIds[framesCount++] = frame->header.id;
+  }
+}
+
+static void onSample(void *context, const struct HostDecoder_Sample *sample) {
+  if (samplesCount < MAX_EVENTS) {
+    samples[samplesCount++] = *sample;
+  }
+}
+
+static void onBlock(void *context, const struct HostDecoder_Block *block) {
+  if (blocksCount < MAX_BLOCKS) {
+    blocks[blocksCount++] = *block;
+  }
+}
+
+/**
+ * Appends an acceleration frame.
+ *
+ * @return number of bytes written
+ */
+static uint16_t putAcceleration(uint8_t *bytes, uint16_t index, int16_t x) {
+  struct TransportFrame *frame = {(struct TransportFrame *)bytes};
+  frame->header.id = Transport_HeaderId_Tx_Acceleration;
+  frame->asTxFrame.asAcceleration.index = index;
+  frame->asTxFrame.asAcceleration.values.x = x;
+  frame->asTxFrame.asAcceleration.values.y = (int16_t)-x;
+  frame->asTxFrame.asAcceleration.values.z = 256;
+  return SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration);
+}
+
+/**
+ * Wraps chunk into a stream frame as the controller does.
+ *
+ * @return size of stream frame
+ */
+static uint16_t putStreamFrame(uint32_t *words, uint16_t sequence,
+                               const uint8_t *chunk, uint16_t chunkBytes) {
+  const uint16_t headerBytes = {sizeof(struct Transport_StreamFrameHeader)};
+  uint8_t *bytes = {(uint8_t *)words};
+  struct Transport_StreamFrameHeader *header = {
+      (struct Transport_StreamFrameHeader *)bytes};
+  header->sync = TRANSPORT_STREAM_SYNC;
+  header->length = chunkBytes;
+  header->sequence = sequence;
+
+  const uint16_t paddedBytes = {headerBytes + ((chunkBytes + 3U) & ~3U)};
+  memset(&bytes[headerBytes], 0, paddedBytes - headerBytes);
+  memcpy(&bytes[headerBytes], chunk, chunkBytes);
+  words[paddedBytes / 4U] = Crc_crc32Words(words, paddedBytes / 4U);
+  return paddedBytes + sizeof(uint32_t);
+}
+
+void setUp() {
+  samplesCount = 0;
+  framesCount = 0;
+  blocksCount = 0;
+}
+
+void tearDown() {}
+
+void test_framesSplitBytewise_reassembled() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  uint8_t bytes[64] = {Transport_HeaderId_Tx_SamplingStarted, 0x10, 0x00};
+  uint16_t count = {3};
+  count += putAcceleration(&bytes[count], 7, 100);
+  count += putAcceleration(&bytes[count], 8, -100);
+  bytes[count++] = Transport_HeaderId_Tx_SamplingFinished;
+
+  for (uint16_t idx = 0; idx < count; idx++) {
+    HostDecoder_feed(&decoder, &bytes[idx], 1);
+  }
+
+  TEST_ASSERT_EQUAL(2, samplesCount);
+  TEST_ASSERT_EQUAL(7, samples[0].index);
+  TEST_ASSERT_EQUAL(100, samples[0].values.x);
+  TEST_ASSERT_EQUAL(-100, samples[0].values.y);
+  TEST_ASSERT_EQUAL(256, samples[0].values.z);
+  TEST_ASSERT_EQUAL(8, samples[1].index);
+  TEST_ASSERT_EQUAL(2, framesCount);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Tx_SamplingStarted, frameIds[0]);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Tx_SamplingFinished, frameIds[1]);
+  TEST_ASSERT_EQUAL(0, decoder.statistics.discardedBytes);
+}
+
+void test_garbage_discardedUntilInSync() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  uint8_t bytes[32] = {0xFF, 0x00, Transport_HeaderId_Rx_SamplingStart};
+  uint16_t count = {3};
+  count += putAcceleration(&bytes[count], 1, 5);
+
+  HostDecoder_feed(&decoder, bytes, count);
+
+  TEST_ASSERT_EQUAL(3, decoder.statistics.discardedBytes);
+  TEST_ASSERT_EQUAL(1, samplesCount);
+  TEST_ASSERT_EQUAL(1, samples[0].index);
+}
+
+void test_sensorTag_assignsFollowingSamples() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  uint8_t bytes[32];
+  struct TransportFrame *tag = {(struct TransportFrame *)bytes};
+  tag->header.id = Transport_HeaderId_Tx_AccelerationSensor;
+  tag->asTxFrame.asAccelerationSensor.sensor = 1;
+  tag->asTxFrame.asAccelerationSensor.count = 1;
+  tag->asTxFrame.asAccelerationSensor.firstIndex = 3;
+  tag->asTxFrame.asAccelerationSensor.timerTicks = 0;
+  uint16_t count = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSensor)};
+  count += putAcceleration(&bytes[count], 3, 0);
+
+  HostDecoder_feed(&decoder, bytes, count);
+
+  TEST_ASSERT_EQUAL(1, framesCount);
+  TEST_ASSERT_EQUAL(1, samplesCount);
+  TEST_ASSERT_EQUAL(1, samples[0].sensor);
+}
+
+void test_streamFrames_verifiedAndUnwrapped() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  uint8_t chunk[32];
+  uint16_t chunkBytes = {putAcceleration(chunk, 0, 1)};
+  chunkBytes += putAcceleration(&chunk[chunkBytes], 1, 2);
+
+  uint32_t words[3][16];
+  const uint16_t frameBytes = {putStreamFrame(words[0], 0, chunk, chunkBytes)};
+  putStreamFrame(words[1], 1, chunk, chunkBytes);
+  putStreamFrame(words[2], 2, chunk, chunkBytes);
+
+  // misaligned, split and corrupted
+  uint8_t stream[1 + 3 * sizeof(words[0])];
+  memcpy(&stream[1], words[0], frameBytes);
+  memcpy(&stream[1 + frameBytes], words[1], frameBytes);
+  memcpy(&stream[1 + 2 * frameBytes], words[2], frameBytes);
+  stream[1 + frameBytes + 12] ^= 0x01U;
+
+  HostDecoder_feed(&decoder, &stream[1], 5);
+  HostDecoder_feed(&decoder, &stream[6], 3 * frameBytes - 5);
+
+  TEST_ASSERT_EQUAL(1, decoder.statistics.crcErrorCount);
+  TEST_ASSERT_EQUAL(1, decoder.statistics.lostStreamFramesCount);
+  TEST_ASSERT_EQUAL(frameBytes, decoder.statistics.discardedBytes);
+  TEST_ASSERT_EQUAL(4, samplesCount);
+  TEST_ASSERT_EQUAL(0, framesCount);
+}
+
+void test_frameSize_variableFrames() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  const uint8_t axes[] = {Transport_HeaderId_Tx_AccelerationAxes, 0, 0, 2, 0,
+                          Transport_Axis_X | Transport_Axis_Z};
+  const uint8_t chunk[] = {Transport_HeaderId_Tx_CaptureChunk, 0, 0, 9, 0, 3};
+
+  TEST_ASSERT_EQUAL(0, HostDecoder_frameSizeBytes(&decoder, axes, 5, false));
+  TEST_ASSERT_EQUAL(6 + 2 * 4,
+                    HostDecoder_frameSizeBytes(&decoder, axes, 6, false));
+  TEST_ASSERT_EQUAL(6 + 3 * 6,
+                    HostDecoder_frameSizeBytes(&decoder, chunk, 6, false));
+
+  decoder.axes = Transport_Axis_Y;
+  TEST_ASSERT_EQUAL(6 + 3 * 2,
+                    HostDecoder_frameSizeBytes(&decoder, chunk, 6, false));
+}
+
+void test_accelerationRun_splitIntoBlocks() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  static uint8_t bytes[360 * 9];
+  uint16_t count = {0};
+  for (uint16_t idx = 0; idx < 100U; idx++) {
+    count += putAcceleration(&bytes[count], idx, (int16_t)idx);
+  }
+  // 100 samples lost
+  for (uint16_t idx = 200; idx < 460U; idx++) {
+    count += putAcceleration(&bytes[count], idx, (int16_t)idx);
+  }
+
+  HostDecoder_feed(&decoder, bytes, count);
+
+  TEST_ASSERT_EQUAL(360, decoder.statistics.framesCount);
+  TEST_ASSERT_EQUAL(360, decoder.statistics.samplesCount);
+  TEST_ASSERT_EQUAL(3, decoder.statistics.blocksCount);
+  TEST_ASSERT_EQUAL(3, blocksCount);
+  TEST_ASSERT_EQUAL(0, blocks[0].firstIndex);
+  TEST_ASSERT_EQUAL(100, blocks[0].count);
+  TEST_ASSERT_EQUAL(200, blocks[1].firstIndex);
+  TEST_ASSERT_EQUAL(HOSTDECODER_BLOCK_SAMPLES, blocks[1].count);
+  TEST_ASSERT_EQUAL(456, blocks[2].firstIndex);
+  TEST_ASSERT_EQUAL(4, blocks[2].count);
+  TEST_ASSERT_EQUAL(299, blocks[1].x[99]);
+  TEST_ASSERT_EQUAL(-299, blocks[1].y[99]);
+  TEST_ASSERT_EQUAL(256, blocks[1].z[99]);
+  TEST_ASSERT_EQUAL(459, blocks[2].x[3]);
+
+  // samples are handed out one by one as well
+  TEST_ASSERT_EQUAL(MAX_EVENTS, samplesCount);
+  TEST_ASSERT_EQUAL(15, samples[15].index);
+  TEST_ASSERT_EQUAL(15, samples[15].values.x);
+}
+
+void test_sampleFormats_decodedIntoOneBlock() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  uint8_t bytes[128] = {0};
+  uint16_t count = {0};
+
+  // samples 0..2 as structure of arrays
+  const uint8_t soa[] = {Transport_HeaderId_Tx_AccelerationSoa, 0, 0, 3};
+  memcpy(bytes, soa, sizeof(soa));
+  const int16_t columns[3][4] = {{1, 2, 3}, {-1, -2, -3}, {10, 20, 30}};
+  memcpy(&bytes[sizeof(soa)], columns, sizeof(columns));
+  count += sizeof(soa) + sizeof(columns);
+
+  // samples 3..4 reduced to x and z
+  const uint8_t axes[] = {
+      Transport_HeaderId_Tx_AccelerationAxes, 3, 0, 2, 0,
+      Transport_Axis_X | Transport_Axis_Z, 4, 0, 40, 0, 5, 0, 50, 0};
+  memcpy(&bytes[count], axes, sizeof(axes));
+  count += sizeof(axes);
+
+  // samples 5..6 bit-packed and compressed
+  const struct Codec_Acceleration values[] = {{6, -6, 60}, {7, -7, 70}};
+  const uint8_t packed[] = {Transport_HeaderId_Tx_AccelerationPacked, 5, 0, 1,
+                            0, Transport_SampleFormat_Packed13};
+  memcpy(&bytes[count], packed, sizeof(packed));
+  count += sizeof(packed);
+  count += Codec_pack(Codec_Packing_13bit, values, 1, &bytes[count]);
+
+  const uint8_t delta[] = {Transport_HeaderId_Tx_AccelerationDelta, 6, 0};
+  memcpy(&bytes[count], delta, sizeof(delta));
+  count += sizeof(delta);
+  count += Codec_encodeBlock(&values[1], 1, &bytes[count]);
+
+  bytes[count++] = Transport_HeaderId_Tx_SamplingFinished;
+
+  HostDecoder_feed(&decoder, bytes, count);
+
+  TEST_ASSERT_EQUAL(0, decoder.statistics.discardedBytes);
+  TEST_ASSERT_EQUAL(1, blocksCount);
+  TEST_ASSERT_EQUAL(7, blocks[0].count);
+  TEST_ASSERT_EQUAL(0, blocks[0].firstIndex);
+  TEST_ASSERT_EQUAL(3, blocks[0].x[2]);
+  TEST_ASSERT_EQUAL(-3, blocks[0].y[2]);
+  TEST_ASSERT_EQUAL(30, blocks[0].z[2]);
+  TEST_ASSERT_EQUAL(5, blocks[0].x[4]);
+  TEST_ASSERT_EQUAL(0, blocks[0].y[4]);
+  TEST_ASSERT_EQUAL(50, blocks[0].z[4]);
+  TEST_ASSERT_EQUAL(-6, blocks[0].y[5]);
+  TEST_ASSERT_EQUAL(70, blocks[0].z[6]);
+
+  // the samples precede the event
+  TEST_ASSERT_EQUAL(1, framesCount);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Tx_SamplingFinished, frameIds[0]);
+  TEST_ASSERT_EQUAL(1, blocksBeforeFrame[0]);
+}
+
+void test_sensorTag_beginsBlock() {
+  struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(onFrame, onSample, onBlock, NULL);
+  uint8_t bytes[64];
+  uint16_t count = {putAcceleration(bytes, 0, 0)};
+  struct TransportFrame *tag = {(struct TransportFrame *)&bytes[count]};
+  tag->header.id = Transport_HeaderId_Tx_AccelerationSensor;
+  tag->asTxFrame.asAccelerationSensor.sensor = 1;
+  tag->asTxFrame.asAccelerationSensor.count = 1;
+  tag->asTxFrame.asAccelerationSensor.firstIndex = 1;
+  tag->asTxFrame.asAccelerationSensor.timerTicks = 0;
+  count += SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSensor);
+  count += putAcceleration(&bytes[count], 1, 0);
+
+  // split within the tag
+  HostDecoder_feed(&decoder, bytes, 12);
+  HostDecoder_feed(&decoder, &bytes[12], count - 12U);
+
+  TEST_ASSERT_EQUAL(2, blocksCount);
+  TEST_ASSERT_EQUAL(0, blocks[0].sensor);
+  TEST_ASSERT_EQUAL(1, blocks[1].sensor);
+  TEST_ASSERT_EQUAL(1, blocks[1].firstIndex);
+  TEST_ASSERT_EQUAL(1, blocksBeforeFrame[0]);
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_framesSplitBytewise_reassembled);
+  RUN_TEST(test_garbage_discardedUntilInSync);
+  RUN_TEST(test_sensorTag_assignsFollowingSamples);
+  RUN_TEST(test_streamFrames_verifiedAndUnwrapped);
+  RUN_TEST(test_frameSize_variableFrames);
+  RUN_TEST(test_accelerationRun_splitIntoBlocks);
+  RUN_TEST(test_sampleFormats_decodedIntoOneBlock);
+  RUN_TEST(test_sensorTag_beginsBlock);
+  return UNITY_END();
+}
+
+#include "../utils/run-tests.h"
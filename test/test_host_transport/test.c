@@ -0,0 +1,460 @@
+#include "../../lib/codec/src/codec.h"
+#include "../../lib/crc/src/crc.h"
+#include "../../lib/host_transport/src/host_transport.h"
+#include "../../lib/host_transport/src/host_transport_types.h"
+#include "../../lib/host_transport/src/to_host_transport.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unity.h>
+
+#define STORAGE_SIZE_BYTES 90U
+
+static uint8_t storage[STORAGE_SIZE_BYTES];
+
+#define DECLARE_HANDLE                                                         \
+  struct HostTransport_Handle handle = {                                       \
+      .toHost = {.ringbuffer = {.storage = storage},                           \
+                 .axes = Transport_Axis_All}}
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define STREAM_STORAGE_SIZE_BYTES 8192U
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define SENT_MAX_BYTES 8192U
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TRANSFERS_MAX 32U
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t streamStorage[STREAM_STORAGE_SIZE_BYTES];
+
+/**
+ * All bytes passed to doTransmitImpl() in order.
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t sent[SENT_MAX_BYTES];
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t sentBytes;
+
+/**
+ * Size of each transfer passed to doTransmitImpl().
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t transferBytes[TRANSFERS_MAX];
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t transfersCount;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static bool isBusy;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint32_t tickMs;
+
+static enum HostTransport_Status doTransmitImpl(uint8_t *buffer,
+                                                uint16_t length) {
+  for (uint16_t idx = 0; idx < length; idx++) {
+    sent[sentBytes++] = buffer[idx];
+  }
+  transferBytes[transfersCount++] = length;
+  return HostTransport_Status_Ok;
+}
+
+static volatile bool isTransmitBusyImpl() { return isBusy; }
+
+static uint32_t getTickMsImpl() { return tickMs; }
+
+#define DECLARE_STREAM_HANDLE                                                  \
+  struct HostTransport_Handle handle = {                                       \
+      .toHost = {.ringbuffer = {.storage = streamStorage},                     \
+                 .axes = Transport_Axis_All,                                   \
+                 .doTransmitImpl = doTransmitImpl,                             \
+                 .isTransmitBusyImpl = isTransmitBusyImpl,                     \
+                 .doCrc32WordsImpl = Crc_crc32Words,                           \
+                 .getTickMsImpl = getTickMsImpl}}
+
+/**
+ * Fills samples with values far apart so that blocks compress poorly and
+ * vary in size.
+ */
+static void fillSamples(struct Transport_Acceleration *samples, uint8_t count,
+                        uint8_t seed) {
+  for (uint8_t idx = 0; idx < count; idx++) {
+    samples[idx].x = (int16_t)(seed * 977 + idx * 4099);
+    samples[idx].y = (int16_t)(seed * 31 - idx * 7919);
+    samples[idx].z = (int16_t)((idx & 1U) ? seed : -seed * idx);
+  }
+}
+
+/**
+ * Determines the size of the frame transmitted at offset from its header.
+ *
+ * @return 0 if the frame is unknown
+ */
+static uint16_t sentFrameBytes(uint16_t offset) {
+  const struct TransportFrame *frame = {
+      (const struct TransportFrame *)&sent[offset]};
+  switch (frame->header.id) {
+  case Transport_HeaderId_Tx_AccelerationDelta: {
+    const uint16_t headerBytes = {
+        SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationDelta)};
+    const int blockBytes = {Codec_blockSizeBytes(
+        &sent[offset + headerBytes], sentBytes - offset - headerBytes)};
+    return (0 > blockBytes) ? 0 : headerBytes + blockBytes;
+  }
+  case Transport_HeaderId_Tx_AccelerationSoa:
+    return SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSoa) +
+           3U * TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(
+                    frame->asTxFrame.asAccelerationSoa.count);
+  case Transport_HeaderId_Tx_Uptime:
+    return SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Uptime);
+  default:
+    return 0;
+  }
+}
+
+/**
+ * Piles up more variable sized frames than one transfer takes, sends a
+ * response in between and expects the response right after a whole frame.
+ */
+static void assertResponseFollowsWholeFrames(uint8_t format, uint8_t count) {
+  DECLARE_STREAM_HANDLE;
+  TEST_ASSERT_EQUAL(
+      0, Transport_setFormat(&handle, format, STREAM_STORAGE_SIZE_BYTES));
+
+  struct Transport_Acceleration
+      samples[TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES];
+  isBusy = true;
+  // more than the transfer and the flush ahead of the response take
+  for (uint8_t block = 0;
+       Ringbuffer_itemsCount(&handle.toHost.ringbuffer) <=
+       2U * TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES;
+       block++) {
+    fillSamples(samples, count, block);
+    TEST_ASSERT_EQUAL(-EAGAIN, TransportTx_TxAccelerationBuffer(
+                                   &handle, samples, count, block * count));
+  }
+
+  isBusy = false;
+  TEST_ASSERT_EQUAL(-EAGAIN,
+                    TransportTx_TxAccelerationBuffer(&handle, NULL, 0, 0));
+  TEST_ASSERT_EQUAL(1, transfersCount);
+  TransportTx_TxUptime(&handle, 42);
+  TEST_ASSERT_FALSE(Ringbuffer_isEmpty(&handle.toHost.ringbuffer));
+
+  uint16_t offset = {0};
+  uint16_t framesCount = {0};
+  const struct TransportFrame *frame = {
+      (const struct TransportFrame *)&sent[offset]};
+  while (offset < sentBytes &&
+         Transport_HeaderId_Tx_Uptime != frame->header.id) {
+    const uint16_t frameBytes = {sentFrameBytes(offset)};
+    TEST_ASSERT_NOT_EQUAL(0, frameBytes);
+    offset += frameBytes;
+    frame = (const struct TransportFrame *)&sent[offset];
+    framesCount++;
+  }
+
+  TEST_ASSERT_GREATER_THAN(1, framesCount);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Tx_Uptime, frame->header.id);
+  TEST_ASSERT_EQUAL(sentBytes, offset + sentFrameBytes(offset));
+}
+
+void test_sampleSize_countsSelectedAxes() {
+  TEST_ASSERT_EQUAL(2, Transport_sampleSizeBytes(Transport_Axis_X));
+  TEST_ASSERT_EQUAL(4, Transport_sampleSizeBytes(Transport_Axis_X |
+                                                 Transport_Axis_Z));
+  TEST_ASSERT_EQUAL(6, Transport_sampleSizeBytes(Transport_Axis_All));
+}
+
+void test_packAxes_keepsOrderWithoutPadding() {
+  const struct Transport_Acceleration samples[2] = {
+      {.x = 0x0102, .y = 0x0304, .z = -2}, {.x = 0x0506, .y = 0, .z = 0x0708}};
+  const uint8_t expected[] = {0x02, 0x01, 0xFE, 0xFF, 0x06, 0x05, 0x08, 0x07};
+  uint8_t packed[sizeof(samples)] = {0};
+
+  TEST_ASSERT_EQUAL(
+      sizeof(expected),
+      Transport_packAxes(Transport_Axis_X | Transport_Axis_Z, samples, 2,
+                         packed));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, packed, sizeof(expected));
+}
+
+void test_setAxes_repartitionsBuffer() {
+  DECLARE_HANDLE;
+
+  TEST_ASSERT_EQUAL(-EINVAL, Transport_setAxes(&handle, 0, STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(-EINVAL, Transport_setAxes(&handle, 1U << 3U,
+                                               STORAGE_SIZE_BYTES));
+
+  TEST_ASSERT_EQUAL(0, Transport_setAxes(&handle, Transport_Axis_Y,
+                                         STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(Transport_Axis_Y, handle.toHost.axes);
+  TEST_ASSERT_EQUAL(45, Ringbuffer_capacity(&handle.toHost.ringbuffer));
+  TEST_ASSERT_EQUAL(2, Ringbuffer_itemSizeBytes(&handle.toHost.ringbuffer));
+
+  TEST_ASSERT_EQUAL(0, Transport_setAxes(&handle, Transport_Axis_All,
+                                         STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(10, Ringbuffer_capacity(&handle.toHost.ringbuffer));
+  TEST_ASSERT_EQUAL(
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration),
+      Ringbuffer_itemSizeBytes(&handle.toHost.ringbuffer));
+}
+
+void test_setFormat_deltaUsesByteItemsOfAllAxes() {
+  DECLARE_HANDLE;
+
+  TEST_ASSERT_EQUAL(0, Transport_setFormat(
+                           &handle, Transport_SampleFormat_AccelerationDelta,
+                           STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(STORAGE_SIZE_BYTES,
+                    Ringbuffer_capacity(&handle.toHost.ringbuffer));
+  TEST_ASSERT_EQUAL(1, Ringbuffer_itemSizeBytes(&handle.toHost.ringbuffer));
+  TEST_ASSERT_EQUAL(-EINVAL, Transport_setAxes(&handle, Transport_Axis_X,
+                                               STORAGE_SIZE_BYTES));
+
+  TEST_ASSERT_EQUAL(0, Transport_setFormat(&handle,
+                                           Transport_SampleFormat_Acceleration,
+                                           STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(0, Transport_setAxes(&handle, Transport_Axis_X,
+                                         STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(-EINVAL, Transport_setFormat(
+                                 &handle,
+                                 Transport_SampleFormat_AccelerationDelta,
+                                 STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(-EINVAL, Transport_setFormat(&handle, 0xFF,
+                                                 STORAGE_SIZE_BYTES));
+}
+
+void test_soa_axisArraysStay4ByteAligned() {
+  DECLARE_HANDLE;
+
+  TEST_ASSERT_EQUAL(0, TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(0));
+  TEST_ASSERT_EQUAL(4, TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(1));
+  TEST_ASSERT_EQUAL(48, TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(24));
+  TEST_ASSERT_EQUAL(52, TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(25));
+
+  TEST_ASSERT_EQUAL(0, Transport_setFormat(
+                           &handle, Transport_SampleFormat_AccelerationSoa,
+                           STORAGE_SIZE_BYTES));
+  TEST_ASSERT_EQUAL(1, Ringbuffer_itemSizeBytes(&handle.toHost.ringbuffer));
+}
+
+/**
+ * Streams count samples starting at firstIndex and appends the frames
+ * expected on the wire to expected.
+ *
+ * @return -EAGAIN if transmitted, -ENODATA if held back
+ */
+static int streamSamples(struct HostTransport_Handle *handle,
+                         uint16_t firstIndex, uint8_t count,
+                         uint8_t *expected, uint16_t *expectedBytes) {
+  const uint8_t sizeofFrame = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration)};
+  struct Transport_Acceleration
+      samples[TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES];
+  for (uint8_t idx = 0; idx < count; idx++) {
+    const uint16_t index = {(uint16_t)(firstIndex + idx)};
+    samples[idx].x = (int16_t)index;
+    samples[idx].y = (int16_t)-index;
+    samples[idx].z = (int16_t)(index * 3);
+
+    struct TransportFrame *frame = {
+        (struct TransportFrame *)&expected[*expectedBytes]};
+    frame->header.id = Transport_HeaderId_Tx_Acceleration;
+    frame->asTxFrame.asAcceleration.index = index;
+    frame->asTxFrame.asAcceleration.values = samples[idx];
+    *expectedBytes += sizeofFrame;
+  }
+  return TransportTx_TxAccelerationBuffer(handle, samples, count, firstIndex);
+}
+
+void test_holdBack_transfersWholePackets() {
+  DECLARE_STREAM_HANDLE;
+  TEST_ASSERT_EQUAL(0, Transport_setFormat(&handle,
+                                           Transport_SampleFormat_Acceleration,
+                                           STREAM_STORAGE_SIZE_BYTES));
+  uint8_t expected[SENT_MAX_BYTES];
+  uint16_t expectedBytes = {0};
+
+  // 90 bytes: one packet and 26 bytes held back
+  TEST_ASSERT_EQUAL(-EAGAIN,
+                    streamSamples(&handle, 0, 10, expected, &expectedBytes));
+  TEST_ASSERT_EQUAL(1, transfersCount);
+  TEST_ASSERT_EQUAL(TRANSPORTTX_USB_PACKET_BYTES, transferBytes[0]);
+  TEST_ASSERT_EQUAL(26, handle.toHost.txCarryBytes);
+
+  // too little for another packet
+  TEST_ASSERT_EQUAL(-ENODATA,
+                    streamSamples(&handle, 10, 3, expected, &expectedBytes));
+  TEST_ASSERT_EQUAL(1, transfersCount);
+  TEST_ASSERT_EQUAL(53, handle.toHost.txCarryBytes);
+
+  TEST_ASSERT_EQUAL(-EAGAIN,
+                    streamSamples(&handle, 13, 24, expected, &expectedBytes));
+  TEST_ASSERT_EQUAL(2, transfersCount);
+  TEST_ASSERT_EQUAL(4 * TRANSPORTTX_USB_PACKET_BYTES, transferBytes[1]);
+  TEST_ASSERT_EQUAL(expectedBytes - 5 * TRANSPORTTX_USB_PACKET_BYTES,
+                    handle.toHost.txCarryBytes);
+  TEST_ASSERT_EQUAL(5 * TRANSPORTTX_USB_PACKET_BYTES, sentBytes);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, sentBytes);
+}
+
+void test_holdBack_carryLeadsNextTransfer() {
+  DECLARE_STREAM_HANDLE;
+  TEST_ASSERT_EQUAL(0, Transport_setFormat(&handle,
+                                           Transport_SampleFormat_Acceleration,
+                                           STREAM_STORAGE_SIZE_BYTES));
+  uint8_t expected[SENT_MAX_BYTES];
+  uint16_t expectedBytes = {0};
+
+  streamSamples(&handle, 0, 10, expected, &expectedBytes);
+  streamSamples(&handle, 10, 5, expected, &expectedBytes);
+
+  // 26 held back bytes lead the 45 new ones
+  TEST_ASSERT_EQUAL(2, transfersCount);
+  TEST_ASSERT_EQUAL(TRANSPORTTX_USB_PACKET_BYTES, transferBytes[1]);
+  TEST_ASSERT_EQUAL(7, handle.toHost.txCarryBytes);
+  TEST_ASSERT_EQUAL(2 * TRANSPORTTX_USB_PACKET_BYTES, sentBytes);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, sentBytes);
+}
+
+void test_holdBack_flushesAfterDeadline() {
+  DECLARE_STREAM_HANDLE;
+  TEST_ASSERT_EQUAL(0, Transport_setFormat(&handle,
+                                           Transport_SampleFormat_Acceleration,
+                                           STREAM_STORAGE_SIZE_BYTES));
+  uint8_t expected[SENT_MAX_BYTES];
+  uint16_t expectedBytes = {0};
+
+  tickMs = 1000;
+  streamSamples(&handle, 0, 10, expected, &expectedBytes);
+
+  tickMs += TRANSPORTTX_FLUSH_DEADLINE_MS - 1U;
+  TEST_ASSERT_EQUAL(-ENODATA,
+                    TransportTx_TxAccelerationBuffer(&handle, NULL, 0, 0));
+  TEST_ASSERT_EQUAL(1, transfersCount);
+
+  // short packet once expired
+  tickMs++;
+  TEST_ASSERT_EQUAL(-EAGAIN,
+                    TransportTx_TxAccelerationBuffer(&handle, NULL, 0, 0));
+  TEST_ASSERT_EQUAL(2, transfersCount);
+  TEST_ASSERT_EQUAL(26, transferBytes[1]);
+  TEST_ASSERT_EQUAL(0, handle.toHost.txCarryBytes);
+  TEST_ASSERT_EQUAL(expectedBytes, sentBytes);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, sentBytes);
+
+  TEST_ASSERT_EQUAL(-ENODATA,
+                    TransportTx_TxAccelerationBuffer(&handle, NULL, 0, 0));
+  TEST_ASSERT_EQUAL(2, transfersCount);
+}
+
+void test_holdBack_flushedBeforeResponse() {
+  DECLARE_STREAM_HANDLE;
+  TEST_ASSERT_EQUAL(0, Transport_setFormat(&handle,
+                                           Transport_SampleFormat_Acceleration,
+                                           STREAM_STORAGE_SIZE_BYTES));
+  uint8_t expected[SENT_MAX_BYTES];
+  uint16_t expectedBytes = {0};
+
+  streamSamples(&handle, 0, 10, expected, &expectedBytes);
+  TransportTx_TxUptime(&handle, 0x01020304);
+
+  struct TransportFrame *uptime = {
+      (struct TransportFrame *)&expected[expectedBytes]};
+  uptime->header.id = Transport_HeaderId_Tx_Uptime;
+  uptime->asTxFrame.asUptime.elapsedMs = 0x01020304;
+  expectedBytes += SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Uptime);
+
+  TEST_ASSERT_EQUAL(3, transfersCount);
+  TEST_ASSERT_EQUAL(TRANSPORTTX_USB_PACKET_BYTES, transferBytes[0]);
+  TEST_ASSERT_EQUAL(26, transferBytes[1]);
+  TEST_ASSERT_EQUAL(SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Uptime),
+                    transferBytes[2]);
+  TEST_ASSERT_EQUAL(0, handle.toHost.txCarryBytes);
+  TEST_ASSERT_EQUAL(expectedBytes, sentBytes);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, sentBytes);
+}
+
+void test_delta_responseFollowsWholeFrames() {
+  assertResponseFollowsWholeFrames(
+      Transport_SampleFormat_AccelerationDelta,
+      TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES);
+}
+
+void test_soa_responseFollowsWholeFrames() {
+  // odd count: padded axis arrays
+  assertResponseFollowsWholeFrames(
+      Transport_SampleFormat_AccelerationSoa,
+      TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES - 1U);
+}
+
+void test_configurationSaved_reportsRejection() {
+  DECLARE_STREAM_HANDLE;
+
+  // a save rejected while sampling echoes the stored setup
+  TransportTx_TxConfigurationSaved(&handle, 0x0A, 0x02, 0x01, -EBUSY);
+
+  const struct TransportFrame *frame = {(const struct TransportFrame *)sent};
+  TEST_ASSERT_EQUAL(1, transfersCount);
+  TEST_ASSERT_EQUAL(
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_ConfigurationSaved),
+      sentBytes);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Tx_ConfigurationSaved,
+                    frame->header.id);
+  TEST_ASSERT_EQUAL(
+      0x0A, frame->asTxFrame.asConfigurationSaved.setup.outputDataRate);
+  TEST_ASSERT_EQUAL(0x02, frame->asTxFrame.asConfigurationSaved.setup.range);
+  TEST_ASSERT_EQUAL(0x01, frame->asTxFrame.asConfigurationSaved.setup.scale);
+  TEST_ASSERT_EQUAL(-EBUSY, frame->asTxFrame.asConfigurationSaved.result);
+}
+
+void test_streamSetup_echoesAxesAndFraming() {
+  DECLARE_STREAM_HANDLE;
+  TEST_ASSERT_EQUAL(0, Transport_setAxes(&handle, Transport_Axis_Y,
+                                         STREAM_STORAGE_SIZE_BYTES));
+  Transport_setFraming(&handle, true);
+
+  TransportTx_TxStreamSetup(&handle, -EBUSY);
+
+  const struct TransportFrame *frame = {(const struct TransportFrame *)sent};
+  TEST_ASSERT_EQUAL(1, transfersCount);
+  TEST_ASSERT_EQUAL(SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_StreamSetup),
+                    sentBytes);
+  TEST_ASSERT_EQUAL(Transport_HeaderId_Tx_StreamSetup, frame->header.id);
+  TEST_ASSERT_EQUAL(Transport_Axis_Y, frame->asTxFrame.asStreamSetup.axes);
+  TEST_ASSERT_EQUAL(1, frame->asTxFrame.asStreamSetup.framed);
+  TEST_ASSERT_EQUAL(-EBUSY, frame->asTxFrame.asStreamSetup.result);
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_sampleSize_countsSelectedAxes);
+  RUN_TEST(test_packAxes_keepsOrderWithoutPadding);
+  RUN_TEST(test_setAxes_repartitionsBuffer);
+  RUN_TEST(test_setFormat_deltaUsesByteItemsOfAllAxes);
+  RUN_TEST(test_soa_axisArraysStay4ByteAligned);
+  RUN_TEST(test_holdBack_transfersWholePackets);
+  RUN_TEST(test_holdBack_carryLeadsNextTransfer);
+  RUN_TEST(test_holdBack_flushesAfterDeadline);
+  RUN_TEST(test_holdBack_flushedBeforeResponse);
+  RUN_TEST(test_delta_responseFollowsWholeFrames);
+  RUN_TEST(test_soa_responseFollowsWholeFrames);
+  RUN_TEST(test_configurationSaved_reportsRejection);
+  RUN_TEST(test_streamSetup_echoesAxesAndFraming);
+  return UNITY_END();
+}
+
+void setUp() {
+  sentBytes = 0;
+  transfersCount = 0;
+  isBusy = false;
+  tickMs = 0;
+}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
@@ -334,6 +334,86 @@ void test_cap65535_movingWindowBeyondLimits() {
   TEST_ASSERT_EQUAL(true, Ringbuffer_isEmpty(&buffer));
 }
 
+void test_cap3_putOverwrite_dropsOldest() {
+  DECLARE_BUFFER_CAPACITY3;
+  struct Foo item = {.data = 0};
+
+  for (uint8_t idx = 1; idx <= 5; idx++) {
+    item.data = idx;
+    bool isOverwritten = {false};
+    TEST_ASSERT_EQUAL(
+        0, Ringbuffer_putOverwrite(&buffer, (uint8_t *)&item, &isOverwritten));
+    TEST_ASSERT_EQUAL(idx > 3, isOverwritten);
+  }
+
+  TEST_ASSERT_EQUAL(true, Ringbuffer_isFull(&buffer));
+  TEST_ASSERT_EQUAL(3, Ringbuffer_itemsCount(&buffer));
+
+  for (uint8_t idx = 3; idx <= 5; idx++) {
+    TEST_ASSERT_EQUAL(0, Ringbuffer_take(&buffer, (uint8_t *)&item));
+    TEST_ASSERT_EQUAL(idx, item.data);
+  }
+  TEST_ASSERT_EQUAL(true, Ringbuffer_isEmpty(&buffer));
+}
+
+void test_cap3_peek_wrapped() {
+  DECLARE_BUFFER_CAPACITY3;
+  struct Foo item = {.data = 0};
+
+  for (uint8_t idx = 1; idx <= 4; idx++) {
+    item.data = idx;
+    Ringbuffer_putOverwrite(&buffer, (uint8_t *)&item, NULL);
+  }
+
+  for (uint8_t idx = 0; idx < 3; idx++) {
+    TEST_ASSERT_EQUAL(0, Ringbuffer_peek(&buffer, idx, (uint8_t *)&item));
+    TEST_ASSERT_EQUAL(idx + 2, item.data);
+  }
+  TEST_ASSERT_EQUAL(-ENODATA, Ringbuffer_peek(&buffer, 3, (uint8_t *)&item));
+  TEST_ASSERT_EQUAL(3, Ringbuffer_itemsCount(&buffer));
+}
+
+void test_cap3_linearize_wrapped() {
+  DECLARE_BUFFER_CAPACITY3;
+  struct Foo item = {.data = 0};
+
+  for (uint8_t idx = 1; idx <= 4; idx++) {
+    item.data = idx;
+    Ringbuffer_putOverwrite(&buffer, (uint8_t *)&item, NULL);
+  }
+
+  Ringbuffer_linearize(&buffer);
+
+  TEST_ASSERT_EQUAL(2, storage[0].data);
+  TEST_ASSERT_EQUAL(3, storage[1].data);
+  TEST_ASSERT_EQUAL(4, storage[2].data);
+  TEST_ASSERT_EQUAL(3, Ringbuffer_itemsCount(&buffer));
+  TEST_ASSERT_EQUAL(0, Ringbuffer_take(&buffer, (uint8_t *)&item));
+  TEST_ASSERT_EQUAL(2, item.data);
+}
+
+void test_cap3_linearize_notFull() {
+  DECLARE_BUFFER_CAPACITY3;
+  struct Foo item = {.data = 0};
+
+  for (uint8_t idx = 1; idx <= 3; idx++) {
+    item.data = idx;
+    Ringbuffer_put(&buffer, (uint8_t *)&item);
+  }
+  Ringbuffer_take(&buffer, (uint8_t *)&item);
+
+  Ringbuffer_linearize(&buffer);
+
+  TEST_ASSERT_EQUAL(2, storage[0].data);
+  TEST_ASSERT_EQUAL(3, storage[1].data);
+  TEST_ASSERT_EQUAL(2, Ringbuffer_itemsCount(&buffer));
+
+  item.data = 7;
+  TEST_ASSERT_EQUAL(0, Ringbuffer_put(&buffer, (uint8_t *)&item));
+  TEST_ASSERT_EQUAL(7, storage[2].data);
+  TEST_ASSERT_EQUAL(true, Ringbuffer_isFull(&buffer));
+}
+
 int tests() {
   UNITY_BEGIN();
   RUN_TEST(test_cap1_empty_isEmptyNotFull);
@@ -349,6 +429,10 @@ int tests() {
   RUN_TEST(test_cap3_putAndTakeNoOverflow);
   RUN_TEST(test_cap65535_beyondLimitsAndAbove);
   RUN_TEST(test_cap65535_movingWindowBeyondLimits);
+  RUN_TEST(test_cap3_putOverwrite_dropsOldest);
+  RUN_TEST(test_cap3_peek_wrapped);
+  RUN_TEST(test_cap3_linearize_wrapped);
+  RUN_TEST(test_cap3_linearize_notFull);
   return UNITY_END();
 }
 
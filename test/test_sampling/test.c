@@ -0,0 +1,183 @@
+#include "../../lib/sampling/src/sampling.h"
+#include "../../lib/sampling/src/sampling_types.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unity.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define MAX_LATENCY_MS 5U
+
+/**
+ * Entries reported by FIFO_STATUS.
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t fifoEntries;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t fetchedCount;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t forwardedCount;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint16_t flushCount;
+
+static void doNothingImpl(const struct Sampling_Handle *handle) {}
+
+static void doWaitDelay5usImpl(struct Sampling_Handle *handle) {}
+
+static void
+doFetchSensorAccelerationImpl(const struct Sampling_Handle *handle,
+                              struct Sampling_Acceleration *sample) {
+  if (NULL != sample) {
+    sample->x = (int16_t)fetchedCount;
+    fetchedCount++;
+  }
+}
+
+static int doForwardAccelerationBufferImpl(
+    const struct Sampling_Handle *handle,
+    const struct Sampling_Acceleration *buffer,
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    uint16_t count, uint16_t firstIndex) {
+  if (NULL == buffer || 0 == count) {
+    return -ENODATA;
+  }
+  forwardedCount += count;
+  return 0;
+}
+
+static int doFlushAccelerationBufferImpl() {
+  flushCount++;
+  return -ENODATA;
+}
+
+static uint8_t doGetFifoEntriesImpl(const struct Sampling_Handle *handle) {
+  return fifoEntries;
+}
+
+static void onEventCb() {}
+
+#define DECLARE_HANDLE                                                         \
+  struct Sampling_Handle handle = {                                            \
+      .state = {.samplesPerFetch = SAMPLING_NUM_SAMPLES_READ_AT_ONCE},         \
+      .doEnableSensorImpl = doNothingImpl,                                     \
+      .doDisableSensorImpl = doNothingImpl,                                    \
+      .doFetchSensorAccelerationImpl = doFetchSensorAccelerationImpl,          \
+      .doWaitDelay5usImpl = doWaitDelay5usImpl,                                \
+      .doForwardAccelerationBufferImpl = doForwardAccelerationBufferImpl,      \
+      .doFlushAccelerationBufferImpl = doFlushAccelerationBufferImpl,          \
+      .doGetFifoEntriesImpl = doGetFifoEntriesImpl,                            \
+      .onSamplingStartedCb = onEventCb,                                        \
+      .onSamplingStoppedCb = onEventCb,                                        \
+      .onSamplingAbortedCb = onEventCb,                                        \
+      .onSamplingFinishedCb = onEventCb,                                       \
+      .onFifoOverflowCb = onEventCb,                                           \
+      .onBufferOverflowCb = onEventCb,                                         \
+      .onTransmissionErrorCb = onEventCb,                                      \
+  }
+
+/**
+ * Ticks count milliseconds.
+ *
+ * @return number of ticks reporting an expired deadline
+ */
+static uint16_t tick(struct Sampling_Handle *handle, uint16_t count) {
+  uint16_t expiredCount = {0};
+  for (uint16_t idx = 0; idx < count; idx++) {
+    expiredCount += Sampling_onMillisecondTick(handle) ? 1 : 0;
+  }
+  return expiredCount;
+}
+
+void test_latency_watermarkFirst() {
+  DECLARE_HANDLE;
+  TEST_ASSERT_EQUAL(0, Sampling_setMaxLatency(&handle, MAX_LATENCY_MS));
+  Sampling_start(&handle, 0);
+  Sampling_fetchForward(&handle);
+  TEST_ASSERT_EQUAL(true, handle.state.isStarted);
+
+  TEST_ASSERT_EQUAL(0, tick(&handle, MAX_LATENCY_MS - 1U));
+  Sampling_setFifoWatermark(&handle);
+  Sampling_fetchForward(&handle);
+  Sampling_clearFifoWatermark(&handle);
+
+  // a full batch without flush, the drain restarted the deadline
+  TEST_ASSERT_EQUAL(SAMPLING_NUM_SAMPLES_READ_AT_ONCE, forwardedCount);
+  TEST_ASSERT_EQUAL(0, flushCount);
+  TEST_ASSERT_EQUAL(MAX_LATENCY_MS, handle.state.latencyCountdownMs);
+  TEST_ASSERT_EQUAL(0, tick(&handle, MAX_LATENCY_MS - 1U));
+  TEST_ASSERT_EQUAL(false, Sampling_hasPendingWork(&handle));
+}
+
+void test_latency_deadlineFirst() {
+  DECLARE_HANDLE;
+  TEST_ASSERT_EQUAL(0, Sampling_setMaxLatency(&handle, MAX_LATENCY_MS));
+  Sampling_start(&handle, 0);
+  Sampling_fetchForward(&handle);
+
+  fifoEntries = 7;
+  TEST_ASSERT_EQUAL(0, tick(&handle, MAX_LATENCY_MS - 1U));
+  TEST_ASSERT_EQUAL(false, Sampling_hasPendingWork(&handle));
+  TEST_ASSERT_EQUAL(1, tick(&handle, 1));
+  TEST_ASSERT_EQUAL(true, Sampling_hasPendingWork(&handle));
+
+  // drains the entries below the watermark and flushes
+  Sampling_fetchForward(&handle);
+  TEST_ASSERT_EQUAL(7, fetchedCount);
+  TEST_ASSERT_EQUAL(7, forwardedCount);
+  TEST_ASSERT_EQUAL(1, flushCount);
+  TEST_ASSERT_EQUAL(false, handle.state.isLatencyDeadlineSet);
+  TEST_ASSERT_EQUAL(MAX_LATENCY_MS, handle.state.latencyCountdownMs);
+
+  // never more than a batch
+  fifoEntries = ADXL345_FIFO_ENTRIES;
+  TEST_ASSERT_EQUAL(1, tick(&handle, MAX_LATENCY_MS));
+  Sampling_fetchForward(&handle);
+  TEST_ASSERT_EQUAL(7 + SAMPLING_NUM_SAMPLES_READ_AT_ONCE, forwardedCount);
+  TEST_ASSERT_EQUAL(2, flushCount);
+}
+
+void test_latency_zeroDisables() {
+  DECLARE_HANDLE;
+  TEST_ASSERT_EQUAL(0, Sampling_setMaxLatency(&handle, 0));
+  Sampling_start(&handle, 0);
+  Sampling_fetchForward(&handle);
+
+  fifoEntries = 7;
+  TEST_ASSERT_EQUAL(0, tick(&handle, UINT16_MAX));
+  TEST_ASSERT_EQUAL(false, Sampling_hasPendingWork(&handle));
+  Sampling_fetchForward(&handle);
+  TEST_ASSERT_EQUAL(0, fetchedCount);
+  TEST_ASSERT_EQUAL(0, flushCount);
+}
+
+void test_latency_rejectedWhileStarted() {
+  DECLARE_HANDLE;
+  Sampling_start(&handle, 0);
+  Sampling_fetchForward(&handle);
+
+  TEST_ASSERT_EQUAL(-EBUSY, Sampling_setMaxLatency(&handle, MAX_LATENCY_MS));
+  TEST_ASSERT_EQUAL(0, handle.state.maxLatencyMs);
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_latency_watermarkFirst);
+  RUN_TEST(test_latency_deadlineFirst);
+  RUN_TEST(test_latency_zeroDisables);
+  RUN_TEST(test_latency_rejectedWhileStarted);
+  return UNITY_END();
+}
+
+void setUp() {
+  fifoEntries = 0;
+  fetchedCount = 0;
+  forwardedCount = 0;
+  flushCount = 0;
+}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
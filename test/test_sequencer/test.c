@@ -0,0 +1,90 @@
+#include "../../lib/sequencer/src/sequencer.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unity.h>
+
+void test_append_invalidArgs() {
+  struct Sequencer sequencer = SEQUENCER_INITIALIZER;
+  const struct Sequencer_Entry empty = {
+      .trigger = Sequencer_Trigger_Delay, .delayMs = 0, .samplesCount = 0};
+
+  TEST_ASSERT_EQUAL(-EINVAL, Sequencer_append(&sequencer, &empty));
+  TEST_ASSERT_EQUAL(-ENODATA, Sequencer_start(&sequencer, 0));
+}
+
+void test_delay_segmentsBackToBack() {
+  struct Sequencer sequencer = SEQUENCER_INITIALIZER;
+  const struct Sequencer_Entry entry = {
+      .trigger = Sequencer_Trigger_Delay, .delayMs = 0, .samplesCount = 5};
+  struct Sequencer_Slice slice;
+
+  TEST_ASSERT_EQUAL(0, Sequencer_append(&sequencer, &entry));
+  TEST_ASSERT_EQUAL(0, Sequencer_append(&sequencer, &entry));
+  TEST_ASSERT_EQUAL(0, Sequencer_start(&sequencer, 0));
+
+  // batch of 8: 5 samples of segment 0, 3 samples of segment 1
+  TEST_ASSERT_EQUAL(true, Sequencer_next(&sequencer, 0, 8, &slice));
+  TEST_ASSERT_EQUAL(5, slice.count);
+  TEST_ASSERT_EQUAL(0, slice.segment);
+  TEST_ASSERT_EQUAL(true, slice.isFirst);
+
+  TEST_ASSERT_EQUAL(true, Sequencer_next(&sequencer, 0, 3, &slice));
+  TEST_ASSERT_EQUAL(3, slice.count);
+  TEST_ASSERT_EQUAL(1, slice.segment);
+  TEST_ASSERT_EQUAL(0, slice.firstIndex);
+  TEST_ASSERT_EQUAL(true, slice.isFirst);
+
+  TEST_ASSERT_EQUAL(true, Sequencer_next(&sequencer, 0, 8, &slice));
+  TEST_ASSERT_EQUAL(2, slice.count);
+  TEST_ASSERT_EQUAL(3, slice.firstIndex);
+  TEST_ASSERT_EQUAL(false, slice.isFirst);
+
+  TEST_ASSERT_EQUAL(false, Sequencer_isRunning(&sequencer));
+  TEST_ASSERT_EQUAL(false, Sequencer_next(&sequencer, 0, 6, &slice));
+}
+
+void test_delay_waitsUntilElapsed() {
+  struct Sequencer sequencer = SEQUENCER_INITIALIZER;
+  const struct Sequencer_Entry entry = {
+      .trigger = Sequencer_Trigger_Delay, .delayMs = 10, .samplesCount = 2};
+  struct Sequencer_Slice slice;
+
+  Sequencer_append(&sequencer, &entry);
+  Sequencer_start(&sequencer, 100);
+
+  TEST_ASSERT_EQUAL(false, Sequencer_next(&sequencer, 109, 4, &slice));
+  TEST_ASSERT_EQUAL(true, Sequencer_next(&sequencer, 110, 4, &slice));
+  TEST_ASSERT_EQUAL(2, slice.count);
+}
+
+void test_marker_latched() {
+  struct Sequencer sequencer = SEQUENCER_INITIALIZER;
+  const struct Sequencer_Entry entry = {
+      .trigger = Sequencer_Trigger_Marker, .delayMs = 0, .samplesCount = 2};
+  struct Sequencer_Slice slice;
+
+  Sequencer_append(&sequencer, &entry);
+  Sequencer_start(&sequencer, 0);
+
+  TEST_ASSERT_EQUAL(false, Sequencer_next(&sequencer, 1000, 4, &slice));
+  Sequencer_mark(&sequencer);
+  TEST_ASSERT_EQUAL(true, Sequencer_next(&sequencer, 1000, 4, &slice));
+  TEST_ASSERT_EQUAL(true, slice.isFirst);
+  TEST_ASSERT_EQUAL(false, Sequencer_isRunning(&sequencer));
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_append_invalidArgs);
+  RUN_TEST(test_delay_segmentsBackToBack);
+  RUN_TEST(test_delay_waitsUntilElapsed);
+  RUN_TEST(test_marker_latched);
+  return UNITY_END();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
@@ -0,0 +1,85 @@
+#include "../../lib/trigger/src/trigger.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <unity.h>
+
+void test_threshold_belowThreshold_acceptsAll() {
+  struct Trigger trigger = TRIGGER_INITIALIZER;
+  const struct Trigger_Acceleration samples[] = {
+      {.x = 0, .y = 0, .z = 256},
+      {.x = 3, .y = 4, .z = 256},
+      {.x = -3, .y = -4, .z = 256},
+  };
+
+  Trigger_arm(&trigger, Trigger_Source_Threshold, 5, 2);
+
+  TEST_ASSERT_EQUAL(3, Trigger_feed(&trigger, samples, 3));
+  TEST_ASSERT_EQUAL(false, Trigger_isTriggered(&trigger));
+  TEST_ASSERT_EQUAL(false, Trigger_isComplete(&trigger));
+}
+
+void test_threshold_exceeded_acceptsPostSamples() {
+  struct Trigger trigger = TRIGGER_INITIALIZER;
+  const struct Trigger_Acceleration samples[] = {
+      {.x = 0, .y = 0, .z = 256}, {.x = 0, .y = 0, .z = 256},
+      {.x = 0, .y = 6, .z = 256}, {.x = 0, .y = 0, .z = 256},
+      {.x = 0, .y = 0, .z = 256}, {.x = 0, .y = 0, .z = 256},
+  };
+
+  Trigger_arm(&trigger, Trigger_Source_Threshold, 5, 2);
+
+  // trigger sample at index 2, post-trigger samples at index 3 and 4
+  TEST_ASSERT_EQUAL(5, Trigger_feed(&trigger, samples, 6));
+  TEST_ASSERT_EQUAL(true, Trigger_isTriggered(&trigger));
+  TEST_ASSERT_EQUAL(true, Trigger_isComplete(&trigger));
+  TEST_ASSERT_EQUAL(3, Trigger_postSamplesAccepted(&trigger));
+
+  TEST_ASSERT_EQUAL(0, Trigger_feed(&trigger, samples, 6));
+}
+
+void test_threshold_fullScaleDeviation_exceeds() {
+  struct Trigger trigger = TRIGGER_INITIALIZER;
+  // each squared deviation exceeds 31 bit, their sum 32 bit
+  const struct Trigger_Acceleration samples[] = {
+      {.x = INT16_MIN, .y = INT16_MIN, .z = INT16_MIN},
+      {.x = INT16_MAX, .y = INT16_MAX, .z = INT16_MAX},
+  };
+
+  Trigger_arm(&trigger, Trigger_Source_Threshold, UINT16_MAX, 0);
+
+  TEST_ASSERT_EQUAL(2, Trigger_feed(&trigger, samples, 2));
+  TEST_ASSERT_EQUAL(true, Trigger_isTriggered(&trigger));
+}
+
+void test_external_firesAtNextSample_acrossBatches() {
+  struct Trigger trigger = TRIGGER_INITIALIZER;
+  const struct Trigger_Acceleration samples[2] = {0};
+
+  Trigger_arm(&trigger, Trigger_Source_External, 0, 2);
+
+  TEST_ASSERT_EQUAL(2, Trigger_feed(&trigger, samples, 2));
+  TEST_ASSERT_EQUAL(false, Trigger_isTriggered(&trigger));
+
+  Trigger_fire(&trigger);
+  TEST_ASSERT_EQUAL(2, Trigger_feed(&trigger, samples, 2));
+  TEST_ASSERT_EQUAL(true, Trigger_isTriggered(&trigger));
+  TEST_ASSERT_EQUAL(false, Trigger_isComplete(&trigger));
+
+  TEST_ASSERT_EQUAL(1, Trigger_feed(&trigger, samples, 2));
+  TEST_ASSERT_EQUAL(true, Trigger_isComplete(&trigger));
+}
+
+int tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_threshold_belowThreshold_acceptsAll);
+  RUN_TEST(test_threshold_exceeded_acceptsPostSamples);
+  RUN_TEST(test_threshold_fullScaleDeviation_exceeds);
+  RUN_TEST(test_external_firesAtNextSample_acrossBatches);
+  return UNITY_END();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+#include "../utils/run-tests.h"
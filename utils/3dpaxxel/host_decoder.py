@@ -0,0 +1,214 @@
+"""
+Python binding of the host decoder (``lib/host_decoder``) through ctypes.
+
+Decoding runs in C, Python is called once per block of up to 256 samples and once per event frame. The shared library
+is built by ``make -C utils/aggregator`` and looked up in ``utils/aggregator/build`` unless the environment variable
+``PAXXEL_HOST_DECODER`` names it.
+
+Example::
+
+    decoder = HostDecoder(on_block=lambda block: print(block.sensor, block.first_index, len(block.x)),
+                          on_frame=lambda frame: print(frame.id.name, frame.payload))
+    with open("/dev/ttyACM0", "rb", buffering=0) as tty:
+        while True:
+            decoder.feed(tty.read(16384))
+
+Block columns are ``array.array("h")``, hence ``numpy.frombuffer(block.x, dtype=numpy.int16)`` does not copy.
+"""
+
+import argparse
+import ctypes
+import os
+import time
+from array import array
+from enum import IntEnum
+from pathlib import Path
+from typing import Callable, NamedTuple, Optional
+
+BLOCK_SAMPLES = 256
+"""Capacity of a block, ``HOSTDECODER_BLOCK_SAMPLES``."""
+
+BINDING_VERSION = 1
+"""``DECODERBINDING_VERSION`` the structures below mirror."""
+
+
+class TxHeaderId(IntEnum):
+    """Response frames handed out as events, ``Transport_HeaderId_Tx_*``."""
+
+    OutputDataRate = 25
+    Range = 26
+    Scale = 27
+    DeviceSetup = 28
+    FirmwareVersion = 29
+    Uptime = 30
+    BufferStatus = 31
+    CaptureChunk = 32
+    FifoOverflow = 33
+    SamplingStarted = 34
+    SamplingFinished = 35
+    SamplingStopped = 36
+    SamplingAborted = 37
+    Acceleration = 38
+    Fault = 39
+    BufferOverflow = 40
+    TransmissionError = 41
+    SamplingConfiguredStarted = 42
+    RecorderFinished = 43
+    SequenceSegment = 44
+    AccelerationAxes = 45
+    AccelerationDelta = 46
+    AccelerationPacked = 47
+    AccelerationSoa = 48
+    ClockCorrelation = 49
+    AccelerationSensor = 50
+    Calibration = 51
+    SpiClock = 53
+    ConfigurationSaved = 55
+    StreamSetup = 56
+
+
+class Frame(NamedTuple):
+    id: TxHeaderId
+    payload: bytes  # packed payload struct of host_transport_types.h
+
+
+class Block(NamedTuple):
+    sensor: int
+    first_index: int  # running index of x[0], following samples are consecutive (modulo 2^16)
+    x: array
+    y: array
+    z: array
+
+
+class _Block(ctypes.Structure):
+    _fields_ = [
+        ("sensor", ctypes.c_uint8),
+        ("firstIndex", ctypes.c_uint16),
+        ("count", ctypes.c_uint16),
+        ("x", ctypes.c_int16 * BLOCK_SAMPLES),
+        ("y", ctypes.c_int16 * BLOCK_SAMPLES),
+        ("z", ctypes.c_int16 * BLOCK_SAMPLES),
+    ]
+
+
+class _Statistics(ctypes.Structure):
+    _fields_ = [
+        ("framesCount", ctypes.c_uint32),
+        ("samplesCount", ctypes.c_uint32),
+        ("blocksCount", ctypes.c_uint32),
+        ("discardedBytes", ctypes.c_uint32),
+        ("crcErrorCount", ctypes.c_uint32),
+        ("lostStreamFramesCount", ctypes.c_uint32),
+    ]
+
+
+_OnFrame = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint8), ctypes.c_uint16)
+_OnBlock = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.POINTER(_Block))
+
+
+def _load_library(path: Optional[str]) -> ctypes.CDLL:
+    if path is None:
+        path = os.environ.get(
+            "PAXXEL_HOST_DECODER", str(Path(__file__).parent / "../aggregator/build/lib3dpaxxel-decoder.so")
+        )
+    library = ctypes.CDLL(path)
+
+    library.DecoderBinding_version.restype = ctypes.c_uint32
+    library.DecoderBinding_blockSizeBytes.restype = ctypes.c_size_t
+    library.DecoderBinding_create.argtypes = [_OnFrame, _OnBlock, ctypes.c_void_p]
+    library.DecoderBinding_create.restype = ctypes.c_void_p
+    library.DecoderBinding_destroy.argtypes = [ctypes.c_void_p]
+    library.DecoderBinding_statistics.argtypes = [ctypes.c_void_p]
+    library.DecoderBinding_statistics.restype = ctypes.POINTER(_Statistics)
+    library.HostDecoder_feed.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t]
+    library.HostDecoder_reset.argtypes = [ctypes.c_void_p]
+
+    if BINDING_VERSION != library.DecoderBinding_version() or ctypes.sizeof(
+        _Block
+    ) != library.DecoderBinding_blockSizeBytes():
+        raise ImportError(f"{path}: binding version mismatch, rebuild the library")
+    return library
+
+
+class HostDecoder:
+    """
+    Incremental decoder of the byte stream received from one controller.
+
+    Callbacks are invoked in stream order from within :meth:`feed`. Samples preceding an event are handed out before.
+    """
+
+    def __init__(
+        self,
+        on_block: Optional[Callable[[Block], None]] = None,
+        on_frame: Optional[Callable[[Frame], None]] = None,
+        library: Optional[str] = None,
+    ):
+        self._library = _load_library(library)
+        self._on_block = on_block
+        self._on_frame = on_frame
+        # referenced as long as the decoder lives
+        self._on_frame_cb = _OnFrame(self._frame_received)
+        self._on_block_cb = _OnBlock(self._block_received)
+        self._handle = self._library.DecoderBinding_create(self._on_frame_cb, self._on_block_cb, None)
+        if self._handle is None:
+            raise MemoryError()
+
+    def __del__(self):
+        if getattr(self, "_handle", None) is not None:
+            self._library.DecoderBinding_destroy(self._handle)
+            self._handle = None
+
+    def _frame_received(self, _context, frame, frame_bytes: int):
+        if self._on_frame is not None:
+            data = ctypes.string_at(frame, frame_bytes)
+            self._on_frame(Frame(TxHeaderId(data[0]), data[1:]))
+
+    def _block_received(self, _context, block_ptr):
+        if self._on_block is not None:
+            block = block_ptr.contents
+            count = block.count
+
+            def column(values) -> array:
+                column_array = array("h")
+                column_array.frombytes(ctypes.string_at(values, count * 2))
+                return column_array
+
+            self._on_block(Block(block.sensor, block.firstIndex, column(block.x), column(block.y), column(block.z)))
+
+    def feed(self, data: bytes) -> None:
+        """Decodes the next chunk of received bytes, frames may span chunks."""
+        self._library.HostDecoder_feed(self._handle, data, len(data))
+
+    def reset(self) -> None:
+        """Drops partially received frames, i.e. after the device was re-opened."""
+        self._library.HostDecoder_reset(self._handle)
+
+    @property
+    def statistics(self) -> dict:
+        """Decoder counters, see ``HostDecoder_Statistics``."""
+        statistics = self._library.DecoderBinding_statistics(self._handle).contents
+        return {name: getattr(statistics, name) for name, _ in _Statistics._fields_}
+
+
+def _main():
+    parser = argparse.ArgumentParser(description="Decodes a raw dump of a controller's stream.")
+    parser.add_argument("file", help="raw bytes as read from the tty")
+    parser.add_argument("--chunk", type=int, default=16384, help="bytes fed at once")
+    args = parser.parse_args()
+
+    samples = [0]
+    decoder = HostDecoder(on_block=lambda block: samples.__setitem__(0, samples[0] + len(block.x)))
+    with open(args.file, "rb") as f:
+        data = f.read()
+
+    start = time.perf_counter()
+    for offset in range(0, len(data), args.chunk):
+        decoder.feed(data[offset : offset + args.chunk])
+    elapsed = time.perf_counter() - start
+
+    print(decoder.statistics)
+    print(f"{samples[0]} samples in {elapsed:.3f}s, {samples[0] / elapsed / 1e6:.2f} Msamples/s")
+
+
+if __name__ == "__main__":
+    _main()
@@ -0,0 +1,758 @@
+/**
+ * \file aggregator.c
+ */
+
+#define _GNU_SOURCE
+#include "aggregator.h"
+#include <errno.h>
+#include <libgen.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * epoll tags of the descriptors other than devices, which are tagged by
+ * their slot.
+ * @{
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TAG_TIMER UINT64_MAX
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TAG_SIGNAL (UINT64_MAX - 1U)
+/// @}
+
+/**
+ * Bytes read at once. Yields fewer samples than fit into a sensor's queue.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define READ_BUFFER_BYTES 16384U
+
+/**
+ * Samples written to the merged file at once.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define MERGE_BATCH_RECORDS 1024U
+
+/**
+ * Ticks in between two scans for new devices.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define DISCOVER_TICKS (1000U / AGGREGATOR_TICK_MS)
+
+/**
+ * Time to receive the remaining samples after requesting the stop.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define STOP_DRAIN_MS 200U
+
+/**
+ * Sample period at 3200Hz, the sensor's default output data rate.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define PERIOD_3200HZ_NS 312500ULL
+
+/**
+ * Consecutive samples appended to a capture file at once.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define CAPTURE_RUN_SAMPLES 256U
+
+static_assert(0 == (AGGREGATOR_PENDING_RECORDS &
+                    (AGGREGATOR_PENDING_RECORDS - 1U)),
+              "ERROR: AGGREGATOR_PENDING_RECORDS must be power of two");
+static_assert(READ_BUFFER_BYTES /
+                      SIZEOF_HEADER_INCL_PAYLOAD(
+                          struct TransportTx_Acceleration) <
+                  AGGREGATOR_PENDING_RECORDS,
+              "ERROR: a chunk must not overrun a sensor's queue");
+
+static uint64_t nowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @param rate \see TransportRx_SetOutputDataRate_Rate
+ * @return sample period, the rate halves with each step below 3200Hz
+ */
+static uint64_t periodNsOfRate(uint8_t rate) {
+  return PERIOD_3200HZ_NS << (TransportRx_SetOutputDataRate_Rate3200 -
+                              (rate & TransportRx_SetOutputDataRate_Rate3200));
+}
+
+/**
+ * Creates the capture file of a sensor unless done before.
+ *
+ * @param device
+ * @param id sensor ID
+ * @return capture file, NULL if it could not be created
+ */
+static struct CaptureFile *openCapture(struct Aggregator_Device *device,
+                                       uint8_t id) {
+  struct Aggregator_Sensor *sensor = {&device->sensors[id]};
+  if (sensor->isFileFailed) {
+    return NULL;
+  }
+  if (0 <= sensor->file.fd) {
+    return &sensor->file;
+  }
+
+  char base[SERIALDEVICE_PATH_MAX_BYTES];
+  strncpy(base, device->path, sizeof(base));
+  char filePath[PATH_MAX];
+  snprintf(filePath, sizeof(filePath), "%s/device%u-%s-sensor%u.cap",
+           device->aggregator->options.outputDir, device->number,
+           basename(base), id);
+
+  const struct CaptureFile_Source source = {.path = device->path,
+                                            .sensor = id,
+                                            .periodNs = device->periodNs,
+                                            .firmware = device->firmware,
+                                            .setup = device->setup};
+  const int result = {CaptureFile_create(&sensor->file, filePath, &source)};
+  if (0 != result) {
+    fprintf(stderr, "%s: %s\n", filePath, strerror(-result));
+    sensor->isFileFailed = true;
+    return NULL;
+  }
+  return &sensor->file;
+}
+
+/**
+ * Marks an event in the capture files of all sensors recording.
+ *
+ * @param device
+ * @param kind \see CaptureFile_MarkerKind
+ */
+static void markCaptures(struct Aggregator_Device *device,
+                         enum CaptureFile_MarkerKind kind) {
+  for (uint8_t id = 0; id < AGGREGATOR_SENSORS; id++) {
+    if (0 <= device->sensors[id].file.fd) {
+      CaptureFile_mark(&device->sensors[id].file, kind, 0);
+    }
+  }
+}
+
+/**
+ * Appends the samples stamped last to the sensor's capture file in runs of
+ * consecutive indices.
+ *
+ * @param device
+ * @param id sensor ID
+ */
+static void appendCapture(struct Aggregator_Device *device, uint8_t id) {
+  const struct Aggregator_Sensor *sensor = {&device->sensors[id]};
+  struct CaptureFile *file = {openCapture(device, id)};
+  if (NULL == file) {
+    return;
+  }
+
+  struct Transport_Acceleration run[CAPTURE_RUN_SAMPLES];
+  uint32_t runCount = {0};
+  uint32_t runIndex = {0};
+  uint64_t runStampNs = {0};
+
+  for (uint32_t idx = sensor->stampedTail; idx != sensor->head; idx++) {
+    const struct RecordFile_Record *record = {
+        &sensor->pending[idx & (AGGREGATOR_PENDING_RECORDS - 1U)]};
+    if (0 < runCount && (CAPTURE_RUN_SAMPLES == runCount ||
+                         runIndex + runCount != record->index)) {
+      CaptureFile_append(file, run, runCount, runIndex, runStampNs);
+      runCount = 0;
+    }
+    if (0 == runCount) {
+      runIndex = record->index;
+      runStampNs = record->timestampNs;
+    }
+    run[runCount].x = record->x;
+    run[runCount].y = record->y;
+    run[runCount].z = record->z;
+    runCount++;
+  }
+
+  if (0 < runCount) {
+    CaptureFile_append(file, run, runCount, runIndex, runStampNs);
+  }
+}
+
+/**
+ * Stamps the samples decoded from the current chunk and appends them to the
+ * sensors' capture files.
+ *
+ * @param device
+ */
+static void stampPending(struct Aggregator_Device *device) {
+  for (uint8_t id = 0; id < AGGREGATOR_SENSORS; id++) {
+    struct Aggregator_Sensor *sensor = {&device->sensors[id]};
+    if (sensor->stampedTail == sensor->head) {
+      continue;
+    }
+
+    // the last sample of the chunk is the one waiting the least
+    const int64_t candidateNs = {
+        (int64_t)device->arrivalNs -
+        (int64_t)((uint64_t)sensor->unwrapped * device->periodNs)};
+    if (0 == sensor->updatedNs) {
+      sensor->offsetNs = candidateNs;
+    } else {
+      const int64_t creepNs = {
+          (int64_t)((device->arrivalNs - sensor->updatedNs) *
+                    AGGREGATOR_CLOCK_DRIFT_PPM / 1000000U)};
+      sensor->offsetNs = sensor->offsetNs + creepNs < candidateNs
+                             ? sensor->offsetNs + creepNs
+                             : candidateNs;
+    }
+    sensor->updatedNs = device->arrivalNs;
+    sensor->arrivalNs = device->arrivalNs;
+
+    for (uint32_t idx = sensor->stampedTail; idx != sensor->head; idx++) {
+      struct RecordFile_Record *record = {
+          &sensor->pending[idx & (AGGREGATOR_PENDING_RECORDS - 1U)]};
+      uint64_t stampNs = {(uint64_t)(sensor->offsetNs +
+                                     (int64_t)((uint64_t)record->index *
+                                               device->periodNs))};
+      // a lowered offset must not reorder the samples of a sensor
+      if (stampNs < sensor->lastStampNs) {
+        stampNs = sensor->lastStampNs;
+      }
+      record->timestampNs = stampNs;
+      sensor->lastStampNs = stampNs;
+    }
+    appendCapture(device, id);
+    sensor->stampedTail = sensor->head;
+  }
+}
+
+/**
+ * Forgets the time estimates, the sample index restarts with sampling.
+ *
+ * @param device
+ */
+static void resetClocks(struct Aggregator_Device *device) {
+  stampPending(device);
+  for (uint8_t id = 0; id < AGGREGATOR_SENSORS; id++) {
+    struct Aggregator_Sensor *sensor = {&device->sensors[id]};
+    sensor->isValid = false;
+    sensor->updatedNs = 0;
+  }
+}
+
+static void appendMerged(struct Aggregator *aggregator,
+                         const struct RecordFile_Record *records,
+                         uint32_t count) {
+  for (uint32_t idx = 0; idx < count; idx++) {
+    if (records[idx].timestampNs < aggregator->mergedNs) {
+      aggregator->lateCount++;
+    } else {
+      aggregator->mergedNs = records[idx].timestampNs;
+    }
+  }
+  RecordFile_append(&aggregator->merged, records, count);
+}
+
+static void decoder_onFrame(void *context, const struct TransportFrame *frame,
+                            uint16_t frameBytes) {
+  struct Aggregator_Device *device = {context};
+
+  const union TransportTxFrame *response = {&frame->asTxFrame};
+
+  switch (frame->header.id) {
+  case Transport_HeaderId_Tx_OutputDataRate:
+    device->setup.outputDataRate = response->asOutputDataRate.rate;
+    device->periodNs = periodNsOfRate(device->setup.outputDataRate);
+    break;
+  case Transport_HeaderId_Tx_Range:
+    device->setup.range = response->asRange.range;
+    break;
+  case Transport_HeaderId_Tx_Scale:
+    device->setup.scale = response->asScale.scale;
+    break;
+  case Transport_HeaderId_Tx_DeviceSetup:
+    device->setup = response->asDeviceSetup;
+    device->periodNs = periodNsOfRate(device->setup.outputDataRate);
+    break;
+  case Transport_HeaderId_Tx_FirmwareVersion:
+    device->firmware = response->asFirmwareVersion;
+    break;
+  case Transport_HeaderId_Tx_SamplingConfiguredStarted:
+    if (0 != response->asSamplingConfiguredStarted.result) {
+      // rejected: nothing started, the setup is unchanged
+      break;
+    }
+    resetClocks(device);
+    device->setup.outputDataRate =
+        response->asSamplingConfiguredStarted.outputDataRate;
+    device->setup.range = response->asSamplingConfiguredStarted.range;
+    device->setup.scale = response->asSamplingConfiguredStarted.scale;
+    device->periodNs = periodNsOfRate(device->setup.outputDataRate);
+    markCaptures(device, CaptureFile_MarkerKind_Start);
+    break;
+  case Transport_HeaderId_Tx_SamplingStarted:
+    resetClocks(device);
+    markCaptures(device, CaptureFile_MarkerKind_Start);
+    break;
+  case Transport_HeaderId_Tx_SamplingStopped:
+  case Transport_HeaderId_Tx_SamplingFinished:
+  case Transport_HeaderId_Tx_SamplingAborted:
+    stampPending(device);
+    markCaptures(device, CaptureFile_MarkerKind_Stop);
+    break;
+  case Transport_HeaderId_Tx_SequenceSegment: {
+    // segments are sampled by the primary sensor
+    struct CaptureFile *file = {openCapture(device, 0)};
+    if (NULL != file) {
+      stampPending(device);
+      CaptureFile_mark(file, CaptureFile_MarkerKind_Segment,
+                       response->asSequenceSegment.segment);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+static void decoder_onSample(void *context,
+                             const struct HostDecoder_Sample *sample) {
+  struct Aggregator_Device *device = {context};
+  if (AGGREGATOR_SENSORS <= sample->sensor) {
+    device->ignoredCount++;
+    return;
+  }
+
+  struct Aggregator_Sensor *sensor = {&device->sensors[sample->sensor]};
+  if (sensor->isValid) {
+    sensor->unwrapped += (uint16_t)(sample->index - sensor->lastIndex);
+  } else {
+    sensor->isValid = true;
+    sensor->unwrapped = sample->index;
+  }
+  sensor->lastIndex = sample->index;
+
+  // the merge lags too far behind, give up the order of the oldest sample
+  if (AGGREGATOR_PENDING_RECORDS == sensor->head - sensor->tail) {
+    appendMerged(
+        device->aggregator,
+        &sensor->pending[sensor->tail & (AGGREGATOR_PENDING_RECORDS - 1U)], 1);
+    sensor->tail++;
+  }
+
+  struct RecordFile_Record *record = {
+      &sensor->pending[sensor->head & (AGGREGATOR_PENDING_RECORDS - 1U)]};
+  record->timestampNs = 0;
+  record->index = sensor->unwrapped;
+  record->device = device->number;
+  record->sensor = sample->sensor;
+  record->x = sample->values.x;
+  record->y = sample->values.y;
+  record->z = sample->values.z;
+  sensor->head++;
+}
+
+/**
+ * Sends a request without payload or with the given payload.
+ *
+ * @param device
+ * @param id request header ID
+ * @param payload NULL if none
+ * @param payloadBytes size of payload
+ * @return same as SerialDevice_write()
+ */
+static int sendRequest(const struct Aggregator_Device *device,
+                       enum Transport_HeaderId id, const void *payload,
+                       uint8_t payloadBytes) {
+  struct TransportFrame frame = {.header.id = id};
+  if (NULL != payload) {
+    memcpy(&frame.asRxFrame, payload, payloadBytes);
+  }
+  return SerialDevice_write(device->fd, &frame,
+                            sizeof(struct Transport_Header) + payloadBytes);
+}
+
+/**
+ * Closes the tty, the queued samples are merged and the slot is freed
+ * afterwards.
+ *
+ * @param aggregator
+ * @param device
+ */
+static void closeDevice(struct Aggregator *aggregator,
+                        struct Aggregator_Device *device) {
+  if (0 > device->fd) {
+    return;
+  }
+  stampPending(device);
+  epoll_ctl(aggregator->epollFd, EPOLL_CTL_DEL, device->fd, NULL);
+  close(device->fd);
+  device->fd = -1;
+  for (uint8_t id = 0; id < AGGREGATOR_SENSORS; id++) {
+    CaptureFile_close(&device->sensors[id].file);
+  }
+
+  const struct HostDecoder_Statistics *statistics = {
+      &device->decoder.statistics};
+  fprintf(stderr,
+          "%s: closed, device %u, samples %" PRIu32 ", frames %" PRIu32
+          ", discarded bytes %" PRIu32 ", crc errors %" PRIu32
+          ", lost stream frames %" PRIu32 ", ignored samples %" PRIu32 "\n",
+          device->path, device->number, statistics->samplesCount,
+          statistics->framesCount, statistics->discardedBytes,
+          statistics->crcErrorCount, statistics->lostStreamFramesCount,
+          device->ignoredCount);
+}
+
+int Aggregator_addDevice(struct Aggregator *aggregator, const char *path) {
+  uint8_t slot = {AGGREGATOR_MAX_DEVICES};
+  for (uint8_t idx = 0; idx < AGGREGATOR_MAX_DEVICES; idx++) {
+    const struct Aggregator_Device *device = {aggregator->devices[idx]};
+    if (NULL == device) {
+      slot = AGGREGATOR_MAX_DEVICES == slot ? idx : slot;
+    } else if (0 <= device->fd && 0 == strcmp(device->path, path)) {
+      return -EEXIST;
+    }
+  }
+  if (AGGREGATOR_MAX_DEVICES == slot) {
+    return -ENOMEM;
+  }
+
+  struct Aggregator_Device *device = {calloc(1, sizeof(*device))};
+  if (NULL == device) {
+    return -ENOMEM;
+  }
+  device->fd = SerialDevice_open(path);
+  if (0 > device->fd) {
+    const int result = {device->fd};
+    free(device);
+    return result;
+  }
+
+  const struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(decoder_onFrame, decoder_onSample, NULL, device);
+  device->decoder = decoder;
+  device->aggregator = aggregator;
+  device->number = aggregator->nextNumber++;
+  device->periodNs = PERIOD_3200HZ_NS;
+  strncpy(device->path, path, sizeof(device->path) - 1U);
+  for (uint8_t id = 0; id < AGGREGATOR_SENSORS; id++) {
+    const struct CaptureFile file = CAPTUREFILE_INITIALIZER;
+    device->sensors[id].file = file;
+  }
+
+  struct epoll_event event = {.events = EPOLLIN, .data.u64 = slot};
+  if (0 != epoll_ctl(aggregator->epollFd, EPOLL_CTL_ADD, device->fd, &event)) {
+    const int result = {-errno};
+    close(device->fd);
+    free(device);
+    return result;
+  }
+  aggregator->devices[slot] = device;
+
+  if (aggregator->options.isFramed) {
+    const struct TransportRx_SetFraming framing = {.enable = 1};
+    sendRequest(device, Transport_HeaderId_Rx_SetFraming, &framing,
+                sizeof(framing));
+  }
+  sendRequest(device, Transport_HeaderId_Rx_GetFirmwareVersion, NULL, 0);
+  sendRequest(device, Transport_HeaderId_Rx_GetDeviceSetup, NULL, 0);
+  if (aggregator->options.isStart) {
+    const struct TransportRx_SamplingStart start = {.max_samples_count = 0};
+    sendRequest(device, Transport_HeaderId_Rx_SamplingStart, &start,
+                sizeof(start));
+  }
+
+  fprintf(stderr, "%s: opened, device %u\n", path, device->number);
+  return 0;
+}
+
+/**
+ * Reads and decodes everything received so far.
+ *
+ * @param aggregator
+ * @param device
+ */
+static void onReadable(struct Aggregator *aggregator,
+                       struct Aggregator_Device *device) {
+  static uint8_t bytes[READ_BUFFER_BYTES];
+
+  for (;;) {
+    const ssize_t count = {read(device->fd, bytes, sizeof(bytes))};
+    if (0 < count) {
+      device->arrivalNs = nowNs();
+      HostDecoder_feed(&device->decoder, bytes, count);
+      stampPending(device);
+      continue;
+    }
+    if (0 > count && EINTR == errno) {
+      continue;
+    }
+    if (0 > count && EAGAIN == errno) {
+      return;
+    }
+
+    // unplugged or the pseudo-tty's other end is gone
+    closeDevice(aggregator, device);
+    return;
+  }
+}
+
+/**
+ * Merges the stamped samples of all sensors in time order.
+ *
+ * Sensors which received samples recently hold back the merge at their last
+ * timestamp: the next samples they receive are not older.
+ *
+ * @param aggregator
+ * @param isFinal merge all samples regardless of the active sensors
+ */
+static void merge(struct Aggregator *aggregator, bool isFinal) {
+  const uint64_t nowArrivalNs = {nowNs()};
+  uint64_t watermarkNs = {UINT64_MAX};
+  struct Aggregator_Sensor *queued[AGGREGATOR_MAX_DEVICES * AGGREGATOR_SENSORS];
+  uint16_t queuedCount = {0};
+
+  for (uint8_t slot = 0; slot < AGGREGATOR_MAX_DEVICES; slot++) {
+    struct Aggregator_Device *device = {aggregator->devices[slot]};
+    if (NULL == device) {
+      continue;
+    }
+    for (uint8_t id = 0; id < AGGREGATOR_SENSORS; id++) {
+      struct Aggregator_Sensor *sensor = {&device->sensors[id]};
+      if (!isFinal && 0 <= device->fd && sensor->isValid &&
+          nowArrivalNs - sensor->arrivalNs <
+              AGGREGATOR_IDLE_MS * 1000000ULL &&
+          sensor->lastStampNs < watermarkNs) {
+        watermarkNs = sensor->lastStampNs;
+      }
+      if (sensor->tail != sensor->stampedTail) {
+        queued[queuedCount++] = sensor;
+      }
+    }
+  }
+
+  struct RecordFile_Record batch[MERGE_BATCH_RECORDS];
+  uint32_t batchCount = {0};
+
+  while (0 < queuedCount) {
+    uint16_t oldest = {0};
+    const struct RecordFile_Record *oldestRecord = {NULL};
+    for (uint16_t idx = 0; idx < queuedCount; idx++) {
+      const struct Aggregator_Sensor *sensor = {queued[idx]};
+      const struct RecordFile_Record *record = {
+          &sensor->pending[sensor->tail & (AGGREGATOR_PENDING_RECORDS - 1U)]};
+      if (NULL == oldestRecord ||
+          record->timestampNs < oldestRecord->timestampNs) {
+        oldest = idx;
+        oldestRecord = record;
+      }
+    }
+    if (watermarkNs < oldestRecord->timestampNs) {
+      break;
+    }
+
+    batch[batchCount++] = *oldestRecord;
+    if (MERGE_BATCH_RECORDS == batchCount) {
+      appendMerged(aggregator, batch, batchCount);
+      batchCount = 0;
+    }
+
+    struct Aggregator_Sensor *sensor = {queued[oldest]};
+    sensor->tail++;
+    if (sensor->tail == sensor->stampedTail) {
+      queued[oldest] = queued[--queuedCount];
+    }
+  }
+
+  appendMerged(aggregator, batch, batchCount);
+}
+
+/**
+ * Frees the slots of closed devices once their samples are merged.
+ *
+ * @param aggregator
+ */
+static void releaseClosed(struct Aggregator *aggregator) {
+  for (uint8_t slot = 0; slot < AGGREGATOR_MAX_DEVICES; slot++) {
+    struct Aggregator_Device *device = {aggregator->devices[slot]};
+    if (NULL == device || 0 <= device->fd) {
+      continue;
+    }
+    bool isMerged = {true};
+    for (uint8_t id = 0; id < AGGREGATOR_SENSORS; id++) {
+      isMerged &= device->sensors[id].tail == device->sensors[id].head;
+    }
+    if (isMerged) {
+      free(device);
+      aggregator->devices[slot] = NULL;
+    }
+  }
+}
+
+static void discover(struct Aggregator *aggregator) {
+  char paths[AGGREGATOR_MAX_DEVICES][SERIALDEVICE_PATH_MAX_BYTES];
+  const int count = {SerialDevice_discover(paths, AGGREGATOR_MAX_DEVICES)};
+  for (int idx = 0; idx < count; idx++) {
+    const int result = {Aggregator_addDevice(aggregator, paths[idx])};
+    if (0 != result && -EEXIST != result) {
+      fprintf(stderr, "%s: %s\n", paths[idx], strerror(-result));
+    }
+  }
+}
+
+static void onTimer(struct Aggregator *aggregator) {
+  uint64_t expirations = {0};
+  if (sizeof(expirations) !=
+      read(aggregator->timerFd, &expirations, sizeof(expirations))) {
+    return;
+  }
+  aggregator->ticks += expirations;
+
+  merge(aggregator, false);
+  releaseClosed(aggregator);
+
+  if (aggregator->options.isDiscover &&
+      0 == aggregator->ticks % DISCOVER_TICKS) {
+    discover(aggregator);
+  }
+}
+
+/**
+ * Requests all devices to stop sampling if started on open.
+ *
+ * @param aggregator
+ * @return time to keep on receiving
+ */
+static uint32_t stopAll(struct Aggregator *aggregator) {
+  if (!aggregator->options.isStart) {
+    return 0;
+  }
+  for (uint8_t slot = 0; slot < AGGREGATOR_MAX_DEVICES; slot++) {
+    const struct Aggregator_Device *device = {aggregator->devices[slot]};
+    if (NULL != device && 0 <= device->fd) {
+      sendRequest(device, Transport_HeaderId_Rx_SamplingStop, NULL, 0);
+    }
+  }
+  return STOP_DRAIN_MS;
+}
+
+int Aggregator_init(struct Aggregator *aggregator,
+                    const struct Aggregator_Options *options) {
+  memset(aggregator, 0, sizeof(*aggregator));
+  aggregator->options = *options;
+  aggregator->epollFd = -1;
+  aggregator->timerFd = -1;
+  aggregator->signalFd = -1;
+  aggregator->merged.fd = -1;
+
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  sigprocmask(SIG_BLOCK, &signals, NULL);
+
+  const struct itimerspec period = {
+      .it_interval = {.tv_nsec = AGGREGATOR_TICK_MS * 1000000L},
+      .it_value = {.tv_nsec = AGGREGATOR_TICK_MS * 1000000L}};
+  aggregator->epollFd = epoll_create1(EPOLL_CLOEXEC);
+  aggregator->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  aggregator->signalFd = signalfd(-1, &signals, SFD_CLOEXEC);
+  if (0 > aggregator->epollFd || 0 > aggregator->timerFd ||
+      0 > aggregator->signalFd ||
+      0 != timerfd_settime(aggregator->timerFd, 0, &period, NULL)) {
+    return -errno;
+  }
+
+  struct epoll_event timerEvent = {.events = EPOLLIN, .data.u64 = TAG_TIMER};
+  struct epoll_event signalEvent = {.events = EPOLLIN,
+                                    .data.u64 = TAG_SIGNAL};
+  if (0 != epoll_ctl(aggregator->epollFd, EPOLL_CTL_ADD, aggregator->timerFd,
+                     &timerEvent) ||
+      0 != epoll_ctl(aggregator->epollFd, EPOLL_CTL_ADD, aggregator->signalFd,
+                     &signalEvent)) {
+    return -errno;
+  }
+
+  char filePath[PATH_MAX];
+  snprintf(filePath, sizeof(filePath), "%s/merged.rec", options->outputDir);
+  return RecordFile_create(&aggregator->merged, filePath, "merged");
+}
+
+int Aggregator_run(struct Aggregator *aggregator, uint32_t durationMs) {
+  if (aggregator->options.isDiscover) {
+    discover(aggregator);
+  }
+
+  const uint64_t startNs = {nowNs()};
+  uint64_t endNs = {0 == durationMs
+                        ? UINT64_MAX
+                        : startNs + (uint64_t)durationMs * 1000000ULL};
+  bool isStopping = {false};
+  aggregator->isRunning = true;
+
+  while (aggregator->isRunning) {
+    struct epoll_event events[AGGREGATOR_MAX_DEVICES + 2U];
+    const int count = {epoll_wait(aggregator->epollFd, events,
+                                  AGGREGATOR_MAX_DEVICES + 2U, -1)};
+    if (0 > count && EINTR != errno) {
+      return -errno;
+    }
+
+    for (int idx = 0; idx < count; idx++) {
+      const uint64_t tag = {events[idx].data.u64};
+      if (TAG_TIMER == tag) {
+        onTimer(aggregator);
+      } else if (TAG_SIGNAL == tag) {
+        struct signalfd_siginfo info;
+        if (sizeof(info) == read(aggregator->signalFd, &info, sizeof(info)) &&
+            !isStopping) {
+          endNs = nowNs();
+        }
+      } else if (NULL != aggregator->devices[tag] &&
+                 0 <= aggregator->devices[tag]->fd) {
+        onReadable(aggregator, aggregator->devices[tag]);
+      }
+    }
+
+    if (nowNs() < endNs) {
+      continue;
+    }
+    if (isStopping) {
+      aggregator->isRunning = false;
+    } else {
+      isStopping = true;
+      endNs = nowNs() + stopAll(aggregator) * 1000000ULL;
+    }
+  }
+
+  return 0;
+}
+
+void Aggregator_deinit(struct Aggregator *aggregator) {
+  for (uint8_t slot = 0; slot < AGGREGATOR_MAX_DEVICES; slot++) {
+    if (NULL != aggregator->devices[slot]) {
+      closeDevice(aggregator, aggregator->devices[slot]);
+    }
+  }
+
+  merge(aggregator, true);
+  releaseClosed(aggregator);
+
+  fprintf(stderr, "merged: samples %" PRIu64 ", out of order %" PRIu64 "\n",
+          aggregator->merged.recordsCount, aggregator->lateCount);
+  RecordFile_close(&aggregator->merged);
+
+  const int fds[] = {aggregator->signalFd, aggregator->timerFd,
+                     aggregator->epollFd};
+  for (uint8_t idx = 0; idx < sizeof(fds) / sizeof(fds[0]); idx++) {
+    if (0 <= fds[idx]) {
+      close(fds[idx]);
+    }
+  }
+}
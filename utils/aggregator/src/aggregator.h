@@ -0,0 +1,174 @@
+/**
+ * \file aggregator.h
+ *
+ * Reads the streams of many controllers on a single thread.
+ *
+ * All ttys are non-blocking and multiplexed by one epoll instance. Received
+ * bytes are decoded right away \see host_decoder.h, each sample is stamped
+ * with an estimate of the host time it was sampled at and appended to the
+ * columnar capture file of its sensor \see capture_file.h. The samples of all
+ * devices are additionally merged in timestamp order into one record file.
+ *
+ * Timestamps: the sample period follows from the device's output data rate,
+ * the offset is the earliest arrival time seen for a sample index. Transfer
+ * delays only ever add to the arrival time, hence the minimum converges to
+ * the delay-free offset. The offset may creep forward by
+ * AGGREGATOR_CLOCK_DRIFT_PPM to follow a device clock running slower than
+ * the host's.
+ */
+
+#pragma once
+
+#include "record_file.h"
+#include "serial_device.h"
+#include <capture_file.h>
+#include <host_decoder.h>
+#include <inttypes.h>
+#include <stdbool.h>
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define AGGREGATOR_MAX_DEVICES 64U
+
+/**
+ * Sensors per device told apart by TransportTx_AccelerationSensor.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define AGGREGATOR_SENSORS 4U
+
+/**
+ * Samples per sensor waiting to be merged, power of two.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define AGGREGATOR_PENDING_RECORDS 4096U
+
+/**
+ * Devices without samples for this long do not hold back the merge.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define AGGREGATOR_IDLE_MS 250U
+
+/**
+ * Period of merging and housekeeping.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define AGGREGATOR_TICK_MS 10U
+
+/**
+ * Maximum drift of the device's clock against the host's.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define AGGREGATOR_CLOCK_DRIFT_PPM 200U
+
+/**
+ * Samples of one sensor of a device.
+ */
+struct Aggregator_Sensor {
+  /**
+   * Host time estimate.
+   * @{
+   */
+  bool isValid;         ///< at least one sample seen since sampling start
+  uint16_t lastIndex;   ///< index of last sample as received
+  uint32_t unwrapped;   ///< index of last sample, unwrapped
+  int64_t offsetNs;     ///< estimated host time of index 0
+  uint64_t updatedNs;   ///< arrival time offsetNs was updated at, 0 if never
+  uint64_t arrivalNs;   ///< arrival time of last sample
+  uint64_t lastStampNs; ///< timestamp of last sample
+  /// @}
+
+  /**
+   * Samples not yet merged, free running indices.
+   *
+   * Samples from stampedTail up to head are decoded from the current chunk
+   * and are stamped once the chunk is decoded completely.
+   * @{
+   */
+  struct RecordFile_Record pending[AGGREGATOR_PENDING_RECORDS];
+  uint32_t head;
+  uint32_t stampedTail;
+  uint32_t tail;
+  /// @}
+
+  struct CaptureFile file; ///< created once samples or markers arrive
+  bool isFileFailed;       ///< file could not be created, not retried
+};
+
+struct Aggregator;
+
+struct Aggregator_Device {
+  struct Aggregator *aggregator;
+  char path[SERIALDEVICE_PATH_MAX_BYTES];
+  int fd;                ///< -1 once closed
+  uint8_t number;        ///< device number in records and file name
+  uint64_t periodNs;     ///< sample period, \see TransportRx_SetOutputDataRate
+  uint64_t arrivalNs;    ///< CLOCK_MONOTONIC when the current chunk was read
+  uint32_t ignoredCount; ///< samples of sensors beyond AGGREGATOR_SENSORS
+
+  struct TransportTx_DeviceSetup setup;        ///< as last reported
+  struct TransportTx_FirmwareVersion firmware; ///< zero until reported
+
+  struct HostDecoder_Handle decoder;
+  struct Aggregator_Sensor sensors[AGGREGATOR_SENSORS];
+};
+
+struct Aggregator_Options {
+  const char *outputDir; ///< directory of capture files
+  bool isDiscover;       ///< open all controllers, rescan periodically
+  bool isStart;          ///< start sampling on open, stop on exit
+  bool isFramed;         ///< enable stream framing on open
+};
+
+struct Aggregator {
+  struct Aggregator_Options options;
+  int epollFd;
+  int timerFd;
+  int signalFd;
+  bool isRunning;
+  uint8_t nextNumber; ///< number of the next device opened
+  uint32_t ticks;     ///< timer expirations so far
+
+  struct Aggregator_Device *devices[AGGREGATOR_MAX_DEVICES];
+
+  struct RecordFile merged; ///< samples of all devices in time order
+  uint64_t mergedNs;        ///< timestamp of last merged sample
+  uint64_t lateCount;       ///< samples merged behind mergedNs
+};
+
+/**
+ * Sets up the event loop and creates the merged capture file.
+ *
+ * SIGINT and SIGTERM are blocked and handled by Aggregator_run().
+ *
+ * @param aggregator
+ * @param options
+ * @return 0 on success, negative errno on failure
+ */
+int Aggregator_init(struct Aggregator *aggregator,
+                    const struct Aggregator_Options *options);
+
+/**
+ * Opens a device, its capture files are created on the first samples.
+ *
+ * @param aggregator
+ * @param path tty, i.e. /dev/ttyACM0 or a pseudo-tty
+ * @return 0 on success, -EEXIST if already open, -ENOMEM if the maximum
+ * number of devices is open, negative errno on other failures
+ */
+int Aggregator_addDevice(struct Aggregator *aggregator, const char *path);
+
+/**
+ * Serves all devices until SIGINT, SIGTERM or timeout.
+ *
+ * @param aggregator
+ * @param durationMs 0 to run until signaled
+ * @return 0 on success, negative errno on failure
+ */
+int Aggregator_run(struct Aggregator *aggregator, uint32_t durationMs);
+
+/**
+ * Closes all devices and files, merges the remaining samples and prints the
+ * statistics to stderr.
+ *
+ * @param aggregator
+ */
+void Aggregator_deinit(struct Aggregator *aggregator);
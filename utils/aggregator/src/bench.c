@@ -0,0 +1,353 @@
+/**
+ * \file bench.c
+ *
+ * Measures the throughput of the host decoder.
+ *
+ * Builds a stream of synthetic samples in memory for each sample format and
+ * feeds it to HostDecoder_feed() in chunks as read from a tty. Samples are
+ * consumed by blocks \see HostDecoder_Handle.onBlockImpl or one by one \see
+ * HostDecoder_Handle.onSampleImpl.
+ */
+
+#define _GNU_SOURCE
+#include <codec.h>
+#include <codec_packed.h>
+#include <crc.h>
+#include <getopt.h>
+#include <host_decoder.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * Samples per block frame, one sensor FiFo as sent by the controller.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define FRAME_SAMPLES 32U
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define SAMPLE_RATE_HZ 3200U
+
+enum Bench_Format {
+  Bench_Format_Acceleration,
+  Bench_Format_Framed, ///< acceleration frames within stream frames
+  Bench_Format_Soa,
+  Bench_Format_Delta,
+  Bench_Format_Packed13,
+  Bench_Format_Count,
+};
+
+static const char *formatNames[Bench_Format_Count] = {
+    [Bench_Format_Acceleration] = "acceleration",
+    [Bench_Format_Framed] = "framed",
+    [Bench_Format_Soa] = "soa",
+    [Bench_Format_Delta] = "delta",
+    [Bench_Format_Packed13] = "packed13",
+};
+
+struct Bench_Stream {
+  uint8_t *bytes;
+  size_t count;
+  size_t capacity;
+};
+
+/**
+ * Sum of all values received, keeps the consumer from being optimized away.
+ */
+static int64_t checksum;
+
+static uint64_t nowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Noisy triangle waves within 13 bits, compress like real vibrations.
+ */
+static struct Codec_Acceleration sampleAt(uint32_t index) {
+  static uint32_t noise = {1};
+  noise = noise * 1103515245U + 12345U;
+  const int16_t wave = {(int16_t)((index * 37U) % 2048U) - 1024};
+  const int16_t jitter = {(int16_t)((noise >> 16U) & 0x7U) - 4};
+  const struct Codec_Acceleration sample = {
+      .x = (int16_t)(wave + jitter),
+      .y = (int16_t)(-wave / 2 + jitter),
+      .z = (int16_t)(256 + jitter)};
+  return sample;
+}
+
+static uint8_t *reserve(struct Bench_Stream *stream, size_t count) {
+  if (stream->capacity < stream->count + count) {
+    stream->capacity = 2U * (stream->count + count);
+    stream->bytes = realloc(stream->bytes, stream->capacity);
+    if (NULL == stream->bytes) {
+      fprintf(stderr, "out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  uint8_t *bytes = {&stream->bytes[stream->count]};
+  stream->count += count;
+  return bytes;
+}
+
+static void putAcceleration(struct Bench_Stream *stream, uint32_t index) {
+  struct TransportFrame *frame = {(struct TransportFrame *)reserve(
+      stream, SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration))};
+  const struct Codec_Acceleration sample = sampleAt(index);
+  frame->header.id = Transport_HeaderId_Tx_Acceleration;
+  frame->asTxFrame.asAcceleration.index = (uint16_t)index;
+  frame->asTxFrame.asAcceleration.values.x = sample.x;
+  frame->asTxFrame.asAcceleration.values.y = sample.y;
+  frame->asTxFrame.asAcceleration.values.z = sample.z;
+}
+
+static void putSoa(struct Bench_Stream *stream, uint32_t firstIndex) {
+  const size_t strideBytes = {
+      TRANSPORTTX_SOA_AXIS_STRIDE_BYTES(FRAME_SAMPLES)};
+  uint8_t *bytes = {reserve(
+      stream, SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSoa) +
+                  3U * strideBytes)};
+  struct TransportFrame *frame = {(struct TransportFrame *)bytes};
+  frame->header.id = Transport_HeaderId_Tx_AccelerationSoa;
+  frame->asTxFrame.asAccelerationSoa.firstIndex = (uint16_t)firstIndex;
+  frame->asTxFrame.asAccelerationSoa.count = FRAME_SAMPLES;
+
+  int16_t x[FRAME_SAMPLES];
+  int16_t y[FRAME_SAMPLES];
+  int16_t z[FRAME_SAMPLES];
+  for (uint32_t idx = 0; idx < FRAME_SAMPLES; idx++) {
+    const struct Codec_Acceleration sample = sampleAt(firstIndex + idx);
+    x[idx] = sample.x;
+    y[idx] = sample.y;
+    z[idx] = sample.z;
+  }
+  uint8_t *columns = {
+      &bytes[SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationSoa)]};
+  memcpy(columns, x, sizeof(x));
+  memcpy(&columns[strideBytes], y, sizeof(y));
+  memcpy(&columns[2U * strideBytes], z, sizeof(z));
+}
+
+static void putDelta(struct Bench_Stream *stream, uint32_t firstIndex) {
+  struct Codec_Acceleration samples[FRAME_SAMPLES];
+  for (uint32_t idx = 0; idx < FRAME_SAMPLES; idx++) {
+    samples[idx] = sampleAt(firstIndex + idx);
+  }
+
+  const size_t headerBytes = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationDelta)};
+  const size_t offset = {stream->count};
+  reserve(stream, headerBytes + CODEC_BLOCK_MAX_BYTES(FRAME_SAMPLES));
+  struct TransportFrame *frame = {
+      (struct TransportFrame *)&stream->bytes[offset]};
+  frame->header.id = Transport_HeaderId_Tx_AccelerationDelta;
+  frame->asTxFrame.asAccelerationDelta.firstIndex = (uint16_t)firstIndex;
+  const int blockBytes = {Codec_encodeBlock(
+      samples, FRAME_SAMPLES, &stream->bytes[offset + headerBytes])};
+  stream->count = offset + headerBytes + blockBytes;
+}
+
+static void putPacked(struct Bench_Stream *stream, uint32_t firstIndex) {
+  struct Codec_Acceleration samples[FRAME_SAMPLES];
+  for (uint32_t idx = 0; idx < FRAME_SAMPLES; idx++) {
+    samples[idx] = sampleAt(firstIndex + idx);
+  }
+
+  const size_t headerBytes = {
+      SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_AccelerationPacked)};
+  uint8_t *bytes = {reserve(
+      stream, headerBytes + FRAME_SAMPLES * Codec_packedSizeBytes(
+                                                Codec_Packing_13bit))};
+  struct TransportFrame *frame = {(struct TransportFrame *)bytes};
+  frame->header.id = Transport_HeaderId_Tx_AccelerationPacked;
+  frame->asTxFrame.asAccelerationPacked.firstIndex = (uint16_t)firstIndex;
+  frame->asTxFrame.asAccelerationPacked.count = FRAME_SAMPLES;
+  frame->asTxFrame.asAccelerationPacked.format =
+      Transport_SampleFormat_Packed13;
+  Codec_pack(Codec_Packing_13bit, samples, FRAME_SAMPLES,
+             &bytes[headerBytes]);
+}
+
+/**
+ * Wraps a stream of frames into stream frames of full transmit chunks.
+ */
+static void putFramed(struct Bench_Stream *stream,
+                      const struct Bench_Stream *frames) {
+  const size_t headerBytes = {sizeof(struct Transport_StreamFrameHeader)};
+  uint16_t sequence = {0};
+
+  for (size_t offset = 0; offset < frames->count;
+       offset += TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES) {
+    size_t length = {frames->count - offset};
+    if (TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES < length) {
+      length = TRANSPORTTX_TRANSMIT_TX_DATA_CHUNK_BUFFER_BYTES;
+    }
+    const size_t paddedBytes = {headerBytes + ((length + 3U) & ~3U)};
+    uint32_t words[HOSTDECODER_FRAME_MAX_BYTES / sizeof(uint32_t)] = {0};
+    struct Transport_StreamFrameHeader *header = {
+        (struct Transport_StreamFrameHeader *)words};
+    header->sync = TRANSPORT_STREAM_SYNC;
+    header->length = (uint16_t)length;
+    header->sequence = sequence++;
+    memcpy(&((uint8_t *)words)[headerBytes], &frames->bytes[offset], length);
+    words[paddedBytes / sizeof(uint32_t)] =
+        Crc_crc32Words(words, paddedBytes / sizeof(uint32_t));
+    memcpy(reserve(stream, paddedBytes + sizeof(uint32_t)), words,
+           paddedBytes + sizeof(uint32_t));
+  }
+}
+
+static void build(struct Bench_Stream *stream, enum Bench_Format format,
+                  uint32_t samplesCount) {
+  struct Bench_Stream frames = {.bytes = NULL, .count = 0, .capacity = 0};
+
+  for (uint32_t index = 0; index < samplesCount;) {
+    switch (format) {
+    case Bench_Format_Acceleration:
+    case Bench_Format_Framed:
+      putAcceleration(&frames, index);
+      index++;
+      break;
+    case Bench_Format_Soa:
+      putSoa(&frames, index);
+      index += FRAME_SAMPLES;
+      break;
+    case Bench_Format_Delta:
+      putDelta(&frames, index);
+      index += FRAME_SAMPLES;
+      break;
+    default:
+      putPacked(&frames, index);
+      index += FRAME_SAMPLES;
+      break;
+    }
+  }
+
+  if (Bench_Format_Framed == format) {
+    putFramed(stream, &frames);
+    free(frames.bytes);
+  } else {
+    *stream = frames;
+  }
+}
+
+static void onBlock(void *context, const struct HostDecoder_Block *block) {
+  for (uint16_t idx = 0; idx < block->count; idx++) {
+    checksum += block->x[idx] + block->y[idx] + block->z[idx];
+  }
+}
+
+static void onSample(void *context, const struct HostDecoder_Sample *sample) {
+  checksum += sample->values.x + sample->values.y + sample->values.z;
+}
+
+/**
+ * Decodes the stream once.
+ *
+ * @return elapsed time in seconds
+ */
+static double run(const struct Bench_Stream *stream, size_t chunkBytes,
+                  bool isBlocks, struct HostDecoder_Statistics *statistics) {
+  static struct HostDecoder_Handle decoder;
+  const struct HostDecoder_Handle initial =
+      HOSTDECODER_INITIALIZER(NULL, isBlocks ? NULL : onSample,
+                              isBlocks ? onBlock : NULL, NULL);
+  decoder = initial;
+
+  const uint64_t startNs = {nowNs()};
+  for (size_t offset = 0; offset < stream->count; offset += chunkBytes) {
+    const size_t count = {stream->count - offset < chunkBytes
+                              ? stream->count - offset
+                              : chunkBytes};
+    HostDecoder_feed(&decoder, &stream->bytes[offset], count);
+  }
+  const uint64_t elapsedNs = {nowNs() - startNs};
+
+  *statistics = decoder.statistics;
+  return (double)elapsedNs / 1e9;
+}
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [-n SAMPLES] [-c BYTES] [-r REPEAT]\n"
+          "  -n, --samples SAMPLES samples per format, default 4194304\n"
+          "  -c, --chunk BYTES     bytes fed at once, default 16384\n"
+          "  -r, --repeat REPEAT   best of REPEAT runs, default 3\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  static const struct option longOptions[] = {
+      {"samples", required_argument, NULL, 'n'},
+      {"chunk", required_argument, NULL, 'c'},
+      {"repeat", required_argument, NULL, 'r'},
+      {"help", no_argument, NULL, 'h'},
+      {NULL, 0, NULL, 0}};
+  uint32_t samplesCount = {4194304U};
+  size_t chunkBytes = {16384U};
+  uint32_t repeat = {3};
+
+  int option = {0};
+  while (-1 != (option = getopt_long(argc, argv, "n:c:r:h", longOptions,
+                                     NULL))) {
+    switch (option) {
+    case 'n':
+      samplesCount = strtoul(optarg, NULL, 0);
+      break;
+    case 'c':
+      chunkBytes = strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      repeat = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      usage(argv[0]);
+      return 'h' == option ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (0 == samplesCount || 0 == chunkBytes || 0 == repeat) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  printf("%-12s %-7s %10s %10s %10s %12s\n", "format", "consume", "MiB",
+         "MiB/s", "Msamples/s", "sensors@3200");
+  int result = {EXIT_SUCCESS};
+  for (uint8_t format = 0; format < Bench_Format_Count; format++) {
+    struct Bench_Stream stream = {.bytes = NULL, .count = 0, .capacity = 0};
+    build(&stream, format, samplesCount);
+
+    for (uint8_t isBlocks = 0; isBlocks < 2U; isBlocks++) {
+      struct HostDecoder_Statistics statistics = {0};
+      double bestSeconds = {0};
+      for (uint32_t idx = 0; idx < repeat; idx++) {
+        const double seconds = {
+            run(&stream, chunkBytes, isBlocks, &statistics)};
+        if (0 == idx || seconds < bestSeconds) {
+          bestSeconds = seconds;
+        }
+      }
+      if (statistics.samplesCount < samplesCount ||
+          0 != statistics.discardedBytes) {
+        fprintf(stderr, "%s: decoded %" PRIu32 " samples, discarded %" PRIu32
+                        " bytes\n",
+                formatNames[format], statistics.samplesCount,
+                statistics.discardedBytes);
+        result = EXIT_FAILURE;
+      }
+
+      const double samplesPerSecond = {statistics.samplesCount / bestSeconds};
+      printf("%-12s %-7s %10.1f %10.1f %10.2f %12.0f\n", formatNames[format],
+             isBlocks ? "blocks" : "samples",
+             (double)stream.count / (1024.0 * 1024.0),
+             (double)stream.count / (1024.0 * 1024.0) / bestSeconds,
+             samplesPerSecond / 1e6, samplesPerSecond / SAMPLE_RATE_HZ);
+    }
+    free(stream.bytes);
+  }
+
+  fprintf(stderr, "checksum %" PRId64 "\n", checksum);
+  return result;
+}
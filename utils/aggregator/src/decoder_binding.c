@@ -0,0 +1,65 @@
+/**
+ * \file decoder_binding.c
+ */
+
+#include "decoder_binding.h"
+#include <stdlib.h>
+
+/**
+ * Callbacks of the binding, the first member is HostDecoder_Handle so the
+ * handle is handed out to the binding as is.
+ */
+struct DecoderBinding {
+  struct HostDecoder_Handle decoder;
+  DecoderBinding_OnFrame onFrame;
+  DecoderBinding_OnBlock onBlock;
+  void *context;
+};
+
+static void binding_onFrame(void *context, const struct TransportFrame *frame,
+                            uint16_t frameBytes) {
+  const struct DecoderBinding *binding = {context};
+  if (NULL != binding->onFrame) {
+    binding->onFrame(binding->context, (const uint8_t *)frame, frameBytes);
+  }
+}
+
+static void binding_onBlock(void *context,
+                            const struct HostDecoder_Block *block) {
+  const struct DecoderBinding *binding = {context};
+  if (NULL != binding->onBlock) {
+    binding->onBlock(binding->context, block);
+  }
+}
+
+uint32_t DecoderBinding_version(void) { return DECODERBINDING_VERSION; }
+
+size_t DecoderBinding_blockSizeBytes(void) {
+  return sizeof(struct HostDecoder_Block);
+}
+
+struct HostDecoder_Handle *DecoderBinding_create(DecoderBinding_OnFrame onFrame,
+                                                 DecoderBinding_OnBlock onBlock,
+                                                 void *context) {
+  struct DecoderBinding *binding = {malloc(sizeof(struct DecoderBinding))};
+  if (NULL == binding) {
+    return NULL;
+  }
+
+  const struct HostDecoder_Handle decoder =
+      HOSTDECODER_INITIALIZER(binding_onFrame, NULL, binding_onBlock, binding);
+  binding->decoder = decoder;
+  binding->onFrame = onFrame;
+  binding->onBlock = onBlock;
+  binding->context = context;
+  return &binding->decoder;
+}
+
+void DecoderBinding_destroy(struct HostDecoder_Handle *handle) {
+  free(handle);
+}
+
+const struct HostDecoder_Statistics *
+DecoderBinding_statistics(const struct HostDecoder_Handle *handle) {
+  return &handle->statistics;
+}
@@ -0,0 +1,60 @@
+/**
+ * \file decoder_binding.h
+ *
+ * Entry points of the shared decoder library for foreign function interfaces,
+ * i.e. Python's ctypes \see utils/3dpaxxel/host_decoder.py.
+ *
+ * The decoder handle is allocated by the library, hence bindings only mirror
+ * HostDecoder_Block and HostDecoder_Statistics. The frame callback gets the
+ * frame as bytes, \see HostDecoder_Handle.onFrameImpl.
+ */
+
+#pragma once
+
+#include <host_decoder.h>
+
+/**
+ * ABI version, incremented whenever a mirrored structure changes.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define DECODERBINDING_VERSION 1U
+
+typedef void (*DecoderBinding_OnFrame)(void *context, const uint8_t *frame,
+                                       uint16_t frameBytes);
+typedef void (*DecoderBinding_OnBlock)(void *context,
+                                       const struct HostDecoder_Block *block);
+
+/**
+ * @return DECODERBINDING_VERSION the library was built with
+ */
+uint32_t DecoderBinding_version(void);
+
+/**
+ * @return sizeof(struct HostDecoder_Block), lets bindings verify their mirror
+ */
+size_t DecoderBinding_blockSizeBytes(void);
+
+/**
+ * Allocates a decoder.
+ *
+ * @param onFrame called for each frame except sample and stream frames, may
+ * be NULL
+ * @param onBlock called for each block of samples, may be NULL
+ * @param context passed to the callbacks as is
+ * @return decoder, NULL if out of memory
+ */
+struct HostDecoder_Handle *DecoderBinding_create(DecoderBinding_OnFrame onFrame,
+                                                 DecoderBinding_OnBlock onBlock,
+                                                 void *context);
+
+/**
+ * @param handle created by DecoderBinding_create(), may be NULL
+ */
+void DecoderBinding_destroy(struct HostDecoder_Handle *handle);
+
+/**
+ * @param handle
+ * @return counters of the decoder
+ */
+const struct HostDecoder_Statistics *
+DecoderBinding_statistics(const struct HostDecoder_Handle *handle);
@@ -0,0 +1,100 @@
+/**
+ * \file dump.c
+ *
+ * Prints a record or capture file as tab separated values.
+ */
+
+#include "record_file.h"
+#include <capture_file.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void dumpRecords(const struct RecordFile *file) {
+  const struct RecordFile_Header *header = {RecordFile_header(file)};
+  printf("# source %s, records %" PRIu64 ", monotonic %" PRIu64
+         "ns, realtime %" PRIu64 "ns\n",
+         header->source, file->recordsCount, header->monotonicNs,
+         header->realtimeNs);
+  printf("timestamp_ns\tdevice\tsensor\tindex\tx\ty\tz\n");
+
+  const struct RecordFile_Record *records = {RecordFile_records(file)};
+  for (uint64_t idx = 0; idx < file->recordsCount; idx++) {
+    const struct RecordFile_Record *record = {&records[idx]};
+    printf("%" PRIu64 "\t%u\t%u\t%" PRIu32 "\t%d\t%d\t%d\n",
+           record->timestampNs, record->device, record->sensor, record->index,
+           record->x, record->y, record->z);
+  }
+}
+
+/**
+ * Prints markers followed by the samples, timestamps are interpolated within
+ * each block.
+ */
+static void dumpCapture(const struct CaptureFile *file) {
+  const struct CaptureFile_Header *header = {CaptureFile_header(file)};
+  printf("# source %s, sensor %u, samples %" PRIu64 ", blocks %" PRIu32
+         ", period %" PRIu64 "ns, monotonic %" PRIu64 "ns, realtime %" PRIu64
+         "ns, firmware %u.%u.%u, rate %u, range %u, scale %u\n",
+         header->source, header->sensor, header->samplesCount,
+         header->blocksCount, header->periodNs, header->monotonicNs,
+         header->realtimeNs, header->firmware.major, header->firmware.minor,
+         header->firmware.patch, header->setup.outputDataRate,
+         header->setup.range, header->setup.scale);
+
+  const struct CaptureFile_Marker *markers = {CaptureFile_markers(file)};
+  for (uint32_t idx = 0; idx < header->markersCount; idx++) {
+    printf("# marker kind %" PRIu32 ", value %" PRIu32 ", position %" PRIu64
+           ", index %" PRIu64 "\n",
+           markers[idx].kind, markers[idx].value, markers[idx].position,
+           markers[idx].sampleIndex);
+  }
+  printf("timestamp_ns\tsensor\tindex\tx\ty\tz\n");
+
+  const struct CaptureFile_Block *blocks = {CaptureFile_blocks(file)};
+  for (uint32_t block = 0; block < header->blocksCount; block++) {
+    const struct CaptureFile_Block *entry = {&blocks[block]};
+    const int16_t *x = {CaptureFile_column(file, block, CaptureFile_Axis_X)};
+    const int16_t *y = {CaptureFile_column(file, block, CaptureFile_Axis_Y)};
+    const int16_t *z = {CaptureFile_column(file, block, CaptureFile_Axis_Z)};
+    const uint64_t spanNs = {entry->lastStampNs - entry->firstStampNs};
+
+    for (uint32_t idx = 0; idx < entry->count; idx++) {
+      const uint64_t stampNs = {
+          1U < entry->count
+              ? entry->firstStampNs + spanNs * idx / (entry->count - 1U)
+              : entry->firstStampNs};
+      printf("%" PRIu64 "\t%u\t%" PRIu64 "\t%d\t%d\t%d\n", stampNs,
+             header->sensor, entry->firstIndex + idx, x[idx], y[idx], z[idx]);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  if (2 != argc) {
+    fprintf(stderr, "usage: %s FILE\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  struct RecordFile records = RECORDFILE_INITIALIZER;
+  int result = {RecordFile_open(&records, argv[1])};
+  if (0 == result) {
+    dumpRecords(&records);
+    RecordFile_close(&records);
+    return EXIT_SUCCESS;
+  }
+
+  struct CaptureFile capture = CAPTUREFILE_INITIALIZER;
+  if (-EBADMSG == result) {
+    result = CaptureFile_open(&capture, argv[1]);
+  }
+  if (0 != result) {
+    fprintf(stderr, "%s: %s\n", argv[1], strerror(-result));
+    return EXIT_FAILURE;
+  }
+
+  dumpCapture(&capture);
+  CaptureFile_close(&capture);
+  return EXIT_SUCCESS;
+}
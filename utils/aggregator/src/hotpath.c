@@ -0,0 +1,333 @@
+/**
+ * \file hotpath.c
+ *
+ * Measures the firmware's sampling and streaming hot path natively.
+ *
+ * Built twice by the Makefile: with the flags of env:controller (-O0) and
+ * with those of env:controller_performance (-Os, LTO, RAMFUNC functions at
+ * -O3), hence both reports compare the optimization of each hot function. The
+ * sensor and the USB endpoint are stubs: the figures cover the firmware's own
+ * share only. Cycles are read from the time stamp counter where available.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <getopt.h>
+#include <host_transport.h>
+#include <host_transport_types.h>
+#include <ringbuffer.h>
+#include <sampling.h>
+#include <sampling_types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <to_host_transport.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef HOTPATH_BUILD
+#define HOTPATH_BUILD "custom"
+#endif
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define STORAGE_SIZE_BYTES 32768U
+
+/**
+ * Items of the ringbuffer benchmark, as many as the streaming ringbuffer.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define RINGBUFFER_ITEMS                                                       \
+  (STORAGE_SIZE_BYTES /                                                        \
+   SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration))
+
+enum Hotpath_Function {
+  Hotpath_Function_RingbufferPut,
+  Hotpath_Function_RingbufferTake,
+  Hotpath_Function_TxAccelerationBuffer,
+  Hotpath_Function_FetchForward,
+  Hotpath_Function_Stream, ///< fetch forward into TxAccelerationBuffer
+  Hotpath_Function_Count,
+};
+
+static const char *functionNames[Hotpath_Function_Count] = {
+    [Hotpath_Function_RingbufferPut] = "Ringbuffer_put",
+    [Hotpath_Function_RingbufferTake] = "Ringbuffer_take",
+    [Hotpath_Function_TxAccelerationBuffer] =
+        "TransportTx_TxAccelerationBuffer",
+    [Hotpath_Function_FetchForward] = "Sampling_fetchForward",
+    [Hotpath_Function_Stream] = "stream (fetch, forward, transmit)",
+};
+
+struct Hotpath_Result {
+  uint32_t calls;
+  uint32_t samplesPerCall;
+  uint64_t ns;
+  uint64_t cycles; ///< 0 if no cycle counter
+};
+
+static uint8_t storage[STORAGE_SIZE_BYTES];
+
+/**
+ * Sum of all values passed on, keeps stubs from being optimized away.
+ */
+static int64_t checksum;
+
+/**
+ * Whether Sampling_fetchForward() forwards to the transport or discards.
+ */
+static bool isForwardedToTransport;
+
+static uint64_t nowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t nowCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static enum HostTransport_Status hotpath_doTransmitImpl(uint8_t *buffer,
+                                                        uint16_t length) {
+  checksum += buffer[0] + length;
+  return HostTransport_Status_Ok;
+}
+
+static volatile bool hotpath_isTransmitBusyImpl() { return false; }
+
+static uint32_t hotpath_doCrc32WordsImpl(const uint32_t *words,
+                                         uint16_t count) {
+  return words[0] ^ count;
+}
+
+static uint32_t hotpath_getTickMsImpl() { return 0; }
+
+static int hotpath_onTakeReceivedImpl(const uint8_t *buffer) { return 0; }
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct HostTransport_Handle transport = {
+    .fromHost = {.doTakeReceivedPacketImpl = hotpath_onTakeReceivedImpl},
+    .toHost = {
+        .ringbuffer = {.storage = storage},
+        .axes = Transport_Axis_All,
+        .format = Transport_SampleFormat_Acceleration,
+        .doTransmitImpl = hotpath_doTransmitImpl,
+        .isTransmitBusyImpl = hotpath_isTransmitBusyImpl,
+        .doCrc32WordsImpl = hotpath_doCrc32WordsImpl,
+        .getTickMsImpl = hotpath_getTickMsImpl,
+    }};
+
+static void sampling_doNothing(const struct Sampling_Handle *handle) {}
+
+static void sampling_doWaitDelay5usImpl(struct Sampling_Handle *handle) {}
+
+static void
+sampling_doFetchSensorAccelerationImpl(const struct Sampling_Handle *handle,
+                                       struct Sampling_Acceleration *sample) {
+  static int16_t value = {0};
+  if (NULL != sample) {
+    sample->x = value++;
+    sample->y = (int16_t)-value;
+    sample->z = 256;
+  }
+}
+
+static int sampling_doForwardAccelerationBufferImpl(
+    const struct Sampling_Handle *handle,
+    const struct Sampling_Acceleration *buffer, uint16_t bufferLen,
+    uint16_t firstIndex) {
+  if (isForwardedToTransport) {
+    return TransportTx_TxAccelerationBuffer(
+        &transport, (const struct Transport_Acceleration *)buffer,
+        (uint8_t)bufferLen, firstIndex);
+  }
+  if (NULL == buffer) {
+    return -ENODATA;
+  }
+  checksum += buffer[bufferLen - 1U].x + firstIndex;
+  return 0;
+}
+
+static int sampling_doFlushAccelerationBufferImpl() { return -ENODATA; }
+
+static uint8_t
+sampling_doGetFifoEntriesImpl(const struct Sampling_Handle *handle) {
+  return SAMPLING_NUM_SAMPLES_READ_AT_ONCE;
+}
+
+static void sampling_onEvent() {}
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct Sampling_Handle sampling = {
+    .state = {.samplesPerFetch = SAMPLING_NUM_SAMPLES_READ_AT_ONCE},
+    .sensor = 0,
+    .doEnableSensorImpl = sampling_doNothing,
+    .doDisableSensorImpl = sampling_doNothing,
+    .doFetchSensorAccelerationImpl = sampling_doFetchSensorAccelerationImpl,
+    .doWaitDelay5usImpl = sampling_doWaitDelay5usImpl,
+    .doForwardAccelerationBufferImpl = sampling_doForwardAccelerationBufferImpl,
+    .doFlushAccelerationBufferImpl = sampling_doFlushAccelerationBufferImpl,
+    .doGetFifoEntriesImpl = sampling_doGetFifoEntriesImpl,
+    .onSamplingStartedCb = sampling_onEvent,
+    .onSamplingStoppedCb = sampling_onEvent,
+    .onSamplingAbortedCb = sampling_onEvent,
+    .onSamplingFinishedCb = sampling_onEvent,
+    .onFifoOverflowCb = sampling_onEvent,
+    .onBufferOverflowCb = sampling_onEvent,
+    .onTransmissionErrorCb = sampling_onEvent,
+};
+
+static void startSampling(bool isStream) {
+  isForwardedToTransport = isStream;
+  Transport_setAxes(&transport, Transport_Axis_All, STORAGE_SIZE_BYTES);
+  Sampling_start(&sampling, 0);
+  Sampling_setFifoWatermark(&sampling);
+  // takes the start request and the first batch
+  Sampling_fetchForward(&sampling);
+}
+
+static void stopSampling() {
+  Sampling_stop(&sampling);
+  Sampling_fetchForward(&sampling);
+}
+
+/**
+ * Runs calls of one function.
+ *
+ * @param function
+ * @param calls
+ * @param result output, elapsed time of all calls
+ */
+static void measure(enum Hotpath_Function function, uint32_t calls,
+                    struct Hotpath_Result *result) {
+  static struct Ringbuffer ringbuffer;
+  static uint8_t
+      item[SIZEOF_HEADER_INCL_PAYLOAD(struct TransportTx_Acceleration)];
+  struct Transport_Acceleration samples[SAMPLING_NUM_SAMPLES_READ_AT_ONCE];
+  for (uint8_t idx = 0; idx < SAMPLING_NUM_SAMPLES_READ_AT_ONCE; idx++) {
+    samples[idx].x = idx;
+    samples[idx].y = (int16_t)-idx;
+    samples[idx].z = 256;
+  }
+
+  result->calls = calls;
+  result->samplesPerCall = 1;
+  switch (function) {
+  case Hotpath_Function_RingbufferPut:
+  case Hotpath_Function_RingbufferTake:
+    // calls fill the ringbuffer at most
+    if (RINGBUFFER_ITEMS < calls) {
+      result->calls = calls = RINGBUFFER_ITEMS;
+    }
+    Ringbuffer_init(&ringbuffer, storage, RINGBUFFER_ITEMS, sizeof(item));
+    if (Hotpath_Function_RingbufferTake == function) {
+      for (uint32_t idx = 0; idx < calls; idx++) {
+        Ringbuffer_put(&ringbuffer, item);
+      }
+    }
+    break;
+  case Hotpath_Function_TxAccelerationBuffer:
+    result->samplesPerCall = SAMPLING_NUM_SAMPLES_READ_AT_ONCE;
+    Transport_setAxes(&transport, Transport_Axis_All, STORAGE_SIZE_BYTES);
+    break;
+  case Hotpath_Function_FetchForward:
+  case Hotpath_Function_Stream:
+    result->samplesPerCall = SAMPLING_NUM_SAMPLES_READ_AT_ONCE;
+    startSampling(Hotpath_Function_Stream == function);
+    break;
+  default:
+    break;
+  }
+
+  const uint64_t startNs = {nowNs()};
+  const uint64_t startCycles = {nowCycles()};
+  for (uint32_t idx = 0; idx < calls; idx++) {
+    switch (function) {
+    case Hotpath_Function_RingbufferPut:
+      Ringbuffer_put(&ringbuffer, item);
+      break;
+    case Hotpath_Function_RingbufferTake:
+      Ringbuffer_take(&ringbuffer, item);
+      break;
+    case Hotpath_Function_TxAccelerationBuffer:
+      TransportTx_TxAccelerationBuffer(&transport, samples,
+                                       SAMPLING_NUM_SAMPLES_READ_AT_ONCE,
+                                       (uint16_t)idx);
+      break;
+    default:
+      Sampling_fetchForward(&sampling);
+      break;
+    }
+  }
+  result->cycles = nowCycles() - startCycles;
+  result->ns = nowNs() - startNs;
+
+  if (Hotpath_Function_FetchForward == function ||
+      Hotpath_Function_Stream == function) {
+    stopSampling();
+  }
+}
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [-n CALLS] [-r REPEAT]\n"
+          "  -n, --calls CALLS   calls per function, default 100000\n"
+          "  -r, --repeat REPEAT best of REPEAT runs, default 5\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  static const struct option longOptions[] = {
+      {"calls", required_argument, NULL, 'n'},
+      {"repeat", required_argument, NULL, 'r'},
+      {"help", no_argument, NULL, 'h'},
+      {NULL, 0, NULL, 0}};
+
+  uint32_t calls = {100000U};
+  uint32_t repeat = {5};
+  int option = {0};
+  while (-1 != (option = getopt_long(argc, argv, "n:r:h", longOptions, NULL))) {
+    switch (option) {
+    case 'n':
+      calls = strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      repeat = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      usage(argv[0]);
+      return 'h' == option ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (0 == calls || 0 == repeat) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  printf("%-12s %-34s %8s %10s %12s %14s\n", "build", "function", "samples",
+         "ns/call", "cycles/call", "cycles/sample");
+  for (uint8_t function = 0; function < Hotpath_Function_Count; function++) {
+    struct Hotpath_Result best = {0};
+    for (uint32_t idx = 0; idx < repeat; idx++) {
+      struct Hotpath_Result result = {0};
+      measure(function, calls, &result);
+      if (0 == idx || result.ns < best.ns) {
+        best = result;
+      }
+    }
+
+    const double cyclesPerCall = {(double)best.cycles / best.calls};
+    printf("%-12s %-34s %8" PRIu32 " %10.1f %12.1f %14.1f\n", HOTPATH_BUILD,
+           functionNames[function], best.samplesPerCall,
+           (double)best.ns / best.calls, cyclesPerCall,
+           cyclesPerCall / best.samplesPerCall);
+  }
+  fprintf(stderr, "checksum %" PRId64 "\n", checksum);
+  return EXIT_SUCCESS;
+}
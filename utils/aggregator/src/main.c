@@ -0,0 +1,91 @@
+/**
+ * \file main.c
+ *
+ * Command line of the aggregator.
+ */
+
+#include "aggregator.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [-o DIR] [-d] [-s] [-f] [-t SECONDS] [DEVICE...]\n"
+          "  -o, --output DIR      directory of capture files, default .\n"
+          "  -d, --discover        open all controllers, rescan every second\n"
+          "  -s, --start           start sampling on open, stop on exit\n"
+          "  -f, --framing         enable stream framing on open\n"
+          "  -t, --duration SECONDS stop after SECONDS, default until "
+          "SIGINT\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  static const struct option longOptions[] = {
+      {"output", required_argument, NULL, 'o'},
+      {"discover", no_argument, NULL, 'd'},
+      {"start", no_argument, NULL, 's'},
+      {"framing", no_argument, NULL, 'f'},
+      {"duration", required_argument, NULL, 't'},
+      {"help", no_argument, NULL, 'h'},
+      {NULL, 0, NULL, 0}};
+  struct Aggregator_Options options = {.outputDir = ".",
+                                       .isDiscover = false,
+                                       .isStart = false,
+                                       .isFramed = false};
+  uint32_t durationMs = {0};
+
+  int option = {0};
+  while (-1 !=
+         (option = getopt_long(argc, argv, "o:dsft:h", longOptions, NULL))) {
+    switch (option) {
+    case 'o':
+      options.outputDir = optarg;
+      break;
+    case 'd':
+      options.isDiscover = true;
+      break;
+    case 's':
+      options.isStart = true;
+      break;
+    case 'f':
+      options.isFramed = true;
+      break;
+    case 't':
+      durationMs = (uint32_t)(strtod(optarg, NULL) * 1000.0);
+      break;
+    default:
+      usage(argv[0]);
+      return 'h' == option ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (!options.isDiscover && optind == argc) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  static struct Aggregator aggregator;
+  int result = {Aggregator_init(&aggregator, &options)};
+  if (0 != result) {
+    fprintf(stderr, "init: %s\n", strerror(-result));
+    Aggregator_deinit(&aggregator);
+    return EXIT_FAILURE;
+  }
+
+  for (int idx = optind; idx < argc; idx++) {
+    result = Aggregator_addDevice(&aggregator, argv[idx]);
+    if (0 != result) {
+      fprintf(stderr, "%s: %s\n", argv[idx], strerror(-result));
+    }
+  }
+
+  result = Aggregator_run(&aggregator, durationMs);
+  if (0 != result) {
+    fprintf(stderr, "run: %s\n", strerror(-result));
+  }
+
+  Aggregator_deinit(&aggregator);
+  return 0 == result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+/**
+ * \file record_file.c
+ */
+
+#define _GNU_SOURCE
+#include "record_file.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t nowNs(clockid_t clock) {
+  struct timespec now;
+  clock_gettime(clock, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * Grows file and mapping to hold at least requiredBytes.
+ *
+ * @param file
+ * @param requiredBytes
+ * @return 0 on success, negative errno on failure
+ */
+static int grow(struct RecordFile *file, size_t requiredBytes) {
+  size_t mapBytes = {file->mapBytes};
+  while (mapBytes < requiredBytes) {
+    mapBytes += RECORDFILE_GROW_BYTES;
+  }
+  if (mapBytes == file->mapBytes) {
+    return 0;
+  }
+
+  if (0 != ftruncate(file->fd, (off_t)mapBytes)) {
+    return -errno;
+  }
+
+  void *map = {NULL == file->map
+                   ? mmap(NULL, mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          file->fd, 0)
+                   : mremap(file->map, file->mapBytes, mapBytes,
+                            MREMAP_MAYMOVE)};
+  if (MAP_FAILED == map) {
+    return -errno;
+  }
+
+  file->map = map;
+  file->mapBytes = mapBytes;
+  return 0;
+}
+
+int RecordFile_create(struct RecordFile *file, const char *path,
+                      const char *source) {
+  file->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (0 > file->fd) {
+    return -errno;
+  }
+  file->map = NULL;
+  file->mapBytes = 0;
+  file->recordsCount = 0;
+  file->isWritable = true;
+
+  const int result = {grow(file, sizeof(struct RecordFile_Header))};
+  if (0 != result) {
+    close(file->fd);
+    file->fd = -1;
+    return result;
+  }
+
+  struct RecordFile_Header *header = {(struct RecordFile_Header *)file->map};
+  memcpy(header->magic, RECORDFILE_MAGIC, sizeof(header->magic));
+  header->version = RECORDFILE_VERSION;
+  header->recordBytes = sizeof(struct RecordFile_Record);
+  header->monotonicNs = nowNs(CLOCK_MONOTONIC);
+  header->realtimeNs = nowNs(CLOCK_REALTIME);
+  header->recordsCount = 0;
+  strncpy(header->source, source, sizeof(header->source) - 1U);
+  return 0;
+}
+
+int RecordFile_append(struct RecordFile *file,
+                      const struct RecordFile_Record *records, size_t count) {
+  const size_t offset = {sizeof(struct RecordFile_Header) +
+                         file->recordsCount * sizeof(*records)};
+  const int result = {grow(file, offset + count * sizeof(*records))};
+  if (0 != result) {
+    return result;
+  }
+
+  memcpy(&file->map[offset], records, count * sizeof(*records));
+  file->recordsCount += count;
+  ((struct RecordFile_Header *)file->map)->recordsCount = file->recordsCount;
+  return 0;
+}
+
+int RecordFile_open(struct RecordFile *file, const char *path) {
+  file->fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (0 > file->fd) {
+    return -errno;
+  }
+
+  struct stat status;
+  if (0 != fstat(file->fd, &status)) {
+    const int result = {-errno};
+    close(file->fd);
+    return result;
+  }
+
+  file->mapBytes = 0;
+  file->isWritable = false;
+  file->map = MAP_FAILED;
+  if (sizeof(struct RecordFile_Header) <= (size_t)status.st_size) {
+    file->map = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, file->fd, 0);
+  }
+  if (MAP_FAILED == file->map) {
+    close(file->fd);
+    return -EBADMSG;
+  }
+  file->mapBytes = status.st_size;
+
+  const struct RecordFile_Header *header = {RecordFile_header(file)};
+  const uint64_t capacity = {
+      (file->mapBytes - sizeof(*header)) / sizeof(struct RecordFile_Record)};
+  if (0 != memcmp(header->magic, RECORDFILE_MAGIC, sizeof(header->magic)) ||
+      sizeof(struct RecordFile_Record) != header->recordBytes ||
+      capacity < header->recordsCount) {
+    munmap(file->map, file->mapBytes);
+    close(file->fd);
+    return -EBADMSG;
+  }
+
+  file->recordsCount = header->recordsCount;
+  return 0;
+}
+
+const struct RecordFile_Header *
+RecordFile_header(const struct RecordFile *file) {
+  return (const struct RecordFile_Header *)file->map;
+}
+
+const struct RecordFile_Record *
+RecordFile_records(const struct RecordFile *file) {
+  return (const struct RecordFile_Record
+              *)&file->map[sizeof(struct RecordFile_Header)];
+}
+
+void RecordFile_close(struct RecordFile *file) {
+  if (0 > file->fd) {
+    return;
+  }
+
+  munmap(file->map, file->mapBytes);
+  // drop the room reserved for growing
+  if (file->isWritable &&
+      0 != ftruncate(file->fd, sizeof(struct RecordFile_Header) +
+                                   file->recordsCount *
+                                       sizeof(struct RecordFile_Record))) {
+    file->isWritable = false;
+  }
+  close(file->fd);
+  file->fd = -1;
+  file->map = NULL;
+  file->mapBytes = 0;
+}
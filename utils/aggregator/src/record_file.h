@@ -0,0 +1,120 @@
+/**
+ * \file record_file.h
+ *
+ * Memory-mapped capture file of timestamped samples.
+ *
+ * Layout: RecordFile_Header followed by RecordFile_Header.recordsCount
+ * records of type RecordFile_Record, both little endian and packed. The
+ * header is kept up to date while recording, so a file can be read while
+ * it grows.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Identifies the file type.
+ */
+#define RECORDFILE_MAGIC "3DPAXREC"
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define RECORDFILE_VERSION 1U
+
+/**
+ * The file grows in steps of this size while recording.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define RECORDFILE_GROW_BYTES (16UL * 1024UL * 1024UL)
+
+struct RecordFile_Header {
+  char magic[8];         ///< RECORDFILE_MAGIC without termination
+  uint32_t version;      ///< RECORDFILE_VERSION
+  uint32_t recordBytes;  ///< sizeof(struct RecordFile_Record)
+  uint64_t monotonicNs;  ///< CLOCK_MONOTONIC at creation
+  uint64_t realtimeNs;   ///< CLOCK_REALTIME at creation
+  uint64_t recordsCount; ///< number of records following
+  char source[64];       ///< device path or "merged", zero terminated
+} __attribute__((packed));
+
+/**
+ * One sample with host timestamp.
+ */
+struct RecordFile_Record {
+  uint64_t timestampNs; ///< estimated CLOCK_MONOTONIC at sampling
+  uint32_t index;       ///< running sample index of the sensor, unwrapped
+  uint8_t device;       ///< device number of the aggregator
+  uint8_t sensor;       ///< sensor ID within the device
+  int16_t x;            ///< raw value as received
+  int16_t y;            ///< raw value as received
+  int16_t z;            ///< raw value as received
+} __attribute__((packed));
+
+struct RecordFile {
+  int fd;
+  uint8_t *map;          ///< whole file
+  size_t mapBytes;       ///< size of mapping and file while recording
+  uint64_t recordsCount; ///< number of records
+  bool isWritable;       ///< created for recording
+};
+
+#define RECORDFILE_INITIALIZER                                                 \
+  {                                                                            \
+    .fd = -1, .map = NULL, .mapBytes = 0, .recordsCount = 0,                   \
+    .isWritable = false,                                                       \
+  }
+
+/**
+ * Creates a file for recording, replaces an existing one.
+ *
+ * @param file
+ * @param path
+ * @param source written to RecordFile_Header.source
+ * @return 0 on success, negative errno on failure
+ */
+int RecordFile_create(struct RecordFile *file, const char *path,
+                      const char *source);
+
+/**
+ * Appends records.
+ *
+ * @param file created by RecordFile_create()
+ * @param records
+ * @param count number of records
+ * @return 0 on success, negative errno if the file could not grow
+ */
+int RecordFile_append(struct RecordFile *file,
+                      const struct RecordFile_Record *records, size_t count);
+
+/**
+ * Maps an existing file for reading.
+ *
+ * @param file
+ * @param path
+ * @return 0 on success, -EBADMSG if no record file, negative errno on other
+ * failures
+ */
+int RecordFile_open(struct RecordFile *file, const char *path);
+
+/**
+ * @param file opened or created
+ * @return header of the mapped file
+ */
+const struct RecordFile_Header *
+RecordFile_header(const struct RecordFile *file);
+
+/**
+ * @param file opened or created
+ * @return first of RecordFile.recordsCount records of the mapped file
+ */
+const struct RecordFile_Record *
+RecordFile_records(const struct RecordFile *file);
+
+/**
+ * Truncates a recorded file to its records and unmaps it.
+ *
+ * @param file
+ */
+void RecordFile_close(struct RecordFile *file);
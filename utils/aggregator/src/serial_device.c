@@ -0,0 +1,133 @@
+/**
+ * \file serial_device.c
+ */
+
+#include "serial_device.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * Time to wait for the tty to accept more bytes.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define WRITE_TIMEOUT_MS 100
+
+/**
+ * Longest tty name considered, the kernel's are much shorter.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TTY_NAME_MAX_BYTES 32U
+
+int SerialDevice_makeRaw(int fd) {
+  struct termios options;
+  if (0 != tcgetattr(fd, &options)) {
+    return -errno;
+  }
+  cfmakeraw(&options);
+  if (0 != tcsetattr(fd, TCSANOW, &options)) {
+    return -errno;
+  }
+  return 0;
+}
+
+int SerialDevice_open(const char *path) {
+  const int fd = {open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC)};
+  if (0 > fd) {
+    return -errno;
+  }
+
+  const int result = {SerialDevice_makeRaw(fd)};
+  if (0 != result) {
+    close(fd);
+    return result;
+  }
+
+  // bytes received before opening belong to an unknown session
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+int SerialDevice_write(int fd, const void *bytes, size_t count) {
+  size_t offset = {0};
+
+  while (offset < count) {
+    const ssize_t written = {
+        write(fd, &((const uint8_t *)bytes)[offset], count - offset)};
+    if (0 < written) {
+      offset += written;
+      continue;
+    }
+    if (0 > written && EINTR == errno) {
+      continue;
+    }
+    if (0 > written && EAGAIN != errno) {
+      return -errno;
+    }
+
+    struct pollfd pollFd = {.fd = fd, .events = POLLOUT};
+    if (0 == poll(&pollFd, 1, WRITE_TIMEOUT_MS)) {
+      return -ETIMEDOUT;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Reads a hexadecimal USB ID from sysfs.
+ *
+ * @param path attribute file
+ * @return ID, -1 if not readable
+ */
+static long readUsbId(const char *path) {
+  FILE *file = {fopen(path, "r")};
+  if (NULL == file) {
+    return -1;
+  }
+  unsigned int id = {0};
+  const int matched = {fscanf(file, "%x", &id)};
+  fclose(file);
+  return 1 == matched ? (long)id : -1;
+}
+
+int SerialDevice_discover(char (*paths)[SERIALDEVICE_PATH_MAX_BYTES],
+                          uint8_t maxCount) {
+  DIR *ttys = {opendir("/sys/class/tty")};
+  if (NULL == ttys) {
+    return -errno;
+  }
+
+  uint8_t count = {0};
+  const struct dirent *entry = {NULL};
+  while (count < maxCount && NULL != (entry = readdir(ttys))) {
+    if (0 != strncmp(entry->d_name, "ttyACM", strlen("ttyACM")) ||
+        TTY_NAME_MAX_BYTES <= strlen(entry->d_name)) {
+      continue;
+    }
+
+    // device links to the USB interface, the IDs belong to its parent
+    char path[SERIALDEVICE_PATH_MAX_BYTES];
+    snprintf(path, sizeof(path), "/sys/class/tty/%.32s/device/../idVendor",
+             entry->d_name);
+    const long vendorId = {readUsbId(path)};
+    snprintf(path, sizeof(path), "/sys/class/tty/%.32s/device/../idProduct",
+             entry->d_name);
+    const long productId = {readUsbId(path)};
+
+    if (SERIALDEVICE_VENDOR_ID == vendorId &&
+        SERIALDEVICE_PRODUCT_ID == productId) {
+      snprintf(paths[count], SERIALDEVICE_PATH_MAX_BYTES, "/dev/%.32s",
+               entry->d_name);
+      count++;
+    }
+  }
+
+  closedir(ttys);
+  return count;
+}
@@ -0,0 +1,60 @@
+/**
+ * \file serial_device.h
+ *
+ * Access to the controller's CDC ACM tty.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+
+/**
+ * USB IDs of the controller, \see scripts/wireshark/wireshark.sh
+ * @{
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define SERIALDEVICE_VENDOR_ID 0x1209U
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define SERIALDEVICE_PRODUCT_ID 0xE11AU
+/// @}
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define SERIALDEVICE_PATH_MAX_BYTES 128U
+
+/**
+ * Opens a tty non-blocking and switches it to raw mode.
+ *
+ * @param path i.e. /dev/ttyACM0
+ * @return file descriptor, negative errno on failure
+ */
+int SerialDevice_open(const char *path);
+
+/**
+ * Switches an open tty to raw mode.
+ *
+ * @param fd
+ * @return 0 on success, negative errno on failure
+ */
+int SerialDevice_makeRaw(int fd);
+
+/**
+ * Writes all bytes, waits for the non-blocking tty to accept them.
+ *
+ * @param fd
+ * @param bytes
+ * @param count
+ * @return 0 on success, -ETIMEDOUT if the tty does not drain, negative errno
+ * on other failures
+ */
+int SerialDevice_write(int fd, const void *bytes, size_t count);
+
+/**
+ * Lists the ttys of all connected controllers by USB vendor and product ID.
+ *
+ * @param paths output, device node paths
+ * @param maxCount capacity of paths
+ * @return number of paths written, negative errno on failure
+ */
+int SerialDevice_discover(char (*paths)[SERIALDEVICE_PATH_MAX_BYTES],
+                          uint8_t maxCount);
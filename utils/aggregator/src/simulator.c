@@ -0,0 +1,402 @@
+/**
+ * \file simulator.c
+ *
+ * Simulates a controller on a pseudo-tty.
+ *
+ * Requests are parsed and responses are encoded by the firmware's very own
+ * host transport, sampling is replaced by a sine wave generated in real time
+ * at the selected output data rate. Intended for testing the aggregator and
+ * host tools without hardware.
+ */
+
+#define _GNU_SOURCE
+#include "serial_device.h"
+#include <crc.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <from_host_transport.h>
+#include <fw/version.h>
+#include <getopt.h>
+#include <host_transport.h>
+#include <host_transport_types.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <to_host_transport.h>
+#include <unistd.h>
+
+/**
+ * Size of the stream buffer, same order of magnitude as on the controller.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define STORAGE_SIZE_BYTES 65340U
+
+/**
+ * Maximum number of simulated sensors \see TransportTx_AccelerationSensor.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define MAX_SENSORS 4U
+
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define TICK_MS 1U
+
+/**
+ * Samples fetched at once, same as the sensor's FiFo watermark.
+ */
+// NOLINTNEXTLINE(modernize-macro-to-enum)
+#define BATCH_SAMPLES TRANSPORTTX_TRANSMIT_ACCELERATION_BUFFER_BYTES
+
+struct Simulator {
+  int masterFd;
+  int slaveFd; ///< kept open, the master reads EIO while no slave is open
+  uint8_t sensorsCount;
+
+  uint8_t rate;  ///< \see TransportRx_SetOutputDataRate_Rate
+  uint8_t range; ///< \see TransportRx_SetRange_Range
+  uint8_t scale; ///< \see TransportRx_SetScale_Scale
+
+  bool isStarted;
+  uint16_t maxSamples; ///< samples until finished, infinite if 0
+  uint32_t samplesCount;
+  uint64_t startNs;
+  uint16_t nextIndex;
+};
+
+static struct Simulator simulator = {
+    .masterFd = -1,
+    .slaveFd = -1,
+    .sensorsCount = 1,
+    .rate = TransportRx_SetOutputDataRate_Rate3200,
+    .range = TransportRx_SetRange_Range_2g,
+    .scale = TransportRx_SetScale_Scale_10bit,
+};
+
+static uint8_t storage[STORAGE_SIZE_BYTES];
+
+static uint64_t nowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static uint32_t simulator_getTickMsImpl() {
+  return (uint32_t)(nowNs() / 1000000ULL);
+}
+
+/**
+ * Writes the whole chunk, blocks while the reader lags behind just like a
+ * busy IN endpoint.
+ */
+static enum HostTransport_Status simulator_doTransmitImpl(uint8_t *buffer,
+                                                          uint16_t length) {
+  return 0 == SerialDevice_write(simulator.masterFd, buffer, length)
+             ? HostTransport_Status_Ok
+             : HostTransport_Status_Fail;
+}
+
+static volatile bool simulator_isTransmitBusyImpl() { return false; }
+
+static uint32_t simulator_doCrc32WordsImpl(const uint32_t *words,
+                                           uint16_t count) {
+  return Crc_crc32Words(words, count);
+}
+
+static int simulator_onTakeReceivedImpl(const uint8_t *buffer);
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static struct HostTransport_Handle transport = {
+    .fromHost = {.doTakeReceivedPacketImpl = simulator_onTakeReceivedImpl},
+    .toHost = {
+        .ringbuffer = {.storage = storage},
+        .axes = Transport_Axis_All,
+        .format = Transport_SampleFormat_Acceleration,
+        .doTransmitImpl = simulator_doTransmitImpl,
+        .isTransmitBusyImpl = simulator_isTransmitBusyImpl,
+        .doCrc32WordsImpl = simulator_doCrc32WordsImpl,
+        .getTickMsImpl = simulator_getTickMsImpl,
+    }};
+
+/**
+ * @return samples per second at the selected output data rate
+ */
+static uint32_t samplesPerSecond() {
+  return 3200U >> (TransportRx_SetOutputDataRate_Rate3200 - simulator.rate);
+}
+
+static void flushStream() {
+  while (-ENODATA != TransportTx_TxAccelerationFlush(&transport)) {
+  }
+}
+
+static void startSampling(uint16_t maxSamples, uint8_t format) {
+  Transport_setFormat(&transport, format, STORAGE_SIZE_BYTES);
+  simulator.isStarted = true;
+  simulator.maxSamples = maxSamples;
+  simulator.samplesCount = 0;
+  simulator.nextIndex = 0;
+  simulator.startNs = nowNs();
+}
+
+static int simulator_onTakeReceivedImpl(const uint8_t *buffer) {
+  const struct TransportFrame *frame = {(const struct TransportFrame *)buffer};
+  const union TransportRxFrame *request = {&frame->asRxFrame};
+
+  switch (frame->header.id) {
+  case Transport_HeaderId_Rx_SetOutputDataRate:
+    if (TransportRx_SetOutputDataRate_Rate_50 <=
+        request->asSetOutputDataRate.rate) {
+      simulator.rate = request->asSetOutputDataRate.rate;
+    }
+    // fall through
+  case Transport_HeaderId_Rx_GetOutputDataRate:
+    TransportTx_TxOutputDataRate(&transport, simulator.rate);
+    break;
+  case Transport_HeaderId_Rx_SetRange:
+    simulator.range = request->asSetRange.range;
+    // fall through
+  case Transport_HeaderId_Rx_GetRange:
+    TransportTx_TxRange(&transport, simulator.range);
+    break;
+  case Transport_HeaderId_Rx_SetScale:
+    simulator.scale = request->asSetScale.scale;
+    // fall through
+  case Transport_HeaderId_Rx_GetScale:
+    TransportTx_TxScale(&transport, simulator.scale);
+    break;
+  case Transport_HeaderId_Rx_GetDeviceSetup:
+    TransportTx_TxSamplingSetup(&transport, simulator.rate, simulator.scale,
+                                simulator.range);
+    break;
+  case Transport_HeaderId_Rx_GetFirmwareVersion:
+    TransportTx_TxFirmwareVersion(&transport, VERSION_MAJOR, VERSION_MINOR,
+                                  VERSION_PATCH);
+    break;
+  case Transport_HeaderId_Rx_GetUptime:
+    TransportTx_TxUptime(&transport, simulator_getTickMsImpl());
+    break;
+  case Transport_HeaderId_Rx_SetFraming:
+    Transport_setFraming(&transport, 0 != request->asSetFraming.enable);
+    TransportTx_TxStreamSetup(&transport, 0);
+    break;
+  case Transport_HeaderId_Rx_SamplingStart:
+    startSampling(request->asSamplingStart.max_samples_count,
+                  Transport_SampleFormat_Acceleration);
+    TransportTx_TxSamplingStarted(&transport, simulator.maxSamples);
+    break;
+  case Transport_HeaderId_Rx_ConfigureAndStart: {
+    const struct TransportRx_ConfigureAndStart *configure = {
+        &request->asConfigureAndStart};
+    if (!Transport_isValidFormat(configure->format) ||
+        TransportRx_SetOutputDataRate_Rate_50 > configure->rate) {
+      // answered like the firmware does, with the unchanged setup
+      TransportTx_TxSamplingConfiguredStarted(
+          &transport, 0, simulator.rate, simulator.scale, simulator.range,
+          configure->watermark, Transport_SampleFormat_Acceleration, -EINVAL);
+      return -EINVAL;
+    }
+    simulator.rate = configure->rate;
+    simulator.range = configure->range;
+    simulator.scale = configure->scale;
+    startSampling(configure->max_samples_count, configure->format);
+    TransportTx_TxSamplingConfiguredStarted(
+        &transport, simulator.maxSamples, simulator.rate, simulator.scale,
+        simulator.range, configure->watermark, configure->format, 0);
+    break;
+  }
+  case Transport_HeaderId_Rx_SamplingStop:
+    if (simulator.isStarted) {
+      simulator.isStarted = false;
+      flushStream();
+      TransportTx_TxSamplingStopped(&transport);
+    }
+    break;
+  default:
+    return -ENOTSUP;
+  }
+  return 0;
+}
+
+/**
+ * Generates the samples due since sampling started, one batch per sensor at
+ * a time.
+ */
+static void sample() {
+  if (!simulator.isStarted) {
+    TransportTx_TxAccelerationBuffer(&transport, NULL, 0, 0);
+    return;
+  }
+
+  const uint64_t dueCount = {(nowNs() - simulator.startNs) *
+                             samplesPerSecond() / 1000000000ULL};
+  while (simulator.samplesCount + BATCH_SAMPLES <= dueCount) {
+    uint8_t count = {BATCH_SAMPLES};
+    if (0 != simulator.maxSamples &&
+        simulator.maxSamples - simulator.samplesCount < count) {
+      count = simulator.maxSamples - simulator.samplesCount;
+    }
+
+    for (uint8_t sensor = 0; sensor < simulator.sensorsCount; sensor++) {
+      struct Transport_Acceleration batch[BATCH_SAMPLES];
+      for (uint8_t idx = 0; idx < count; idx++) {
+        const double phase = {2.0 * M_PI *
+                              (double)(simulator.samplesCount + idx) /
+                              (double)samplesPerSecond()};
+        batch[idx].x = (int16_t)(256.0 * sin(phase * (1.0 + sensor)));
+        batch[idx].y = (int16_t)(256.0 * cos(phase * (1.0 + sensor)));
+        batch[idx].z = (int16_t)(256 + sensor);
+      }
+      if (1U < simulator.sensorsCount) {
+        TransportTx_TxAccelerationSensor(&transport, sensor, count,
+                                         simulator.nextIndex,
+                                         simulator_getTickMsImpl());
+      }
+      TransportTx_TxAccelerationBuffer(&transport, batch, count,
+                                       simulator.nextIndex);
+    }
+    simulator.samplesCount += count;
+    simulator.nextIndex += count;
+
+    if (0 != simulator.maxSamples &&
+        simulator.maxSamples <= simulator.samplesCount) {
+      simulator.isStarted = false;
+      flushStream();
+      TransportTx_TxSamplingFinished(&transport);
+      return;
+    }
+  }
+}
+
+/**
+ * Opens a pseudo-tty pair.
+ *
+ * @param linkPath symbolic link to create to the slave, NULL if none
+ * @return 0 on success, negative errno on failure
+ */
+static int openPty(const char *linkPath) {
+  simulator.masterFd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (0 > simulator.masterFd || 0 != grantpt(simulator.masterFd) ||
+      0 != unlockpt(simulator.masterFd)) {
+    return -errno;
+  }
+
+  const char *slavePath = {ptsname(simulator.masterFd)};
+  simulator.slaveFd = open(slavePath, O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (0 > simulator.slaveFd) {
+    return -errno;
+  }
+  // no echo of requests while the aggregator has not yet opened the slave
+  const int result = {SerialDevice_makeRaw(simulator.slaveFd)};
+  if (0 != result) {
+    return result;
+  }
+
+  if (NULL != linkPath) {
+    unlink(linkPath);
+    if (0 != symlink(slavePath, linkPath)) {
+      return -errno;
+    }
+  }
+
+  printf("%s\n", NULL == linkPath ? slavePath : linkPath);
+  fflush(stdout);
+  return 0;
+}
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [-l LINK] [-n SENSORS]\n"
+          "  -l, --link LINK       create symbolic link to the pseudo-tty\n"
+          "  -n, --sensors SENSORS number of sensors, 1 to %u\n",
+          name, MAX_SENSORS);
+}
+
+int main(int argc, char **argv) {
+  static const struct option options[] = {
+      {"link", required_argument, NULL, 'l'},
+      {"sensors", required_argument, NULL, 'n'},
+      {"help", no_argument, NULL, 'h'},
+      {NULL, 0, NULL, 0}};
+  const char *linkPath = {NULL};
+
+  int option = {0};
+  while (-1 != (option = getopt_long(argc, argv, "l:n:h", options, NULL))) {
+    switch (option) {
+    case 'l':
+      linkPath = optarg;
+      break;
+    case 'n':
+      simulator.sensorsCount = (uint8_t)atoi(optarg);
+      if (0 == simulator.sensorsCount || MAX_SENSORS < simulator.sensorsCount) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    default:
+      usage(argv[0]);
+      return 'h' == option ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  Transport_setAxes(&transport, Transport_Axis_All, STORAGE_SIZE_BYTES);
+
+  int result = {openPty(linkPath)};
+  if (0 != result) {
+    fprintf(stderr, "pseudo-tty: %s\n", strerror(-result));
+    return EXIT_FAILURE;
+  }
+
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  sigprocmask(SIG_BLOCK, &signals, NULL);
+
+  const int timerFd = {timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC)};
+  const struct itimerspec period = {
+      .it_interval = {.tv_nsec = TICK_MS * 1000000L},
+      .it_value = {.tv_nsec = TICK_MS * 1000000L}};
+  timerfd_settime(timerFd, 0, &period, NULL);
+
+  struct pollfd pollFds[] = {{.fd = simulator.masterFd, .events = POLLIN},
+                             {.fd = timerFd, .events = POLLIN}};
+  const struct timespec noWait = {0};
+
+  for (;;) {
+    if (0 < sigtimedwait(&signals, NULL, &noWait)) {
+      break;
+    }
+    if (0 > poll(pollFds, sizeof(pollFds) / sizeof(pollFds[0]), -1)) {
+      continue;
+    }
+
+    if (pollFds[0].revents & POLLIN) {
+      uint8_t bytes[256];
+      const ssize_t count = {read(simulator.masterFd, bytes, sizeof(bytes))};
+      if (0 < count) {
+        TransportRx_Process(&transport, bytes, (uint16_t)count);
+        TransportRx_DispatchPending(&transport);
+      }
+    }
+    if (pollFds[1].revents & POLLIN) {
+      uint64_t expirations = {0};
+      if (sizeof(expirations) == read(timerFd, &expirations,
+                                      sizeof(expirations))) {
+        sample();
+      }
+    }
+  }
+
+  if (NULL != linkPath) {
+    unlink(linkPath);
+  }
+  close(timerFd);
+  close(simulator.slaveFd);
+  close(simulator.masterFd);
+  return EXIT_SUCCESS;
+}
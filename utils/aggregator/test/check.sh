@@ -0,0 +1,85 @@
+#!/bin/bash
+# Records simulated controllers and verifies the capture files.
+#
+# usage: check.sh BUILDDIR
+
+set -euo pipefail
+
+BUILDDIR=$(realpath "${1:-build}")
+WORKDIR=$(mktemp -d)
+PIDS=()
+
+cleanup() {
+  for pid in "${PIDS[@]}"; do
+    kill "$pid" 2>/dev/null || true
+  done
+  wait 2>/dev/null || true
+  rm -rf "$WORKDIR"
+}
+trap cleanup EXIT
+
+fail() {
+  echo "FAIL: $*" >&2
+  exit 1
+}
+
+# device 0: one sensor, device 1: two interleaved sensors with framing
+"$BUILDDIR/3dpaxxel-simulator" -l "$WORKDIR/tty0" >/dev/null &
+PIDS+=($!)
+"$BUILDDIR/3dpaxxel-simulator" -l "$WORKDIR/tty1" -n 2 >/dev/null &
+PIDS+=($!)
+for tty in tty0 tty1; do
+  for _ in $(seq 50); do
+    [ -e "$WORKDIR/$tty" ] && break
+    sleep 0.02
+  done
+done
+
+"$BUILDDIR/3dpaxxel-aggregator" -o "$WORKDIR" -s -f -t 1 \
+  "$WORKDIR/tty0" "$WORKDIR/tty1"
+
+# about 3200 samples per sensor and second
+check_capture() {
+  local file=$1 minimum=$2
+  "$BUILDDIR/3dpaxxel-dump" "$file" | awk -v minimum="$minimum" -F '\t' '
+    /^# source/ && /firmware 0\.0\.0/ {
+      print "firmware version missing"
+      failed = 1
+    }
+    /^#/ || /^timestamp/ { next }
+    {
+      if (count && $3 != lastIndex + 1) {
+        printf "index gap: %d -> %d\n", lastIndex, $3
+        failed = 1
+      }
+      if (count && $1 < lastStamp) {
+        printf "timestamp goes back at index %d\n", $3
+        failed = 1
+      }
+      lastIndex = $3
+      lastStamp = $1
+      count++
+    }
+    END {
+      if (count < minimum) {
+        printf "only %d samples\n", count
+        failed = 1
+      }
+      exit failed
+    }' || fail "$file"
+}
+
+check_capture "$WORKDIR/device0-tty0-sensor0.cap" 2000
+check_capture "$WORKDIR/device1-tty1-sensor0.cap" 2000
+check_capture "$WORKDIR/device1-tty1-sensor1.cap" 2000
+
+MERGED=$("$BUILDDIR/3dpaxxel-dump" "$WORKDIR/merged.rec" | awk -F '\t' '
+  /^#/ || /^timestamp/ { next }
+  $1 < last { late++ }
+  { last = $1; count++ }
+  END { printf "%d %d", count, late }')
+read -r MERGED_COUNT MERGED_LATE <<<"$MERGED"
+[ "$MERGED_COUNT" -ge 6000 ] || fail "merged only $MERGED_COUNT samples"
+[ "$MERGED_LATE" -eq 0 ] || fail "merged $MERGED_LATE samples out of order"
+
+echo "PASS: merged $MERGED_COUNT samples"